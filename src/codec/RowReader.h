@@ -77,6 +77,25 @@ public:
     // Return the number of bytes used for the header info
     virtual size_t headerLen() const noexcept = 0;
 
+    // Read the field in place without building a Value, integer types (and timestamp)
+    // are read by getInt, float and double by getFloat, string and fixed string by getStr.
+    // Return false when the field is null, or the reader can't read the field this way,
+    // then the caller should fall back to getValueByIndex
+    virtual bool getInt(int64_t index, int64_t& v) const noexcept {
+        UNUSED(index); UNUSED(v);
+        return false;
+    }
+
+    virtual bool getFloat(int64_t index, double& v) const noexcept {
+        UNUSED(index); UNUSED(v);
+        return false;
+    }
+
+    virtual bool getStr(int64_t index, folly::StringPiece& v) const noexcept {
+        UNUSED(index); UNUSED(v);
+        return false;
+    }
+
 
     virtual Iterator begin() const noexcept {
         return Iterator(this, 0);
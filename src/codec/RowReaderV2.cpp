@@ -183,6 +183,109 @@ Value RowReaderV2::getValueByIndex(const int64_t index) const noexcept {
     LOG(FATAL) << "Should not reach here";
 }
 
+const meta::SchemaProviderIf::Field* RowReaderV2::fieldAt(int64_t index,
+                                                         size_t& offset) const {
+    if (index < 0 || static_cast<size_t>(index) >= schema_->getNumFields()) {
+        return nullptr;
+    }
+    auto field = schema_->field(index);
+    if (field->nullable() && isNull(field->nullFlagPos())) {
+        return nullptr;
+    }
+    offset = headerLen_ + numNullBytes_ + field->offset();
+    return field;
+}
+
+
+bool RowReaderV2::getInt(int64_t index, int64_t& v) const noexcept {
+    size_t offset = 0;
+    auto field = fieldAt(index, offset);
+    if (field == nullptr) {
+        return false;
+    }
+    switch (field->type()) {
+        case meta::cpp2::PropertyType::INT8: {
+            v = static_cast<int8_t>(data_[offset]);
+            return true;
+        }
+        case meta::cpp2::PropertyType::INT16: {
+            int16_t val;
+            memcpy(reinterpret_cast<void*>(&val), &data_[offset], sizeof(int16_t));
+            v = val;
+            return true;
+        }
+        case meta::cpp2::PropertyType::INT32: {
+            int32_t val;
+            memcpy(reinterpret_cast<void*>(&val), &data_[offset], sizeof(int32_t));
+            v = val;
+            return true;
+        }
+        case meta::cpp2::PropertyType::INT64:
+        case meta::cpp2::PropertyType::TIMESTAMP: {
+            memcpy(reinterpret_cast<void*>(&v), &data_[offset], sizeof(int64_t));
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+
+bool RowReaderV2::getFloat(int64_t index, double& v) const noexcept {
+    size_t offset = 0;
+    auto field = fieldAt(index, offset);
+    if (field == nullptr) {
+        return false;
+    }
+    switch (field->type()) {
+        case meta::cpp2::PropertyType::FLOAT: {
+            float val;
+            memcpy(reinterpret_cast<void*>(&val), &data_[offset], sizeof(float));
+            v = val;
+            return true;
+        }
+        case meta::cpp2::PropertyType::DOUBLE: {
+            memcpy(reinterpret_cast<void*>(&v), &data_[offset], sizeof(double));
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+
+bool RowReaderV2::getStr(int64_t index, folly::StringPiece& v) const noexcept {
+    size_t offset = 0;
+    auto field = fieldAt(index, offset);
+    if (field == nullptr) {
+        return false;
+    }
+    switch (field->type()) {
+        case meta::cpp2::PropertyType::STRING: {
+            int32_t strOffset;
+            int32_t strLen;
+            memcpy(reinterpret_cast<void*>(&strOffset), &data_[offset], sizeof(int32_t));
+            memcpy(reinterpret_cast<void*>(&strLen),
+                   &data_[offset + sizeof(int32_t)],
+                   sizeof(int32_t));
+            if (static_cast<size_t>(strOffset) == data_.size() && strLen == 0) {
+                v = folly::StringPiece();
+                return true;
+            }
+            CHECK_LT(strOffset, data_.size());
+            v = folly::StringPiece(&data_[strOffset], strLen);
+            return true;
+        }
+        case meta::cpp2::PropertyType::FIXED_STRING: {
+            v = folly::StringPiece(&data_[offset], field->size());
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+
 int64_t RowReaderV2::getTimestamp() const noexcept {
     return *reinterpret_cast<const int64_t*>(data_.begin() + (data_.size() - sizeof(int64_t)));
 }
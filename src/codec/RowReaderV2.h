@@ -32,6 +32,10 @@ public:
     Value getValueByIndex(const int64_t index) const noexcept override;
     int64_t getTimestamp() const noexcept override;
 
+    bool getInt(int64_t index, int64_t& v) const noexcept override;
+    bool getFloat(int64_t index, double& v) const noexcept override;
+    bool getStr(int64_t index, folly::StringPiece& v) const noexcept override;
+
     int32_t readerVer() const noexcept override {
         return 2;
     }
@@ -52,6 +56,9 @@ private:
 
     // Check whether the flag at the given position is set or not
     bool isNull(size_t pos) const;
+
+    // Return the field if it's valid and not null, and set the offset of its data
+    const meta::SchemaProviderIf::Field* fieldAt(int64_t index, size_t& offset) const;
 };
 
 }  // namespace nebula
@@ -101,6 +101,21 @@ public:
         return currReader_->getTimestamp();
     }
 
+    bool getInt(int64_t index, int64_t& v) const noexcept override {
+        DCHECK(!!currReader_);
+        return currReader_->getInt(index, v);
+    }
+
+    bool getFloat(int64_t index, double& v) const noexcept override {
+        DCHECK(!!currReader_);
+        return currReader_->getFloat(index, v);
+    }
+
+    bool getStr(int64_t index, folly::StringPiece& v) const noexcept override {
+        DCHECK(!!currReader_);
+        return currReader_->getStr(index, v);
+    }
+
     int32_t readerVer() const noexcept override {
         DCHECK(!!currReader_);
         return currReader_->readerVer();
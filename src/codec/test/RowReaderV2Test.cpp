@@ -314,6 +314,30 @@ TEST(RowReaderV2, encodedData) {
     // Col 13 -- non-existing column
     val = reader->getValueByIndex(13);
     EXPECT_EQ(Value::Type::NULLVALUE, val.type());
+
+    // Read in place
+    int64_t intVal = 0;
+    double floatVal = 0;
+    folly::StringPiece strVal;
+    EXPECT_TRUE(reader->getInt(2, intVal));
+    EXPECT_EQ(100, intVal);
+    EXPECT_TRUE(reader->getInt(3, intVal));
+    EXPECT_EQ(0xFFFFFFFFFFFFFFFFL, intVal);
+    EXPECT_TRUE(reader->getInt(9, intVal));
+    EXPECT_EQ(1551331827, intVal);
+    EXPECT_TRUE(reader->getFloat(7, floatVal));
+    EXPECT_DOUBLE_EQ(pi, floatVal);
+    EXPECT_TRUE(reader->getFloat(8, floatVal));
+    EXPECT_DOUBLE_EQ(e, floatVal);
+    EXPECT_TRUE(reader->getStr(1, strVal));
+    EXPECT_EQ(str1, strVal);
+    EXPECT_TRUE(reader->getStr(5, strVal));
+    EXPECT_EQ(str2, strVal);
+    // Type mismatch or non-existing column
+    EXPECT_FALSE(reader->getInt(0, intVal));
+    EXPECT_FALSE(reader->getFloat(2, floatVal));
+    EXPECT_FALSE(reader->getStr(4, strVal));
+    EXPECT_FALSE(reader->getInt(13, intVal));
 }
 
 
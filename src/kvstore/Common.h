@@ -67,6 +67,24 @@ public:
                         const folly::StringPiece& val) const = 0;
 };
 
+/**
+ * Notified of the data changed in a part, on the leader and the followers alike. It is called
+ * from the thread committing the part, after the change has been written into the engine.
+ * */
+class CommitListener {
+public:
+    virtual ~CommitListener() = default;
+
+    // The keys put, merged or removed by a batch of committed logs
+    virtual void onCommitted(GraphSpaceID spaceId,
+                             PartitionID partId,
+                             const std::vector<std::string>& keys) = 0;
+
+    // The part is changed without knowing which keys, e.g. a range is removed, or a snapshot or
+    // sst files are written into it
+    virtual void onReset(GraphSpaceID spaceId, PartitionID partId) = 0;
+};
+
 using KV = std::pair<std::string, std::string>;
 using KVCallback = folly::Function<void(ResultCode code)>;
 using NewLeaderCallback = folly::Function<void(HostAddr nLeader)>;
@@ -24,6 +24,9 @@ public:
 
     virtual ResultCode remove(folly::StringPiece key) = 0;
 
+    // Record a merge operand, which is resolved by the engine's merge operator on read
+    virtual ResultCode merge(folly::StringPiece key, folly::StringPiece operand) = 0;
+
     // Remove all keys in the range [start, end)
     virtual ResultCode removeRange(folly::StringPiece start,
                                    folly::StringPiece end) = 0;
@@ -111,6 +114,15 @@ public:
     virtual ResultCode setDBOption(const std::string& configKey,
                                    const std::string& configValue) = 0;
 
+    // Return at most count - 1 keys in (start, end), which split the range into parts of about
+    // the same size on disk. It is only an estimation, no key is returned if it is unknown.
+    virtual std::vector<std::string> splitRange(const std::string& start,
+                                                const std::string& end,
+                                                int32_t count) = 0;
+
+    // Return the estimated bytes of the keys in [start, end), both on disk and in memory
+    virtual int64_t approximateSize(const std::string& start, const std::string& end) = 0;
+
     virtual ResultCode compact() = 0;
 
     virtual ResultCode flush() = 0;
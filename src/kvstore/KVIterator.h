@@ -22,6 +22,9 @@ public:
 
     virtual void prev() = 0;
 
+    // Move to the first key which is not less than target
+    virtual void seek(folly::StringPiece target) = 0;
+
     virtual folly::StringPiece key() const = 0;
 
     virtual folly::StringPiece val() const = 0;
@@ -46,6 +46,9 @@ struct KVOptions {
      * Custom CompactionFilter used in compaction.
      * */
     std::unique_ptr<CompactionFilterFactoryBuilder> cffBuilder_{nullptr};
+
+    // Notified of the data committed into all parts
+    std::shared_ptr<CommitListener> commitListener_{nullptr};
 };
 
 struct StoreCapability {
@@ -147,6 +150,13 @@ public:
                                std::vector<KV>&& keyValues,
                                KVCallback cb) = 0;
 
+    // Blind write of merge operands, they are folded into the current value by
+    // the engine's merge operator (KVOptions::mergeOp_) on read and compaction
+    virtual void asyncMultiMerge(GraphSpaceID spaceId,
+                                 PartitionID partId,
+                                 std::vector<KV>&& keyValues,
+                                 KVCallback cb) = 0;
+
     // Asynchronous version of remove methods
     virtual void asyncRemove(GraphSpaceID spaceId,
                              PartitionID partId,
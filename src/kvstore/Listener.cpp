@@ -179,7 +179,9 @@ void Listener::doApply() {
                 }
                 case OP_REMOVE:
                 case OP_REMOVE_RANGE:
-                case OP_MULTI_REMOVE: {
+                case OP_MULTI_REMOVE:
+                case OP_MULTI_MERGE: {
+                    // merge operands are only meaningful to the engine's merge operator
                     break;
                 }
                 case OP_BATCH_WRITE: {
@@ -37,6 +37,33 @@ std::pair<folly::StringPiece, folly::StringPiece> decodeKV(const std::string& da
     return std::make_pair(key, val);
 }
 
+constexpr uint32_t kSstChunkMarker = std::numeric_limits<uint32_t>::max();
+
+std::string encodeSstChunk(int32_t fileIndex, bool last, folly::StringPiece data) {
+    std::string str;
+    str.reserve(sizeof(uint32_t) + sizeof(int32_t) + 1 + data.size());
+    str.append(reinterpret_cast<const char*>(&kSstChunkMarker), sizeof(uint32_t));
+    str.append(reinterpret_cast<const char*>(&fileIndex), sizeof(int32_t));
+    str.append(1, last ? 1 : 0);
+    str.append(data.data(), data.size());
+    return str;
+}
+
+bool isSstChunk(const std::string& row) {
+    return row.size() >= sizeof(uint32_t) + sizeof(int32_t) + 1 &&
+           *reinterpret_cast<const uint32_t*>(row.data()) == kSstChunkMarker;
+}
+
+SstChunk decodeSstChunk(const std::string& row) {
+    DCHECK(isSstChunk(row));
+    SstChunk chunk;
+    chunk.fileIndex = *reinterpret_cast<const int32_t*>(row.data() + sizeof(uint32_t));
+    chunk.last = row[sizeof(uint32_t) + sizeof(int32_t)] != 0;
+    auto head = sizeof(uint32_t) + sizeof(int32_t) + 1;
+    chunk.data = folly::StringPiece(row.data() + head, row.size() - head);
+    return chunk;
+}
+
 std::string encodeSingleValue(LogType type, folly::StringPiece val) {
     std::string encoded;
     encoded.reserve(val.size() + kHeadLen);
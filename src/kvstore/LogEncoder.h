@@ -23,6 +23,7 @@ enum LogType : char {
     OP_ADD_PEER       = 0x09,
     OP_REMOVE_PEER    = 0x10,
     OP_BATCH_WRITE    = 0x11,
+    OP_MULTI_MERGE    = 0x12,
 };
 
 enum BatchLogType : char {
@@ -36,6 +37,18 @@ std::string encodeKV(const folly::StringPiece& key,
 
 std::pair<folly::StringPiece, folly::StringPiece> decodeKV(const std::string& data);
 
+// A chunk of sst file in the snapshot, it shares the rows of SendSnapshotRequest with
+// encodeKV, and is distinguished by an impossible key size at the head
+struct SstChunk {
+    int32_t fileIndex;
+    bool last;
+    folly::StringPiece data;
+};
+
+std::string encodeSstChunk(int32_t fileIndex, bool last, folly::StringPiece data);
+bool isSstChunk(const std::string& row);
+SstChunk decodeSstChunk(const std::string& row);
+
 std::string encodeSingleValue(LogType type, folly::StringPiece val);
 folly::StringPiece decodeSingleValue(folly::StringPiece encoded);
 
@@ -163,6 +163,7 @@ void NebulaStore::loadPartFromDataPath() {
                                                             workers_,
                                                             snapshot_,
                                                             clientMan_);
+                        part->setCommitListener(options_.commitListener_);
                         auto status = options_.partMan_->partMeta(spaceId, partId);
                         if (!status.ok()) {
                             LOG(WARNING) << status.status().toString();
@@ -379,6 +380,7 @@ std::shared_ptr<Part> NebulaStore::newPart(GraphSpaceID spaceId,
                                        workers_,
                                        snapshot_,
                                        clientMan_);
+    part->setCommitListener(options_.commitListener_);
     std::vector<HostAddr> peers;
     if (defaultPeers.empty()) {
         // pull the information from meta
@@ -579,6 +581,7 @@ ResultCode NebulaStore::get(GraphSpaceID spaceId,
     if (!checkLeader(part, canReadFromFollower)) {
         return ResultCode::ERR_LEADER_CHANGED;
     }
+    part->addRead();
     return part->engine()->get(key, value);
 }
 
@@ -598,6 +601,7 @@ std::pair<ResultCode, std::vector<Status>> NebulaStore::multiGet(
     if (!checkLeader(part, canReadFromFollower)) {
         return {ResultCode::ERR_LEADER_CHANGED, status};
     }
+    part->addRead();
     status = part->engine()->multiGet(keys, values);
     auto allExist = std::all_of(status.begin(), status.end(),
                                 [] (const auto& s) {
@@ -625,6 +629,7 @@ ResultCode NebulaStore::range(GraphSpaceID spaceId,
     if (!checkLeader(part, canReadFromFollower)) {
         return ResultCode::ERR_LEADER_CHANGED;
     }
+    part->addRead();
     return part->engine()->range(start, end, iter);
 }
 
@@ -642,6 +647,7 @@ ResultCode NebulaStore::prefix(GraphSpaceID spaceId,
     if (!checkLeader(part, canReadFromFollower)) {
         return ResultCode::ERR_LEADER_CHANGED;
     }
+    part->addRead();
     return part->engine()->prefix(prefix, iter);
 }
 
@@ -660,6 +666,7 @@ ResultCode NebulaStore::rangeWithPrefix(GraphSpaceID spaceId,
     if (!checkLeader(part, canReadFromFollower)) {
         return ResultCode::ERR_LEADER_CHANGED;
     }
+    part->addRead();
     return part->engine()->rangeWithPrefix(start, prefix, iter);
 }
 
@@ -710,6 +717,19 @@ void NebulaStore::asyncMultiPut(GraphSpaceID spaceId,
     part->asyncMultiPut(std::move(keyValues), std::move(cb));
 }
 
+void NebulaStore::asyncMultiMerge(GraphSpaceID spaceId,
+                                  PartitionID partId,
+                                  std::vector<KV>&& keyValues,
+                                  KVCallback cb) {
+    auto ret = part(spaceId, partId);
+    if (!ok(ret)) {
+        cb(error(ret));
+        return;
+    }
+    auto part = nebula::value(ret);
+    part->asyncMultiMerge(std::move(keyValues), std::move(cb));
+}
+
 
 void NebulaStore::asyncRemove(GraphSpaceID spaceId,
                               PartitionID partId,
@@ -809,6 +829,9 @@ ResultCode NebulaStore::ingest(GraphSpaceID spaceId) {
                     return code;
                 }
             }
+            if (options_.commitListener_ != nullptr && !files.empty()) {
+                options_.commitListener_->onReset(spaceId, part);
+            }
         }
     }
     return ResultCode::SUCCEEDED;
@@ -1116,6 +1139,11 @@ ResultCode NebulaStore::restoreFromFiles(GraphSpaceID spaceId,
         if (ret != ResultCode::SUCCEEDED) {
             return ret;
         }
+        if (options_.commitListener_ != nullptr) {
+            for (auto part : engine->allParts()) {
+                options_.commitListener_->onReset(spaceId, part);
+            }
+        }
     }
 
     return ResultCode::SUCCEEDED;
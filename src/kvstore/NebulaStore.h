@@ -181,6 +181,11 @@ public:
                        std::vector<KV>&& keyValues,
                        KVCallback cb) override;
 
+    void asyncMultiMerge(GraphSpaceID spaceId,
+                         PartitionID partId,
+                         std::vector<KV>&& keyValues,
+                         KVCallback cb) override;
+
     void asyncRemove(GraphSpaceID spaceId,
                      PartitionID partId,
                      const std::string& key,
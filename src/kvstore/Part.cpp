@@ -5,9 +5,11 @@
  */
 
 #include "kvstore/Part.h"
+#include "common/fs/FileUtils.h"
 #include "kvstore/LogEncoder.h"
 #include "kvstore/RocksEngineConfig.h"
 #include "utils/NebulaKeyUtils.h"
+#include <fstream>
 
 DEFINE_int32(cluster_id, 0, "A unique id for each cluster");
 
@@ -88,6 +90,16 @@ void Part::asyncMultiPut(const std::vector<KV>& keyValues, KVCallback cb) {
 }
 
 
+void Part::asyncMultiMerge(const std::vector<KV>& keyValues, KVCallback cb) {
+    std::string log = encodeMultiValues(OP_MULTI_MERGE, keyValues);
+
+    appendAsync(FLAGS_cluster_id, std::move(log))
+        .thenValue([this, callback = std::move(cb)] (AppendLogResult res) mutable {
+            callback(this->toResultCode(res));
+        });
+}
+
+
 void Part::asyncRemove(folly::StringPiece key, KVCallback cb) {
     std::string log = encodeSingleValue(OP_REMOVE, key);
 
@@ -198,6 +210,15 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
     auto batch = engine_->startBatchWrite();
     LogID lastId = -1;
     TermID lastTerm = -1;
+    int64_t bytes = 0;
+    // The keys written and whether a range is removed, only collected for the listener
+    std::vector<std::string> keys;
+    bool rangeRemoved = false;
+    auto written = [&keys, this] (folly::StringPiece key) {
+        if (commitListener_ != nullptr) {
+            keys.emplace_back(key.str());
+        }
+    };
     while (iter->valid()) {
         lastId = iter->logId();
         lastTerm = iter->logTerm();
@@ -208,6 +229,7 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
             continue;
         }
         DCHECK_GE(log.size(), sizeof(int64_t) + 1 + sizeof(uint32_t));
+        bytes += log.size();
         // Skip the timestamp (type of int64_t)
         switch (log[sizeof(int64_t)]) {
         case OP_PUT: {
@@ -217,6 +239,7 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
                 LOG(ERROR) << idStr_ << "Failed to call WriteBatch::put()";
                 return false;
             }
+            written(pieces[0]);
             break;
         }
         case OP_MULTI_PUT: {
@@ -228,6 +251,19 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
                     LOG(ERROR) << idStr_ << "Failed to call WriteBatch::put()";
                     return false;
                 }
+                written(kvs[i]);
+            }
+            break;
+        }
+        case OP_MULTI_MERGE: {
+            auto kvs = decodeMultiValues(log);
+            DCHECK_EQ((kvs.size() + 1) / 2, kvs.size() / 2);
+            for (size_t i = 0; i < kvs.size(); i += 2) {
+                if (batch->merge(kvs[i], kvs[i + 1]) != ResultCode::SUCCEEDED) {
+                    LOG(ERROR) << idStr_ << "Failed to call WriteBatch::merge()";
+                    return false;
+                }
+                written(kvs[i]);
             }
             break;
         }
@@ -237,6 +273,7 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
                 LOG(ERROR) << idStr_ << "Failed to call WriteBatch::remove()";
                 return false;
             }
+            written(key);
             break;
         }
         case OP_MULTI_REMOVE: {
@@ -246,6 +283,7 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
                     LOG(ERROR) << idStr_ << "Failed to call WriteBatch::remove()";
                     return false;
                 }
+                written(k);
             }
             break;
         }
@@ -256,6 +294,7 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
                 LOG(ERROR) << idStr_ << "Failed to call WriteBatch::removeRange()";
                 return false;
             }
+            rangeRemoved = true;
             break;
         }
         case OP_BATCH_WRITE: {
@@ -264,10 +303,13 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
                 ResultCode code = ResultCode::SUCCEEDED;
                 if (op.first == BatchLogType::OP_BATCH_PUT) {
                     code = batch->put(op.second.first, op.second.second);
+                    written(op.second.first);
                 } else if (op.first == BatchLogType::OP_BATCH_REMOVE) {
                     code = batch->remove(op.second.first);
+                    written(op.second.first);
                 } else if (op.first == BatchLogType::OP_BATCH_REMOVE_RANGE) {
                     code = batch->removeRange(op.second.first, op.second.second);
+                    rangeRemoved = true;
                 }
                 if (code != ResultCode::SUCCEEDED) {
                     LOG(ERROR) << idStr_ << "Failed to call WriteBatch";
@@ -318,9 +360,20 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
             return false;
         }
     }
-    return engine_->commitBatchWrite(std::move(batch),
-                                     FLAGS_rocksdb_disable_wal,
-                                     FLAGS_rocksdb_wal_sync) == ResultCode::SUCCEEDED;
+    writtenBytes_.fetch_add(bytes, std::memory_order_relaxed);
+    if (engine_->commitBatchWrite(std::move(batch),
+                                  FLAGS_rocksdb_disable_wal,
+                                  FLAGS_rocksdb_wal_sync) != ResultCode::SUCCEEDED) {
+        return false;
+    }
+    if (commitListener_ != nullptr) {
+        if (rangeRemoved) {
+            commitListener_->onReset(spaceId_, partId_);
+        } else if (!keys.empty()) {
+            commitListener_->onCommitted(spaceId_, partId_, keys);
+        }
+    }
+    return true;
 }
 
 std::pair<int64_t, int64_t> Part::commitSnapshot(const std::vector<std::string>& rows,
@@ -333,6 +386,12 @@ std::pair<int64_t, int64_t> Part::commitSnapshot(const std::vector<std::string>&
     for (auto& row : rows) {
         count++;
         size += row.size();
+        if (isSstChunk(row)) {
+            if (!commitSstChunk(row)) {
+                return std::make_pair(0, 0);
+            }
+            continue;
+        }
         auto kv = decodeKV(row);
         if (ResultCode::SUCCEEDED != batch->put(kv.first, kv.second)) {
             LOG(ERROR) << idStr_ << "Put failed in commit";
@@ -350,9 +409,50 @@ std::pair<int64_t, int64_t> Part::commitSnapshot(const std::vector<std::string>&
         LOG(ERROR) << idStr_ << "Put failed in commit";
         return std::make_pair(0, 0);
     }
+    if (commitListener_ != nullptr) {
+        commitListener_->onReset(spaceId_, partId_);
+    }
     return std::make_pair(count, size);
 }
 
+bool Part::commitSstChunk(const std::string& row) {
+    auto chunk = decodeSstChunk(row);
+    std::ios_base::openmode mode = std::ios::binary | std::ios::app;
+    if (chunk.fileIndex != snapshotFileIndex_) {
+        // The first chunk of a new file
+        auto dir = folly::stringPrintf("%s/snapshot", engine_->getDataRoot());
+        if (!fs::FileUtils::makeDir(dir)) {
+            LOG(ERROR) << idStr_ << "Failed to create dir " << dir;
+            return false;
+        }
+        snapshotFileIndex_ = chunk.fileIndex;
+        snapshotFilePath_ = folly::stringPrintf("%s/%d.%d.sst",
+                                                dir.c_str(), partId_, chunk.fileIndex);
+        mode = std::ios::binary | std::ios::trunc;
+    }
+    {
+        std::ofstream ofs(snapshotFilePath_, mode);
+        ofs.write(chunk.data.data(), chunk.data.size());
+        if (!ofs.good()) {
+            LOG(ERROR) << idStr_ << "Failed to write snapshot file " << snapshotFilePath_;
+            return false;
+        }
+    }
+    if (!chunk.last) {
+        return true;
+    }
+
+    auto code = engine_->ingest({snapshotFilePath_});
+    fs::FileUtils::remove(snapshotFilePath_.c_str());
+    snapshotFileIndex_ = -1;
+    if (code != ResultCode::SUCCEEDED) {
+        LOG(ERROR) << idStr_ << "Failed to ingest snapshot file " << snapshotFilePath_;
+        return false;
+    }
+    LOG(INFO) << idStr_ << "Ingest snapshot file " << snapshotFilePath_;
+    return true;
+}
+
 ResultCode Part::putCommitMsg(WriteBatch* batch, LogID committedLogId, TermID committedLogTerm) {
     std::string commitMsg;
     commitMsg.reserve(sizeof(LogID) + sizeof(TermID));
@@ -45,6 +45,8 @@ public:
     void asyncPut(folly::StringPiece key, folly::StringPiece value, KVCallback cb);
     void asyncMultiPut(const std::vector<KV>& keyValues, KVCallback cb);
 
+    void asyncMultiMerge(const std::vector<KV>& keyValues, KVCallback cb);
+
     void asyncRemove(folly::StringPiece key, KVCallback cb);
     void asyncMultiRemove(const std::vector<std::string>& keys, KVCallback cb);
     void asyncRemoveRange(folly::StringPiece start,
@@ -76,6 +78,25 @@ public:
         newLeaderCb_ = nullptr;
     }
 
+    // Must be set before the part is started
+    void setCommitListener(std::shared_ptr<CommitListener> listener) {
+        commitListener_ = std::move(listener);
+    }
+
+    // Count a read served by the part, which is reported as the load of the part
+    void addRead() {
+        reads_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    int64_t reads() const {
+        return reads_.load(std::memory_order_relaxed);
+    }
+
+    // The bytes of the logs committed into the engine
+    int64_t writtenBytes() const {
+        return writtenBytes_.load(std::memory_order_relaxed);
+    }
+
     // clean up all data about this part.
     void reset() {
         LOG(INFO) << idStr_ << "Clean up all wals";
@@ -113,8 +134,12 @@ private:
 
     ResultCode putCommitMsg(WriteBatch* batch, LogID committedLogId, TermID committedLogTerm);
 
+    // Append a sst chunk of snapshot to local file, the file is ingested on its last chunk
+    bool commitSstChunk(const std::string& row);
+
     void cleanup() override {
         LOG(INFO) << idStr_ << "Clean up all data, just reset the committedLogId!";
+        snapshotFileIndex_ = -1;
         auto batch = engine_->startBatchWrite();
         if (ResultCode::SUCCEEDED != putCommitMsg(batch.get(), 0, 0)) {
             LOG(ERROR) << idStr_ << "Put failed in commit";
@@ -124,6 +149,9 @@ private:
             LOG(ERROR) << idStr_ << "Put failed in commit";
             return;
         }
+        if (commitListener_ != nullptr) {
+            commitListener_->onReset(spaceId_, partId_);
+        }
         return;
     }
 
@@ -135,9 +163,15 @@ protected:
     PartitionID partId_;
     std::string walPath_;
     NewLeaderCallback newLeaderCb_ = nullptr;
+    std::shared_ptr<CommitListener> commitListener_ = nullptr;
 
 private:
     KVEngine* engine_ = nullptr;
+    // The sst file of snapshot being received, only accessed under raftLock_
+    int32_t snapshotFileIndex_{-1};
+    std::string snapshotFilePath_;
+    std::atomic<int64_t> reads_{0};
+    std::atomic<int64_t> writtenBytes_{0};
 };
 
 }  // namespace kvstore
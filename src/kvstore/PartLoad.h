@@ -0,0 +1,86 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef KVSTORE_PARTLOAD_H_
+#define KVSTORE_PARTLOAD_H_
+
+#include "common/base/Base.h"
+#include "common/thrift/ThriftTypes.h"
+
+namespace nebula {
+namespace kvstore {
+
+/**
+ * The size and load of a part, reported by the leader of the part.
+ *
+ * storaged saves them through the custom kv interface of the meta service under segment(),
+ * and the balancer reads them back to weigh the parts.
+ * */
+struct PartLoad {
+    // Estimated bytes of the part in the engine
+    int64_t     bytes_{0};
+    // Reads per second served by the leader
+    double      readQps_{0};
+    // Bytes per second committed into the part
+    double      writeRate_{0};
+    // When the load is measured, in seconds
+    int64_t     reportTime_{0};
+
+    static std::string segment() {
+        return "partload";
+    }
+
+    static std::string key(GraphSpaceID spaceId, PartitionID partId) {
+        std::string key;
+        key.reserve(sizeof(GraphSpaceID) + sizeof(PartitionID));
+        key.append(reinterpret_cast<const char*>(&spaceId), sizeof(GraphSpaceID))
+           .append(reinterpret_cast<const char*>(&partId), sizeof(PartitionID));
+        return key;
+    }
+
+    static std::string prefix(GraphSpaceID spaceId) {
+        return std::string(reinterpret_cast<const char*>(&spaceId), sizeof(GraphSpaceID));
+    }
+
+    static PartitionID parsePartId(folly::StringPiece key) {
+        PartitionID partId;
+        memcpy(&partId, key.data() + key.size() - sizeof(PartitionID), sizeof(PartitionID));
+        return partId;
+    }
+
+    std::string encode() const {
+        std::string val;
+        val.reserve(kEncodedSize);
+        val.append(reinterpret_cast<const char*>(&bytes_), sizeof(int64_t))
+           .append(reinterpret_cast<const char*>(&readQps_), sizeof(double))
+           .append(reinterpret_cast<const char*>(&writeRate_), sizeof(double))
+           .append(reinterpret_cast<const char*>(&reportTime_), sizeof(int64_t));
+        return val;
+    }
+
+    static folly::Optional<PartLoad> decode(folly::StringPiece val) {
+        if (val.size() != kEncodedSize) {
+            return folly::none;
+        }
+        PartLoad load;
+        auto* ptr = val.data();
+        memcpy(&load.bytes_, ptr, sizeof(int64_t));
+        ptr += sizeof(int64_t);
+        memcpy(&load.readQps_, ptr, sizeof(double));
+        ptr += sizeof(double);
+        memcpy(&load.writeRate_, ptr, sizeof(double));
+        ptr += sizeof(double);
+        memcpy(&load.reportTime_, ptr, sizeof(int64_t));
+        return load;
+    }
+
+private:
+    static constexpr size_t kEncodedSize = 2 * sizeof(int64_t) + 2 * sizeof(double);
+};
+
+}  // namespace kvstore
+}  // namespace nebula
+#endif  // KVSTORE_PARTLOAD_H_
@@ -5,8 +5,10 @@
  */
 
 #include "kvstore/RocksEngine.h"
+#include <folly/ScopeGuard.h>
 #include <folly/String.h>
 #include <rocksdb/convenience.h>
+#include <rocksdb/sst_file_reader.h>
 #include "common/base/Base.h"
 #include "common/fs/FileUtils.h"
 #include "kvstore/KVStore.h"
@@ -32,14 +34,17 @@ namespace {
 class RocksWriteBatch : public WriteBatch {
 private:
     rocksdb::WriteBatch batch_;
+    const RocksEngine*  engine_;
 
 public:
-    RocksWriteBatch() : batch_(FLAGS_rocksdb_batch_size) {}
+    explicit RocksWriteBatch(const RocksEngine* engine)
+        : batch_(FLAGS_rocksdb_batch_size)
+        , engine_(engine) {}
 
     virtual ~RocksWriteBatch() = default;
 
     ResultCode put(folly::StringPiece key, folly::StringPiece value) override {
-        if (batch_.Put(toSlice(key), toSlice(value)).ok()) {
+        if (batch_.Put(engine_->columnFamily(key), toSlice(key), toSlice(value)).ok()) {
             return ResultCode::SUCCEEDED;
         } else {
             return ResultCode::ERR_UNKNOWN;
@@ -47,27 +52,44 @@ public:
     }
 
     ResultCode remove(folly::StringPiece key) override {
-        if (batch_.Delete(toSlice(key)).ok()) {
+        if (batch_.Delete(engine_->columnFamily(key), toSlice(key)).ok()) {
             return ResultCode::SUCCEEDED;
         } else {
             return ResultCode::ERR_UNKNOWN;
         }
     }
 
-    // Remove all keys in the range [start, end)
-    ResultCode removeRange(folly::StringPiece start, folly::StringPiece end) override {
-        if (batch_.DeleteRange(toSlice(start), toSlice(end)).ok()) {
+    ResultCode merge(folly::StringPiece key, folly::StringPiece operand) override {
+        if (batch_.Merge(engine_->columnFamily(key), toSlice(key), toSlice(operand)).ok()) {
             return ResultCode::SUCCEEDED;
         } else {
             return ResultCode::ERR_UNKNOWN;
         }
     }
 
+    // Remove all keys in the range [start, end)
+    ResultCode removeRange(folly::StringPiece start, folly::StringPiece end) override {
+        for (auto* cf : engine_->columnFamilies(start, end)) {
+            if (!batch_.DeleteRange(cf, toSlice(start), toSlice(end)).ok()) {
+                return ResultCode::ERR_UNKNOWN;
+            }
+        }
+        return ResultCode::SUCCEEDED;
+    }
+
     rocksdb::WriteBatch* data() {
         return &batch_;
     }
 };
 
+// The key types which have a column family of their own
+constexpr NebulaKeyType kKeyTypes[] = {NebulaKeyType::kVertex,
+                                       NebulaKeyType::kEdge,
+                                       NebulaKeyType::kIndex,
+                                       NebulaKeyType::kSystem,
+                                       NebulaKeyType::kOperation,
+                                       NebulaKeyType::kKeyValue};
+
 }   // Anonymous namespace
 
 /***************************************
@@ -107,16 +129,112 @@ RocksEngine::RocksEngine(GraphSpaceID spaceId,
     if (cfFactory != nullptr) {
         options.compaction_filter_factory = cfFactory;
     }
+    prefixExtractor_ = options.prefix_extractor;
+
+    // An existing db keeps its layout, whatever the flag is
+    cfPerKeyType_ = FLAGS_rocksdb_column_family_per_key_type;
+    std::vector<std::string> cfNames;
+    if (rocksdb::DB::ListColumnFamilies(options, path, &cfNames).ok()) {
+        bool hasKeyTypeCf = std::find(cfNames.begin(), cfNames.end(),
+                                      keyTypeName(NebulaKeyType::kVertex)) != cfNames.end();
+        if (hasKeyTypeCf != cfPerKeyType_) {
+            LOG(WARNING) << "Space " << spaceId << " was created with "
+                         << "rocksdb_column_family_per_key_type=" << hasKeyTypeCf
+                         << ", keep using it";
+        }
+        cfPerKeyType_ = hasKeyTypeCf;
+    }
 
-    if (readonly) {
-        status = rocksdb::DB::OpenForReadOnly(options, path, &db);
+    if (!cfPerKeyType_) {
+        if (readonly) {
+            status = rocksdb::DB::OpenForReadOnly(options, path, &db);
+        } else {
+            status = rocksdb::DB::Open(options, path, &db);
+        }
+        CHECK(status.ok()) << status.ToString();
+        db_.reset(db);
+        cfOfByte_.fill(db_->DefaultColumnFamily());
     } else {
-        status = rocksdb::DB::Open(options, path, &db);
+        std::vector<rocksdb::ColumnFamilyDescriptor> descriptors;
+        descriptors.emplace_back(rocksdb::kDefaultColumnFamilyName,
+                                 rocksdb::ColumnFamilyOptions(options));
+        for (auto type : kKeyTypes) {
+            rocksdb::ColumnFamilyOptions cfOpts;
+            status = initRocksdbCFOptions(cfOpts, options, type);
+            CHECK(status.ok()) << status.ToString();
+            descriptors.emplace_back(keyTypeName(type), cfOpts);
+        }
+        options.create_missing_column_families = true;
+        if (readonly) {
+            status = rocksdb::DB::OpenForReadOnly(options, path, descriptors, &cfHandles_, &db);
+        } else {
+            status = rocksdb::DB::Open(options, path, descriptors, &cfHandles_, &db);
+        }
+        CHECK(status.ok()) << status.ToString();
+        db_.reset(db);
+        cfOfByte_.fill(cfHandles_[0]);
+        for (size_t i = 0; i < sizeof(kKeyTypes) / sizeof(kKeyTypes[0]); i++) {
+            cfOfByte_[static_cast<uint8_t>(kKeyTypes[i])] = cfHandles_[i + 1];
+        }
     }
-    CHECK(status.ok()) << status.ToString();
-    db_.reset(db);
     partsNum_ = allParts().size();
-    LOG(INFO) << "open rocksdb on " << path;
+    LOG(INFO) << "open rocksdb on " << path
+              << (cfPerKeyType_ ? " with a column family per key type" : "");
+}
+
+RocksEngine::~RocksEngine() {
+    if (db_) {
+        for (auto* handle : cfHandles_) {
+            db_->DestroyColumnFamilyHandle(handle);
+        }
+    }
+    LOG(INFO) << "Release rocksdb on " << dataPath_;
+}
+
+std::vector<rocksdb::ColumnFamilyHandle*>
+RocksEngine::columnFamilies(folly::StringPiece start, folly::StringPiece end) const {
+    if (!cfPerKeyType_) {
+        return {db_->DefaultColumnFamily()};
+    }
+    if (!start.empty() && !end.empty() && start[0] == end[0]) {
+        return {columnFamily(start)};
+    }
+    uint32_t first = start.empty() ? 0 : static_cast<uint8_t>(start[0]);
+    uint32_t last = end.empty() ? 255 : static_cast<uint8_t>(end[0]);
+    std::vector<rocksdb::ColumnFamilyHandle*> cfs;
+    for (auto b = first; b <= last; b++) {
+        if (std::find(cfs.begin(), cfs.end(), cfOfByte_[b]) == cfs.end()) {
+            cfs.emplace_back(cfOfByte_[b]);
+        }
+    }
+    return cfs;
+}
+
+std::unique_ptr<KVIterator> RocksEngine::concatIter(folly::StringPiece start,
+                                                    folly::StringPiece end) {
+    rocksdb::ReadOptions options;
+    options.total_order_seek = true;
+    uint32_t first = start.empty() ? 0 : static_cast<uint8_t>(start[0]);
+    uint32_t last = end.empty() ? 255 : static_cast<uint8_t>(end[0]);
+    std::vector<RocksConcatIter::Segment> segments;
+    for (auto b = first; b <= last;) {
+        // the consecutive first bytes in the same column family are one segment
+        auto e = b;
+        while (e < last && cfOfByte_[e + 1] == cfOfByte_[b]) {
+            e++;
+        }
+        RocksConcatIter::Segment seg;
+        seg.iter_.reset(db_->NewIterator(options, cfOfByte_[b]));
+        seg.lower_ = b == first ? start.str() : std::string(1, static_cast<char>(b));
+        if (e == last) {
+            seg.upper_ = end.str();
+        } else {
+            seg.upper_ = std::string(1, static_cast<char>(e + 1));
+        }
+        segments.emplace_back(std::move(seg));
+        b = e + 1;
+    }
+    return std::make_unique<RocksConcatIter>(std::move(segments), start);
 }
 
 void RocksEngine::stop() {
@@ -128,7 +246,7 @@ void RocksEngine::stop() {
 }
 
 std::unique_ptr<WriteBatch> RocksEngine::startBatchWrite() {
-    return std::make_unique<RocksWriteBatch>();
+    return std::make_unique<RocksWriteBatch>(this);
 }
 
 ResultCode RocksEngine::commitBatchWrite(std::unique_ptr<WriteBatch> batch,
@@ -148,7 +266,7 @@ ResultCode RocksEngine::commitBatchWrite(std::unique_ptr<WriteBatch> batch,
 
 ResultCode RocksEngine::get(const std::string& key, std::string* value) {
     rocksdb::ReadOptions options;
-    rocksdb::Status status = db_->Get(options, rocksdb::Slice(key), value);
+    rocksdb::Status status = db_->Get(options, columnFamily(key), rocksdb::Slice(key), value);
     if (status.ok()) {
         return ResultCode::SUCCEEDED;
     } else if (status.IsNotFound()) {
@@ -164,11 +282,13 @@ std::vector<Status> RocksEngine::multiGet(const std::vector<std::string>& keys,
                                           std::vector<std::string>* values) {
     rocksdb::ReadOptions options;
     std::vector<rocksdb::Slice> slices;
+    std::vector<rocksdb::ColumnFamilyHandle*> cfs;
     for (size_t index = 0; index < keys.size(); index++) {
         slices.emplace_back(keys[index]);
+        cfs.emplace_back(columnFamily(keys[index]));
     }
 
-    auto status = db_->MultiGet(options, slices, values);
+    auto status = db_->MultiGet(options, cfs, slices, values);
     std::vector<Status> ret;
     std::transform(status.begin(), status.end(), std::back_inserter(ret), [](const auto& s) {
         if (s.ok()) {
@@ -185,9 +305,13 @@ std::vector<Status> RocksEngine::multiGet(const std::vector<std::string>& keys,
 ResultCode RocksEngine::range(const std::string& start,
                               const std::string& end,
                               std::unique_ptr<KVIterator>* storageIter) {
+    if (cfPerKeyType_ && !end.empty() && (start.empty() || start[0] != end[0])) {
+        *storageIter = concatIter(start, end);
+        return ResultCode::SUCCEEDED;
+    }
     rocksdb::ReadOptions options;
     options.total_order_seek = true;
-    rocksdb::Iterator* iter = db_->NewIterator(options);
+    rocksdb::Iterator* iter = db_->NewIterator(options, columnFamily(start));
     if (iter) {
         iter->Seek(rocksdb::Slice(start));
     }
@@ -197,9 +321,13 @@ ResultCode RocksEngine::range(const std::string& start,
 
 ResultCode RocksEngine::prefix(const std::string& prefix,
                                std::unique_ptr<KVIterator>* storageIter) {
+    if (cfPerKeyType_ && prefix.empty()) {
+        *storageIter = concatIter("", "");
+        return ResultCode::SUCCEEDED;
+    }
     rocksdb::ReadOptions options;
-    options.prefix_same_as_start = true;
-    rocksdb::Iterator* iter = db_->NewIterator(options);
+    setPrefixSeek(options, prefix);
+    rocksdb::Iterator* iter = db_->NewIterator(options, columnFamily(prefix));
     if (iter) {
         iter->Seek(rocksdb::Slice(prefix));
     }
@@ -210,9 +338,13 @@ ResultCode RocksEngine::prefix(const std::string& prefix,
 ResultCode RocksEngine::rangeWithPrefix(const std::string& start,
                                         const std::string& prefix,
                                         std::unique_ptr<KVIterator>* storageIter) {
+    if (cfPerKeyType_ && prefix.empty()) {
+        *storageIter = concatIter(start, "");
+        return ResultCode::SUCCEEDED;
+    }
     rocksdb::ReadOptions options;
-    options.prefix_same_as_start = true;
-    rocksdb::Iterator* iter = db_->NewIterator(options);
+    setPrefixSeek(options, prefix);
+    rocksdb::Iterator* iter = db_->NewIterator(options, columnFamily(prefix));
     if (iter) {
         iter->Seek(rocksdb::Slice(start));
     }
@@ -223,7 +355,7 @@ ResultCode RocksEngine::rangeWithPrefix(const std::string& start,
 ResultCode RocksEngine::put(std::string key, std::string value) {
     rocksdb::WriteOptions options;
     options.disableWAL = FLAGS_rocksdb_disable_wal;
-    rocksdb::Status status = db_->Put(options, key, value);
+    rocksdb::Status status = db_->Put(options, columnFamily(key), key, value);
     if (status.ok()) {
         return ResultCode::SUCCEEDED;
     } else {
@@ -235,7 +367,7 @@ ResultCode RocksEngine::put(std::string key, std::string value) {
 ResultCode RocksEngine::multiPut(std::vector<KV> keyValues) {
     rocksdb::WriteBatch updates(FLAGS_rocksdb_batch_size);
     for (size_t i = 0; i < keyValues.size(); i++) {
-        updates.Put(keyValues[i].first, keyValues[i].second);
+        updates.Put(columnFamily(keyValues[i].first), keyValues[i].first, keyValues[i].second);
     }
     rocksdb::WriteOptions options;
     options.disableWAL = FLAGS_rocksdb_disable_wal;
@@ -251,7 +383,7 @@ ResultCode RocksEngine::multiPut(std::vector<KV> keyValues) {
 ResultCode RocksEngine::remove(const std::string& key) {
     rocksdb::WriteOptions options;
     options.disableWAL = FLAGS_rocksdb_disable_wal;
-    auto status = db_->Delete(options, key);
+    auto status = db_->Delete(options, columnFamily(key), key);
     if (status.ok()) {
         return ResultCode::SUCCEEDED;
     } else {
@@ -263,7 +395,7 @@ ResultCode RocksEngine::remove(const std::string& key) {
 ResultCode RocksEngine::multiRemove(std::vector<std::string> keys) {
     rocksdb::WriteBatch deletes(FLAGS_rocksdb_batch_size);
     for (size_t i = 0; i < keys.size(); i++) {
-        deletes.Delete(keys[i]);
+        deletes.Delete(columnFamily(keys[i]), keys[i]);
     }
     rocksdb::WriteOptions options;
     options.disableWAL = FLAGS_rocksdb_disable_wal;
@@ -279,13 +411,14 @@ ResultCode RocksEngine::multiRemove(std::vector<std::string> keys) {
 ResultCode RocksEngine::removeRange(const std::string& start, const std::string& end) {
     rocksdb::WriteOptions options;
     options.disableWAL = FLAGS_rocksdb_disable_wal;
-    auto status = db_->DeleteRange(options, db_->DefaultColumnFamily(), start, end);
-    if (status.ok()) {
-        return ResultCode::SUCCEEDED;
-    } else {
-        VLOG(3) << "RemoveRange Failed: " << status.ToString();
-        return ResultCode::ERR_UNKNOWN;
+    for (auto* cf : columnFamilies(start, end)) {
+        auto status = db_->DeleteRange(options, cf, start, end);
+        if (!status.ok()) {
+            VLOG(3) << "RemoveRange Failed: " << status.ToString();
+            return ResultCode::ERR_UNKNOWN;
+        }
     }
+    return ResultCode::SUCCEEDED;
 }
 
 std::string RocksEngine::partKey(PartitionID partId) {
@@ -303,7 +436,8 @@ void RocksEngine::addPart(PartitionID partId) {
 void RocksEngine::removePart(PartitionID partId) {
     rocksdb::WriteOptions options;
     options.disableWAL = FLAGS_rocksdb_disable_wal;
-    auto status = db_->Delete(options, partKey(partId));
+    auto key = partKey(partId);
+    auto status = db_->Delete(options, columnFamily(key), key);
     if (status.ok()) {
         partsNum_--;
         CHECK_GE(partsNum_, 0);
@@ -340,7 +474,41 @@ int32_t RocksEngine::totalPartsNum() {
 ResultCode RocksEngine::ingest(const std::vector<std::string>& files) {
     rocksdb::IngestExternalFileOptions options;
     options.move_files = FLAGS_move_files;
-    rocksdb::Status status = db_->IngestExternalFile(files, options);
+    if (!cfPerKeyType_) {
+        rocksdb::Status status = db_->IngestExternalFile(files, options);
+        if (status.ok()) {
+            return ResultCode::SUCCEEDED;
+        } else {
+            LOG(ERROR) << "Ingest Failed: " << status.ToString();
+            return ResultCode::ERR_UNKNOWN;
+        }
+    }
+
+    std::map<rocksdb::ColumnFamilyHandle*, std::vector<std::string>> filesOfCf;
+    std::vector<std::string> tmpFiles;
+    SCOPE_EXIT {
+        for (const auto& file : tmpFiles) {
+            if (FileUtils::exist(file)) {
+                FileUtils::remove(file.c_str());
+            }
+        }
+    };
+    auto ret = splitIngestFiles(files, filesOfCf, tmpFiles);
+    if (ret != ResultCode::SUCCEEDED) {
+        return ret;
+    }
+    if (filesOfCf.empty()) {
+        return ResultCode::SUCCEEDED;
+    }
+    std::vector<rocksdb::IngestExternalFileArg> args;
+    for (auto& entry : filesOfCf) {
+        rocksdb::IngestExternalFileArg arg;
+        arg.column_family = entry.first;
+        arg.external_files = std::move(entry.second);
+        arg.options = options;
+        args.emplace_back(std::move(arg));
+    }
+    rocksdb::Status status = db_->IngestExternalFiles(args);
     if (status.ok()) {
         return ResultCode::SUCCEEDED;
     } else {
@@ -349,10 +517,79 @@ ResultCode RocksEngine::ingest(const std::vector<std::string>& files) {
     }
 }
 
+ResultCode RocksEngine::splitIngestFiles(
+        const std::vector<std::string>& files,
+        std::map<rocksdb::ColumnFamilyHandle*, std::vector<std::string>>& filesOfCf,
+        std::vector<std::string>& tmpFiles) {
+    rocksdb::Options options;
+    for (const auto& file : files) {
+        rocksdb::SstFileReader reader(options);
+        auto status = reader.Open(file);
+        if (!status.ok()) {
+            LOG(ERROR) << "Open " << file << " failed: " << status.ToString();
+            return ResultCode::ERR_IO_ERROR;
+        }
+        std::unique_ptr<rocksdb::Iterator> iter(reader.NewIterator(rocksdb::ReadOptions()));
+        iter->SeekToFirst();
+        if (!iter->Valid()) {
+            continue;
+        }
+        auto firstKey = iter->key().ToString();
+        iter->SeekToLast();
+        if (firstKey[0] == iter->key()[0]) {
+            // All keys are of the same type, which is the common case
+            filesOfCf[columnFamily(firstKey)].emplace_back(file);
+            continue;
+        }
+
+        VLOG(1) << "Split " << file << " into the column families of its keys";
+        std::unordered_map<rocksdb::ColumnFamilyHandle*,
+                           std::unique_ptr<rocksdb::SstFileWriter>> writers;
+        for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+            auto* cf = columnFamily(folly::StringPiece(iter->key().data(), iter->key().size()));
+            auto& writer = writers[cf];
+            if (writer == nullptr) {
+                auto path = folly::stringPrintf("%s.%s", file.c_str(), cf->GetName().c_str());
+                writer = std::make_unique<rocksdb::SstFileWriter>(rocksdb::EnvOptions(), options);
+                status = writer->Open(path);
+                if (!status.ok()) {
+                    LOG(ERROR) << "Open " << path << " failed: " << status.ToString();
+                    return ResultCode::ERR_IO_ERROR;
+                }
+                tmpFiles.emplace_back(path);
+                filesOfCf[cf].emplace_back(std::move(path));
+            }
+            status = writer->Put(iter->key(), iter->value());
+            if (!status.ok()) {
+                LOG(ERROR) << "Split " << file << " failed: " << status.ToString();
+                return ResultCode::ERR_IO_ERROR;
+            }
+        }
+        for (auto& entry : writers) {
+            status = entry.second->Finish();
+            if (!status.ok()) {
+                LOG(ERROR) << "Split " << file << " failed: " << status.ToString();
+                return ResultCode::ERR_IO_ERROR;
+            }
+        }
+    }
+    return ResultCode::SUCCEEDED;
+}
+
 ResultCode RocksEngine::setOption(const std::string& configKey, const std::string& configValue) {
     std::unordered_map<std::string, std::string> configOptions = {{configKey, configValue}};
 
-    rocksdb::Status status = db_->SetOptions(configOptions);
+    rocksdb::Status status;
+    if (cfHandles_.empty()) {
+        status = db_->SetOptions(configOptions);
+    } else {
+        for (auto* handle : cfHandles_) {
+            status = db_->SetOptions(handle, configOptions);
+            if (!status.ok()) {
+                break;
+            }
+        }
+    }
     if (status.ok()) {
         LOG(INFO) << "SetOption Succeeded: " << configKey << ":" << configValue;
         return ResultCode::SUCCEEDED;
@@ -375,11 +612,73 @@ ResultCode RocksEngine::setDBOption(const std::string& configKey, const std::str
     }
 }
 
+// The smallest key of each sst file overlapping the range is a candidate, the size of the files
+// before it is the size of the keys before it.
+std::vector<std::string> RocksEngine::splitRange(const std::string& start,
+                                                 const std::string& end,
+                                                 int32_t count) {
+    std::vector<std::string> keys;
+    if (count <= 1) {
+        return keys;
+    }
+
+    std::vector<rocksdb::LiveFileMetaData> files;
+    db_->GetLiveFilesMetaData(&files);
+    std::vector<std::pair<std::string, uint64_t>> candidates;
+    uint64_t total = 0;
+    for (const auto& file : files) {
+        if (file.largestkey < start || file.smallestkey >= end) {
+            continue;
+        }
+        total += file.size;
+        candidates.emplace_back(std::max(file.smallestkey, start), file.size);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    uint64_t step = total / count;
+    uint64_t before = 0;
+    for (const auto& candidate : candidates) {
+        if (static_cast<int32_t>(keys.size()) + 1 >= count) {
+            break;
+        }
+        if (before >= step * (keys.size() + 1) &&
+            candidate.first > start &&
+            (keys.empty() || candidate.first > keys.back())) {
+            keys.emplace_back(candidate.first);
+        }
+        before += candidate.second;
+    }
+    return keys;
+}
+
+int64_t RocksEngine::approximateSize(const std::string& start, const std::string& end) {
+    rocksdb::Range range(start, end);
+    auto flags = rocksdb::DB::SizeApproximationFlags::INCLUDE_FILES |
+                 rocksdb::DB::SizeApproximationFlags::INCLUDE_MEMTABLES;
+    int64_t total = 0;
+    for (auto* cf : columnFamilies(start, end)) {
+        uint64_t size = 0;
+        db_->GetApproximateSizes(cf, &range, 1, &size, flags);
+        total += size;
+    }
+    return total;
+}
+
 ResultCode RocksEngine::compact() {
     rocksdb::CompactRangeOptions options;
     options.change_level = FLAGS_rocksdb_compact_change_level;
     options.target_level = FLAGS_rocksdb_compact_target_level;
-    rocksdb::Status status = db_->CompactRange(options, nullptr, nullptr);
+    rocksdb::Status status;
+    if (cfHandles_.empty()) {
+        status = db_->CompactRange(options, nullptr, nullptr);
+    } else {
+        for (auto* handle : cfHandles_) {
+            status = db_->CompactRange(options, handle, nullptr, nullptr);
+            if (!status.ok()) {
+                break;
+            }
+        }
+    }
     if (status.ok()) {
         return ResultCode::SUCCEEDED;
     } else {
@@ -390,7 +689,8 @@ ResultCode RocksEngine::compact() {
 
 ResultCode RocksEngine::flush() {
     rocksdb::FlushOptions options;
-    rocksdb::Status status = db_->Flush(options);
+    rocksdb::Status status = cfHandles_.empty() ? db_->Flush(options)
+                                                : db_->Flush(options, cfHandles_);
     if (status.ok()) {
         return ResultCode::SUCCEEDED;
     } else {
@@ -9,6 +9,7 @@
 
 #include <gtest/gtest_prod.h>
 #include <rocksdb/db.h>
+#include <rocksdb/slice_transform.h>
 #include <rocksdb/utilities/checkpoint.h>
 #include "common/base/Base.h"
 #include "kvstore/KVEngine.h"
@@ -36,6 +37,10 @@ public:
         iter_->Prev();
     }
 
+    void seek(folly::StringPiece target) override {
+        iter_->Seek(rocksdb::Slice(target.data(), target.size()));
+    }
+
     folly::StringPiece key() const override {
         return folly::StringPiece(iter_->key().data(), iter_->key().size());
     }
@@ -69,6 +74,10 @@ public:
         iter_->Prev();
     }
 
+    void seek(folly::StringPiece target) override {
+        iter_->Seek(rocksdb::Slice(target.data(), target.size()));
+    }
+
     folly::StringPiece key() const override {
         return folly::StringPiece(iter_->key().data(), iter_->key().size());
     }
@@ -82,6 +91,113 @@ protected:
     rocksdb::Slice prefix_;
 };
 
+// Iterator over a range whose keys are in several column families. The range is split into
+// segments by the first byte of the keys, each segment is in one column family, and the
+// segments are visited in order.
+class RocksConcatIter : public KVIterator {
+public:
+    struct Segment {
+        std::unique_ptr<rocksdb::Iterator> iter_;
+        std::string                        lower_;
+        // empty means no upper bound
+        std::string                        upper_;
+    };
+
+    RocksConcatIter(std::vector<Segment> segments, folly::StringPiece start)
+        : segments_(std::move(segments)) {
+        seek(start);
+    }
+
+    bool valid() const override {
+        return cur_ < segments_.size() && segmentValid(cur_);
+    }
+
+    void next() override {
+        segments_[cur_].iter_->Next();
+        skipForward();
+    }
+
+    void prev() override {
+        if (cur_ == segments_.size()) {
+            if (segments_.empty()) {
+                return;
+            }
+            cur_ = segments_.size() - 1;
+            seekToLast(cur_);
+        } else {
+            segments_[cur_].iter_->Prev();
+        }
+        skipBackward();
+    }
+
+    void seek(folly::StringPiece target) override {
+        cur_ = 0;
+        while (cur_ < segments_.size() &&
+               !segments_[cur_].upper_.empty() &&
+               target >= folly::StringPiece(segments_[cur_].upper_)) {
+            ++cur_;
+        }
+        if (cur_ < segments_.size()) {
+            const auto& lower = segments_[cur_].lower_;
+            auto from = target < folly::StringPiece(lower) ? folly::StringPiece(lower) : target;
+            segments_[cur_].iter_->Seek(rocksdb::Slice(from.data(), from.size()));
+            skipForward();
+        }
+    }
+
+    folly::StringPiece key() const override {
+        auto key = segments_[cur_].iter_->key();
+        return folly::StringPiece(key.data(), key.size());
+    }
+
+    folly::StringPiece val() const override {
+        auto val = segments_[cur_].iter_->value();
+        return folly::StringPiece(val.data(), val.size());
+    }
+
+private:
+    bool segmentValid(size_t i) const {
+        const auto& seg = segments_[i];
+        if (!seg.iter_->Valid() || seg.iter_->key().compare(seg.lower_) < 0) {
+            return false;
+        }
+        return seg.upper_.empty() || seg.iter_->key().compare(seg.upper_) < 0;
+    }
+
+    void skipForward() {
+        while (cur_ < segments_.size() && !segmentValid(cur_)) {
+            if (++cur_ < segments_.size()) {
+                segments_[cur_].iter_->Seek(segments_[cur_].lower_);
+            }
+        }
+    }
+
+    void skipBackward() {
+        while (!segmentValid(cur_)) {
+            if (cur_ == 0) {
+                cur_ = segments_.size();
+                return;
+            }
+            seekToLast(--cur_);
+        }
+    }
+
+    void seekToLast(size_t i) {
+        auto& seg = segments_[i];
+        if (seg.upper_.empty()) {
+            seg.iter_->SeekToLast();
+        } else {
+            seg.iter_->SeekForPrev(seg.upper_);
+            if (seg.iter_->Valid() && seg.iter_->key().compare(seg.upper_) == 0) {
+                seg.iter_->Prev();
+            }
+        }
+    }
+
+    std::vector<Segment> segments_;
+    size_t               cur_{0};
+};
+
 /**************************************************************************
  *
  * An implementation of KVEngine based on Rocksdb
@@ -98,9 +214,7 @@ public:
                 std::shared_ptr<rocksdb::CompactionFilterFactory> cfFactory = nullptr,
                 bool readonly = false);
 
-    ~RocksEngine() {
-        LOG(INFO) << "Release rocksdb on " << dataPath_;
-    }
+    ~RocksEngine();
 
     void stop() override;
 
@@ -162,6 +276,12 @@ public:
 
     ResultCode setDBOption(const std::string& configKey, const std::string& configValue) override;
 
+    std::vector<std::string> splitRange(const std::string& start,
+                                        const std::string& end,
+                                        int32_t count) override;
+
+    int64_t approximateSize(const std::string& start, const std::string& end) override;
+
     ResultCode compact() override;
 
     ResultCode flush() override;
@@ -176,13 +296,64 @@ public:
         const std::string& tablePrefix,
         std::function<bool(const folly::StringPiece& key)> filter) override;
 
+    /*********************
+     * Column families
+     ********************/
+    // The column family of the key. When rocksdb_column_family_per_key_type is on, the keys
+    // of each NebulaKeyType are in a column family of their own, and the keys not of any type
+    // are in the default one. Otherwise all keys are in the default column family.
+    rocksdb::ColumnFamilyHandle* columnFamily(folly::StringPiece key) const {
+        if (key.empty()) {
+            return cfOfByte_[0];
+        }
+        return cfOfByte_[static_cast<uint8_t>(key[0])];
+    }
+
+    // All column families which may have keys in [start, end), an empty end means no bound
+    std::vector<rocksdb::ColumnFamilyHandle*> columnFamilies(folly::StringPiece start,
+                                                             folly::StringPiece end) const;
+
+    bool columnFamilyPerKeyType() const {
+        return cfPerKeyType_;
+    }
+
 private:
     std::string partKey(PartitionID partId);
 
+    // Prefix seek is only used when the prefix is in the domain of the prefix extractor,
+    // otherwise the scan would stop at the end of the first extracted prefix.
+    void setPrefixSeek(rocksdb::ReadOptions& options, folly::StringPiece prefix) const {
+        if (prefixExtractor_ != nullptr &&
+            prefixExtractor_->InDomain(rocksdb::Slice(prefix.data(), prefix.size()))) {
+            options.prefix_same_as_start = true;
+        } else {
+            options.total_order_seek = true;
+        }
+    }
+
+    // Iterator over [start, end) across column families, an empty end means no bound
+    std::unique_ptr<KVIterator> concatIter(folly::StringPiece start, folly::StringPiece end);
+
+    // Split the files whose keys are in more than one column family, the files of each column
+    // family are put into filesOfCf, and the new files are put into tmpFiles
+    ResultCode splitIngestFiles(
+        const std::vector<std::string>& files,
+        std::map<rocksdb::ColumnFamilyHandle*, std::vector<std::string>>& filesOfCf,
+        std::vector<std::string>& tmpFiles);
+
 private:
     std::string dataPath_;
     std::unique_ptr<rocksdb::DB> db_{nullptr};
     int32_t partsNum_ = -1;
+
+    // Used to tell whether a prefix is long enough for the prefix bloom filter
+    std::shared_ptr<const rocksdb::SliceTransform> prefixExtractor_;
+
+    bool                                        cfPerKeyType_{false};
+    // The handles of column families opened, including the default one
+    std::vector<rocksdb::ColumnFamilyHandle*>   cfHandles_;
+    // The column family of the keys beginning with each byte
+    std::array<rocksdb::ColumnFamilyHandle*, 256> cfOfByte_;
 };
 
 }   // namespace kvstore
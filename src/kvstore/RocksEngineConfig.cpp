@@ -17,6 +17,7 @@
 #include <rocksdb/concurrent_task_limiter.h>
 #include <rocksdb/rate_limiter.h>
 #include "utils/NebulaKeyUtils.h"
+#include <folly/json.h>
 
 // [WAL]
 DEFINE_bool(rocksdb_disable_wal,
@@ -77,7 +78,24 @@ DEFINE_bool(enable_rocksdb_prefix_filtering, false,
 DEFINE_bool(enable_rocksdb_whole_key_filtering, true,
             "Whether or not to enable the whole key filtering.");
 DEFINE_int32(rocksdb_filtering_prefix_length, 12,
-            "The prefix length, default value is 12 bytes(PartitionID+VertexID).");
+            "Deprecated, the prefix length is decided by the key type and the vid length.");
+
+DEFINE_bool(rocksdb_column_family_per_key_type, false,
+            "Whether to put the keys of each type (vertex, edge, index, system, operation, kv) "
+            "into a column family of its own when a space is created. The layout of an existing "
+            "space won't be changed");
+
+DEFINE_string(rocksdb_key_type_cf_options,
+              "{}",
+              "json string from key type to the json of its ColumnFamilyOptions, which override "
+              "rocksdb_column_family_options, e.g. {\"index\":{\"write_buffer_size\":\"8388608\"}}"
+              ". Only used when rocksdb_column_family_per_key_type is on");
+
+DEFINE_string(rocksdb_key_type_block_based_table_options,
+              "{}",
+              "json string from key type to the json of its BlockBasedTableOptions, which "
+              "override rocksdb_block_based_table_options, e.g. {\"edge\":{\"block_size\":"
+              "\"16384\"}}. Only used when rocksdb_column_family_per_key_type is on");
 
 DEFINE_bool(rocksdb_compact_change_level, true,
             "If true, compacted files will be moved to the minimum level capable "
@@ -91,25 +109,50 @@ DEFINE_int32(rocksdb_compact_target_level, -1,
 namespace nebula {
 namespace kvstore {
 
+// The prefix of a key depends on its type, which is the first byte of the key:
+//   vertex: part + vid
+//   edge:   part + src + edge type
+//   index:  part + index id
+// Keys of other types are not in the domain, so they are only filtered by the whole key.
 class GraphPrefixTransform : public rocksdb::SliceTransform {
 private:
-    size_t prefixLen_;
+    size_t vertexPrefixLen_;
+    size_t edgePrefixLen_;
+    size_t indexPrefixLen_;
     std::string name_;
 
+    size_t prefixLen(const rocksdb::Slice& src) const {
+        if (src.empty()) {
+            return 0;
+        }
+        switch (static_cast<NebulaKeyType>(static_cast<uint8_t>(src[0]))) {
+            case NebulaKeyType::kVertex:
+                return vertexPrefixLen_;
+            case NebulaKeyType::kEdge:
+                return edgePrefixLen_;
+            case NebulaKeyType::kIndex:
+                return indexPrefixLen_;
+            default:
+                return 0;
+        }
+    }
+
 public:
-    explicit GraphPrefixTransform(size_t prefixLen)
-        : prefixLen_(prefixLen),
-        name_("nebula.GraphPrefix." + std::to_string(prefixLen_)) {}
+    explicit GraphPrefixTransform(size_t vIdLen)
+        : vertexPrefixLen_(sizeof(PartitionID) + vIdLen),
+        edgePrefixLen_(sizeof(PartitionID) + vIdLen + sizeof(EdgeType)),
+        indexPrefixLen_(sizeof(PartitionID) + sizeof(IndexID)),
+        name_("nebula.GraphKeyTypePrefix." + std::to_string(vIdLen)) {}
 
     const char* Name() const override { return name_.c_str(); }
 
     rocksdb::Slice Transform(const rocksdb::Slice& src) const override {
-        return rocksdb::Slice(src.data(), prefixLen_);
+        return rocksdb::Slice(src.data(), prefixLen(src));
     }
 
     bool InDomain(const rocksdb::Slice& src) const override {
-        // todo(doodle): only need to consider tag and edge
-        return src.size() >= prefixLen_;
+        auto len = prefixLen(src);
+        return len > 0 && src.size() >= len;
     }
 };
 
@@ -159,6 +202,70 @@ static rocksdb::Status initRocksdbCompression(rocksdb::Options &baseOpts) {
     return rocksdb::Status::OK();
 }
 
+static rocksdb::Status initBlockBasedTableOptions(rocksdb::BlockBasedTableOptions &bbtOpts,
+                                                  const rocksdb::Options &baseOpts) {
+    std::unordered_map<std::string, std::string> bbtOptsMap;
+    if (!loadOptionsMap(bbtOptsMap, FLAGS_rocksdb_block_based_table_options)) {
+        return rocksdb::Status::InvalidArgument();
+    }
+    auto s = GetBlockBasedTableOptionsFromMap(rocksdb::BlockBasedTableOptions(), bbtOptsMap,
+                                              &bbtOpts, true);
+    if (!s.ok()) {
+        return s;
+    }
+
+    if (FLAGS_rocksdb_block_cache <= 0) {
+        bbtOpts.no_block_cache = true;
+    } else {
+        static std::shared_ptr<rocksdb::Cache> blockCache
+            = rocksdb::NewLRUCache(FLAGS_rocksdb_block_cache * 1024 * 1024, 8/*shard bits*/);
+        bbtOpts.block_cache = blockCache;
+    }
+
+    bbtOpts.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10, false));
+    if (FLAGS_enable_partitioned_index_filter) {
+        bbtOpts.index_type = rocksdb::BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+        bbtOpts.partition_filters = true;
+        bbtOpts.cache_index_and_filter_blocks = true;
+        bbtOpts.cache_index_and_filter_blocks_with_high_priority = true;
+        bbtOpts.pin_l0_filter_and_index_blocks_in_cache =
+            baseOpts.compaction_style == rocksdb::CompactionStyle::kCompactionStyleLevel;
+    }
+    bbtOpts.whole_key_filtering = FLAGS_enable_rocksdb_whole_key_filtering;
+    return s;
+}
+
+// Find the options of the key type in the json from key type name to options
+static bool loadKeyTypeOptionsMap(std::unordered_map<std::string, std::string> &map,
+                                  const std::string& gflags,
+                                  const std::string& typeName) {
+    folly::dynamic obj;
+    try {
+        obj = folly::parseJson(gflags);
+    } catch (const std::exception& e) {
+        LOG(ERROR) << "Invalid json " << gflags << ", error: " << e.what();
+        return false;
+    }
+    if (!obj.isObject()) {
+        LOG(ERROR) << "Invalid json " << gflags << ", not an object";
+        return false;
+    }
+    auto it = obj.find(typeName);
+    if (it == obj.items().end()) {
+        return true;
+    }
+    if (!it->second.isObject()) {
+        LOG(ERROR) << "Invalid options of " << typeName << ": " << folly::toJson(it->second);
+        return false;
+    }
+    for (const auto& item : it->second.items()) {
+        LOG(INFO) << "Emplace rocksdb option of " << typeName << " column family "
+                  << item.first.asString() << "=" << item.second.asString();
+        map.emplace(item.first.asString(), item.second.asString());
+    }
+    return true;
+}
+
 rocksdb::Status initRocksdbOptions(rocksdb::Options &baseOpts, int32_t vidLen) {
     rocksdb::Status s;
     rocksdb::DBOptions dbOpts;
@@ -196,23 +303,11 @@ rocksdb::Status initRocksdbOptions(rocksdb::Options &baseOpts, int32_t vidLen) {
         return s;
     }
 
-    std::unordered_map<std::string, std::string> bbtOptsMap;
-    if (!loadOptionsMap(bbtOptsMap, FLAGS_rocksdb_block_based_table_options)) {
-        return rocksdb::Status::InvalidArgument();
-    }
-    s = GetBlockBasedTableOptionsFromMap(rocksdb::BlockBasedTableOptions(), bbtOptsMap,
-                                         &bbtOpts, true);
+    s = initBlockBasedTableOptions(bbtOpts, baseOpts);
     if (!s.ok()) {
         return s;
     }
 
-    if (FLAGS_rocksdb_block_cache <= 0) {
-        bbtOpts.no_block_cache = true;
-    } else {
-        static std::shared_ptr<rocksdb::Cache> blockCache
-            = rocksdb::NewLRUCache(FLAGS_rocksdb_block_cache * 1024 * 1024, 8/*shard bits*/);
-        bbtOpts.block_cache = blockCache;
-    }
     if (FLAGS_num_compaction_threads > 0) {
         static std::shared_ptr<rocksdb::ConcurrentTaskLimiter> compaction_thread_limiter{
             rocksdb::NewConcurrentTaskLimiter("compaction", FLAGS_num_compaction_threads)};
@@ -224,26 +319,77 @@ rocksdb::Status initRocksdbOptions(rocksdb::Options &baseOpts, int32_t vidLen) {
         baseOpts.rate_limiter = rate_limiter;
     }
 
-    bbtOpts.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10, false));
-    if (FLAGS_enable_partitioned_index_filter) {
-        bbtOpts.index_type = rocksdb::BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
-        bbtOpts.partition_filters = true;
-        bbtOpts.cache_index_and_filter_blocks = true;
-        bbtOpts.cache_index_and_filter_blocks_with_high_priority = true;
-        bbtOpts.pin_l0_filter_and_index_blocks_in_cache =
-            baseOpts.compaction_style == rocksdb::CompactionStyle::kCompactionStyleLevel;
-    }
     if (FLAGS_enable_rocksdb_prefix_filtering) {
-        int lengthBeforeVid = 4;
-        baseOpts.prefix_extractor.reset(
-                new GraphPrefixTransform(lengthBeforeVid + vidLen));
+        baseOpts.prefix_extractor.reset(new GraphPrefixTransform(vidLen));
     }
-    bbtOpts.whole_key_filtering = FLAGS_enable_rocksdb_whole_key_filtering;
     baseOpts.table_factory.reset(NewBlockBasedTableFactory(bbtOpts));
     baseOpts.create_if_missing = true;
     return s;
 }
 
+rocksdb::Status initRocksdbCFOptions(rocksdb::ColumnFamilyOptions &cfOpts,
+                                     const rocksdb::Options &baseOpts,
+                                     NebulaKeyType type) {
+    auto typeName = keyTypeName(type);
+    cfOpts = rocksdb::ColumnFamilyOptions(baseOpts);
+    // Only the vertex, edge and index keys are in the domain of the prefix extractor
+    if (type != NebulaKeyType::kVertex &&
+        type != NebulaKeyType::kEdge &&
+        type != NebulaKeyType::kIndex) {
+        cfOpts.prefix_extractor.reset();
+    }
+
+    std::unordered_map<std::string, std::string> cfOptsMap;
+    if (!loadKeyTypeOptionsMap(cfOptsMap, FLAGS_rocksdb_key_type_cf_options, typeName)) {
+        return rocksdb::Status::InvalidArgument();
+    }
+    if (!cfOptsMap.empty()) {
+        rocksdb::ColumnFamilyOptions base = cfOpts;
+        auto s = GetColumnFamilyOptionsFromMap(base, cfOptsMap, &cfOpts, true);
+        if (!s.ok()) {
+            return s;
+        }
+    }
+
+    std::unordered_map<std::string, std::string> bbtOptsMap;
+    if (!loadKeyTypeOptionsMap(bbtOptsMap, FLAGS_rocksdb_key_type_block_based_table_options,
+                               typeName)) {
+        return rocksdb::Status::InvalidArgument();
+    }
+    if (!bbtOptsMap.empty()) {
+        rocksdb::BlockBasedTableOptions base;
+        auto s = initBlockBasedTableOptions(base, baseOpts);
+        if (!s.ok()) {
+            return s;
+        }
+        rocksdb::BlockBasedTableOptions bbtOpts;
+        s = GetBlockBasedTableOptionsFromMap(base, bbtOptsMap, &bbtOpts, true);
+        if (!s.ok()) {
+            return s;
+        }
+        cfOpts.table_factory.reset(NewBlockBasedTableFactory(bbtOpts));
+    }
+    return rocksdb::Status::OK();
+}
+
+const char* keyTypeName(NebulaKeyType type) {
+    switch (type) {
+        case NebulaKeyType::kVertex:
+            return "vertex";
+        case NebulaKeyType::kEdge:
+            return "edge";
+        case NebulaKeyType::kIndex:
+            return "index";
+        case NebulaKeyType::kSystem:
+            return "system";
+        case NebulaKeyType::kOperation:
+            return "operation";
+        case NebulaKeyType::kKeyValue:
+            return "kv";
+    }
+    return "unknown";
+}
+
 bool loadOptionsMap(std::unordered_map<std::string, std::string> &map, const std::string& gflags) {
     conf::Configuration conf;
     auto status = conf.parseFromString(gflags);
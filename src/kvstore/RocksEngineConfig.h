@@ -9,6 +9,7 @@
 
 #include "common/base/Base.h"
 #include <rocksdb/db.h>
+#include "utils/Types.h"
 
 // [Version]
 DECLARE_string(rocksdb_options_version);
@@ -47,6 +48,10 @@ DECLARE_bool(enable_rocksdb_prefix_filtering);
 DECLARE_bool(enable_rocksdb_whole_key_filtering);
 DECLARE_int32(rocksdb_filtering_prefix_length);
 
+DECLARE_bool(rocksdb_column_family_per_key_type);
+DECLARE_string(rocksdb_key_type_cf_options);
+DECLARE_string(rocksdb_key_type_block_based_table_options);
+
 // rocksdb compact RangeOptions
 DECLARE_bool(rocksdb_compact_change_level);
 DECLARE_int32(rocksdb_compact_target_level);
@@ -56,6 +61,15 @@ namespace kvstore {
 
 rocksdb::Status initRocksdbOptions(rocksdb::Options &baseOpts, int32_t vidLen = 8);
 
+// Options of the column family of the given key type, which are baseOpts overridden by
+// rocksdb_key_type_cf_options and rocksdb_key_type_block_based_table_options
+rocksdb::Status initRocksdbCFOptions(rocksdb::ColumnFamilyOptions &cfOpts,
+                                     const rocksdb::Options &baseOpts,
+                                     NebulaKeyType type);
+
+// The name of the column family of the given key type
+const char* keyTypeName(NebulaKeyType type);
+
 bool loadOptionsMap(std::unordered_map<std::string, std::string> &map, const std::string& gflags);
 
 std::shared_ptr<rocksdb::Statistics> getDBStatistics();
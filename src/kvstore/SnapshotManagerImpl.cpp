@@ -6,8 +6,18 @@
 #include "kvstore/SnapshotManagerImpl.h"
 #include "utils/NebulaKeyUtils.h"
 #include "kvstore/LogEncoder.h"
+#include "kvstore/Part.h"
+#include "common/fs/FileUtils.h"
+#include <rocksdb/sst_file_writer.h>
+#include <fstream>
 
 DEFINE_int32(snapshot_batch_size, 1024 * 1024 * 10, "batch size for snapshot");
+DEFINE_bool(snapshot_send_sst, false,
+            "Send the snapshot as sst files which are ingested by the receiver, "
+            "all peers must support it before it is turned on");
+DEFINE_int64(snapshot_sst_file_size, 64 * 1024 * 1024,
+             "The sst file of snapshot is sent and removed once it reaches the size, "
+             "a new one is started for the rest of rows");
 
 namespace nebula {
 namespace kvstore {
@@ -20,9 +30,10 @@ void SnapshotManagerImpl::accessAllRowsInSnapshot(GraphSpaceID spaceId,
     std::vector<std::string> data;
     int64_t totalSize = 0;
     int64_t totalCount = 0;
+    int32_t fileIndex = 0;
 
     for (const auto& prefix : tables) {
-        if (!accessTable(spaceId, partId, prefix, cb, data, totalCount, totalSize)) {
+        if (!accessTable(spaceId, partId, prefix, fileIndex, cb, data, totalCount, totalSize)) {
             return;
         }
     }
@@ -34,10 +45,46 @@ void SnapshotManagerImpl::accessAllRowsInSnapshot(GraphSpaceID spaceId,
 bool SnapshotManagerImpl::accessTable(GraphSpaceID spaceId,
                                       PartitionID partId,
                                       const std::string& prefix,
+                                      int32_t& fileIndex,
                                       raftex::SnapshotCallback& cb,
                                       std::vector<std::string>& data,
                                       int64_t& totalCount,
                                       int64_t& totalSize) {
+    if (FLAGS_snapshot_send_sst) {
+        auto ret = store_->part(spaceId, partId);
+        if (!ok(ret)) {
+            cb(data, totalCount, totalSize, raftex::SnapshotStatus::FAILED);
+            return false;
+        }
+        auto* engine = nebula::value(ret)->engine();
+        std::unique_ptr<KVIterator> iter;
+        if (engine->prefix(prefix, &iter) != ResultCode::SUCCEEDED) {
+            LOG(INFO) << "[spaceId:" << spaceId << ", partId:" << partId
+                      << "] access prefix failed";
+            cb(data, totalCount, totalSize, raftex::SnapshotStatus::FAILED);
+            return false;
+        }
+        // Each file is sent as soon as it is finished, so a sending holds one file at a time
+        auto status = Status::OK();
+        while (iter && iter->valid()) {
+            auto path = sstFilePath(engine, partId);
+            status = buildSstFile(iter.get(), path);
+            if (!status.ok()) {
+                break;
+            }
+            if (!sendSstFile(spaceId, partId, path, fileIndex++,
+                             cb, data, totalCount, totalSize)) {
+                return false;
+            }
+        }
+        if (status.ok()) {
+            return true;
+        }
+        // The files ingested already hold the same rows, so sending all rows is still correct
+        LOG(WARNING) << "[spaceId:" << spaceId << ", partId:" << partId << "] "
+                     << status << ", fall back to send rows";
+    }
+
     std::unique_ptr<KVIterator> iter;
     auto ret = store_->prefix(spaceId, partId, prefix, &iter);
     if (ret != ResultCode::SUCCEEDED) {
@@ -70,6 +117,76 @@ bool SnapshotManagerImpl::accessTable(GraphSpaceID spaceId,
     return true;
 }
 
+std::string SnapshotManagerImpl::sstFilePath(KVEngine* engine, PartitionID partId) {
+    // A part may be sent to several peers at the same time
+    return folly::stringPrintf("%s/snapshot_send/%d.%lu.sst",
+                               engine->getDataRoot(), partId, fileSeq_++);
+}
+
+Status SnapshotManagerImpl::buildSstFile(KVIterator* iter, const std::string& path) {
+    auto dir = fs::FileUtils::dirname(path.c_str());
+    if (!fs::FileUtils::makeDir(dir)) {
+        return Status::Error("Failed to create dir %s", dir.c_str());
+    }
+    rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), rocksdb::Options());
+    auto status = writer.Open(path);
+    while (status.ok()
+            && iter->valid()
+            && static_cast<int64_t>(writer.FileSize()) < FLAGS_snapshot_sst_file_size) {
+        status = writer.Put(toSlice(iter->key()), toSlice(iter->val()));
+        iter->next();
+    }
+    if (status.ok()) {
+        status = writer.Finish();
+    }
+    if (!status.ok()) {
+        fs::FileUtils::remove(path.c_str());
+        return Status::Error("Failed to write sst file: %s", status.ToString().c_str());
+    }
+    return Status::OK();
+}
+
+// The file is sent chunk by chunk, the receiver ingests it when the last chunk arrives.
+bool SnapshotManagerImpl::sendSstFile(GraphSpaceID spaceId,
+                                      PartitionID partId,
+                                      const std::string& path,
+                                      int32_t fileIndex,
+                                      raftex::SnapshotCallback& cb,
+                                      std::vector<std::string>& data,
+                                      int64_t& totalCount,
+                                      int64_t& totalSize) {
+    SCOPE_EXIT {
+        fs::FileUtils::remove(path.c_str());
+    };
+    std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+    int64_t fileSize = ifs.tellg();
+    ifs.seekg(0);
+    std::string buf(std::min<int64_t>(FLAGS_snapshot_batch_size, fileSize), '\0');
+    int64_t offset = 0;
+    while (offset < fileSize) {
+        auto len = std::min<int64_t>(buf.size(), fileSize - offset);
+        if (!ifs.read(&buf[0], len)) {
+            LOG(ERROR) << "[spaceId:" << spaceId << ", partId:" << partId
+                       << "] read " << path << " failed";
+            cb(data, totalCount, totalSize, raftex::SnapshotStatus::FAILED);
+            return false;
+        }
+        offset += len;
+        data.emplace_back(encodeSstChunk(fileIndex,
+                                         offset == fileSize,
+                                         folly::StringPiece(buf.data(), len)));
+        totalSize += data.back().size();
+        totalCount++;
+        if (!cb(data, totalCount, totalSize, raftex::SnapshotStatus::IN_PROGRESS)) {
+            LOG(INFO) << "[spaceId:" << spaceId << ", partId:" << partId
+                      << "] send snapshot failed";
+            return false;
+        }
+        data.clear();
+    }
+    return true;
+}
+
 }   // namespace kvstore
 }  // namespace nebula
 
@@ -9,6 +9,7 @@
 
 #include "common/base/Base.h"
 #include "kvstore/raftex/SnapshotManager.h"
+#include "kvstore/KVEngine.h"
 #include "kvstore/KVStore.h"
 
 namespace nebula {
@@ -23,15 +24,34 @@ public:
                                  raftex::SnapshotCallback cb) override;
 
 private:
+    // fileIndex is the index of the next sst file in the snapshot
     bool accessTable(GraphSpaceID spaceId,
                      PartitionID partId,
                      const std::string& prefix,
+                     int32_t& fileIndex,
                      raftex::SnapshotCallback& cb,
                      std::vector<std::string>& data,
                      int64_t& totalCount,
                      int64_t& totalSize);
 
-    KVStore* store_;
+    // A local path of sst file which is not used by any other sending
+    std::string sstFilePath(KVEngine* engine, PartitionID partId);
+
+    // Dump the rows from iter into a sst file at path, until the file reaches
+    // FLAGS_snapshot_sst_file_size or iter has no more rows
+    Status buildSstFile(KVIterator* iter, const std::string& path);
+
+    bool sendSstFile(GraphSpaceID spaceId,
+                     PartitionID partId,
+                     const std::string& path,
+                     int32_t fileIndex,
+                     raftex::SnapshotCallback& cb,
+                     std::vector<std::string>& data,
+                     int64_t& totalCount,
+                     int64_t& totalSize);
+
+    KVStore*                store_;
+    std::atomic<uint64_t>   fileSeq_{0};
 };
 
 }  // namespace kvstore
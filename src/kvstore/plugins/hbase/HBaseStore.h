@@ -41,6 +41,12 @@ public:
         current_--;
     }
 
+    void seek(folly::StringPiece target) override {
+        current_ = std::lower_bound(begin_, end_, target, [] (const auto& kv, const auto& key) {
+            return folly::StringPiece(kv.first) < key;
+        });
+    }
+
     folly::StringPiece key() const override {
         return folly::StringPiece(current_->first);
     }
@@ -168,6 +174,13 @@ public:
                            const std::string& prefix,
                            KVCallback cb);
 
+    void asyncMultiMerge(GraphSpaceID,
+                         PartitionID,
+                         std::vector<KV>&&,
+                         KVCallback) override {
+        LOG(FATAL) << "Not supportted yet!";
+    }
+
     void asyncAtomicOp(GraphSpaceID,
                        PartitionID,
                        raftex::AtomicOp,
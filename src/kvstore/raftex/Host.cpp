@@ -14,6 +14,9 @@
 
 DEFINE_uint32(max_appendlog_batch_size, 128,
               "The max number of logs in each appendLog request batch");
+DEFINE_uint32(max_appendlog_inflight_batches, 4,
+              "The max number of appendLog requests in flight to each follower, a larger window"
+              " keeps a high latency link busy");
 DEFINE_uint32(max_outstanding_requests, 1024,
               "The max number of outstanding appendLog requests");
 DEFINE_int32(raft_rpc_timeout_ms, 500, "rpc timeout for raft client");
@@ -106,7 +109,8 @@ folly::Future<cpp2::AppendLogResponse> Host::appendLogs(
                   << "]";
     }
     auto ret = folly::Future<cpp2::AppendLogResponse>::makeEmpty();
-    std::shared_ptr<cpp2::AppendLogRequest> req;
+    std::vector<std::shared_ptr<cpp2::AppendLogRequest>> reqs;
+    uint64_t epoch = 0;
     {
         std::lock_guard<std::mutex> g(lock_);
 
@@ -166,11 +170,15 @@ folly::Future<cpp2::AppendLogResponse> Host::appendLogs(
 
         requestOnGoing_ = true;
 
-        req = prepareAppendLogRequest();
+        newEpoch();
+        reqs = prepareWindow();
+        epoch = epoch_;
     }
 
     // Get a new promise
-    appendLogsInternal(eb, std::move(req));
+    for (auto& req : reqs) {
+        appendLogsInternal(eb, std::move(req), epoch);
+    }
 
     return ret;
 }
@@ -182,227 +190,265 @@ void Host::setResponse(const cpp2::AppendLogResponse& r) {
     cachingPromise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
     pendingReq_ = std::make_tuple(0, 0, 0);
     requestOnGoing_ = false;
+    // The responses of the requests still in flight are ignored
+    newEpoch();
 }
 
 void Host::appendLogsInternal(folly::EventBase* eb,
-                              std::shared_ptr<cpp2::AppendLogRequest> req) {
+                              std::shared_ptr<cpp2::AppendLogRequest> req,
+                              uint64_t epoch) {
+    auto prevLogId = req->get_last_log_id_sent();
     sendAppendLogRequest(eb, std::move(req)).via(eb).then(
-            [eb, self = shared_from_this()] (folly::Try<cpp2::AppendLogResponse>&& t) {
+            [eb, epoch, prevLogId, self = shared_from_this()]
+            (folly::Try<cpp2::AppendLogResponse>&& t) {
         VLOG(3) << self->idStr_ << "appendLogs() call got response";
-        if (t.hasException()) {
-            VLOG(2) << self->idStr_ << t.exception().what();
-            cpp2::AppendLogResponse r;
-            r.set_error_code(cpp2::ErrorCode::E_EXCEPTION);
-            {
-                std::lock_guard<std::mutex> g(self->lock_);
-                self->setResponse(r);
-                self->lastLogIdSent_ = self->logIdToSend_ - 1;
+        std::vector<std::shared_ptr<cpp2::AppendLogRequest>> newReqs;
+        uint64_t nextEpoch = 0;
+        {
+            std::lock_guard<std::mutex> g(self->lock_);
+            if (epoch != self->epoch_) {
+                VLOG(2) << self->idStr_ << "Ignore the response of a former epoch " << epoch;
+                return;
             }
+            self->inflight_--;
+            newReqs = self->handleResponse(std::move(t), prevLogId);
+            nextEpoch = self->epoch_;
+        }
+        for (auto& newReq : newReqs) {
+            self->appendLogsInternal(eb, std::move(newReq), nextEpoch);
+        }
+        if (newReqs.empty()) {
             self->noMoreRequestCV_.notify_all();
-            return;
         }
+    });
+}
 
-        cpp2::AppendLogResponse resp = std::move(t).value();
-        if (FLAGS_trace_raft) {
-            LOG(INFO)
-                << self->idStr_ << "AppendLogResponse "
-                << "code " << apache::thrift::util::enumNameSafe(resp.get_error_code())
-                << ", currTerm " << resp.get_current_term()
-                << ", lastLogId " << resp.get_last_log_id()
-                << ", lastLogTerm " << resp.get_last_log_term()
-                << ", commitLogId " << resp.get_committed_log_id()
-                << ", lastLogIdSent_ " << self->lastLogIdSent_
-                << ", lastLogTermSent_ " << self->lastLogTermSent_;
-        }
-        switch (resp.get_error_code()) {
-            case cpp2::ErrorCode::SUCCEEDED: {
-                VLOG(2) << self->idStr_
-                        << "AppendLog request sent successfully";
-
-                std::shared_ptr<cpp2::AppendLogRequest> newReq;
-                {
-                    std::lock_guard<std::mutex> g(self->lock_);
-                    auto res = self->checkStatus();
-                    if (res != cpp2::ErrorCode::SUCCEEDED) {
-                        VLOG(2) << self->idStr_
-                                << "The host is not in a proper status,"
-                                   " just return";
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(res);
-                        self->setResponse(r);
-                    } else if (self->lastLogIdSent_ >= resp.get_last_log_id()) {
-                        VLOG(1) << self->idStr_
-                                << "We send nothing in the last request"
-                                << ", so we don't send the same logs again";
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(res);
-                        self->setResponse(r);
-                    } else {
-                        self->lastLogIdSent_ = resp.get_last_log_id();
-                        self->lastLogTermSent_ = resp.get_last_log_term();
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        if (self->lastLogIdSent_ < self->logIdToSend_) {
-                            // More to send
-                            VLOG(2) << self->idStr_
-                                    << "There are more logs to send";
-                            newReq = self->prepareAppendLogRequest();
-                        } else {
-                            VLOG(2) << self->idStr_
-                                    << "Fulfill the promise, size = " << self->promise_.size();
-                            // Fulfill the promise
-                            self->promise_.setValue(resp);
-
-                            if (self->noRequest()) {
-                                VLOG(2) << self->idStr_ << "No request any more!";
-                                self->requestOnGoing_ = false;
-                            } else {
-                                auto& tup = self->pendingReq_;
-                                self->logTermToSend_ = std::get<0>(tup);
-                                self->logIdToSend_ = std::get<1>(tup);
-                                self->committedLogId_ = std::get<2>(tup);
-                                VLOG(2) << self->idStr_
-                                        << "Sending the pending request in the queue"
-                                        << ", from " << self->lastLogIdSent_ + 1
-                                        << " to " << self->logIdToSend_;
-                                newReq = self->prepareAppendLogRequest();
-                                self->promise_ = std::move(self->cachingPromise_);
-                                self->cachingPromise_
-                                    = folly::SharedPromise<cpp2::AppendLogResponse>();
-                                self->pendingReq_ = std::make_tuple(0, 0, 0);
-                            }  // self->noRequest()
-                        }  // self->lastLogIdSent_ < self->logIdToSend_
-                    }  // else
-                }
-                if (newReq) {
-                    self->appendLogsInternal(eb, newReq);
-                } else {
-                    self->noMoreRequestCV_.notify_all();
-                }
-                return;
+
+std::vector<std::shared_ptr<cpp2::AppendLogRequest>>
+Host::handleResponse(folly::Try<cpp2::AppendLogResponse>&& t, LogID prevLogId) {
+    CHECK(!lock_.try_lock());
+    std::vector<std::shared_ptr<cpp2::AppendLogRequest>> newReqs;
+    bool failed = t.hasException() ||
+                  t.value().get_error_code() != cpp2::ErrorCode::SUCCEEDED;
+    if (failed && inflight_ > 0) {
+        // The follower may have received the requests in a different order. The requests still
+        // in flight tell where it is, so wait for them, and send nothing more for now.
+        VLOG(2) << idStr_ << "An AppendLog request failed, " << inflight_
+                << " requests are still in flight";
+        rewinding_ = true;
+        return newReqs;
+    }
+
+    if (t.hasException()) {
+        VLOG(2) << idStr_ << t.exception().what();
+        cpp2::AppendLogResponse r;
+        r.set_error_code(cpp2::ErrorCode::E_EXCEPTION);
+        setResponse(r);
+        lastLogIdSent_ = logIdToSend_ - 1;
+        return newReqs;
+    }
+
+    cpp2::AppendLogResponse resp = std::move(t).value();
+    if (FLAGS_trace_raft) {
+        LOG(INFO)
+            << idStr_ << "AppendLogResponse "
+            << "code " << apache::thrift::util::enumNameSafe(resp.get_error_code())
+            << ", currTerm " << resp.get_current_term()
+            << ", lastLogId " << resp.get_last_log_id()
+            << ", lastLogTerm " << resp.get_last_log_term()
+            << ", commitLogId " << resp.get_committed_log_id()
+            << ", lastLogIdSent_ " << lastLogIdSent_
+            << ", lastLogTermSent_ " << lastLogTermSent_;
+    }
+    switch (resp.get_error_code()) {
+        case cpp2::ErrorCode::SUCCEEDED: {
+            VLOG(2) << idStr_ << "AppendLog request sent successfully";
+            auto res = checkStatus();
+            if (res != cpp2::ErrorCode::SUCCEEDED) {
+                VLOG(2) << idStr_ << "The host is not in a proper status, just return";
+                cpp2::AppendLogResponse r;
+                r.set_error_code(res);
+                setResponse(r);
+                return newReqs;
             }
-            case cpp2::ErrorCode::E_LOG_GAP: {
-                VLOG(2) << self->idStr_
-                        << "The host's log is behind, need to catch up";
-                std::shared_ptr<cpp2::AppendLogRequest> newReq;
-                {
-                    std::lock_guard<std::mutex> g(self->lock_);
-                    auto res = self->checkStatus();
-                    if (res != cpp2::ErrorCode::SUCCEEDED) {
-                        VLOG(2) << self->idStr_
-                                << "The host is not in a proper status,"
-                                   " skip catching up the gap";
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(res);
-                        self->setResponse(r);
-                    } else if (self->lastLogIdSent_ == resp.get_last_log_id()) {
-                        VLOG(1) << self->idStr_
-                                << "We send nothing in the last request"
-                                << ", so we don't send the same logs again";
-                        self->lastLogIdSent_ = resp.get_last_log_id();
-                        self->lastLogTermSent_ = resp.get_last_log_term();
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(cpp2::ErrorCode::SUCCEEDED);
-                        self->setResponse(r);
-                    } else {
-                        self->lastLogIdSent_ = std::min(resp.get_last_log_id(),
-                                                        self->logIdToSend_ - 1);
-                        self->lastLogTermSent_ = resp.get_last_log_term();
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        newReq = self->prepareAppendLogRequest();
-                    }
-                }
-                if (newReq) {
-                    self->appendLogsInternal(eb, newReq);
-                } else {
-                    self->noMoreRequestCV_.notify_all();
-                }
-                return;
+
+            followerCommittedLogId_ = resp.get_committed_log_id();
+            // The responses may arrive in a different order from the requests, an older one
+            // tells nothing new
+            bool progressed = resp.get_last_log_id() > lastLogIdSent_;
+            if (progressed) {
+                lastLogIdSent_ = resp.get_last_log_id();
+                lastLogTermSent_ = resp.get_last_log_term();
             }
-            case cpp2::ErrorCode::E_WAITING_SNAPSHOT: {
-                LOG(INFO) << self->idStr_
-                          << "The host is waiting for the snapshot, so we need to send log from "
-                          << "current committedLogId " << self->committedLogId_;
-                std::shared_ptr<cpp2::AppendLogRequest> newReq;
-                {
-                    std::lock_guard<std::mutex> g(self->lock_);
-                    auto res = self->checkStatus();
-                    if (res != cpp2::ErrorCode::SUCCEEDED) {
-                        VLOG(2) << self->idStr_
-                                << "The host is not in a proper status,"
-                                   " skip waiting the snapshot";
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(res);
-                        self->setResponse(r);
-                    } else {
-                        self->lastLogIdSent_ = self->committedLogId_;
-                        self->lastLogTermSent_ = self->logTermToSend_;
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        newReq = self->prepareAppendLogRequest();
-                    }
-                }
-                if (newReq) {
-                    self->appendLogsInternal(eb, newReq);
+
+            if (!progressed && inflight_ == 0 && sentNothing(prevLogId)) {
+                VLOG(1) << idStr_
+                        << "We send nothing in the last request"
+                        << ", so we don't send the same logs again";
+                cpp2::AppendLogResponse r;
+                r.set_error_code(res);
+                setResponse(r);
+            } else if (!progressed && inflight_ == 0 && lastLogIdSent_ < logIdToSend_) {
+                // A stale ack is the last one back, the logs after it may never be stored
+                VLOG(2) << idStr_ << "Send the logs again from " << lastLogIdSent_ + 1;
+                newEpoch();
+                newReqs = prepareWindow();
+            } else if (lastLogIdSent_ >= logIdToSend_) {
+                VLOG(2) << idStr_ << "Fulfill the promise, size = " << promise_.size();
+                // Fulfill the promise
+                promise_.setValue(resp);
+                // The requests still in flight carry nothing new
+                newEpoch();
+
+                if (noRequest()) {
+                    VLOG(2) << idStr_ << "No request any more!";
+                    requestOnGoing_ = false;
                 } else {
-                    self->noMoreRequestCV_.notify_all();
+                    auto& tup = pendingReq_;
+                    logTermToSend_ = std::get<0>(tup);
+                    logIdToSend_ = std::get<1>(tup);
+                    committedLogId_ = std::get<2>(tup);
+                    VLOG(2) << idStr_
+                            << "Sending the pending request in the queue"
+                            << ", from " << lastLogIdSent_ + 1
+                            << " to " << logIdToSend_;
+                    newReqs = prepareWindow();
+                    promise_ = std::move(cachingPromise_);
+                    cachingPromise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
+                    pendingReq_ = std::make_tuple(0, 0, 0);
                 }
-                return;
+            } else {
+                // More to send
+                VLOG(2) << idStr_ << "There are more logs to send";
+                newReqs = prepareWindow();
             }
-            case cpp2::ErrorCode::E_LOG_STALE: {
-                VLOG(2) << self->idStr_ << "Log stale, reset lastLogIdSent " << self->lastLogIdSent_
-                        << " to the followers lastLodId " << resp.get_last_log_id();
-                std::shared_ptr<cpp2::AppendLogRequest> newReq;
-                {
-                    std::lock_guard<std::mutex> g(self->lock_);
-                    auto res = self->checkStatus();
-                    if (res != cpp2::ErrorCode::SUCCEEDED) {
-                        VLOG(2) << self->idStr_
-                                << "The host is not in a proper status,"
-                                   " skip waiting the snapshot";
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(res);
-                        self->setResponse(r);
-                    } else if (self->logIdToSend_ <= resp.get_last_log_id()) {
-                        VLOG(1) << self->idStr_
-                                << "It means the request has been received by follower";
-                        self->lastLogIdSent_ = self->logIdToSend_ - 1;
-                        self->lastLogTermSent_ = resp.get_last_log_term();
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(cpp2::ErrorCode::SUCCEEDED);
-                        self->setResponse(r);
-                    } else {
-                        self->lastLogIdSent_ = std::min(resp.get_last_log_id(),
-                                                        self->logIdToSend_ - 1);
-                        self->lastLogTermSent_ = resp.get_last_log_term();
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        newReq = self->prepareAppendLogRequest();
-                    }
-                }
-                if (newReq) {
-                    self->appendLogsInternal(eb, newReq);
-                } else {
-                    self->noMoreRequestCV_.notify_all();
-                }
-                return;
+            return newReqs;
+        }
+        case cpp2::ErrorCode::E_LOG_GAP: {
+            VLOG(2) << idStr_ << "The host's log is behind, need to catch up";
+            auto res = checkStatus();
+            if (res != cpp2::ErrorCode::SUCCEEDED) {
+                VLOG(2) << idStr_
+                        << "The host is not in a proper status,"
+                           " skip catching up the gap";
+                cpp2::AppendLogResponse r;
+                r.set_error_code(res);
+                setResponse(r);
+            } else if (lastLogIdSent_ == resp.get_last_log_id() && sentNothing(prevLogId)) {
+                VLOG(1) << idStr_
+                        << "We send nothing in the last request"
+                        << ", so we don't send the same logs again";
+                lastLogIdSent_ = resp.get_last_log_id();
+                lastLogTermSent_ = resp.get_last_log_term();
+                followerCommittedLogId_ = resp.get_committed_log_id();
+                cpp2::AppendLogResponse r;
+                r.set_error_code(cpp2::ErrorCode::SUCCEEDED);
+                setResponse(r);
+            } else {
+                lastLogIdSent_ = std::min(resp.get_last_log_id(), logIdToSend_ - 1);
+                lastLogTermSent_ = resp.get_last_log_term();
+                followerCommittedLogId_ = resp.get_committed_log_id();
+                newEpoch();
+                newReqs = prepareWindow();
             }
-            default: {
-                LOG_EVERY_N(ERROR, 100)
-                           << self->idStr_
-                           << "Failed to append logs to the host (Err: "
-                           << apache::thrift::util::enumNameSafe(resp.get_error_code())
-                           << ")";
-                {
-                    std::lock_guard<std::mutex> g(self->lock_);
-                    self->setResponse(resp);
-                    self->lastLogIdSent_ = self->logIdToSend_ - 1;
-                }
-                self->noMoreRequestCV_.notify_all();
-                return;
+            return newReqs;
+        }
+        case cpp2::ErrorCode::E_WAITING_SNAPSHOT: {
+            LOG(INFO) << idStr_
+                      << "The host is waiting for the snapshot, so we need to send log from "
+                      << "current committedLogId " << committedLogId_;
+            auto res = checkStatus();
+            if (res != cpp2::ErrorCode::SUCCEEDED) {
+                VLOG(2) << idStr_
+                        << "The host is not in a proper status,"
+                           " skip waiting the snapshot";
+                cpp2::AppendLogResponse r;
+                r.set_error_code(res);
+                setResponse(r);
+            } else {
+                lastLogIdSent_ = committedLogId_;
+                lastLogTermSent_ = logTermToSend_;
+                followerCommittedLogId_ = resp.get_committed_log_id();
+                newEpoch();
+                newReqs = prepareWindow();
             }
+            return newReqs;
         }
-    });
+        case cpp2::ErrorCode::E_LOG_STALE: {
+            VLOG(2) << idStr_ << "Log stale, reset lastLogIdSent " << lastLogIdSent_
+                    << " to the followers lastLodId " << resp.get_last_log_id();
+            auto res = checkStatus();
+            if (res != cpp2::ErrorCode::SUCCEEDED) {
+                VLOG(2) << idStr_
+                        << "The host is not in a proper status,"
+                           " skip waiting the snapshot";
+                cpp2::AppendLogResponse r;
+                r.set_error_code(res);
+                setResponse(r);
+            } else if (logIdToSend_ <= resp.get_last_log_id()) {
+                VLOG(1) << idStr_
+                        << "It means the request has been received by follower";
+                lastLogIdSent_ = logIdToSend_ - 1;
+                lastLogTermSent_ = resp.get_last_log_term();
+                followerCommittedLogId_ = resp.get_committed_log_id();
+                cpp2::AppendLogResponse r;
+                r.set_error_code(cpp2::ErrorCode::SUCCEEDED);
+                setResponse(r);
+            } else {
+                lastLogIdSent_ = std::min(resp.get_last_log_id(), logIdToSend_ - 1);
+                lastLogTermSent_ = resp.get_last_log_term();
+                followerCommittedLogId_ = resp.get_committed_log_id();
+                newEpoch();
+                newReqs = prepareWindow();
+            }
+            return newReqs;
+        }
+        default: {
+            LOG_EVERY_N(ERROR, 100)
+                       << idStr_
+                       << "Failed to append logs to the host (Err: "
+                       << apache::thrift::util::enumNameSafe(resp.get_error_code())
+                       << ")";
+            setResponse(resp);
+            lastLogIdSent_ = logIdToSend_ - 1;
+            return newReqs;
+        }
+    }
+}
+
+
+void Host::newEpoch() {
+    CHECK(!lock_.try_lock());
+    epoch_++;
+    inflight_ = 0;
+    rewinding_ = false;
+}
+
+
+std::vector<std::shared_ptr<cpp2::AppendLogRequest>> Host::prepareWindow() {
+    CHECK(!lock_.try_lock());
+    std::vector<std::shared_ptr<cpp2::AppendLogRequest>> reqs;
+    if (inflight_ == 0) {
+        // Go on from the last log the follower has acknowledged
+        lastLogIdPrepared_ = lastLogIdSent_;
+        lastLogTermPrepared_ = lastLogTermSent_;
+        rewinding_ = false;
+    }
+    auto window = std::max(FLAGS_max_appendlog_inflight_batches, 1U);
+    while (inflight_ < window && !rewinding_) {
+        if (inflight_ > 0 && lastLogIdPrepared_ >= logIdToSend_) {
+            break;
+        }
+        auto req = prepareAppendLogRequest();
+        inflight_++;
+        // Nothing follows a request without logs, or one asking to wait for the snapshot
+        bool hasLogs = !req->get_sending_snapshot() && !req->get_log_str_list().empty();
+        reqs.emplace_back(std::move(req));
+        if (!hasLogs) {
+            break;
+        }
+    }
+    return reqs;
 }
 
 
@@ -417,18 +463,18 @@ Host::prepareAppendLogRequest() {
     req->set_leader_addr(part_->address().host);
     req->set_leader_port(part_->address().port);
     req->set_committed_log_id(committedLogId_);
-    req->set_last_log_term_sent(lastLogTermSent_);
-    req->set_last_log_id_sent(lastLogIdSent_);
+    req->set_last_log_term_sent(lastLogTermPrepared_);
+    req->set_last_log_id_sent(lastLogIdPrepared_);
 
     VLOG(2) << idStr_ << "Prepare AppendLogs request from Log "
-                      << lastLogIdSent_ + 1 << " to " << logIdToSend_;
-    if (lastLogIdSent_ + 1 > part_->wal()->lastLogId()) {
+                      << lastLogIdPrepared_ + 1 << " to " << logIdToSend_;
+    if (lastLogIdPrepared_ + 1 > part_->wal()->lastLogId()) {
         LOG(INFO) << idStr_ << "My lastLogId in wal is " << part_->wal()->lastLogId()
-                  << ", but you are seeking " << lastLogIdSent_ + 1
+                  << ", but you are seeking " << lastLogIdPrepared_ + 1
                   << ", so i have nothing to send.";
         return req;
     }
-    auto it = part_->wal()->iterator(lastLogIdSent_ + 1, logIdToSend_);
+    auto it = part_->wal()->iterator(lastLogIdPrepared_ + 1, logIdToSend_);
     if (it->valid()) {
         VLOG(2) << idStr_ << "Prepare the list of log entries to send";
 
@@ -446,12 +492,15 @@ Host::prepareAppendLogRequest() {
             le.set_log_str(it->logMsg().toString());
             logs.emplace_back(std::move(le));
         }
+        // The next request in the window goes on from here
+        lastLogIdPrepared_ += logs.size();
+        lastLogTermPrepared_ = term;
         req->set_log_str_list(std::move(logs));
         req->set_sending_snapshot(false);
     } else {
         req->set_sending_snapshot(true);
         if (!sendingSnapshot_) {
-            LOG(INFO) << idStr_ << "Can't find log " << lastLogIdSent_ + 1
+            LOG(INFO) << idStr_ << "Can't find log " << lastLogIdPrepared_ + 1
                       << " in wal, send the snapshot"
                       << ", logIdToSend = " << logIdToSend_
                       << ", firstLogId in wal = " << part_->wal()->firstLogId()
@@ -506,6 +555,14 @@ folly::Future<cpp2::AppendLogResponse> Host::sendAppendLogRequest(
     return client->future_appendLog(*req);
 }
 
+bool Host::sentNothing(LogID prevLogId) const {
+    CHECK(!lock_.try_lock());
+    // With requests in flight, an answer of a later request may come back after the logs before
+    // it are lost. Only the request going on from the acknowledged log, with nothing prepared
+    // after it, sends nothing new.
+    return prevLogId == lastLogIdSent_ && lastLogIdPrepared_ == lastLogIdSent_;
+}
+
 bool Host::noRequest() const {
     CHECK(!lock_.try_lock());
     static auto emptyTup = std::make_tuple(0, 0, 0);
@@ -8,6 +8,7 @@
 #define RAFTEX_HOST_H_
 
 #include "common/base/Base.h"
+#include <gtest/gtest_prod.h>
 #include "common/interface/gen-cpp2/raftex_types.h"
 #include "common/interface/gen-cpp2/RaftexServiceAsyncClient.h"
 #include "common/thrift/ThriftClientManager.h"
@@ -25,6 +26,7 @@ class RaftPart;
 
 class Host final : public std::enable_shared_from_this<Host> {
     friend class RaftPart;
+    FRIEND_TEST(LogAppend, ReorderedAppendResponses);
 public:
     Host(const HostAddr& addr, std::shared_ptr<RaftPart> part, bool isLearner = false);
 
@@ -60,9 +62,12 @@ public:
         logTermToSend_ = 0;
         lastLogIdSent_ = 0;
         lastLogTermSent_ = 0;
+        lastLogIdPrepared_ = 0;
+        lastLogTermPrepared_ = 0;
         committedLogId_ = 0;
         sendingSnapshot_ = false;
         followerCommittedLogId_ = 0;
+        newEpoch();
     }
 
     void waitForStop();
@@ -101,8 +106,24 @@ private:
 
     void appendLogsInternal(
         folly::EventBase* eb,
-        std::shared_ptr<cpp2::AppendLogRequest> req);
+        std::shared_ptr<cpp2::AppendLogRequest> req,
+        uint64_t epoch);
+
+    // Handle the response of a request of the current epoch, which goes on from prevLogId,
+    // return the requests to send next
+    std::vector<std::shared_ptr<cpp2::AppendLogRequest>>
+    handleResponse(folly::Try<cpp2::AppendLogResponse>&& t, LogID prevLogId);
+
+    // Whether the request going on from prevLogId carries no log the follower lacks
+    bool sentNothing(LogID prevLogId) const;
 
+    // Forget the requests in flight, their responses will be ignored
+    void newEpoch();
+
+    // Prepare the requests to fill the window of requests in flight
+    std::vector<std::shared_ptr<cpp2::AppendLogRequest>> prepareWindow();
+
+    // Prepare a request of the logs after lastLogIdPrepared_
     std::shared_ptr<cpp2::AppendLogRequest> prepareAppendLogRequest();
 
     bool noRequest() const;
@@ -134,10 +155,21 @@ private:
     LogID logIdToSend_{0};
     TermID logTermToSend_{0};
 
-    // The previous log before this batch
+    // The last log the follower has acknowledged
     LogID lastLogIdSent_{0};
     TermID lastLogTermSent_{0};
 
+    // Up to FLAGS_max_appendlog_inflight_batches requests are sent back to back, each one goes
+    // on from the last log of the previous one. A rewind, or the end of a round, starts a new
+    // epoch, and the responses of the requests of the former epochs are ignored.
+    LogID lastLogIdPrepared_{0};
+    TermID lastLogTermPrepared_{0};
+    uint64_t epoch_{0};
+    // The number of requests of the current epoch in flight
+    uint32_t inflight_{0};
+    // A request failed while others are in flight, nothing more is sent until they are back
+    bool rewinding_{false};
+
     LogID committedLogId_{0};
     std::atomic_bool sendingSnapshot_{false};
 
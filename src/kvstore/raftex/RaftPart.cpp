@@ -715,6 +715,7 @@ void RaftPart::appendLogsInternal(AppendLogsIterator iter, TermID termId) {
     TermID prevLogTerm = 0;
     LogID committed = 0;
     LogID lastId = 0;
+    folly::Future<bool> walSynced = true;
     if (iter.valid()) {
         VLOG(2) << idStr_ << "Ready to append logs from id "
                 << iter.logId() << " (Current term is "
@@ -758,6 +759,7 @@ void RaftPart::appendLogsInternal(AppendLogsIterator iter, TermID termId) {
             break;
         }
         lastId = wal_->lastLogId();
+        walSynced = wal_->sync();
         if (tracker.slow()) {
             tracker.output(idStr_, folly::stringPrintf("Write WAL, total %ld",
                                                        lastId - prevLogId + 1));
@@ -778,7 +780,8 @@ void RaftPart::appendLogsInternal(AppendLogsIterator iter, TermID termId) {
                   lastId,
                   committed,
                   prevLogTerm,
-                  prevLogId);
+                  prevLogId,
+                  std::move(walSynced));
     return;
 }
 
@@ -789,7 +792,8 @@ void RaftPart::replicateLogs(folly::EventBase* eb,
                              LogID lastLogId,
                              LogID committedId,
                              TermID prevLogTerm,
-                             LogID prevLogId) {
+                             LogID prevLogId,
+                             folly::Future<bool> walSynced) {
     using namespace folly;  // NOLINT since the fancy overload of | operator
 
     decltype(hosts_) hosts;
@@ -829,7 +833,7 @@ void RaftPart::replicateLogs(folly::EventBase* eb,
 
     lastMsgSentDur_.reset();
     SlowOpTracker tracker;
-    collectNSucceeded(
+    auto responses = collectNSucceeded(
         gen::from(hosts)
         | gen::map([self = shared_from_this(),
                     eb,
@@ -857,24 +861,36 @@ void RaftPart::replicateLogs(folly::EventBase* eb,
         [hosts] (size_t index, cpp2::AppendLogResponse& resp) {
             return resp.get_error_code() == cpp2::ErrorCode::SUCCEEDED
                     && !hosts[index]->isLearner();
-        })
+        });
+    // The logs are not committed before the local wal is synced as well, which overlaps with
+    // the replication
+    folly::collectAll(std::move(walSynced), std::move(responses))
         .via(executor_.get())
-            .then([self = shared_from_this(),
-                   eb,
-                   it = std::move(iter),
-                   currTerm,
-                   lastLogId,
-                   committedId,
-                   prevLogId,
-                   prevLogTerm,
-                   pHosts = std::move(hosts),
-                   tracker] (folly::Try<AppendLogResponses>&& result) mutable {
+            .thenValue([self = shared_from_this(),
+                        eb,
+                        it = std::move(iter),
+                        currTerm,
+                        lastLogId,
+                        committedId,
+                        prevLogId,
+                        prevLogTerm,
+                        pHosts = std::move(hosts),
+                        tracker] (std::tuple<folly::Try<bool>,
+                                             folly::Try<AppendLogResponses>>&& results) mutable {
+            auto& synced = std::get<0>(results);
+            auto& result = std::get<1>(results);
             VLOG(2) << self->idStr_ << "Received enough response";
             CHECK(!result.hasException());
             if (tracker.slow()) {
                 tracker.output(self->idStr_, folly::stringPrintf("Total send logs: %ld",
                                                                   lastLogId - prevLogId + 1));
             }
+            if (synced.hasException() || !synced.value()) {
+                LOG(ERROR) << self->idStr_ << "Failed to sync logs [" << prevLogId + 1
+                           << ", " << lastLogId << "] into wal, they will not be committed";
+                self->abortOnWalSyncFailure();
+                return;
+            }
             self->processAppendLogResponses(*result,
                                             eb,
                                             std::move(it),
@@ -884,12 +900,25 @@ void RaftPart::replicateLogs(folly::EventBase* eb,
                                             prevLogTerm,
                                             prevLogId,
                                             std::move(pHosts));
-
-            return *result;
         });
 }
 
 
+void RaftPart::abortOnWalSyncFailure() {
+    {
+        std::lock_guard<std::mutex> g(raftLock_);
+        // The logs of the round are not durable locally, drop them as a leader which has
+        // not committed them when losing the leadership
+        if (wal_->lastLogId() > lastLogId_) {
+            LOG(INFO) << idStr_ << "Rollback the wal from " << wal_->lastLogId()
+                      << " to " << lastLogId_;
+            wal_->rollbackToLog(lastLogId_);
+        }
+    }
+    checkAppendLogResult(AppendLogResult::E_WAL_FAILURE);
+}
+
+
 void RaftPart::processAppendLogResponses(
         const AppendLogResponses& resps,
         folly::EventBase* eb,
@@ -1019,7 +1048,8 @@ void RaftPart::processAppendLogResponses(
                       lastLogId,
                       committedId,
                       prevLogTerm,
-                      prevLogId);
+                      prevLogId,
+                      true);
     }
 }
 
@@ -1481,7 +1511,7 @@ void RaftPart::processAskForVoteRequest(
 }
 
 
-void RaftPart::processAppendLogRequest(
+folly::Future<bool> RaftPart::processAppendLogRequest(
         const cpp2::AppendLogRequest& req,
         cpp2::AppendLogResponse& resp) {
     if (FLAGS_trace_raft) {
@@ -1520,12 +1550,12 @@ void RaftPart::processAppendLogRequest(
         VLOG(2) << idStr_
                 << "The part has been stopped, skip the request";
         resp.set_error_code(cpp2::ErrorCode::E_BAD_STATE);
-        return;
+        return true;
     }
     if (UNLIKELY(status_ == Status::STARTING)) {
         VLOG(2) << idStr_ << "The partition is still starting";
         resp.set_error_code(cpp2::ErrorCode::E_NOT_READY);
-        return;
+        return true;
     }
     // Check leadership
     cpp2::ErrorCode err = verifyLeader(req);
@@ -1533,7 +1563,7 @@ void RaftPart::processAppendLogRequest(
         // Wrong leadership
         VLOG(2) << idStr_ << "Will not follow the leader";
         resp.set_error_code(err);
-        return;
+        return true;
     }
 
     // Reset the timeout timer
@@ -1545,7 +1575,7 @@ void RaftPart::processAppendLogRequest(
         reset();
         status_ = Status::WAITING_SNAPSHOT;
         resp.set_error_code(cpp2::ErrorCode::E_WAITING_SNAPSHOT);
-        return;
+        return true;
     }
 
     if (UNLIKELY(status_ == Status::WAITING_SNAPSHOT)) {
@@ -1559,7 +1589,7 @@ void RaftPart::processAppendLogRequest(
             LOG(INFO) << idStr_ << "Local is missing logs from id "
                       << lastLogId_ << ". Need to catch up";
             resp.set_error_code(cpp2::ErrorCode::E_LOG_GAP);
-            return;
+            return true;
         }
         // TODO(heng): if we have 3 node, one is leader, one is wait snapshot and return success,
         // the other is follower, but leader replica log to follow failed,
@@ -1583,11 +1613,11 @@ void RaftPart::processAppendLogRequest(
             resp.set_last_log_id(lastLogId_);
             resp.set_last_log_term(lastLogTerm_);
             resp.set_error_code(cpp2::ErrorCode::SUCCEEDED);
-        } else {
-            LOG(ERROR) << idStr_ << "Failed to append logs to WAL";
-            resp.set_error_code(cpp2::ErrorCode::E_WAL_FAIL);
+            return wal_->sync();
         }
-        return;
+        LOG(ERROR) << idStr_ << "Failed to append logs to WAL";
+        resp.set_error_code(cpp2::ErrorCode::E_WAL_FAIL);
+        return true;
     }
 
     if (req.get_last_log_id_sent() < committedLogId_ && req.get_last_log_term_sent() <= term_) {
@@ -1596,7 +1626,7 @@ void RaftPart::processAppendLogRequest(
                   << " i had committed yet. My committedLogId is "
                   << committedLogId_ << ", term is " << term_;
         resp.set_error_code(cpp2::ErrorCode::E_LOG_STALE);
-        return;
+        return true;
     } else if (req.get_last_log_id_sent() < committedLogId_) {
         LOG(INFO) << idStr_ << "What?? How it happens! The log id is "
                   <<  req.get_last_log_id_sent()
@@ -1609,7 +1639,7 @@ void RaftPart::processAppendLogRequest(
         resp.set_committed_log_id(committedLogId_);
         resp.set_last_log_id(lastLogId_);
         resp.set_last_log_term(lastLogTerm_);
-        return;
+        return true;
     }
 
     // req.get_last_log_id_sent() >= committedLogId_
@@ -1630,13 +1660,13 @@ void RaftPart::processAppendLogRequest(
                       << ", term is " << term_;
          }
          resp.set_error_code(cpp2::ErrorCode::E_LOG_GAP);
-         return;
+         return true;
     } else if (req.get_last_log_id_sent() > lastLogId_) {
         // There is a gap
         LOG(INFO) << idStr_ << "Local is missing logs from id "
                 << lastLogId_ << ". Need to catch up";
         resp.set_error_code(cpp2::ErrorCode::E_LOG_GAP);
-        return;
+        return true;
     } else if (req.get_last_log_id_sent() < lastLogId_) {
         // TODO(doodle): This is a potential bug which would cause data not in consensus. In most
         // case, we would hit this path when leader append logs to follower and timeout (leader
@@ -1652,7 +1682,7 @@ void RaftPart::processAppendLogRequest(
                   << ", lastLogIdSent " << req.get_last_log_id_sent()
                   << ", lastLogTermSent " << req.get_last_log_term_sent();
         resp.set_error_code(cpp2::ErrorCode::E_LOG_STALE);
-        return;
+        return true;
     }
 
     // Append new logs
@@ -1674,7 +1704,7 @@ void RaftPart::processAppendLogRequest(
     } else {
         LOG(ERROR) << idStr_ << "Failed to append logs to WAL";
         resp.set_error_code(cpp2::ErrorCode::E_WAL_FAIL);
-        return;
+        return true;
     }
 
     if (req.get_committed_log_id() > committedLogId_) {
@@ -1694,13 +1724,14 @@ void RaftPart::processAppendLogRequest(
                        << committedLogId_ + 1 << " to "
                        << req.get_committed_log_id();
             resp.set_error_code(cpp2::ErrorCode::E_WAL_FAIL);
-            return;
+            return true;
         }
     }
 
     // Reset the timeout timer again in case wal and commit takes longer time than expected
     lastMsgRecvDur_.reset();
     resp.set_error_code(cpp2::ErrorCode::SUCCEEDED);
+    return wal_->sync();
 }
 
 
@@ -213,8 +213,9 @@ public:
         const cpp2::AskForVoteRequest& req,
         cpp2::AskForVoteResponse& resp);
 
-    // Process appendLog request
-    void processAppendLogRequest(
+    // Process appendLog request. The response is not sent until the returned future is
+    // fulfilled, i.e. the logs appended are synced into the wal
+    folly::Future<bool> processAppendLogRequest(
         const cpp2::AppendLogRequest& req,
         cpp2::AppendLogResponse& resp);
 
@@ -392,7 +393,9 @@ private:
         LogID lastLogId,
         LogID committedId,
         TermID prevLogTerm,
-        LogID prevLogId);
+        LogID prevLogId,
+        // Fulfilled once the logs are synced into the local wal
+        folly::Future<bool> walSynced);
 
     void processAppendLogResponses(
         const AppendLogResponses& resps,
@@ -405,6 +408,9 @@ private:
         LogID prevLogId,
         std::vector<std::shared_ptr<Host>> hosts);
 
+    // Fail the replicating round whose logs are not synced into the local wal
+    void abortOnWalSyncFailure();
+
     // followers return Host of which could vote, in other words, learner is not counted in
     std::vector<std::shared_ptr<Host>> followers() const;
 
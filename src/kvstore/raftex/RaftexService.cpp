@@ -202,17 +202,30 @@ void RaftexService::askForVote(
 }
 
 
-void RaftexService::appendLog(
-        cpp2::AppendLogResponse& resp,
-        const cpp2::AppendLogRequest& req) {
+folly::Future<cpp2::AppendLogResponse>
+RaftexService::future_appendLog(const cpp2::AppendLogRequest& req) {
+    cpp2::AppendLogResponse resp;
     auto part = findPart(req.get_space(), req.get_part());
     if (!part) {
         // Not found
         resp.set_error_code(cpp2::ErrorCode::E_UNKNOWN_PART);
-        return;
+        return resp;
     }
 
-    part->processAppendLogRequest(req, resp);
+    // Respond once the logs are synced into the wal, the thread is not held in the meantime,
+    // so the appends of other parts join the same group commit. The logs are not acked unless
+    // they are durable.
+    auto synced = part->processAppendLogRequest(req, resp);
+    return std::move(synced).thenTry([resp = std::move(resp),
+                                      spaceId = req.get_space(),
+                                      partId = req.get_part()] (folly::Try<bool>&& t) mutable {
+        if (t.hasException() || !t.value()) {
+            LOG(ERROR) << "Failed to sync the wal of space " << spaceId << " part " << partId
+                       << ", the logs are not accepted";
+            resp.set_error_code(cpp2::ErrorCode::E_WAL_FAIL);
+        }
+        return std::move(resp);
+    });
 }
 
 void RaftexService::sendSnapshot(
@@ -42,8 +42,8 @@ public:
     void askForVote(cpp2::AskForVoteResponse& resp,
                     const cpp2::AskForVoteRequest& req) override;
 
-    void appendLog(cpp2::AppendLogResponse& resp,
-                   const cpp2::AppendLogRequest& req) override;
+    folly::Future<cpp2::AppendLogResponse>
+    future_appendLog(const cpp2::AppendLogRequest& req) override;
 
     void sendSnapshot(
         cpp2::SendSnapshotResponse& resp,
@@ -12,11 +12,15 @@
 #include "kvstore/raftex/RaftexService.h"
 #include "kvstore/raftex/test/RaftexTestBase.h"
 #include "kvstore/raftex/test/TestShard.h"
+#include "kvstore/wal/WalSyncer.h"
 #include <gtest/gtest.h>
 #include <folly/String.h>
 
 DECLARE_uint32(raft_heartbeat_interval_secs);
 DECLARE_uint32(max_batch_size);
+DECLARE_uint32(max_appendlog_batch_size);
+DECLARE_uint32(max_appendlog_inflight_batches);
+DECLARE_bool(wal_sync);
 
 namespace nebula {
 namespace raftex {
@@ -65,6 +69,217 @@ TEST(LogAppend, SimpleAppendWithThreeCopies) {
 }
 
 
+TEST(LogAppend, PipelinedAppend) {
+    // Small batches, so each round of the leader is sent as several requests in flight
+    FLAGS_max_appendlog_batch_size = 4;
+    FLAGS_max_appendlog_inflight_batches = 8;
+    fs::TempDir walRoot("/tmp/pipelined_append.XXXXXX");
+    std::shared_ptr<thread::GenericThreadPool> workers;
+    std::vector<std::string> wals;
+    std::vector<HostAddr> allHosts;
+    std::vector<std::shared_ptr<RaftexService>> services;
+    std::vector<std::shared_ptr<test::TestShard>> copies;
+
+    std::shared_ptr<test::TestShard> leader;
+    setupRaft(3, walRoot, workers, wals, allHosts, services, copies, leader);
+
+    // Check all hosts agree on the same leader
+    checkLeadership(copies, leader);
+
+    const int numLogs = 400;
+    FLAGS_max_batch_size = numLogs + 1;
+    folly::Future<AppendLogResult> last = folly::makeFuture(AppendLogResult::SUCCEEDED);
+    for (int i = 1; i <= numLogs; ++i) {
+        last = leader->appendAsync(0, folly::stringPrintf("Log %03d", i));
+    }
+    ASSERT_EQ(AppendLogResult::SUCCEEDED, std::move(last).get());
+
+    // Sleep a while to make sure the last log has been committed on
+    // followers
+    sleep(FLAGS_raft_heartbeat_interval_secs);
+
+    // Check every copy
+    for (auto& c : copies) {
+        ASSERT_EQ(numLogs, c->getNumLogs());
+    }
+    for (int i = 0; i < numLogs; ++i) {
+        folly::StringPiece msg;
+        ASSERT_TRUE(leader->getLogMsg(i, msg));
+        for (auto& c : copies) {
+            if (c != leader) {
+                folly::StringPiece log;
+                ASSERT_TRUE(c->getLogMsg(i, log));
+                ASSERT_EQ(msg, log);
+            }
+        }
+    }
+
+    finishRaft(services, copies, workers, leader);
+    FLAGS_max_appendlog_batch_size = 128;
+    FLAGS_max_appendlog_inflight_batches = 4;
+}
+
+TEST(LogAppend, ReorderedAppendResponses) {
+    FLAGS_max_appendlog_batch_size = 4;
+    FLAGS_max_appendlog_inflight_batches = 3;
+    fs::TempDir walRoot("/tmp/reordered_append_responses.XXXXXX");
+    std::shared_ptr<thread::GenericThreadPool> workers;
+    std::vector<std::string> wals;
+    std::vector<HostAddr> allHosts;
+    std::vector<std::shared_ptr<RaftexService>> services;
+    std::vector<std::shared_ptr<test::TestShard>> copies;
+
+    std::shared_ptr<test::TestShard> leader;
+    setupRaft(1, walRoot, workers, wals, allHosts, services, copies, leader);
+    checkLeadership(copies, leader);
+    folly::Future<AppendLogResult> last = folly::makeFuture(AppendLogResult::SUCCEEDED);
+    for (int i = 1; i <= 12; ++i) {
+        last = leader->appendAsync(0, folly::stringPrintf("Log %03d", i));
+    }
+    ASSERT_EQ(AppendLogResult::SUCCEEDED, std::move(last).get());
+    ASSERT_EQ(12, leader->wal()->lastLogId());
+
+    // The responses are fed to a host directly, as if the follower handled the requests of the
+    // window in any order
+    auto response = [] (cpp2::ErrorCode code, LogID lastLogId) {
+        cpp2::AppendLogResponse resp;
+        resp.set_error_code(code);
+        resp.set_last_log_id(lastLogId);
+        resp.set_last_log_term(1);
+        return folly::Try<cpp2::AppendLogResponse>(std::move(resp));
+    };
+    auto host = std::make_shared<Host>(HostAddr("127.0.0.1", 1), leader);
+    auto start = [&] {
+        CHECK(!host->lock_.try_lock());
+        host->requestOnGoing_ = true;
+        host->promise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
+        host->logIdToSend_ = 12;
+        host->logTermToSend_ = 1;
+        host->lastLogIdSent_ = 0;
+        host->lastLogTermSent_ = 0;
+        host->newEpoch();
+        auto reqs = host->prepareWindow();
+        EXPECT_EQ(3, reqs.size());
+        return host->promise_.getFuture();
+    };
+    auto handle = [&] (folly::Try<cpp2::AppendLogResponse>&& t, LogID prevLogId) {
+        CHECK(!host->lock_.try_lock());
+        host->inflight_--;
+        return host->handleResponse(std::move(t), prevLogId);
+    };
+
+    {
+        LOG(INFO) << "The second request is handled first and finds a gap";
+        std::lock_guard<std::mutex> g(host->lock_);
+        auto future = start();
+        EXPECT_TRUE(handle(response(cpp2::ErrorCode::E_LOG_GAP, 0), 4).empty());
+        EXPECT_TRUE(handle(response(cpp2::ErrorCode::SUCCEEDED, 4), 0).empty());
+        // The last response in flight, only log 4 is stored
+        auto reqs = handle(response(cpp2::ErrorCode::E_LOG_GAP, 4), 8);
+        EXPECT_FALSE(future.isReady());
+        ASSERT_FALSE(reqs.empty());
+        EXPECT_EQ(4, reqs[0]->get_last_log_id_sent());
+
+        EXPECT_EQ(2, reqs.size());
+        // The window is full till the end
+        EXPECT_TRUE(handle(response(cpp2::ErrorCode::SUCCEEDED, 8), 4).empty());
+        EXPECT_FALSE(future.isReady());
+        handle(response(cpp2::ErrorCode::SUCCEEDED, 12), 8);
+        ASSERT_TRUE(future.isReady());
+        EXPECT_EQ(cpp2::ErrorCode::SUCCEEDED, std::move(future).get().get_error_code());
+    }
+    {
+        LOG(INFO) << "The first request is dropped";
+        std::lock_guard<std::mutex> g(host->lock_);
+        auto future = start();
+        folly::exception_wrapper dropped(std::runtime_error("dropped"));
+        EXPECT_TRUE(handle(folly::Try<cpp2::AppendLogResponse>(dropped), 0).empty());
+        EXPECT_TRUE(handle(response(cpp2::ErrorCode::E_LOG_GAP, 0), 4).empty());
+        auto reqs = handle(response(cpp2::ErrorCode::E_LOG_GAP, 0), 8);
+        EXPECT_FALSE(future.isReady());
+        ASSERT_FALSE(reqs.empty());
+        EXPECT_EQ(0, reqs[0]->get_last_log_id_sent());
+        host->newEpoch();
+        host->requestOnGoing_ = false;
+    }
+
+    finishRaft(services, copies, workers, leader);
+    FLAGS_max_appendlog_batch_size = 128;
+    FLAGS_max_appendlog_inflight_batches = 4;
+}
+
+TEST(LogAppend, WalSyncFailure) {
+    FLAGS_wal_sync = true;
+    fs::TempDir walRoot("/tmp/wal_sync_failure.XXXXXX");
+    std::shared_ptr<thread::GenericThreadPool> workers;
+    std::vector<std::string> wals;
+    std::vector<HostAddr> allHosts;
+    std::vector<std::shared_ptr<RaftexService>> services;
+    std::vector<std::shared_ptr<test::TestShard>> copies;
+
+    std::shared_ptr<test::TestShard> leader;
+    setupRaft(3, walRoot, workers, wals, allHosts, services, copies, leader);
+    checkLeadership(copies, leader);
+
+    std::vector<std::string> msgs;
+    appendLogs(0, 9, leader, msgs);
+    checkConsensus(copies, 0, 9, msgs);
+
+    // All wals are on one disk, so they share the syncer
+    auto syncer = wal::WalSyncer::get(walRoot.path());
+    ASSERT_NE(nullptr, syncer);
+    {
+        std::lock_guard<std::mutex> g(syncer->lock_);
+        syncer->failSyncs_ = true;
+    }
+
+    {
+        LOG(INFO) << "A follower does not ack the logs which fail to sync";
+        size_t idx = 0;
+        while (copies[idx] == leader) {
+            idx++;
+        }
+        auto follower = copies[idx];
+        cpp2::AppendLogRequest req;
+        req.set_space(follower->spaceId());
+        req.set_part(follower->partitionId());
+        req.set_current_term(leader->termId());
+        req.set_last_log_id(follower->wal()->lastLogId() + 1);
+        req.set_leader_addr(leader->address().host);
+        req.set_leader_port(leader->address().port);
+        req.set_committed_log_id(leader->wal()->lastLogId());
+        req.set_last_log_term_sent(follower->wal()->lastLogTerm());
+        req.set_last_log_id_sent(follower->wal()->lastLogId());
+        req.set_log_term(leader->termId());
+        cpp2::LogEntry le;
+        le.set_cluster(0);
+        le.set_log_str("Not synced");
+        req.set_log_str_list({le});
+        req.set_sending_snapshot(false);
+        auto resp = services[idx]->future_appendLog(req).get();
+        EXPECT_EQ(cpp2::ErrorCode::E_WAL_FAIL, resp.get_error_code());
+    }
+    {
+        LOG(INFO) << "The leader does not commit the logs which fail to sync";
+        auto lastLogId = leader->wal()->lastLogId();
+        auto ret = leader->appendAsync(0, "Not synced").get();
+        EXPECT_EQ(AppendLogResult::E_WAL_FAILURE, ret);
+        EXPECT_EQ(lastLogId, leader->wal()->lastLogId());
+    }
+
+    {
+        std::lock_guard<std::mutex> g(syncer->lock_);
+        syncer->failSyncs_ = false;
+    }
+    sleep(FLAGS_raft_heartbeat_interval_secs);
+    for (auto& c : copies) {
+        EXPECT_EQ(msgs.size(), c->getNumLogs());
+    }
+
+    finishRaft(services, copies, workers, leader);
+    FLAGS_wal_sync = false;
+}
+
 TEST(LogAppend, MultiThreadAppend) {
     fs::TempDir walRoot("/tmp/multi_thread_append.XXXXXX");
     std::shared_ptr<thread::GenericThreadPool> workers;
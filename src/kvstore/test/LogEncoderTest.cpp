@@ -121,6 +121,19 @@ TEST(LogEncoderTest, KVTest) {
     ASSERT_EQ("KV_val", decoded.second);
 }
 
+TEST(LogEncoderTest, SstChunkTest) {
+    auto encoded = encodeSstChunk(3, true, "sst_data");
+    ASSERT_TRUE(isSstChunk(encoded));
+    auto chunk = decodeSstChunk(encoded);
+    ASSERT_EQ(3, chunk.fileIndex);
+    ASSERT_TRUE(chunk.last);
+    ASSERT_EQ("sst_data", chunk.data);
+
+    // an encoded kv is never taken as a sst chunk
+    ASSERT_FALSE(isSstChunk(encodeKV("KV_key", "KV_val")));
+    ASSERT_FALSE(isSstChunk(encodeKV("", "")));
+}
+
 TEST(LogEncoderTest, HostTest) {
     auto encoded = encodeHost(OP_ADD_LEARNER, HostAddr("1.1.1.1", 1));
     auto decoded = decodeHost(OP_ADD_LEARNER, encoded);
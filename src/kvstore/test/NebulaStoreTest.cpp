@@ -18,8 +18,14 @@
 #include "kvstore/RocksEngine.h"
 #include "kvstore/LogEncoder.h"
 #include "meta/ActiveHostsMan.h"
+#include "utils/NebulaKeyUtils.h"
 
 DECLARE_uint32(raft_heartbeat_interval_secs);
+DECLARE_bool(snapshot_send_sst);
+DECLARE_int32(snapshot_batch_size);
+DECLARE_int64(snapshot_sst_file_size);
+DECLARE_int64(wal_file_size);
+DECLARE_int32(wal_ttl);
 const int32_t kDefaultVidLen = 8;
 using nebula::meta::PartHosts;
 
@@ -798,6 +804,137 @@ TEST(NebulaStoreTest, ThreeCopiesCheckpointTest) {
     }
 }
 
+TEST(NebulaStoreTest, SnapshotSendSstTest) {
+    // Each table is sent as several sst files, and each file in several chunks
+    FLAGS_snapshot_send_sst = true;
+    FLAGS_snapshot_sst_file_size = 16 * 1024;
+    FLAGS_snapshot_batch_size = 4 * 1024;
+    FLAGS_wal_file_size = 1024;
+    fs::TempDir rootPath("/tmp/nebula_store_test.XXXXXX");
+    const GraphSpaceID spaceId = 0;
+    const PartitionID partId = 1;
+    auto initNebulaStore = [&](const std::vector<HostAddr>& peers,
+                               int32_t index) -> std::unique_ptr<NebulaStore> {
+        LOG(INFO) << "Start nebula store on " << peers[index];
+        auto sIoThreadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+        auto partMan = std::make_unique<MemPartManager>();
+        PartHosts pm;
+        pm.spaceId_ = spaceId;
+        pm.partId_ = partId;
+        pm.hosts_ = peers;
+        partMan->partsMap_[spaceId][partId] = std::move(pm);
+        std::vector<std::string> paths;
+        paths.emplace_back(folly::stringPrintf("%s/disk%d", rootPath.path(), index));
+        KVOptions options;
+        options.dataPaths_ = paths;
+        options.partMan_ = std::move(partMan);
+        auto store = std::make_unique<NebulaStore>(std::move(options),
+                                                   sIoThreadPool,
+                                                   peers[index],
+                                                   getHandlers());
+        store->init();
+        return store;
+    };
+    auto prefix = NebulaKeyUtils::vertexPrefix(partId);
+    auto countVertices = [&] (NebulaStore* store) {
+        std::unique_ptr<KVIterator> iter;
+        auto code = store->prefix(spaceId, partId, prefix, &iter, true);
+        EXPECT_EQ(ResultCode::SUCCEEDED, code);
+        int32_t num = 0;
+        while (iter && iter->valid()) {
+            EXPECT_EQ(NebulaKeyUtils::vertexKey(kDefaultVidLen,
+                                                partId,
+                                                folly::stringPrintf("%08d", num),
+                                                1),
+                      iter->key());
+            EXPECT_EQ(folly::stringPrintf("%0128d", num), iter->val());
+            iter->next();
+            num++;
+        }
+        return num;
+    };
+
+    int32_t replicas = 3;
+    std::vector<HostAddr> peers;
+    for (int32_t i = 0; i < replicas; i++) {
+        peers.emplace_back("127.0.0.1", network::NetworkUtils::getAvailablePort());
+    }
+    // The last peer is down for now
+    std::vector<std::unique_ptr<NebulaStore>> stores;
+    for (int32_t i = 0; i < replicas - 1; i++) {
+        stores.emplace_back(initNebulaStore(peers, i));
+    }
+    LOG(INFO) << "Waiting for the leader elected!";
+    NebulaStore* leader = nullptr;
+    while (leader == nullptr) {
+        for (auto& store : stores) {
+            nebula::meta::ActiveHostsMan::AllLeaders leaderIds;
+            if (store->allLeader(leaderIds) == 1) {
+                leader = store.get();
+            }
+        }
+        usleep(100000);
+    }
+
+    const int32_t kVertices = 1000;
+    for (int32_t batch = 0; batch < 10; batch++) {
+        std::vector<KV> data;
+        for (auto i = batch * 100; i < batch * 100 + 100; i++) {
+            data.emplace_back(NebulaKeyUtils::vertexKey(kDefaultVidLen,
+                                                        partId,
+                                                        folly::stringPrintf("%08d", i),
+                                                        1),
+                              folly::stringPrintf("%0128d", i));
+        }
+        folly::Baton<true, std::atomic> baton;
+        leader->asyncMultiPut(spaceId, partId, std::move(data), [&baton](ResultCode code) {
+            EXPECT_EQ(ResultCode::SUCCEEDED, code);
+            baton.post();
+        });
+        baton.wait();
+    }
+    ASSERT_EQ(kVertices, countVertices(leader));
+
+    LOG(INFO) << "Clean the wal of leader, the last peer can only catch up by snapshot";
+    FLAGS_wal_ttl = 1;
+    sleep(FLAGS_wal_ttl + 1);
+    auto part = leader->part(spaceId, partId);
+    ASSERT_TRUE(ok(part));
+    value(part)->wal()->cleanWAL();
+    ASSERT_LT(1, value(part)->wal()->firstLogId());
+    FLAGS_wal_ttl = 14400;
+
+    stores.emplace_back(initNebulaStore(peers, replicas - 1));
+    auto* follower = stores.back().get();
+    for (int32_t retry = 0; retry < 50; retry++) {
+        std::unique_ptr<KVIterator> iter;
+        follower->prefix(spaceId, partId, prefix, &iter, true);
+        if (iter != nullptr && iter->valid()) {
+            // Wait for the rest of snapshot
+            sleep(FLAGS_raft_heartbeat_interval_secs);
+            break;
+        }
+        usleep(100000);
+    }
+    EXPECT_EQ(kVertices, countVertices(follower));
+
+    // No sst file is left on both sides
+    for (int32_t i = 0; i < replicas; i++) {
+        auto engine = stores[i]->engine(spaceId, partId);
+        ASSERT_TRUE(ok(engine));
+        auto root = value(engine)->getDataRoot();
+        for (auto dir : {"snapshot_send", "snapshot"}) {
+            auto path = folly::stringPrintf("%s/%s", root, dir);
+            EXPECT_TRUE(fs::FileUtils::listAllFilesInDir(path.c_str(), false, "*.sst").empty());
+        }
+    }
+
+    FLAGS_snapshot_send_sst = false;
+    FLAGS_snapshot_sst_file_size = 64 * 1024 * 1024;
+    FLAGS_snapshot_batch_size = 1024 * 1024 * 10;
+    FLAGS_wal_file_size = 16 * 1024 * 1024;
+}
+
 TEST(NebulaStoreTest, AtomicOpBatchTest) {
     auto partMan = std::make_unique<MemPartManager>();
     auto ioThreadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
@@ -10,6 +10,9 @@
 #include <rocksdb/db.h>
 #include <folly/lang/Bits.h>
 #include "kvstore/RocksEngine.h"
+#include "kvstore/RocksEngineConfig.h"
+#include "utils/IndexKeyUtils.h"
+#include "utils/NebulaKeyUtils.h"
 
 namespace nebula {
 namespace kvstore {
@@ -115,6 +118,82 @@ TEST(RocksEngineTest, PrefixTest) {
 }
 
 
+TEST(RocksEngineTest, PrefixSeekTest) {
+    fs::TempDir rootPath("/tmp/rocksdb_engine_PrefixSeekTest.XXXXXX");
+    auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
+    std::vector<KV> data;
+    for (int32_t i = 0; i < 10;  i++) {
+        data.emplace_back(folly::stringPrintf("k_a_%d", i), folly::stringPrintf("val_%d", i));
+        data.emplace_back(folly::stringPrintf("k_c_%d", i), folly::stringPrintf("val_%d", i));
+    }
+    data.emplace_back("l_a_0", "val_0");
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->multiPut(std::move(data)));
+
+    std::string prefix = "k_";
+    std::unique_ptr<KVIterator> iter;
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix(prefix, &iter));
+    ASSERT_TRUE(iter->valid());
+    EXPECT_EQ("k_a_0", iter->key());
+
+    LOG(INFO) << "Seek forward to a key not existed";
+    iter->seek("k_b");
+    ASSERT_TRUE(iter->valid());
+    EXPECT_EQ("k_c_0", iter->key());
+
+    LOG(INFO) << "Seek backward";
+    iter->seek("k_a_5");
+    ASSERT_TRUE(iter->valid());
+    EXPECT_EQ("k_a_5", iter->key());
+
+    LOG(INFO) << "Seek beyond the prefix";
+    iter->seek("k_d");
+    EXPECT_FALSE(iter->valid());
+}
+
+TEST(RocksEngineTest, PrefixFilterTest) {
+    FLAGS_enable_rocksdb_prefix_filtering = true;
+    fs::TempDir rootPath("/tmp/rocksdb_engine_PrefixFilterTest.XXXXXX");
+    auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
+    std::vector<KV> data;
+    for (int32_t i = 0; i < 10; i++) {
+        auto vId = folly::stringPrintf("v%d", i);
+        for (TagID tagId = 1; tagId <= 2; tagId++) {
+            data.emplace_back(NebulaKeyUtils::vertexKey(kDefaultVIdLen, 1, vId, tagId), "");
+        }
+        for (EdgeType edgeType = 101; edgeType <= 102; edgeType++) {
+            data.emplace_back(NebulaKeyUtils::edgeKey(kDefaultVIdLen, 1, vId, edgeType, 0, "d"),
+                              "");
+        }
+        data.emplace_back(IndexKeyUtils::vertexIndexKey(kDefaultVIdLen, 1, 7, vId, "val"), "");
+    }
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->multiPut(data));
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->flush());
+
+    auto count = [&engine] (const std::string& prefix) {
+        std::unique_ptr<KVIterator> iter;
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix(prefix, &iter));
+        size_t num = 0;
+        for (; iter->valid(); iter->next()) {
+            num++;
+        }
+        return num;
+    };
+    // prefixes as long as the extracted ones
+    EXPECT_EQ(2, count(NebulaKeyUtils::vertexPrefix(kDefaultVIdLen, 1, "v1")));
+    EXPECT_EQ(1, count(NebulaKeyUtils::edgePrefix(kDefaultVIdLen, 1, "v1", 101)));
+    EXPECT_EQ(10, count(IndexKeyUtils::indexPrefix(1, 7)));
+    EXPECT_EQ(0, count(NebulaKeyUtils::vertexPrefix(kDefaultVIdLen, 1, "v10")));
+    EXPECT_EQ(0, count(NebulaKeyUtils::edgePrefix(kDefaultVIdLen, 1, "v1", 103)));
+    // longer prefixes
+    EXPECT_EQ(1, count(NebulaKeyUtils::vertexPrefix(kDefaultVIdLen, 1, "v1", 2)));
+    // shorter prefixes span several extracted prefixes
+    EXPECT_EQ(2, count(NebulaKeyUtils::edgePrefix(kDefaultVIdLen, 1, "v1")));
+    EXPECT_EQ(20, count(NebulaKeyUtils::edgePrefix(1)));
+    EXPECT_EQ(20, count(NebulaKeyUtils::vertexPrefix(1)));
+    EXPECT_EQ(10, count(IndexKeyUtils::indexPrefix(1)));
+    FLAGS_enable_rocksdb_prefix_filtering = false;
+}
+
 TEST(RocksEngineTest, RemoveTest) {
     fs::TempDir rootPath("/tmp/rocksdb_engine_RemoveTest.XXXXXX");
     auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
@@ -200,6 +279,63 @@ TEST(RocksEngineTest, CompactTest) {
     EXPECT_EQ(ResultCode::SUCCEEDED, engine->compact());
 }
 
+TEST(RocksEngineTest, SplitRangeTest) {
+    fs::TempDir rootPath("/tmp/rocksdb_engine_SplitRangeTest.XXXXXX");
+    auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
+    EXPECT_EQ(ResultCode::SUCCEEDED,
+              engine->setOption("disable_auto_compactions", "true"));
+    // Nothing is on disk yet
+    EXPECT_TRUE(engine->splitRange("key_", "key~", 4).empty());
+
+    // Each flush writes a sst file of 100 keys
+    for (int32_t i = 0; i < 8; i++) {
+        std::vector<KV> data;
+        for (int32_t j = i * 100; j < (i + 1) * 100; j++) {
+            data.emplace_back(folly::stringPrintf("key_%04d", j),
+                              folly::stringPrintf("value_%d", j));
+        }
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->multiPut(std::move(data)));
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->flush());
+    }
+
+    EXPECT_TRUE(engine->splitRange("key_", "key~", 1).empty());
+    auto keys = engine->splitRange("key_", "key~", 4);
+    ASSERT_EQ(3, keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        EXPECT_LT("key_", keys[i]);
+        EXPECT_GT("key~", keys[i]);
+        if (i > 0) {
+            EXPECT_LT(keys[i - 1], keys[i]);
+        }
+    }
+
+    // Only the files in the range count
+    keys = engine->splitRange("key_0400", "key_0800", 2);
+    ASSERT_EQ(1, keys.size());
+    EXPECT_LT("key_0400", keys[0]);
+    EXPECT_GT("key_0800", keys[0]);
+}
+
+TEST(RocksEngineTest, ApproximateSizeTest) {
+    fs::TempDir rootPath("/tmp/rocksdb_engine_ApproximateSizeTest.XXXXXX");
+    auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
+    EXPECT_EQ(0, engine->approximateSize("key_", "key~"));
+
+    std::vector<KV> data;
+    for (int32_t i = 0; i < 1000; i++) {
+        data.emplace_back(folly::stringPrintf("key_%04d", i), std::string(100, 'v'));
+    }
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->multiPut(std::move(data)));
+    // The keys in memtable count as well
+    EXPECT_LT(0, engine->approximateSize("key_", "key~"));
+
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->flush());
+    auto total = engine->approximateSize("key_", "key~");
+    EXPECT_LT(0, total);
+    EXPECT_GE(total, engine->approximateSize("key_0000", "key_0500"));
+    EXPECT_EQ(0, engine->approximateSize("other_", "other~"));
+}
+
 TEST(RocksEngineTest, IngestTest) {
     rocksdb::Options options;
     rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), options);
@@ -226,6 +362,111 @@ TEST(RocksEngineTest, IngestTest) {
     EXPECT_EQ(ResultCode::ERR_KEY_NOT_FOUND, engine->get("key_not_exist", &result));
 }
 
+TEST(RocksEngineTest, ColumnFamilyPerKeyTypeTest) {
+    FLAGS_rocksdb_column_family_per_key_type = true;
+    fs::TempDir rootPath("/tmp/rocksdb_engine_ColumnFamilyTest.XXXXXX");
+    auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
+    ASSERT_TRUE(engine->columnFamilyPerKeyType());
+
+    std::vector<KV> data;
+    for (int32_t i = 0; i < 10; i++) {
+        auto vId = folly::stringPrintf("v%d", i);
+        data.emplace_back(NebulaKeyUtils::vertexKey(kDefaultVIdLen, 1, vId, 1), "vertex");
+        data.emplace_back(NebulaKeyUtils::edgeKey(kDefaultVIdLen, 1, vId, 101, 0, "dst"), "edge");
+        data.emplace_back(NebulaKeyUtils::kvKey(1, vId), "kv");
+    }
+    // not of any key type, which is in the default column family
+    data.emplace_back("\xff_other", "other");
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->multiPut(data));
+    std::sort(data.begin(), data.end());
+
+    auto* vertexCf = engine->columnFamily(data.front().first);
+    EXPECT_NE(vertexCf, engine->columnFamily(NebulaKeyUtils::edgePrefix(1)));
+    EXPECT_EQ("vertex", vertexCf->GetName());
+    EXPECT_EQ(rocksdb::kDefaultColumnFamilyName, engine->columnFamily("\xff")->GetName());
+
+    auto checkIter = [] (KVIterator* iter, const std::vector<KV>& expected) {
+        size_t count = 0;
+        for (; iter->valid(); iter->next(), count++) {
+            ASSERT_LT(count, expected.size());
+            EXPECT_EQ(expected[count].first, iter->key());
+            EXPECT_EQ(expected[count].second, iter->val());
+        }
+        EXPECT_EQ(expected.size(), count);
+    };
+    {
+        LOG(INFO) << "The whole db, in the order of keys across column families";
+        std::unique_ptr<KVIterator> iter;
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix("", &iter));
+        checkIter(iter.get(), data);
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->range("", "\xff\xff", &iter));
+        checkIter(iter.get(), data);
+    }
+    {
+        LOG(INFO) << "A range of vertices and edges";
+        std::unique_ptr<KVIterator> iter;
+        EXPECT_EQ(ResultCode::SUCCEEDED,
+                  engine->range(data[5].first, data[15].first, &iter));
+        checkIter(iter.get(), std::vector<KV>(data.begin() + 5, data.begin() + 15));
+
+        // seek backward into another column family
+        iter->seek(data[3].first);
+        ASSERT_TRUE(iter->valid());
+        EXPECT_EQ(data[5].first, iter->key());
+        iter->seek(data[12].first);
+        ASSERT_TRUE(iter->valid());
+        EXPECT_EQ(data[12].first, iter->key());
+        iter->prev();
+        iter->prev();
+        iter->prev();
+        ASSERT_TRUE(iter->valid());
+        EXPECT_EQ(data[9].first, iter->key());
+    }
+    {
+        LOG(INFO) << "Prefix in one column family";
+        std::unique_ptr<KVIterator> iter;
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix(NebulaKeyUtils::edgePrefix(1), &iter));
+        checkIter(iter.get(), std::vector<KV>(data.begin() + 10, data.begin() + 20));
+    }
+    {
+        LOG(INFO) << "Remove a range across column families";
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->removeRange(data[5].first, data[15].first));
+        std::unique_ptr<KVIterator> iter;
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->range(data[0].first, data[20].first, &iter));
+        std::vector<KV> expected(data.begin(), data.begin() + 5);
+        expected.insert(expected.end(), data.begin() + 15, data.begin() + 20);
+        checkIter(iter.get(), expected);
+    }
+    {
+        LOG(INFO) << "Ingest a file with keys of several types";
+        rocksdb::Options options;
+        rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), options);
+        auto file = folly::stringPrintf("%s/%s", rootPath.path(), "data.sst");
+        ASSERT_TRUE(writer.Open(file).ok());
+        ASSERT_TRUE(writer.Put(data[5].first, "ingested").ok());
+        ASSERT_TRUE(writer.Put(data[25].first, "ingested").ok());
+        ASSERT_TRUE(writer.Finish().ok());
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->ingest({file}));
+
+        std::string value;
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->get(data[5].first, &value));
+        EXPECT_EQ("ingested", value);
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->get(data[25].first, &value));
+        EXPECT_EQ("ingested", value);
+    }
+
+    LOG(INFO) << "Reopen without the flag, the column families are kept";
+    engine.reset();
+    FLAGS_rocksdb_column_family_per_key_type = false;
+    engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
+    EXPECT_TRUE(engine->columnFamilyPerKeyType());
+    std::string value;
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->get(data.back().first, &value));
+    EXPECT_EQ("other", value);
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->get(data[20].first, &value));
+    EXPECT_EQ("kv", value);
+}
+
 TEST(RocksEngineTest, BackupRestoreTable) {
     rocksdb::Options options;
     rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), options);
@@ -14,7 +14,11 @@
 DEFINE_int32(wal_ttl, 14400, "Default wal ttl");
 DEFINE_int64(wal_file_size, 16 * 1024 * 1024, "Default wal file size");
 DEFINE_int32(wal_buffer_size, 8 * 1024 * 1024, "Default wal buffer size");
-DEFINE_bool(wal_sync, false, "Whether fsync needs to be called every write");
+DEFINE_int32(wal_read_buffer_size, 1024 * 1024,
+             "The size of the block read at once when reading logs from the wal files");
+DEFINE_bool(wal_sync, false, "Whether the logs need to be synced on every append");
+DEFINE_bool(wal_group_commit, true, "Whether to sync the wals on the same disk by a shared "
+                                    "thread in group, only works when wal_sync is on");
 
 namespace nebula {
 namespace wal {
@@ -53,6 +57,9 @@ FileBasedWal::FileBasedWal(const folly::StringPiece dir,
     }
 
     logBuffer_ = AtomicLogBuffer::instance(policy_.bufferSize);
+    if (policy_.sync && FLAGS_wal_group_commit) {
+        syncer_ = WalSyncer::get(dir_);
+    }
     scanAllWalFiles();
     if (!walFiles_.empty()) {
         firstLogId_ = walFiles_.begin()->second->firstId();
@@ -290,11 +297,16 @@ void FileBasedWal::closeCurrFile() {
         return;
     }
 
-    if (!policy_.sync) {
-        if (::fsync(currFd_) == -1) {
-            LOG(WARNING) << "sync wal \"" << currInfo_->path()
-                         << "\" failed, error: " << strerror(errno);
-        }
+    // The syncer may still hold the fd
+    {
+        std::unique_lock<std::mutex> g(syncLock_);
+        syncCond_.wait(g, [this] { return inflightSyncs_ == 0; });
+    }
+
+    // The wal may roll over in the middle of appendLogs, which has not synced yet
+    if (::fsync(currFd_) == -1) {
+        LOG(WARNING) << "sync wal \"" << currInfo_->path()
+                     << "\" failed, error: " << strerror(errno);
     }
 
     // Close the file
@@ -540,10 +552,6 @@ bool FileBasedWal::appendLogInternal(LogID id,
                    << ", error:" << strerror(errno);
     }
 
-    if (policy_.sync && ::fsync(currFd_) == -1) {
-        LOG(WARNING) << "sync wal \"" << currInfo_->path()
-                     << "\" failed, error: " << strerror(errno);
-    }
     currInfo_->setSize(currInfo_->size() + strBuf.size());
     currInfo_->setLastId(id);
     currInfo_->setLastTerm(term);
@@ -567,6 +575,7 @@ bool FileBasedWal::appendLog(LogID id,
         LOG(ERROR) << "Failed to append log for logId " << id;
         return false;
     }
+    syncCurrFile();
     return true;
 }
 
@@ -579,14 +588,50 @@ bool FileBasedWal::appendLogs(LogIterator& iter) {
                                iter.logMsg().toString())) {
             LOG(ERROR) << idStr_ << "Failed to append log for logId "
                        << iter.logId();
+            syncCurrFile();
             return false;
         }
     }
 
+    syncCurrFile();
     return true;
 }
 
 
+void FileBasedWal::syncCurrFile() {
+    if (!policy_.sync || syncer_ != nullptr || currFd_ < 0) {
+        // With the group commit, the caller syncs the logs by sync()
+        return;
+    }
+    if (::fdatasync(currFd_) != 0) {
+        LOG(WARNING) << idStr_ << "sync wal \"" << currInfo_->path() << "\" failed";
+    }
+}
+
+
+folly::Future<bool> FileBasedWal::sync() {
+    if (syncer_ == nullptr || currFd_ < 0) {
+        // Synced in the append already, or nothing to sync
+        return true;
+    }
+    {
+        std::lock_guard<std::mutex> g(syncLock_);
+        inflightSyncs_++;
+    }
+    return syncer_->sync(currFd_).thenTry([this] (folly::Try<bool>&& t) {
+        bool ok = t.hasValue() && t.value();
+        if (!ok) {
+            LOG(WARNING) << idStr_ << "sync wal failed";
+        }
+        // The wal may be destroyed once the count drops to zero, so notify under the lock
+        std::lock_guard<std::mutex> g(syncLock_);
+        inflightSyncs_--;
+        syncCond_.notify_all();
+        return ok;
+    });
+}
+
+
 std::unique_ptr<LogIterator> FileBasedWal::iterator(LogID firstLogId,
                                                     LogID lastLogId) {
     auto iter = logBuffer_->iterator(firstLogId, lastLogId);
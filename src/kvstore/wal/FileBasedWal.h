@@ -14,6 +14,7 @@
 #include "kvstore/wal/Wal.h"
 #include "kvstore/wal/WalFileInfo.h"
 #include "kvstore/wal/AtomicLogBuffer.h"
+#include "kvstore/wal/WalSyncer.h"
 
 namespace nebula {
 namespace wal {
@@ -26,7 +27,8 @@ struct FileBasedWalPolicy {
     // Size of each buffer (in byte)
     size_t bufferSize = 8 * 1024L * 1024L;
 
-    // Whether fsync needs to be called every write
+    // Whether the logs need to be synced to disk before an append returns.
+    // All logs of one append are synced together
     bool sync = false;
 };
 
@@ -90,6 +92,14 @@ public:
     // simultaneously
     bool appendLogs(LogIterator& iter) override;
 
+    // With the group commit on, the appends above only write the logs into page cache.
+    // The returned future is fulfilled once all logs appended so far have reached disk,
+    // the caller chains it instead of waiting, so that the appends of other parts in the
+    // meantime share the same fdatasync. Otherwise the logs are synced in the append, and
+    // the future is ready already.
+    // This method **IS NOT** thread-safe, it is called by the thread appending logs
+    folly::Future<bool> sync();
+
     // Rollback to the given ID, all logs after the ID will be discarded
     // This method **IS NOT** thread-safe
     // we **EXPECT** the thread rolling back logs is the same one
@@ -151,6 +161,9 @@ private:
                            ClusterID cluster,
                            std::string msg);
 
+    // Sync the current wal file to disk if policy_.sync is on, and no syncer is used
+    void syncCurrFile();
+
 
 private:
     using WalFiles = std::map<LogID, WalFileInfoPtr>;
@@ -186,6 +199,14 @@ private:
 
     PreProcessor preProcessor_;
 
+    // Shared by all wals on the same disk, only set when policy_.sync is on
+    std::shared_ptr<WalSyncer> syncer_;
+    // Number of syncs handed to the syncer and not finished yet, the current file is not
+    // closed until they are done
+    std::mutex syncLock_;
+    std::condition_variable syncCond_;
+    int32_t inflightSyncs_{0};
+
     folly::RWSpinLock rollbackLock_;
 };
 
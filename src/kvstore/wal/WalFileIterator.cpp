@@ -9,6 +9,8 @@
 #include "kvstore/wal/WalFileInfo.h"
 #include "kvstore/wal/WalFileIterator.h"
 
+DECLARE_int32(wal_read_buffer_size);
+
 namespace nebula {
 namespace wal {
 
@@ -48,6 +50,7 @@ WalFileIterator::WalFileIterator(
             currId_ = lastId_ + 1;
             return false;
         }
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
         fds_.push_front(fd);
         idRanges_.push_front(std::make_pair(info->firstId(), info->lastId()));
 
@@ -77,32 +80,10 @@ WalFileIterator::WalFileIterator(
     }
 
     if (!idRanges_.empty()) {
+        prefetchNextFile();
         // Find the correct position in the first WAL file
         currPos_ = 0;
-        while (true) {
-            LogID logId;
-            // Read the logID
-            int fd = fds_.front();
-            CHECK_EQ(pread(fd,
-                           reinterpret_cast<char*>(&logId),
-                           sizeof(LogID),
-                           currPos_),
-                     static_cast<ssize_t>(sizeof(LogID)));
-            // Read the termID
-            CHECK_EQ(pread(fd,
-                           reinterpret_cast<char*>(&currTerm_),
-                           sizeof(TermID),
-                           currPos_ + sizeof(LogID)),
-                     static_cast<ssize_t>(sizeof(TermID)));
-            // Read the log length
-            CHECK_EQ(pread(fd,
-                           reinterpret_cast<char*>(&currMsgLen_),
-                           sizeof(int32_t),
-                           currPos_ + sizeof(LogID) + sizeof(TermID)),
-                     static_cast<ssize_t>(sizeof(int32_t)));
-            if (logId == currId_) {
-                break;
-            }
+        while (readHead() != currId_) {
             currPos_ += sizeof(LogID)
                         + sizeof(TermID)
                         + sizeof(int32_t) * 2
@@ -143,6 +124,8 @@ LogIterator& WalFileIterator::operator++() {
         nextFirstId_ = getFirstIdInNextFile();
         CHECK_EQ(currId_, idRanges_.front().first);
         currPos_ = 0;
+        bufLen_ = 0;
+        prefetchNextFile();
     } else {
         // Move to the next log
         currPos_ += sizeof(LogID)
@@ -157,27 +140,8 @@ LogIterator& WalFileIterator::operator++() {
         currId_ = lastId_ + 1;
         return *this;
     } else {
-        LogID logId;
-        int fd = fds_.front();
-        // Read the logID
-        CHECK_EQ(pread(fd,
-                       reinterpret_cast<char*>(&logId),
-                       sizeof(LogID),
-                       currPos_),
-                 static_cast<ssize_t>(sizeof(LogID))) << "currPos = " << currPos_;
-        CHECK_EQ(currId_, logId);
-        // Read the termID
-        CHECK_EQ(pread(fd,
-                       reinterpret_cast<char*>(&currTerm_),
-                       sizeof(TermID),
-                       currPos_ + sizeof(LogID)),
-                 static_cast<ssize_t>(sizeof(TermID)));
-        // Read the log length
-        CHECK_EQ(pread(fd,
-                       reinterpret_cast<char*>(&currMsgLen_),
-                       sizeof(int32_t),
-                       currPos_ + sizeof(TermID) + sizeof(LogID)),
-                 static_cast<ssize_t>(sizeof(int32_t)));
+        LogID logId = readHead();
+        CHECK_EQ(currId_, logId) << "currPos = " << currPos_;
     }
 
     return *this;
@@ -200,44 +164,65 @@ TermID WalFileIterator::logTerm() const {
 
 
 ClusterID WalFileIterator::logSource() const {
-            // Retrieve from the file
-    DCHECK(!fds_.empty());
     ClusterID cluster = 0;
-    CHECK_EQ(pread(fds_.front(),
-                   &(cluster),
-                   sizeof(ClusterID),
-                   currPos_
-                    + sizeof(LogID)
-                    + sizeof(TermID)
-                    + sizeof(int32_t)),
-             static_cast<ssize_t>(sizeof(ClusterID)))
-        << "Failed to read. Curr position is " << currPos_
-        << ", expected read length is " << sizeof(ClusterID)
-        << " (errno: " << errno << "): " << strerror(errno);
-
+    memcpy(&cluster,
+           read(currPos_ + sizeof(LogID) + sizeof(TermID) + sizeof(int32_t), sizeof(ClusterID)),
+           sizeof(ClusterID));
     return cluster;
 }
 
 
 folly::StringPiece WalFileIterator::logMsg() const {
-    // Retrieve from the file
+    auto* msg = read(currPos_
+                      + sizeof(LogID)
+                      + sizeof(TermID)
+                      + sizeof(int32_t)
+                      + sizeof(ClusterID),
+                     currMsgLen_);
+    return folly::StringPiece(msg, currMsgLen_);
+}
+
+
+const char* WalFileIterator::read(int64_t pos, size_t len) const {
     DCHECK(!fds_.empty());
+    auto end = pos + static_cast<int64_t>(len);
+    if (pos >= bufPos_ && end <= bufPos_ + static_cast<int64_t>(bufLen_)) {
+        return buf_.data() + (pos - bufPos_);
+    }
 
-    currLog_.resize(currMsgLen_);
-    CHECK_EQ(pread(fds_.front(),
-                   &(currLog_[0]),
-                   currMsgLen_,
-                   currPos_
-                    + sizeof(LogID)
-                    + sizeof(TermID)
-                    + sizeof(int32_t)
-                    + sizeof(ClusterID)),
-             static_cast<ssize_t>(currMsgLen_))
-        << "Failed to read. Curr position is " << currPos_
-        << ", expected read length is " << currMsgLen_
+    // Read a whole block from pos, the following logs are most likely in it
+    auto size = std::max(len, static_cast<size_t>(FLAGS_wal_read_buffer_size));
+    if (buf_.size() < size) {
+        buf_.resize(size);
+    }
+    auto ret = pread(fds_.front(), &buf_[0], size, pos);
+    CHECK_GE(ret, static_cast<ssize_t>(len))
+        << "Failed to read. Curr position is " << pos
+        << ", expected read length is " << len
         << " (errno: " << errno << "): " << strerror(errno);
+    bufPos_ = pos;
+    bufLen_ = ret;
+    return buf_.data();
+}
+
 
-    return currLog_;
+LogID WalFileIterator::readHead() {
+    auto* head = read(currPos_, sizeof(LogID) + sizeof(TermID) + sizeof(int32_t));
+    LogID logId;
+    memcpy(&logId, head, sizeof(LogID));
+    memcpy(&currTerm_, head + sizeof(LogID), sizeof(TermID));
+    memcpy(&currMsgLen_, head + sizeof(LogID) + sizeof(TermID), sizeof(int32_t));
+    // Keep the whole log in the buffer, so logSource() and logMsg() never read again
+    read(currPos_,
+         sizeof(LogID) + sizeof(TermID) + sizeof(int32_t) * 2 + currMsgLen_ + sizeof(ClusterID));
+    return logId;
+}
+
+
+void WalFileIterator::prefetchNextFile() const {
+    if (fds_.size() > 1) {
+        posix_fadvise(*std::next(fds_.begin()), 0, 0, POSIX_FADV_WILLNEED);
+    }
 }
 
 LogID WalFileIterator::getFirstIdInNextFile() const {
@@ -40,6 +40,15 @@ public:
 private:
     LogID getFirstIdInNextFile() const;
 
+    // Return the len bytes at pos of the current file, they are valid until the next read
+    const char* read(int64_t pos, size_t len) const;
+
+    // Read the id, term and length of the log at currPos_, return the id
+    LogID readHead();
+
+    // Tell the kernel to read ahead the file after the current one
+    void prefetchNextFile() const;
+
 private:
     // Holds the Wal object, so that it will not be destroyed before the iterator
     std::shared_ptr<FileBasedWal> wal_;
@@ -55,7 +64,12 @@ private:
     std::list<int> fds_;
     int64_t currPos_{0};
     int32_t currMsgLen_{0};
-    mutable std::string currLog_;
+
+    // The logs are parsed from a block of the current file, instead of several small reads
+    // for each log. The block starts at bufPos_ of the file, and holds bufLen_ bytes.
+    mutable std::string buf_;
+    mutable int64_t bufPos_{0};
+    mutable size_t bufLen_{0};
 };
 
 }  // namespace wal
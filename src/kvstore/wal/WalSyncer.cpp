@@ -0,0 +1,118 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "kvstore/wal/WalSyncer.h"
+#include <sys/stat.h>
+
+namespace nebula {
+namespace wal {
+
+// static
+std::shared_ptr<WalSyncer> WalSyncer::get(const std::string& dir) {
+    static std::mutex lock;
+    static std::map<dev_t, std::weak_ptr<WalSyncer>> syncers;
+
+    struct stat st;
+    if (::stat(dir.c_str(), &st) != 0) {
+        LOG(ERROR) << "Failed to stat \"" << dir << "\", error: " << strerror(errno);
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> g(lock);
+    auto it = syncers.find(st.st_dev);
+    if (it != syncers.end()) {
+        auto syncer = it->second.lock();
+        if (syncer != nullptr) {
+            return syncer;
+        }
+    }
+
+    // Clean up the syncers whose wals are all gone
+    for (auto iter = syncers.begin(); iter != syncers.end();) {
+        if (iter->second.expired()) {
+            iter = syncers.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+
+    LOG(INFO) << "Start wal syncer for device " << st.st_dev << ", first dir " << dir;
+    auto syncer = std::make_shared<WalSyncer>(folly::stringPrintf("wal-sync-%lu",
+                                                                  (uint64_t)st.st_dev));
+    syncers[st.st_dev] = syncer;
+    return syncer;
+}
+
+
+WalSyncer::WalSyncer(const std::string& name) {
+    thread_ = std::make_unique<thread::NamedThread>(name, [this] {
+        loop();
+    });
+}
+
+
+WalSyncer::~WalSyncer() {
+    {
+        std::lock_guard<std::mutex> g(lock_);
+        stopped_ = true;
+    }
+    cond_.notify_one();
+    thread_->join();
+}
+
+
+folly::Future<bool> WalSyncer::sync(int32_t fd) {
+    folly::Promise<bool> promise;
+    auto future = promise.getFuture();
+    {
+        std::lock_guard<std::mutex> g(lock_);
+        pending_.emplace_back(SyncRequest{fd, std::move(promise)});
+    }
+    cond_.notify_one();
+    return future;
+}
+
+
+void WalSyncer::loop() {
+    while (true) {
+        std::vector<SyncRequest> group;
+        bool fail = false;
+        {
+            std::unique_lock<std::mutex> g(lock_);
+            cond_.wait(g, [this] { return stopped_ || (!paused_ && !pending_.empty()); });
+            if (pending_.empty()) {
+                // stopped, and nothing left to sync
+                return;
+            }
+            group.swap(pending_);
+            fail = failSyncs_;
+        }
+
+        // One fdatasync per fd, no matter how many appends of the part are in the group
+        std::unordered_map<int32_t, bool> synced;
+        for (auto& req : group) {
+            if (synced.find(req.fd_) != synced.end()) {
+                continue;
+            }
+            bool ok = !fail && ::fdatasync(req.fd_) == 0;
+            numSyncs_++;
+            if (!ok) {
+                LOG(WARNING) << "fdatasync wal fd " << req.fd_ << " failed, error: "
+                             << strerror(errno);
+            }
+            synced.emplace(req.fd_, ok);
+        }
+        VLOG(3) << "Synced " << synced.size() << " wal files for " << group.size()
+                << " requests";
+
+        for (auto& req : group) {
+            req.promise_.setValue(synced[req.fd_]);
+        }
+    }
+}
+
+}  // namespace wal
+}  // namespace nebula
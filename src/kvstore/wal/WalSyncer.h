@@ -0,0 +1,78 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef WAL_WALSYNCER_H_
+#define WAL_WALSYNCER_H_
+
+#include "common/base/Base.h"
+#include "common/thread/NamedThread.h"
+#include <folly/futures/Future.h>
+#include <gtest/gtest_prod.h>
+
+namespace nebula {
+namespace raftex {
+class LogAppend_WalSyncFailure_Test;
+}  // namespace raftex
+
+namespace wal {
+
+/**
+ * WalSyncer does the group commit of the wals on one disk. Every part has its own
+ * wal file, so with wal_sync on each part used to fsync its file once per append.
+ * Now the part writes its logs into page cache, then hands the fd over to the
+ * syncer of its disk. The syncer thread drains all pending requests at once,
+ * calls fdatasync once per fd in the group, and fulfills the futures afterwards.
+ * Requests arriving while a group is being synced are queued for the next group.
+ * The parts do not wait for the futures on their raft threads, they chain them
+ * into the replication instead, otherwise a group never holds more than one request.
+ *
+ * All wals whose directories are on the same device share one syncer, the syncer
+ * goes away when the last of them is destroyed.
+ * */
+class WalSyncer final {
+    FRIEND_TEST(FileBasedWal, GroupSyncShareOneSync);
+    friend class raftex::LogAppend_WalSyncFailure_Test;
+
+public:
+    static std::shared_ptr<WalSyncer> get(const std::string& dir);
+
+    explicit WalSyncer(const std::string& name);
+
+    ~WalSyncer();
+
+    // The future is fulfilled with whether the data written to fd has reached disk.
+    // The caller must keep the fd open until then.
+    folly::Future<bool> sync(int32_t fd);
+
+    // Number of fdatasync calls so far
+    int64_t numSyncs() const {
+        return numSyncs_.load();
+    }
+
+private:
+    void loop();
+
+private:
+    struct SyncRequest {
+        int32_t             fd_;
+        folly::Promise<bool> promise_;
+    };
+
+    std::mutex                           lock_;
+    std::condition_variable              cond_;
+    std::vector<SyncRequest>             pending_;
+    bool                                 stopped_{false};
+    // Only set in test, the pending requests are held until it is reset
+    bool                                 paused_{false};
+    // Only set in test, the syncs fail without touching the disk
+    bool                                 failSyncs_{false};
+    std::atomic<int64_t>                 numSyncs_{0};
+    std::unique_ptr<thread::NamedThread> thread_;
+};
+
+}  // namespace wal
+}  // namespace nebula
+#endif  // WAL_WALSYNCER_H_
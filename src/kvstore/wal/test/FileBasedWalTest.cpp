@@ -609,6 +609,115 @@ TEST(FileBasedWal, CleanWalBeforeIdTest) {
     CHECK_EQ(1000, wal->lastLogId());
 }
 
+TEST(FileBasedWal, GroupSyncTest) {
+    TempDir rootDir("/tmp/testWal.XXXXXX");
+    FileBasedWalPolicy policy;
+    policy.fileSize = 1024 * 10;
+    policy.sync = true;
+
+    // All parts on one disk share the same syncer
+    auto syncer = WalSyncer::get(rootDir.path());
+    ASSERT_NE(nullptr, syncer);
+    EXPECT_EQ(syncer, WalSyncer::get(folly::stringPrintf("%s/..", rootDir.path())));
+
+    const int32_t kParts = 8;
+    const LogID kLogs = 100;
+    std::vector<std::shared_ptr<FileBasedWal>> wals;
+    for (int32_t part = 0; part < kParts; part++) {
+        wals.emplace_back(FileBasedWal::getWal(
+            folly::stringPrintf("%s/wal%d", rootDir.path(), part),
+            "",
+            policy,
+            [](LogID, TermID, ClusterID, const std::string&) {
+                return true;
+            }));
+    }
+
+    std::vector<std::thread> threads;
+    for (int32_t part = 0; part < kParts; part++) {
+        threads.emplace_back([&wals, part] {
+            for (LogID i = 1; i <= kLogs; i++) {
+                EXPECT_TRUE(wals[part]->appendLog(i, 1, 0, folly::stringPrintf(kLongMsg, i)));
+            }
+            EXPECT_TRUE(wals[part]->sync().get());
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    wals.clear();
+
+    for (int32_t part = 0; part < kParts; part++) {
+        auto wal = FileBasedWal::getWal(folly::stringPrintf("%s/wal%d", rootDir.path(), part),
+                                        "",
+                                        policy,
+                                        [](LogID, TermID, ClusterID, const std::string&) {
+                                            return true;
+                                        });
+        EXPECT_EQ(1, wal->firstLogId());
+        EXPECT_EQ(kLogs, wal->lastLogId());
+        auto it = wal->iterator(1, kLogs);
+        LogID id = 1;
+        while (it->valid()) {
+            EXPECT_EQ(id, it->logId());
+            EXPECT_EQ(folly::stringPrintf(kLongMsg, id), it->logMsg());
+            ++(*it);
+            ++id;
+        }
+        EXPECT_EQ(kLogs + 1, id);
+    }
+}
+
+TEST(FileBasedWal, GroupSyncShareOneSync) {
+    TempDir rootDir("/tmp/testWal.XXXXXX");
+    FileBasedWalPolicy policy;
+    policy.sync = true;
+
+    const int32_t kParts = 2;
+    const LogID kLogs = 10;
+    std::vector<std::shared_ptr<FileBasedWal>> wals;
+    for (int32_t part = 0; part < kParts; part++) {
+        wals.emplace_back(FileBasedWal::getWal(
+            folly::stringPrintf("%s/wal%d", rootDir.path(), part),
+            "",
+            policy,
+            [](LogID, TermID, ClusterID, const std::string&) {
+                return true;
+            }));
+    }
+    auto syncer = WalSyncer::get(rootDir.path());
+    ASSERT_NE(nullptr, syncer);
+    {
+        // Hold the requests, as if the syncer were busy with the last group
+        std::lock_guard<std::mutex> g(syncer->lock_);
+        syncer->paused_ = true;
+    }
+
+    // The appends return without waiting for the disk
+    std::vector<folly::Future<bool>> futures;
+    for (LogID i = 1; i <= kLogs; i++) {
+        for (auto& wal : wals) {
+            EXPECT_TRUE(wal->appendLog(i, 1, 0, folly::stringPrintf(kLongMsg, i)));
+            futures.emplace_back(wal->sync());
+        }
+    }
+    for (auto& f : futures) {
+        EXPECT_FALSE(f.isReady());
+    }
+
+    auto numSyncs = syncer->numSyncs();
+    {
+        std::lock_guard<std::mutex> g(syncer->lock_);
+        syncer->paused_ = false;
+    }
+    syncer->cond_.notify_one();
+    for (auto& f : futures) {
+        EXPECT_TRUE(std::move(f).get());
+    }
+    // All appends of a wal are synced by one fdatasync of its file
+    EXPECT_EQ(kParts, syncer->numSyncs() - numSyncs);
+}
+
 }  // namespace wal
 }  // namespace nebula
 
@@ -6,18 +6,26 @@
 
 #include "common/base/Base.h"
 #include <folly/Benchmark.h>
+#include "common/fs/TempDir.h"
 #include "kvstore/wal/AtomicLogBuffer.h"
+#include "kvstore/wal/FileBasedWal.h"
+#include "kvstore/wal/WalFileIterator.h"
 #include "kvstore/wal/test/InMemoryLogBufferList.h"
 
 DEFINE_bool(only_seek, false, "Only seek in read test");
+DECLARE_int32(wal_read_buffer_size);
 
 #define TEST_WRTIE       1
 #define TEST_READ        1
 #define TEST_RW_MIXED    1
+#define TEST_CATCH_UP    1
 
 using nebula::wal::AtomicLogBuffer;
 using nebula::wal::Record;
 using nebula::wal::InMemoryBufferList;
+using nebula::wal::FileBasedWal;
+using nebula::wal::FileBasedWalPolicy;
+using nebula::wal::WalFileIterator;
 using nebula::LogID;
 
 void prepareData(std::shared_ptr<InMemoryBufferList> inMemoryLogBuffer,
@@ -417,6 +425,65 @@ BENCHMARK_RELATIVE(AtomicLogBufferRWMixedWriteTest) {
 
 #endif
 
+#if TEST_CATCH_UP
+
+// A follower far behind the leader reads all the logs it has missed from the wal files
+void runWalCatchUpTest(int32_t readBufferSize, int32_t len) {
+    const LogID total = 100000;
+    std::unique_ptr<nebula::fs::TempDir> walDir;
+    std::shared_ptr<FileBasedWal> wal;
+    BENCHMARK_SUSPEND {
+        walDir = std::make_unique<nebula::fs::TempDir>("/tmp/catchUpWal.XXXXXX");
+        FileBasedWalPolicy policy;
+        wal = FileBasedWal::getWal(walDir->path(),
+                                   "",
+                                   policy,
+                                   [](LogID, nebula::TermID, nebula::ClusterID,
+                                      const std::string&) {
+                                       return true;
+                                   });
+        for (LogID i = 1; i <= total; i++) {
+            CHECK(wal->appendLog(i, 1, 0, std::string(len, 'A')));
+        }
+        FLAGS_wal_read_buffer_size = readBufferSize;
+    }
+    WalFileIterator iter(wal, 1, total);
+    for (; iter.valid(); ++iter) {
+        auto source = iter.logSource();
+        auto log = iter.logMsg();
+        folly::doNotOptimizeAway(source);
+        folly::doNotOptimizeAway(log);
+    }
+    BENCHMARK_SUSPEND {
+        FLAGS_wal_read_buffer_size = 1024 * 1024;
+        wal.reset();
+        walDir.reset();
+    }
+}
+
+// Each log is read by its own syscalls
+BENCHMARK(WalCatchUpUnbufferedShort) {
+    runWalCatchUpTest(0, 64);
+}
+
+BENCHMARK_RELATIVE(WalCatchUpBufferedShort) {
+    runWalCatchUpTest(1024 * 1024, 64);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(WalCatchUpUnbufferedLong) {
+    runWalCatchUpTest(0, 1024);
+}
+
+BENCHMARK_RELATIVE(WalCatchUpBufferedLong) {
+    runWalCatchUpTest(1024 * 1024, 1024);
+}
+
+BENCHMARK_DRAW_LINE();
+
+#endif
+
 /*************************
  * End of benchmarks
  ************************/
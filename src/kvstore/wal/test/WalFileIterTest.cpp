@@ -10,6 +10,8 @@
 #include "kvstore/wal/WalFileIterator.h"
 #include <gtest/gtest.h>
 
+DECLARE_int32(wal_read_buffer_size);
+
 namespace nebula {
 namespace wal {
 
@@ -109,6 +111,42 @@ TEST(WalFileIter, MultiFilesReadTest) {
 }
 
 
+TEST(WalFileIter, SmallReadBufferTest) {
+    // Most logs cross the end of the read buffer, and some are larger than it
+    FLAGS_wal_read_buffer_size = 100;
+    FileBasedWalPolicy policy;
+    policy.fileSize = 1024;
+    TempDir walDir("/tmp/testWal.XXXXXX");
+
+    auto wal = FileBasedWal::getWal(walDir.path(),
+                                    "",
+                                    policy,
+                                    [](LogID, TermID, ClusterID, const std::string&) {
+                                        return true;
+                                    });
+    for (int i = 1; i <= 1000; i++) {
+        EXPECT_TRUE(
+            wal->appendLog(i /*id*/, 1 /*term*/, i /*cluster*/,
+                           std::string(i % 200, 'a' + i % 26)));
+    }
+    EXPECT_LT(10, wal->walFiles_.size());
+    {
+        auto it = std::make_unique<WalFileIterator>(wal, 300, 1000);
+        LogID id = 300;
+        while (it->valid()) {
+            EXPECT_EQ(id, it->logId());
+            EXPECT_EQ(1, it->logTerm());
+            EXPECT_EQ(std::string(id % 200, 'a' + id % 26), it->logMsg());
+            EXPECT_EQ(id, it->logSource());
+            ++(*it);
+            ++id;
+        }
+        EXPECT_EQ(1001, id);
+    }
+    FLAGS_wal_read_buffer_size = 1024 * 1024;
+}
+
+
 }  // namespace wal
 }  // namespace nebula
 
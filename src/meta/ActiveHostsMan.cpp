@@ -13,18 +13,62 @@
 
 DECLARE_int32(heartbeat_interval_secs);
 DECLARE_uint32(expired_time_factor);
+DEFINE_int32(host_info_persist_interval_secs, 20,
+             "The heartbeat time of a host is only persisted when its info changed or "
+             "at this interval, it should be less than "
+             "heartbeat_interval_secs * expired_time_factor, 0 means persist every heartbeat");
 
 namespace nebula {
 namespace meta {
 
+namespace {
+
+bool needPersist(kvstore::KVStore* kv,
+                 const HeartbeatTable* hbTable,
+                 const std::string& hostKey,
+                 const HostInfo& info) {
+    if (hbTable == nullptr || FLAGS_host_info_persist_interval_secs <= 0) {
+        return true;
+    }
+    std::string val;
+    if (kv->get(kDefaultSpaceId, kDefaultPartId, hostKey, &val) != kvstore::ResultCode::SUCCEEDED) {
+        return true;
+    }
+    auto persisted = HostInfo::decode(val);
+    return persisted.role_ != info.role_ ||
+           persisted.gitInfoSha_ != info.gitInfoSha_ ||
+           info.lastHBTimeInMilliSec_ - persisted.lastHBTimeInMilliSec_ >=
+               FLAGS_host_info_persist_interval_secs * 1000L;
+}
+
+}  // namespace
+
+void HeartbeatTable::update(const HostAddr& host, int64_t lastHBTime) {
+    std::lock_guard<std::mutex> g(lock_);
+    auto& time = hosts_[host];
+    time = std::max(time, lastHBTime);
+}
+
+int64_t HeartbeatTable::lastHBTime(const HostAddr& host) const {
+    std::lock_guard<std::mutex> g(lock_);
+    auto iter = hosts_.find(host);
+    return iter == hosts_.end() ? 0 : iter->second;
+}
+
 cpp2::ErrorCode ActiveHostsMan::updateHostInfo(kvstore::KVStore* kv,
+                                               HeartbeatTable* hbTable,
                                                const HostAddr& hostAddr,
                                                const HostInfo& info,
                                                const AllLeaders* allLeaders) {
     CHECK_NOTNULL(kv);
+    if (hbTable != nullptr) {
+        hbTable->update(hostAddr, info.lastHBTimeInMilliSec_);
+    }
     std::vector<kvstore::KV> data;
-    data.emplace_back(MetaServiceUtils::hostKey(hostAddr.host, hostAddr.port),
-                      HostInfo::encodeV2(info));
+    auto hostKey = MetaServiceUtils::hostKey(hostAddr.host, hostAddr.port);
+    if (needPersist(kv, hbTable, hostKey, info)) {
+        data.emplace_back(std::move(hostKey), HostInfo::encodeV2(info));
+    }
     std::vector<std::string> leaderKeys;
     std::vector<int64_t> terms;
     if (allLeaders != nullptr) {
@@ -63,6 +107,15 @@ cpp2::ErrorCode ActiveHostsMan::updateHostInfo(kvstore::KVStore* kv,
             data.emplace_back(std::make_pair(leaderKeys[i], std::move(val)));
         }
     }
+    if (data.empty()) {
+        // Nothing to persist, just make sure we are still the leader
+        auto partRet = kv->part(kDefaultSpaceId, kDefaultPartId);
+        if (!nebula::ok(partRet)) {
+            return MetaCommon::to(nebula::error(partRet));
+        }
+        return nebula::value(partRet)->isLeader() ? cpp2::ErrorCode::SUCCEEDED
+                                                  : cpp2::ErrorCode::E_LEADER_CHANGED;
+    }
     folly::SharedMutex::WriteHolder wHolder(LockUtils::spaceLock());
     folly::Baton<true, std::atomic> baton;
     kvstore::ResultCode ret;
@@ -76,7 +129,10 @@ cpp2::ErrorCode ActiveHostsMan::updateHostInfo(kvstore::KVStore* kv,
 }
 
 ErrorOr<cpp2::ErrorCode, std::vector<HostAddr>>
-ActiveHostsMan::getActiveHosts(kvstore::KVStore* kv, int32_t expiredTTL, cpp2::HostRole role) {
+ActiveHostsMan::getActiveHosts(kvstore::KVStore* kv,
+                               const HeartbeatTable* hbTable,
+                               int32_t expiredTTL,
+                               cpp2::HostRole role) {
     const auto& prefix = MetaServiceUtils::hostPrefix();
     std::unique_ptr<kvstore::KVIterator> iter;
     auto ret = kv->prefix(kDefaultSpaceId, kDefaultPartId, prefix, &iter);
@@ -95,6 +151,7 @@ ActiveHostsMan::getActiveHosts(kvstore::KVStore* kv, int32_t expiredTTL, cpp2::H
     while (iter->valid()) {
         auto host = MetaServiceUtils::parseHostKey(iter->key());
         HostInfo info = HostInfo::decode(iter->val());
+        refreshHostInfo(hbTable, host, info);
         if (info.role_ == role) {
             if (now - info.lastHBTimeInMilliSec_ < threshold) {
                 hosts.emplace_back(host.host, host.port);
@@ -108,6 +165,7 @@ ActiveHostsMan::getActiveHosts(kvstore::KVStore* kv, int32_t expiredTTL, cpp2::H
 
 ErrorOr<cpp2::ErrorCode, std::vector<HostAddr>>
 ActiveHostsMan::getActiveHostsInZone(kvstore::KVStore* kv,
+                                     const HeartbeatTable* hbTable,
                                      const std::string& zoneName,
                                      int32_t expiredTTL) {
     std::vector<HostAddr> activeHosts;
@@ -127,7 +185,7 @@ ActiveHostsMan::getActiveHostsInZone(kvstore::KVStore* kv,
                          FLAGS_heartbeat_interval_secs * FLAGS_expired_time_factor :
                          expiredTTL) * 1000;
     for (auto& host : hosts) {
-        auto infoRet = getHostInfo(kv, host);
+        auto infoRet = getHostInfo(kv, hbTable, host);
         if (!nebula::ok(infoRet)) {
             return nebula::error(infoRet);
         }
@@ -142,6 +200,7 @@ ActiveHostsMan::getActiveHostsInZone(kvstore::KVStore* kv,
 
 ErrorOr<cpp2::ErrorCode, std::vector<HostAddr>>
 ActiveHostsMan::getActiveHostsWithGroup(kvstore::KVStore* kv,
+                                        const HeartbeatTable* hbTable,
                                         GraphSpaceID spaceId,
                                         int32_t expiredTTL) {
     std::string spaceValue;
@@ -168,7 +227,7 @@ ActiveHostsMan::getActiveHostsWithGroup(kvstore::KVStore* kv,
 
     auto zoneNames = MetaServiceUtils::parseZoneNames(std::move(groupValue));
     for (const auto& zoneName : zoneNames) {
-        auto hostsRet = getActiveHostsInZone(kv, zoneName, expiredTTL);
+        auto hostsRet = getActiveHostsInZone(kv, hbTable, zoneName, expiredTTL);
         if (!nebula::ok(hostsRet)) {
             return nebula::error(hostsRet);
         }
@@ -180,9 +239,10 @@ ActiveHostsMan::getActiveHostsWithGroup(kvstore::KVStore* kv,
 
 ErrorOr<cpp2::ErrorCode, std::vector<HostAddr>>
 ActiveHostsMan::getActiveAdminHosts(kvstore::KVStore* kv,
+                                    const HeartbeatTable* hbTable,
                                     int32_t expiredTTL,
                                     cpp2::HostRole role) {
-    auto hostsRet = getActiveHosts(kv, expiredTTL, role);
+    auto hostsRet = getActiveHosts(kv, hbTable, expiredTTL, role);
     if (!nebula::ok(hostsRet)) {
         return nebula::error(hostsRet);
     }
@@ -195,8 +255,10 @@ ActiveHostsMan::getActiveAdminHosts(kvstore::KVStore* kv,
     return adminHosts;
 }
 
-ErrorOr<cpp2::ErrorCode, bool> ActiveHostsMan::isLived(kvstore::KVStore* kv, const HostAddr& host) {
-    auto activeHostsRet = getActiveHosts(kv);
+ErrorOr<cpp2::ErrorCode, bool> ActiveHostsMan::isLived(kvstore::KVStore* kv,
+                                                       const HeartbeatTable* hbTable,
+                                                       const HostAddr& host) {
+    auto activeHostsRet = getActiveHosts(kv, hbTable);
     if (!nebula::ok(activeHostsRet)) {
         return nebula::error(activeHostsRet);
     }
@@ -206,7 +268,9 @@ ErrorOr<cpp2::ErrorCode, bool> ActiveHostsMan::isLived(kvstore::KVStore* kv, con
 }
 
 ErrorOr<cpp2::ErrorCode, HostInfo>
-ActiveHostsMan::getHostInfo(kvstore::KVStore* kv, const HostAddr& host) {
+ActiveHostsMan::getHostInfo(kvstore::KVStore* kv,
+                            const HeartbeatTable* hbTable,
+                            const HostAddr& host) {
     auto hostKey = MetaServiceUtils::hostKey(host.host, host.port);
     std::string hostValue;
     auto ret = kv->get(kDefaultSpaceId, kDefaultPartId, hostKey, &hostValue);
@@ -216,7 +280,18 @@ ActiveHostsMan::getHostInfo(kvstore::KVStore* kv, const HostAddr& host) {
                    << apache::thrift::util::enumNameSafe(retCode);
         return retCode;
     }
-    return HostInfo::decode(hostValue);
+    auto info = HostInfo::decode(hostValue);
+    refreshHostInfo(hbTable, host, info);
+    return info;
+}
+
+void ActiveHostsMan::refreshHostInfo(const HeartbeatTable* hbTable,
+                                     const HostAddr& host,
+                                     HostInfo& info) {
+    if (hbTable != nullptr) {
+        info.lastHBTimeInMilliSec_ = std::max(info.lastHBTimeInMilliSec_,
+                                              hbTable->lastHBTime(host));
+    }
 }
 
 cpp2::ErrorCode LastUpdateTimeMan::update(kvstore::KVStore* kv, const int64_t timeInMilliSec) {
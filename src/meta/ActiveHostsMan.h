@@ -104,40 +104,75 @@ struct HostInfo {
     }
 };
 
+/**
+ * The latest heartbeat time of hosts received by the meta leader. The host info in kvstore is
+ * persisted at a coarse interval, readers take the newer one of the two.
+ *
+ * It is owned by the meta service. After leader failover, the new leader starts with the
+ * persisted time, which is refreshed by the next heartbeat of each host.
+ * */
+class HeartbeatTable final {
+public:
+    void update(const HostAddr& host, int64_t lastHBTime);
+
+    int64_t lastHBTime(const HostAddr& host) const;
+
+private:
+    mutable std::mutex              lock_;
+    std::map<HostAddr, int64_t>     hosts_;
+};
+
+/**
+ * A null HeartbeatTable means only the persisted host info is used, then the heartbeat time
+ * is persisted every time it is updated.
+ * */
 class ActiveHostsMan final {
 public:
     ~ActiveHostsMan() = default;
 
     using AllLeaders = std::unordered_map<GraphSpaceID, std::vector<cpp2::LeaderInfo>>;
     static cpp2::ErrorCode updateHostInfo(kvstore::KVStore* kv,
+                                          HeartbeatTable* hbTable,
                                           const HostAddr& hostAddr,
                                           const HostInfo& info,
                                           const AllLeaders* leaderParts = nullptr);
 
     static ErrorOr<cpp2::ErrorCode, std::vector<HostAddr>>
     getActiveHosts(kvstore::KVStore* kv,
+                   const HeartbeatTable* hbTable,
                    int32_t expiredTTL = 0,
                    cpp2::HostRole role = cpp2::HostRole::STORAGE);
 
     static ErrorOr<cpp2::ErrorCode, std::vector<HostAddr>>
     getActiveHostsInZone(kvstore::KVStore* kv,
+                         const HeartbeatTable* hbTable,
                          const std::string& zoneName,
                          int32_t expiredTTL = 0);
 
     static ErrorOr<cpp2::ErrorCode, std::vector<HostAddr>>
     getActiveHostsWithGroup(kvstore::KVStore* kv,
+                            const HeartbeatTable* hbTable,
                             GraphSpaceID spaceId,
                             int32_t expiredTTL = 0);
 
     static ErrorOr<cpp2::ErrorCode, std::vector<HostAddr>>
     getActiveAdminHosts(kvstore::KVStore* kv,
+                        const HeartbeatTable* hbTable,
                         int32_t expiredTTL = 0,
                         cpp2::HostRole role = cpp2::HostRole::STORAGE);
 
-    static ErrorOr<cpp2::ErrorCode, bool> isLived(kvstore::KVStore* kv, const HostAddr& host);
+    static ErrorOr<cpp2::ErrorCode, bool> isLived(kvstore::KVStore* kv,
+                                                  const HeartbeatTable* hbTable,
+                                                  const HostAddr& host);
 
     static ErrorOr<cpp2::ErrorCode, HostInfo>
-    getHostInfo(kvstore::KVStore* kv, const HostAddr& host);
+    getHostInfo(kvstore::KVStore* kv, const HeartbeatTable* hbTable, const HostAddr& host);
+
+    // The persisted host info may fall behind the heartbeats received in memory,
+    // refresh it with the latest heartbeat time
+    static void refreshHostInfo(const HeartbeatTable* hbTable,
+                                const HostAddr& host,
+                                HostInfo& info);
 
 protected:
     ActiveHostsMan() = default;
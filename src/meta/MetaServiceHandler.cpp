@@ -78,7 +78,7 @@ namespace meta {
 
 folly::Future<cpp2::ExecResp>
 MetaServiceHandler::future_createSpace(const cpp2::CreateSpaceReq& req) {
-    auto* processor = CreateSpaceProcessor::instance(kvstore_);
+    auto* processor = CreateSpaceProcessor::instance(kvstore_, &hbTable_);
     RETURN_FUTURE(processor);
 }
 
@@ -114,13 +114,13 @@ MetaServiceHandler::future_getSpace(const cpp2::GetSpaceReq& req) {
 
 folly::Future<cpp2::ListHostsResp>
 MetaServiceHandler::future_listHosts(const cpp2::ListHostsReq& req) {
-    auto* processor = ListHostsProcessor::instance(kvstore_);
+    auto* processor = ListHostsProcessor::instance(kvstore_, &hbTable_);
     RETURN_FUTURE(processor);
 }
 
 folly::Future<cpp2::ListPartsResp>
 MetaServiceHandler::future_listParts(const cpp2::ListPartsReq& req) {
-    auto* processor = ListPartsProcessor::instance(kvstore_);
+    auto* processor = ListPartsProcessor::instance(kvstore_, &hbTable_);
     RETURN_FUTURE(processor);
 }
 
@@ -306,7 +306,7 @@ MetaServiceHandler::future_listFTClients(const cpp2::ListFTClientsReq& req) {
 
 folly::Future<cpp2::HBResp>
 MetaServiceHandler::future_heartBeat(const cpp2::HBReq& req) {
-    auto* processor = HBProcessor::instance(kvstore_, &kHBCounters, clusterId_);
+    auto* processor = HBProcessor::instance(kvstore_, &kHBCounters, clusterId_, &hbTable_);
     RETURN_FUTURE(processor);
 }
 
@@ -366,7 +366,7 @@ MetaServiceHandler::future_getUserRoles(const cpp2::GetUserRolesReq& req) {
 
 folly::Future<cpp2::BalanceResp>
 MetaServiceHandler::future_balance(const cpp2::BalanceReq& req) {
-    auto* processor = BalanceProcessor::instance(kvstore_);
+    auto* processor = BalanceProcessor::instance(kvstore_, &hbTable_);
     RETURN_FUTURE(processor);
 }
 
@@ -402,7 +402,7 @@ MetaServiceHandler::future_listConfigs(const cpp2::ListConfigsReq &req) {
 
 folly::Future<cpp2::ExecResp>
 MetaServiceHandler::future_createSnapshot(const cpp2::CreateSnapshotReq& req) {
-    auto* processor = CreateSnapshotProcessor::instance(kvstore_, adminClient_.get());
+    auto* processor = CreateSnapshotProcessor::instance(kvstore_, adminClient_.get(), &hbTable_);
     RETURN_FUTURE(processor);
 }
 
@@ -420,13 +420,13 @@ MetaServiceHandler::future_listSnapshots(const cpp2::ListSnapshotsReq& req) {
 
 folly::Future<cpp2::CreateBackupResp>
 MetaServiceHandler::future_createBackup(const cpp2::CreateBackupReq& req) {
-    auto* processor = CreateBackupProcessor::instance(kvstore_, adminClient_.get());
+    auto* processor = CreateBackupProcessor::instance(kvstore_, adminClient_.get(), &hbTable_);
     RETURN_FUTURE(processor);
 }
 
 folly::Future<cpp2::ExecResp>
 MetaServiceHandler::future_addZone(const cpp2::AddZoneReq &req) {
-    auto* processor = AddZoneProcessor::instance(kvstore_);
+    auto* processor = AddZoneProcessor::instance(kvstore_, &hbTable_);
     RETURN_FUTURE(processor);
 }
 
@@ -450,7 +450,7 @@ MetaServiceHandler::future_listZones(const cpp2::ListZonesReq &req) {
 
 folly::Future<cpp2::ExecResp>
 MetaServiceHandler::future_addHostIntoZone(const cpp2::AddHostIntoZoneReq &req) {
-    auto* processor = AddHostIntoZoneProcessor::instance(kvstore_);
+    auto* processor = AddHostIntoZoneProcessor::instance(kvstore_, &hbTable_);
     RETURN_FUTURE(processor);
 }
 
@@ -510,7 +510,7 @@ MetaServiceHandler::future_removeListener(const cpp2::RemoveListenerReq& req) {
 
 folly::Future<cpp2::ListListenerResp>
 MetaServiceHandler::future_listListener(const cpp2::ListListenerReq& req) {
-    auto* processor = ListListenerProcessor::instance(kvstore_);
+    auto* processor = ListListenerProcessor::instance(kvstore_, &hbTable_);
     RETURN_FUTURE(processor);
 }
 
@@ -20,7 +20,7 @@ class MetaServiceHandler final : public cpp2::MetaServiceSvIf {
 public:
     explicit MetaServiceHandler(kvstore::KVStore* kv, ClusterID clusterId = 0)
         : kvstore_(kv), clusterId_(clusterId) {
-        adminClient_ = std::make_unique<AdminClient>(kvstore_);
+        adminClient_ = std::make_unique<AdminClient>(kvstore_, &hbTable_);
 
         // Initialize counters
         kHBCounters.init();
@@ -274,6 +274,8 @@ public:
 private:
     kvstore::KVStore* kvstore_ = nullptr;
     ClusterID clusterId_{0};
+    // The latest heartbeats received by this meta service
+    HeartbeatTable hbTable_;
     std::unique_ptr<AdminClient> adminClient_;
 };
 
@@ -40,7 +40,7 @@ folly::Future<Status> AdminClient::transLeader(GraphSpaceID spaceId,
     if (dst == kRandomPeer) {
         for (auto& p : peers) {
             if (p != leader) {
-                auto retCode = ActiveHostsMan::isLived(kv_, p);
+                auto retCode = ActiveHostsMan::isLived(kv_, hbTable_, p);
                 if (nebula::ok(retCode) && nebula::value(retCode)) {
                     target = p;
                     break;
@@ -265,7 +265,7 @@ folly::Future<Status> AdminClient::checkPeers(GraphSpaceID spaceId, PartitionID
     auto fut = pro.getFuture();
     std::vector<folly::Future<Status>> futures;
     for (auto& p : peers) {
-        auto ret = ActiveHostsMan::isLived(kv_, p);
+        auto ret = ActiveHostsMan::isLived(kv_, hbTable_, p);
         if (!nebula::ok(ret)) {
             auto retCode = nebula::error(ret);
             LOG(INFO) << "Get active host failed, error: " << static_cast<int32_t>(retCode);
@@ -549,7 +549,7 @@ void AdminClient::getLeaderDist(const HostAddr& host,
 folly::Future<Status> AdminClient::getLeaderDist(HostLeaderMap* result) {
     folly::Promise<Status> promise;
     auto future = promise.getFuture();
-    auto allHostsRet = ActiveHostsMan::getActiveHosts(kv_);
+    auto allHostsRet = ActiveHostsMan::getActiveHosts(kv_, hbTable_);
     if (!nebula::ok(allHostsRet)) {
         promise.setValue(Status::Error("Get leader failed"));
         return future;
@@ -670,7 +670,7 @@ AdminClient::addTask(cpp2::AdminCmd cmd,
     auto f = pro.getFuture();
     std::vector<HostAddr> hosts;
     if (targetHost.empty()) {
-        auto activeHostsRet = ActiveHostsMan::getActiveAdminHosts(kv_);
+        auto activeHostsRet = ActiveHostsMan::getActiveAdminHosts(kv_, hbTable_);
         if (!nebula::ok(activeHostsRet)) {
             pro.setValue(Status::Error("Get actice hosts failed"));
             return f;
@@ -715,7 +715,7 @@ AdminClient::stopTask(const std::vector<HostAddr>& target,
     auto f = pro.getFuture();
     std::vector<HostAddr> hosts;
     if (target.empty()) {
-        auto activeHostsRet = ActiveHostsMan::getActiveAdminHosts(kv_);
+        auto activeHostsRet = ActiveHostsMan::getActiveAdminHosts(kv_, hbTable_);
         if (!nebula::ok(activeHostsRet)) {
             pro.setValue(Status::Error("Get actice hosts failed"));
             return f;
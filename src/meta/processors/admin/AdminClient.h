@@ -12,6 +12,7 @@
 #include "common/thrift/ThriftClientManager.h"
 #include "common/interface/gen-cpp2/StorageAdminServiceAsyncClient.h"
 #include "kvstore/KVStore.h"
+#include "meta/ActiveHostsMan.h"
 #include <folly/executors/IOThreadPoolExecutor.h>
 
 namespace nebula {
@@ -30,8 +31,9 @@ class AdminClient {
 public:
     AdminClient() = default;
 
-    explicit AdminClient(kvstore::KVStore* kv)
-        : kv_(kv) {
+    explicit AdminClient(kvstore::KVStore* kv, const HeartbeatTable* hbTable = nullptr)
+        : kv_(kv)
+        , hbTable_(hbTable) {
         ioThreadPool_ = std::make_unique<folly::IOThreadPoolExecutor>(10);
         clientsMan_ = std::make_unique<
             thrift::ThriftClientManager<storage::cpp2::StorageAdminServiceAsyncClient>>();
@@ -143,6 +145,7 @@ private:
 
 private:
     kvstore::KVStore* kv_{nullptr};
+    const HeartbeatTable* hbTable_{nullptr};
     std::unique_ptr<folly::IOThreadPoolExecutor> ioThreadPool_{nullptr};
     std::unique_ptr<thrift::ThriftClientManager<storage::cpp2::StorageAdminServiceAsyncClient>>
     clientsMan_;
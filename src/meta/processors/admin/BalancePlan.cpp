@@ -190,7 +190,7 @@ cpp2::ErrorCode BalancePlan::recovery(bool resume) {
                     task.ret_ = BalanceTaskResult::IN_PROGRESS;
                 }
                 task.status_ = BalanceTaskStatus::START;
-                auto activeHostRet = ActiveHostsMan::isLived(kv_, task.dst_);
+                auto activeHostRet = ActiveHostsMan::isLived(kv_, nullptr, task.dst_);
                 if (!nebula::ok(activeHostRet)) {
                     auto retCode = nebula::error(activeHostRet);
                     LOG(ERROR) << "Get active hosts failed, error: "
@@ -91,7 +91,7 @@ void BalanceProcessor::process(const cpp2::BalanceReq& req) {
         return;
     }
 
-    auto activeHostsRet = ActiveHostsMan::getActiveHosts(kvstore_);
+    auto activeHostsRet = ActiveHostsMan::getActiveHosts(kvstore_, hbTable_);
     if (!nebula::ok(activeHostsRet)) {
         auto retCode = nebula::error(activeHostsRet);
         LOG(ERROR) << "Get active hosts failed, error: "
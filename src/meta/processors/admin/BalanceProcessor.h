@@ -16,15 +16,19 @@ namespace meta {
 
 class BalanceProcessor : public BaseProcessor<cpp2::BalanceResp> {
 public:
-    static BalanceProcessor* instance(kvstore::KVStore* kvstore) {
-        return new BalanceProcessor(kvstore);
+    static BalanceProcessor* instance(kvstore::KVStore* kvstore,
+                                      const HeartbeatTable* hbTable = nullptr) {
+        return new BalanceProcessor(kvstore, hbTable);
     }
 
     void process(const cpp2::BalanceReq& req);
 
 private:
-    explicit BalanceProcessor(kvstore::KVStore* kvstore)
-        : BaseProcessor<cpp2::BalanceResp>(kvstore) {}
+    BalanceProcessor(kvstore::KVStore* kvstore, const HeartbeatTable* hbTable)
+        : BaseProcessor<cpp2::BalanceResp>(kvstore)
+        , hbTable_(hbTable) {}
+
+    const HeartbeatTable* hbTable_{nullptr};
 };
 
 }  // namespace meta
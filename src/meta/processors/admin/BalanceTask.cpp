@@ -62,7 +62,7 @@ void BalanceTask::invoke() {
         case BalanceTaskStatus::CHANGE_LEADER: {
             LOG(INFO) << taskIdStr_ << " Ask the src to give up the leadership.";
             SAVE_STATE();
-            auto srcLivedRet = ActiveHostsMan::isLived(kv_, src_);
+            auto srcLivedRet = ActiveHostsMan::isLived(kv_, nullptr, src_);
             if (nebula::ok(srcLivedRet) && nebula::value(srcLivedRet)) {
                 client_->transLeader(spaceId_, partId_, src_).thenValue([this](auto&& resp) {
                     if (!resp.ok()) {
@@ -178,7 +178,7 @@ void BalanceTask::invoke() {
             break;
         }
         case BalanceTaskStatus::REMOVE_PART_ON_SRC: {
-            auto srcLivedRet = ActiveHostsMan::isLived(kv_, src_);
+            auto srcLivedRet = ActiveHostsMan::isLived(kv_, nullptr, src_);
             LOG(INFO) << taskIdStr_ << " Close part on src host, srcLived.";
             SAVE_STATE();
             if (nebula::ok(srcLivedRet) && nebula::value(srcLivedRet)) {
@@ -28,6 +28,7 @@ class BalanceTask {
     FRIEND_TEST(BalanceTest, TryToRecoveryTest);
     FRIEND_TEST(BalanceTest, RecoveryTest);
     FRIEND_TEST(BalanceTest, StopPlanTest);
+    FRIEND_TEST(BalanceTest, LoadAwareBalancePartsTest);
 
 public:
     BalanceTask() = default;
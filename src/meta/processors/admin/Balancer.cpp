@@ -17,6 +17,12 @@
 
 DEFINE_double(leader_balance_deviation, 0.05, "after leader balance, leader count should in range "
                                               "[avg * (1 - deviation), avg * (1 + deviation)]");
+DEFINE_double(part_balance_deviation, 0.1, "when the load of parts is reported, after balance "
+                                           "the cost of each host should be at most "
+                                           "avg * (1 + deviation)");
+DEFINE_int32(balance_max_parts_into_host, 4, "max number of parts moved into a host by one balance "
+                                             "plan weighed by the load of parts, 0 means no limit");
+DEFINE_int32(part_load_expired_secs, 600, "the load of a part reported earlier than it is ignored");
 
 namespace nebula {
 namespace meta {
@@ -265,6 +271,7 @@ Balancer::genTasks(GraphSpaceID spaceId,
         LOG(ERROR) << "Invalid space " << spaceId;
         return cpp2::ErrorCode::E_NOT_FOUND;
     }
+    loadPartCosts(spaceId);
 
     auto fetchHostPartsRet = fetchHostParts(spaceId, dependentOnGroup, hostParts, lostHosts);
     if (!nebula::ok(fetchHostPartsRet)) {
@@ -352,9 +359,9 @@ Balancer::fetchHostParts(GraphSpaceID spaceId,
                          std::vector<HostAddr>& lostHosts) {
     ErrorOr<cpp2::ErrorCode, std::vector<HostAddr>> activeHostsRet;
     if (dependentOnGroup) {
-        activeHostsRet = ActiveHostsMan::getActiveHostsWithGroup(kv_, spaceId);
+        activeHostsRet = ActiveHostsMan::getActiveHostsWithGroup(kv_, nullptr, spaceId);
     } else {
-        activeHostsRet = ActiveHostsMan::getActiveHosts(kv_);
+        activeHostsRet = ActiveHostsMan::getActiveHosts(kv_, nullptr);
     }
 
     if (!nebula::ok(activeHostsRet)) {
@@ -383,6 +390,10 @@ bool Balancer::balanceParts(BalanceID balanceId,
                             HostParts& confirmedHostParts,
                             int32_t totalParts,
                             std::vector<BalanceTask>& tasks) {
+    if (!partCosts_.empty()) {
+        return balancePartsByCost(balanceId, spaceId, confirmedHostParts, tasks);
+    }
+
     auto avgLoad = static_cast<float>(totalParts) / confirmedHostParts.size();
     VLOG(3) << "The expect avg load is " << avgLoad;
     int32_t minLoad = std::floor(avgLoad);
@@ -462,6 +473,84 @@ bool Balancer::balanceParts(BalanceID balanceId,
     return true;
 }
 
+// Every round moves a part out of the host costing the most, the part and the target are the
+// ones lowering the larger cost of the two hosts the most, and the target must not cost more than
+// the max load after the move. It stops once no host costs more than the max load.
+bool Balancer::balancePartsByCost(BalanceID balanceId,
+                                  GraphSpaceID spaceId,
+                                  HostParts& confirmedHostParts,
+                                  std::vector<BalanceTask>& tasks) {
+    auto sortedHosts = sortedHostsByCost(confirmedHostParts);
+    if (sortedHosts.empty()) {
+        LOG(ERROR) << "Host is empty";
+        return false;
+    }
+    double totalCost = 0;
+    for (const auto& host : sortedHosts) {
+        totalCost += host.second;
+    }
+    auto avgLoad = totalCost / sortedHosts.size();
+    auto maxLoad = avgLoad * (1 + FLAGS_part_balance_deviation);
+    LOG(INFO) << "The expect avg cost is " << avgLoad << ", max cost is " << maxLoad;
+
+    std::unordered_map<HostAddr, int32_t> movedIn;
+    while (sortedHosts.back().second > maxLoad) {
+        const auto& source = sortedHosts.back();
+        auto& partsFrom = confirmedHostParts[source.first];
+        PartitionID bestPart = -1;
+        HostAddr bestTarget;
+        double bestGain = 0;
+        for (const auto& target : sortedHosts) {
+            if (target.first == source.first) {
+                continue;
+            }
+            if (FLAGS_balance_max_parts_into_host > 0 &&
+                movedIn[target.first] >= FLAGS_balance_max_parts_into_host) {
+                VLOG(3) << "Host " << target.first << " has taken enough parts";
+                continue;
+            }
+            const auto& partsTo = confirmedHostParts[target.first];
+            for (auto partId : partsFrom) {
+                auto cost = replicaCost(partId);
+                if (target.second + cost > maxLoad ||
+                    std::find(partsTo.begin(), partsTo.end(), partId) != partsTo.end()) {
+                    continue;
+                }
+                auto gain = source.second - std::max(source.second - cost, target.second + cost);
+                if (gain > bestGain) {
+                    bestPart = partId;
+                    bestTarget = target.first;
+                    bestGain = gain;
+                }
+            }
+        }
+        if (bestPart < 0) {
+            LOG(INFO) << "No part could be moved out of " << source.first
+                      << ", cost " << source.second;
+            break;
+        }
+
+        LOG(INFO) << "[space:" << spaceId << ", part:" << bestPart << ", cost:"
+                  << replicaCost(bestPart) << "] " << source.first << "->" << bestTarget;
+        partsFrom.erase(std::find(partsFrom.begin(), partsFrom.end(), bestPart));
+        confirmedHostParts[bestTarget].emplace_back(bestPart);
+        movedIn[bestTarget]++;
+        tasks.emplace_back(balanceId,
+                           spaceId,
+                           bestPart,
+                           source.first,
+                           bestTarget,
+                           kv_,
+                           client_);
+        sortedHosts = sortedHostsByCost(confirmedHostParts);
+    }
+    LOG(INFO) << "Balance tasks num: " << tasks.size();
+    for (auto& task : tasks) {
+        LOG(INFO) << task.taskIdStr();
+    }
+    return true;
+}
+
 ErrorOr<cpp2::ErrorCode, bool>
 Balancer::getHostParts(GraphSpaceID spaceId,
                        bool dependentOnGroup,
@@ -613,6 +702,99 @@ Balancer::sortedHostsByParts(const HostParts& hostParts) {
     return hosts;
 }
 
+std::vector<std::pair<HostAddr, double>>
+Balancer::sortedHostsByCost(const HostParts& hostParts) {
+    std::vector<std::pair<HostAddr, double>> hosts;
+    for (auto it = hostParts.begin(); it != hostParts.end(); it++) {
+        double cost = 0;
+        for (auto partId : it->second) {
+            cost += replicaCost(partId);
+        }
+        hosts.emplace_back(it->first, cost);
+    }
+    std::sort(hosts.begin(), hosts.end(), [](const auto& l, const auto& r) {
+        return l.second < r.second;
+    });
+    return hosts;
+}
+
+void Balancer::loadPartCosts(GraphSpaceID spaceId) {
+    partCosts_.clear();
+    auto prefix = MetaServiceUtils::assembleSegmentKey(kvstore::PartLoad::segment(),
+                                                       kvstore::PartLoad::prefix(spaceId));
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto code = kv_->prefix(kDefaultSpaceId, kDefaultPartId, prefix, &iter);
+    if (code != kvstore::ResultCode::SUCCEEDED) {
+        LOG(WARNING) << "Read the load of parts failed, spaceId " << spaceId
+                     << ", balance by the count of parts";
+        return;
+    }
+
+    auto now = time::WallClock::fastNowInSec();
+    std::unordered_map<PartitionID, kvstore::PartLoad> loads;
+    // The parts no longer led by anyone, such as those of a space being dropped, stop
+    // reporting, so their loads are removed once expired
+    std::vector<std::string> expired;
+    double totalBytes = 0;
+    double totalReads = 0;
+    double totalWrites = 0;
+    for (; iter->valid(); iter->next()) {
+        auto load = kvstore::PartLoad::decode(iter->val());
+        if (!load.hasValue() || now - load->reportTime_ > FLAGS_part_load_expired_secs) {
+            expired.emplace_back(iter->key().str());
+            continue;
+        }
+        totalBytes += load->bytes_;
+        totalReads += load->readQps_;
+        totalWrites += load->writeRate_;
+        loads.emplace(kvstore::PartLoad::parsePartId(iter->key()), *load);
+    }
+    if (!expired.empty()) {
+        folly::Baton<true, std::atomic> baton;
+        kv_->asyncMultiRemove(kDefaultSpaceId,
+                              kDefaultPartId,
+                              std::move(expired),
+                              [&baton, spaceId] (kvstore::ResultCode code) {
+            if (code != kvstore::ResultCode::SUCCEEDED) {
+                LOG(WARNING) << "Remove the expired load of parts failed, spaceId " << spaceId;
+            }
+            baton.post();
+        });
+        baton.wait();
+    }
+    if (loads.empty()) {
+        return;
+    }
+
+    // Each kind of load is divided by its average, so a part not reported costs the same as an
+    // average one, and every part costs a little even if it is idle.
+    auto ratio = [] (double load, double total, size_t count) {
+        return total > 0 ? load * count / total : 1.0;
+    };
+    for (const auto& entry : loads) {
+        const auto& load = entry.second;
+        auto bytes = ratio(load.bytes_, totalBytes, loads.size());
+        auto reads = ratio(load.readQps_, totalReads, loads.size());
+        auto writes = ratio(load.writeRate_, totalWrites, loads.size());
+        PartCost cost;
+        cost.replica_ = std::max((bytes + writes) / 2, 0.1);
+        cost.leader_ = std::max((reads + writes) / 2, 0.1);
+        partCosts_.emplace(entry.first, cost);
+    }
+    LOG(INFO) << "Weigh " << partCosts_.size() << " parts of space " << spaceId
+              << " by the reported load";
+}
+
+double Balancer::replicaCost(PartitionID partId) const {
+    auto it = partCosts_.find(partId);
+    return it == partCosts_.end() ? 1.0 : it->second.replica_;
+}
+
+double Balancer::leaderCost(PartitionID partId) const {
+    auto it = partCosts_.find(partId);
+    return it == partCosts_.end() ? 1.0 : it->second.leader_;
+}
+
 Status Balancer::checkReplica(const HostParts& hostParts,
                               const std::vector<HostAddr>& activeHosts,
                               int32_t replica,
@@ -634,7 +816,7 @@ Status Balancer::checkReplica(const HostParts& hostParts,
 ErrorOr<cpp2::ErrorCode, HostAddr>
 Balancer::hostWithMinimalParts(const HostParts& hostParts,
                                PartitionID partId) {
-    auto hosts = sortedHostsByParts(hostParts);
+    auto hosts = sortedHostsByCost(hostParts);
     for (auto& h : hosts) {
         auto it = hostParts.find(h.first);
         if (it == hostParts.end()) {
@@ -653,7 +835,7 @@ ErrorOr<cpp2::ErrorCode, HostAddr>
 Balancer::hostWithMinimalPartsForZone(const HostAddr& source,
                                       const HostParts& hostParts,
                                       PartitionID partId) {
-    auto hosts = sortedHostsByParts(hostParts);
+    auto hosts = sortedHostsByCost(hostParts);
     for (auto& h : hosts) {
         auto it = hostParts.find(h.first);
         if (it == hostParts.end()) {
@@ -830,6 +1012,14 @@ Balancer::buildLeaderBalancePlan(HostLeaderMap* hostLeaderMap,
         }
     }
 
+    loadPartCosts(spaceId);
+    if (!partCosts_.empty()) {
+        // The costs replace the count of leaders, balancing both would move the leaders back
+        // and forth between two plans
+        balanceLeadersByCost(leaderHostParts, peersMap, activeHosts, plan, spaceId);
+        return true;
+    }
+
     while (true) {
         int32_t taskCount = 0;
         bool hasUnbalancedHost = false;
@@ -978,6 +1168,86 @@ int32_t Balancer::giveupLeaders(HostParts& leaderParts,
     return taskCount;
 }
 
+// Instead of the count of leaders, move the leaders out of the host costing the most, in the same
+// way as balancePartsByCost does for parts. A plan leaves every host within the max cost if it
+// can, so planning again on the result moves nothing.
+int32_t Balancer::balanceLeadersByCost(HostParts& leaderHostParts,
+                                       PartAllocation& peersMap,
+                                       std::unordered_set<HostAddr>& activeHosts,
+                                       LeaderBalancePlan& plan,
+                                       GraphSpaceID spaceId) {
+    std::unordered_map<HostAddr, double> loads;
+    double totalCost = 0;
+    for (const auto& host : activeHosts) {
+        double cost = 0;
+        for (auto partId : leaderHostParts[host]) {
+            cost += leaderCost(partId);
+        }
+        loads[host] = cost;
+        totalCost += cost;
+    }
+    auto maxLoad = totalCost / activeHosts.size() * (1 + FLAGS_leader_balance_deviation);
+    VLOG(3) << "Build leader balance plan by cost, expected max cost: " << maxLoad;
+
+    int32_t taskCount = 0;
+    // The hosts none of whose leaders could be moved, e.g. one leading a single hot part
+    std::unordered_set<HostAddr> stuckHosts;
+    while (true) {
+        auto source = loads.end();
+        for (auto it = loads.begin(); it != loads.end(); ++it) {
+            if (!stuckHosts.count(it->first)
+                    && (source == loads.end() || source->second < it->second)) {
+                source = it;
+            }
+        }
+        if (source == loads.end() || source->second <= maxLoad) {
+            break;
+        }
+        auto sourceHost = source->first;
+        auto sourceLoad = source->second;
+        auto& sourceLeaders = leaderHostParts[sourceHost];
+        PartitionID bestPart = -1;
+        HostAddr bestTarget;
+        double bestGain = 0;
+        for (auto partId : sourceLeaders) {
+            auto cost = leaderCost(partId);
+            for (const auto& target : peersMap[partId]) {
+                if (target == sourceHost || !activeHosts.count(target)) {
+                    continue;
+                }
+                auto targetLoad = loads[target];
+                if (targetLoad + cost > maxLoad) {
+                    continue;
+                }
+                auto gain = sourceLoad - std::max(sourceLoad - cost, targetLoad + cost);
+                if (gain > bestGain) {
+                    bestPart = partId;
+                    bestTarget = target;
+                    bestGain = gain;
+                }
+            }
+        }
+        if (bestPart < 0) {
+            LOG(INFO) << "No leader could be moved out of " << sourceHost
+                      << ", cost " << sourceLoad;
+            stuckHosts.emplace(sourceHost);
+            continue;
+        }
+
+        auto cost = leaderCost(bestPart);
+        sourceLeaders.erase(std::find(sourceLeaders.begin(), sourceLeaders.end(), bestPart));
+        leaderHostParts[bestTarget].emplace_back(bestPart);
+        loads[sourceHost] -= cost;
+        loads[bestTarget] += cost;
+        plan.emplace_back(spaceId, bestPart, sourceHost, bestTarget);
+        LOG(INFO) << "cost plan trans leader space: " << spaceId
+                  << " part: " << bestPart << " cost: " << cost
+                  << " from " << sourceHost << " to " << bestTarget;
+        ++taskCount;
+    }
+    return taskCount;
+}
+
 void Balancer::simplifyLeaderBalnacePlan(GraphSpaceID spaceId, LeaderBalancePlan& plan) {
     // Within a leader balance plan, a partition may be moved several times, but actually
     // we only need to transfer the leadership of a partition from the first host to the
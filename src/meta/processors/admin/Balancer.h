@@ -10,6 +10,7 @@
 #include <gtest/gtest_prod.h>
 #include <folly/executors/CPUThreadPoolExecutor.h>
 #include "kvstore/KVStore.h"
+#include "kvstore/PartLoad.h"
 #include "common/network/NetworkUtils.h"
 #include "common/time/WallClock.h"
 #include "meta/processors/admin/AdminClient.h"
@@ -42,6 +43,9 @@ Some notes:
 7. Each balance task contains serval steps. And it should be executed step by step.
 8. One task failed will result in the whole balance plan failed.
 9. Currently, we hope tasks for the same part could be invoked serially
+10. When storaged reports the load of parts (see kvstore::PartLoad), parts and leaders are
+    balanced by the cost of them instead of the count, and a plan moves at most
+    FLAGS_balance_max_parts_into_host parts into a host.
  * */
 class Balancer {
     FRIEND_TEST(BalanceTest, BalancePartsTest);
@@ -68,10 +72,15 @@ class Balancer {
     FRIEND_TEST(BalanceTest, ShrinkZoneTest);
     FRIEND_TEST(BalanceTest, ShrinkHostFromZoneTest);
     FRIEND_TEST(BalanceTest, BalanceWithComplexZoneTest);
+    FRIEND_TEST(BalanceTest, LoadAwareBalancePartsTest);
+    FRIEND_TEST(BalanceTest, LoadAwareLeaderBalancePlanTest);
+    FRIEND_TEST(BalanceTest, LoadAwareLeaderBalanceStableTest);
     FRIEND_TEST(BalanceIntegrationTest, LeaderBalanceTest);
     FRIEND_TEST(BalanceIntegrationTest, BalanceTest);
 
 public:
+    // The balancer is shared by the process, it tells the lived hosts by the persisted
+    // host info only, which falls behind the heartbeats by host_info_persist_interval_secs
     static Balancer* instance(kvstore::KVStore* kv) {
         static std::unique_ptr<AdminClient> client(new AdminClient(kv));
         static std::unique_ptr<Balancer> balancer(new Balancer(kv, client.get()));
@@ -204,6 +213,24 @@ private:
     std::vector<std::pair<HostAddr, int32_t>>
     sortedHostsByParts(const HostParts& hostParts);
 
+    // Sort the hosts by the sum of the replica cost of their parts
+    std::vector<std::pair<HostAddr, double>>
+    sortedHostsByCost(const HostParts& hostParts);
+
+    // Read the load of the parts reported by storaged, and weigh the parts of the space by it
+    void loadPartCosts(GraphSpaceID spaceId);
+
+    // The cost of a replica, which is paid by all hosts of the part
+    double replicaCost(PartitionID partId) const;
+
+    // The cost of being the leader, which is paid only by the leader of the part
+    double leaderCost(PartitionID partId) const;
+
+    bool balancePartsByCost(BalanceID balanceId,
+                            GraphSpaceID spaceId,
+                            HostParts& confirmedHostParts,
+                            std::vector<BalanceTask>& tasks);
+
     cpp2::ErrorCode getAllSpaces(std::vector<std::tuple<GraphSpaceID, int32_t, bool>>& spaces);
 
     ErrorOr<cpp2::ErrorCode, bool>
@@ -231,6 +258,12 @@ private:
                           LeaderBalancePlan& plan,
                           GraphSpaceID spaceId);
 
+    int32_t balanceLeadersByCost(HostParts& leaderHostParts,
+                                 PartAllocation& peersMap,
+                                 std::unordered_set<HostAddr>& activeHosts,
+                                 LeaderBalancePlan& plan,
+                                 GraphSpaceID spaceId);
+
     cpp2::ErrorCode collectZoneParts(const std::string& groupName, HostParts& hostParts);
 
     bool checkZoneLegal(const HostAddr& source, const HostAddr& target, PartitionID part);
@@ -250,6 +283,13 @@ private:
 
     std::unordered_map<HostAddr, std::pair<int32_t, int32_t>> hostBounds_;
     std::unordered_map<HostAddr, ZoneNameAndParts> zoneParts_;
+
+    struct PartCost {
+        double replica_{1.0};
+        double leader_{1.0};
+    };
+    // The cost of the parts of the space being balanced, empty if none of them is reported
+    std::unordered_map<PartitionID, PartCost> partCosts_;
 };
 
 }  // namespace meta
@@ -118,7 +118,7 @@ void CreateBackupProcessor::process(const cpp2::CreateBackupReq& req) {
 
     folly::SharedMutex::WriteHolder wHolder(LockUtils::snapshotLock());
 
-    auto activeHostsRet = ActiveHostsMan::getActiveHosts(kvstore_);
+    auto activeHostsRet = ActiveHostsMan::getActiveHosts(kvstore_, hbTable_);
     if (!nebula::ok(activeHostsRet)) {
         handleErrorCode(nebula::error(activeHostsRet));
         onFinished();
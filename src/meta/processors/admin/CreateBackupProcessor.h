@@ -16,15 +16,19 @@ namespace meta {
 
 class CreateBackupProcessor : public BaseProcessor<cpp2::CreateBackupResp> {
 public:
-    static CreateBackupProcessor* instance(kvstore::KVStore* kvstore, AdminClient* client) {
-        return new CreateBackupProcessor(kvstore, client);
+    static CreateBackupProcessor* instance(kvstore::KVStore* kvstore,
+                                           AdminClient* client,
+                                           const HeartbeatTable* hbTable = nullptr) {
+        return new CreateBackupProcessor(kvstore, client, hbTable);
     }
 
     void process(const cpp2::CreateBackupReq& req);
 
 private:
-    explicit CreateBackupProcessor(kvstore::KVStore* kvstore, AdminClient* client)
-        : BaseProcessor<cpp2::CreateBackupResp>(kvstore), client_(client) {}
+    CreateBackupProcessor(kvstore::KVStore* kvstore,
+                          AdminClient* client,
+                          const HeartbeatTable* hbTable)
+        : BaseProcessor<cpp2::CreateBackupResp>(kvstore), client_(client), hbTable_(hbTable) {}
 
     cpp2::ErrorCode cancelWriteBlocking();
 
@@ -35,6 +39,7 @@ private:
 
 private:
     AdminClient* client_;
+    const HeartbeatTable* hbTable_{nullptr};
 };
 
 }   // namespace meta
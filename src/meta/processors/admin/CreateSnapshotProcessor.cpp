@@ -54,7 +54,7 @@ void CreateSnapshotProcessor::process(const cpp2::CreateSnapshotReq&) {
     auto snapshot = folly::format("SNAPSHOT_{}", MetaServiceUtils::genTimestampStr()).str();
     folly::SharedMutex::WriteHolder wHolder(LockUtils::snapshotLock());
 
-    auto activeHostsRet = ActiveHostsMan::getActiveHosts(kvstore_);
+    auto activeHostsRet = ActiveHostsMan::getActiveHosts(kvstore_, hbTable_);
     if (!nebula::ok(activeHostsRet)) {
         handleErrorCode(nebula::error(activeHostsRet));
         onFinished();
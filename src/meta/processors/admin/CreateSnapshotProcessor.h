@@ -17,22 +17,25 @@ namespace meta {
 class CreateSnapshotProcessor : public BaseProcessor<cpp2::ExecResp> {
 public:
     static CreateSnapshotProcessor* instance(kvstore::KVStore* kvstore,
-                                             AdminClient* client) {
-        return new CreateSnapshotProcessor(kvstore, client);
+                                             AdminClient* client,
+                                             const HeartbeatTable* hbTable = nullptr) {
+        return new CreateSnapshotProcessor(kvstore, client, hbTable);
     }
     void process(const cpp2::CreateSnapshotReq& req);
 
     cpp2::ErrorCode cancelWriteBlocking();
 
 private:
-    explicit CreateSnapshotProcessor(kvstore::KVStore* kvstore,
-                                     AdminClient* client)
-            : BaseProcessor<cpp2::ExecResp>(kvstore), client_(client) {}
+    CreateSnapshotProcessor(kvstore::KVStore* kvstore,
+                            AdminClient* client,
+                            const HeartbeatTable* hbTable)
+            : BaseProcessor<cpp2::ExecResp>(kvstore), client_(client), hbTable_(hbTable) {}
 
     ErrorOr<cpp2::ErrorCode, bool> isIndexRebuilding();
 
 private:
     AdminClient* client_;
+    const HeartbeatTable* hbTable_{nullptr};
 };
 }  // namespace meta
 }  // namespace nebula
@@ -61,10 +61,10 @@ void HBProcessor::process(const cpp2::HBReq& req) {
     HostInfo info(time::WallClock::fastNowInMilliSec(),
                   req.get_role(), req.get_git_info_sha());
     if (req.leader_partIds_ref().has_value()) {
-        ret = ActiveHostsMan::updateHostInfo(kvstore_, host, info,
+        ret = ActiveHostsMan::updateHostInfo(kvstore_, hbTable_, host, info,
                                              &*req.leader_partIds_ref());
     } else {
-        ret = ActiveHostsMan::updateHostInfo(kvstore_, host, info);
+        ret = ActiveHostsMan::updateHostInfo(kvstore_, hbTable_, host, info);
     }
     if (ret == cpp2::ErrorCode::E_LEADER_CHANGED) {
         auto leaderRet = kvstore_->partLeader(kDefaultSpaceId, kDefaultPartId);
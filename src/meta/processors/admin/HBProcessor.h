@@ -45,8 +45,9 @@ class HBProcessor : public BaseProcessor<cpp2::HBResp> {
 public:
     static HBProcessor* instance(kvstore::KVStore* kvstore,
                                  const HBCounters* counters = &kHBCounters,
-                                 ClusterID clusterId = 0) {
-        return new HBProcessor(kvstore, counters, clusterId);
+                                 ClusterID clusterId = 0,
+                                 HeartbeatTable* hbTable = nullptr) {
+        return new HBProcessor(kvstore, counters, clusterId, hbTable);
     }
 
     void process(const cpp2::HBReq& req);
@@ -57,13 +58,16 @@ protected:
 private:
     explicit HBProcessor(kvstore::KVStore* kvstore,
                          const HBCounters* counters,
-                         ClusterID clusterId)
+                         ClusterID clusterId,
+                         HeartbeatTable* hbTable)
             : BaseProcessor<cpp2::HBResp>(kvstore)
             , clusterId_(clusterId)
-            , counters_(counters) {}
+            , counters_(counters)
+            , hbTable_(hbTable) {}
 
     ClusterID clusterId_{0};
     const HBCounters* counters_{nullptr};
+    HeartbeatTable* hbTable_{nullptr};
 };
 
 }  // namespace meta
@@ -22,7 +22,8 @@
 #include "meta/processors/jobMan/JobStatus.h"
 #include "meta/MetaServiceUtils.h"
 
-DEFINE_int32(job_check_intervals, 5000, "job intervals in us");
+DEFINE_int32(max_running_jobs_per_host, 2,
+             "Max number of jobs running on a storage host at the same time");
 DEFINE_double(job_expired_secs, 7 * 24 * 60 * 60, "job expired intervals in sec");
 
 using nebula::kvstore::ResultCode;
@@ -69,6 +70,7 @@ void JobManager::shutDown() {
         std::lock_guard<std::mutex> lk(statusGuard_);
         status_ = JbmgrStatus::STOPPED;
     }
+    wakeUp();
     bgThread_.join();
     LOG(INFO) << "JobManager::shutDown() end";
 }
@@ -76,39 +78,154 @@ void JobManager::shutDown() {
 void JobManager::scheduleThread() {
     LOG(INFO) << "JobManager::runJobBackground() enter";
     while (status_ != JbmgrStatus::STOPPED) {
-        int32_t iJob = 0;
-        while (status_ == JbmgrStatus::BUSY || !try_dequeue(iJob)) {
-            if (status_ == JbmgrStatus::STOPPED) {
-                LOG(INFO) << "[JobManager] detect shutdown called, exit";
-                break;
-            }
-            usleep(FLAGS_job_check_intervals);
+        {
+            std::unique_lock<std::mutex> lk(muSchedule_);
+            cvSchedule_.wait(lk, [this] {
+                return needSchedule_ || status_ == JbmgrStatus::STOPPED;
+            });
+            needSchedule_ = false;
+        }
+        if (status_ == JbmgrStatus::STOPPED) {
+            LOG(INFO) << "[JobManager] detect shutdown called, exit";
+            break;
+        }
+
+        JobID iJob = 0;
+        while (highPriorityQueue_->try_dequeue(iJob)) {
+            pendingHighJobs_.emplace_back(iJob);
+        }
+        while (lowPriorityQueue_->try_dequeue(iJob)) {
+            pendingLowJobs_.emplace_back(iJob);
         }
+        schedulePendingJobs(pendingHighJobs_);
+        schedulePendingJobs(pendingLowJobs_);
+    }
+}
 
+void JobManager::schedulePendingJobs(std::list<JobID>& pendingJobs) {
+    auto it = pendingJobs.begin();
+    while (it != pendingJobs.end() && status_ != JbmgrStatus::STOPPED) {
+        auto iJob = *it;
         auto jobDescRet = JobDescription::loadJobDescription(iJob, kvStore_);
         if (!nebula::ok(jobDescRet)) {
             LOG(ERROR) << "[JobManager] load an invalid job from queue " << iJob;
-            continue;   // leader change or archive happend
+            it = pendingJobs.erase(it);   // leader change or archive happend
+            continue;
         }
         auto jobDesc = nebula::value(jobDescRet);
         if (!jobDesc.setStatus(cpp2::JobStatus::RUNNING)) {
             LOG(INFO) << "[JobManager] skip job " << iJob;
+            it = pendingJobs.erase(it);
             continue;
         }
-        save(jobDesc.jobKey(), jobDesc.jobVal());
-        {
-            std::lock_guard<std::mutex> lk(statusGuard_);
-            if (status_ == JbmgrStatus::IDLE) {
-                status_ = JbmgrStatus::BUSY;
-            }
+        if (!admitJob(jobDesc)) {
+            // Wait for the jobs it conflicts with, the later jobs may still run
+            VLOG(1) << "[JobManager] job " << iJob << " has to wait";
+            ++it;
+            continue;
         }
+        it = pendingJobs.erase(it);
 
+        save(jobDesc.jobKey(), jobDesc.jobVal());
         if (!runJobInternal(jobDesc)) {
             jobFinished(iJob, cpp2::JobStatus::FAILED);
         }
     }
 }
 
+bool JobManager::admitJob(const JobDescription& jobDesc) {
+    // All the jobs take the space name as the last parameter
+    std::string spaceName;
+    if (!jobDesc.getParas().empty()) {
+        spaceName = jobDesc.getParas().back();
+    }
+    std::vector<HostAddr> hosts;
+    auto spaceIdRet = getSpaceId(spaceName);
+    if (nebula::ok(spaceIdRet)) {
+        auto hostsRet = getSpaceHosts(nebula::value(spaceIdRet));
+        if (nebula::ok(hostsRet)) {
+            hosts = nebula::value(hostsRet);
+        }
+    }
+
+    std::lock_guard<std::mutex> lk(muSchedule_);
+    // The jobs of the same space conflict with each other, e.g. the statistics are not
+    // reliable while the index is rebuilding, so they run one by one
+    if (runningSpaces_.count(spaceName) != 0) {
+        return false;
+    }
+    for (const auto& host : hosts) {
+        auto it = runningOnHost_.find(host);
+        if (it != runningOnHost_.end() && it->second >= FLAGS_max_running_jobs_per_host) {
+            return false;
+        }
+    }
+
+    runningSpaces_.emplace(spaceName, jobDesc.getJobId());
+    for (const auto& host : hosts) {
+        ++runningOnHost_[host];
+    }
+    runningJobs_.emplace(jobDesc.getJobId(), std::make_pair(spaceName, std::move(hosts)));
+    std::lock_guard<std::mutex> statusLk(statusGuard_);
+    if (status_ == JbmgrStatus::IDLE) {
+        status_ = JbmgrStatus::BUSY;
+    }
+    return true;
+}
+
+void JobManager::releaseJob(JobID jobId) {
+    {
+        std::lock_guard<std::mutex> lk(muSchedule_);
+        auto it = runningJobs_.find(jobId);
+        if (it == runningJobs_.end()) {
+            return;
+        }
+        auto spaceIt = runningSpaces_.find(it->second.first);
+        if (spaceIt != runningSpaces_.end() && spaceIt->second == jobId) {
+            runningSpaces_.erase(spaceIt);
+        }
+        for (const auto& host : it->second.second) {
+            if (--runningOnHost_[host] <= 0) {
+                runningOnHost_.erase(host);
+            }
+        }
+        runningJobs_.erase(it);
+        if (runningJobs_.empty()) {
+            std::lock_guard<std::mutex> statusLk(statusGuard_);
+            if (status_ == JbmgrStatus::BUSY) {
+                status_ = JbmgrStatus::IDLE;
+            }
+        }
+    }
+    // The jobs waiting for it may run now
+    wakeUp();
+}
+
+void JobManager::wakeUp() {
+    {
+        std::lock_guard<std::mutex> lk(muSchedule_);
+        needSchedule_ = true;
+    }
+    cvSchedule_.notify_one();
+}
+
+ErrorOr<cpp2::ErrorCode, std::vector<HostAddr>> JobManager::getSpaceHosts(GraphSpaceID spaceId) {
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto partPrefix = MetaServiceUtils::partPrefix(spaceId);
+    auto rc = kvStore_->prefix(kDefaultSpaceId, kDefaultPartId, partPrefix, &iter);
+    if (rc != kvstore::ResultCode::SUCCEEDED) {
+        return MetaCommon::to(rc);
+    }
+    std::vector<HostAddr> hosts;
+    for (; iter->valid(); iter->next()) {
+        auto targets = MetaServiceUtils::parsePartVal(iter->val());
+        hosts.insert(hosts.end(), targets.begin(), targets.end());
+    }
+    std::sort(hosts.begin(), hosts.end());
+    hosts.erase(std::unique(hosts.begin(), hosts.end()), hosts.end());
+    return hosts;
+}
+
 // @return: true if all task dispatched, else false
 bool JobManager::runJobInternal(const JobDescription& jobDesc) {
     auto jobExec = MetaJobExecutorFactory::createMetaJobExecutor(jobDesc, kvStore_, adminClient_);
@@ -160,15 +277,9 @@ cpp2::ErrorCode JobManager::jobFinished(JobID jobId, cpp2::JobStatus jobStatus)
     auto optJobDescRet = JobDescription::loadJobDescription(jobId, kvStore_);
     if (!nebula::ok(optJobDescRet)) {
         LOG(WARNING) << folly::sformat("can't load job, jobId={}", jobId);
-        if (jobStatus != cpp2::JobStatus::STOPPED) {
-            // there is a rare condition, that when job finished,
-            // the job description is deleted(default more than a week)
-            // but stop an invalid job should not set status to idle.
-            std::lock_guard<std::mutex> statusLk(statusGuard_);
-            if (status_ == JbmgrStatus::BUSY) {
-                status_ = JbmgrStatus::IDLE;
-            }
-        }
+        // there is a rare condition, that when job finished,
+        // the job description is deleted(default more than a week)
+        releaseJob(jobId);
         return nebula::error(optJobDescRet);
     }
 
@@ -178,12 +289,8 @@ cpp2::ErrorCode JobManager::jobFinished(JobID jobId, cpp2::JobStatus jobStatus)
         // job already been set as finished, failed or stopped
         return cpp2::ErrorCode::E_SAVE_JOB_FAILURE;
     }
-    {
-        std::lock_guard<std::mutex> statusLk(statusGuard_);
-        if (status_ == JbmgrStatus::BUSY) {
-            status_ = JbmgrStatus::IDLE;
-        }
-    }
+    // Only the job not running yet is stopped before here, releasing it does nothing
+    releaseJob(jobId);
     auto rc = save(optJobDesc.jobKey(), optJobDesc.jobVal());
     if (rc != cpp2::ErrorCode::SUCCEEDED) {
         return rc;
@@ -377,6 +484,7 @@ void JobManager::enqueue(const JobID& jobId, const cpp2::AdminCmd& cmd) {
     } else {
         lowPriorityQueue_->enqueue(jobId);
     }
+    wakeUp();
 }
 
 ErrorOr<cpp2::ErrorCode, std::vector<cpp2::JobDesc>>
@@ -39,6 +39,7 @@ class JobManager : public nebula::cpp::NonCopyable, public nebula::cpp::NonMovab
     FRIEND_TEST(JobManagerTest, recoverJob);
     FRIEND_TEST(JobManagerTest, AddRebuildTagIndexJob);
     FRIEND_TEST(JobManagerTest, AddRebuildEdgeIndexJob);
+    FRIEND_TEST(JobManagerTest, AdmitJob);
     FRIEND_TEST(GetStatisTest, StatisJob);
     FRIEND_TEST(GetStatisTest, MockSingleMachineTest);
     FRIEND_TEST(GetStatisTest, MockMultiMachineTest);
@@ -50,7 +51,7 @@ public:
     enum class JbmgrStatus {
         NOT_START,
         IDLE,       // Job manager started, no running any job
-        BUSY,       // Job manager is running job
+        BUSY,       // Job manager is running jobs
         STOPPED,
     };
 
@@ -107,6 +108,20 @@ private:
     void scheduleThread();
     void scheduleThreadOld();
 
+    // Run the pending jobs in order as long as they are admitted, remove them once they run
+    void schedulePendingJobs(std::list<JobID>& pendingJobs);
+
+    // A job is admitted when no other job is running in its space, and each host of the space
+    // runs less than FLAGS_max_running_jobs_per_host jobs. Reserve them for the job if so.
+    bool admitJob(const JobDescription& jobDesc);
+
+    // Give back what the job reserved, and wake up the scheduler
+    void releaseJob(JobID jobId);
+
+    void wakeUp();
+
+    ErrorOr<cpp2::ErrorCode, std::vector<HostAddr>> getSpaceHosts(GraphSpaceID spaceId);
+
     bool runJobInternal(const JobDescription& jobDesc);
     bool runJobInternalOld(const JobDescription& jobDesc);
 
@@ -134,6 +149,19 @@ private:
     // The job in running or queue
     folly::ConcurrentHashMap<JobID, JobDescription>    inFlightJobs_;
 
+    // Only accessed by the schedule thread, the jobs dequeued but not admitted yet
+    std::list<JobID>                                   pendingHighJobs_;
+    std::list<JobID>                                   pendingLowJobs_;
+
+    std::mutex                                         muSchedule_;
+    std::condition_variable                            cvSchedule_;
+    bool                                               needSchedule_{false};
+    // space name -> the job running in it
+    std::unordered_map<std::string, JobID>             runningSpaces_;
+    // job -> <space name, the hosts it runs on>
+    std::unordered_map<JobID, std::pair<std::string, std::vector<HostAddr>>> runningJobs_;
+    std::map<HostAddr, int32_t>                        runningOnHost_;
+
     std::thread                                        bgThread_;
     std::mutex                                         statusGuard_;
     JbmgrStatus                                        status_{JbmgrStatus::NOT_START};
@@ -115,6 +115,7 @@ void ListListenerProcessor::process(const cpp2::ListListenerReq& req) {
 
     auto activeHostsRet = ActiveHostsMan::getActiveHosts(
         kvstore_,
+        hbTable_,
         FLAGS_heartbeat_interval_secs * FLAGS_expired_time_factor,
         cpp2::HostRole::LISTENER);
     if (!nebula::ok(activeHostsRet)) {
@@ -41,15 +41,19 @@ private:
 
 class ListListenerProcessor : public BaseProcessor<cpp2::ListListenerResp> {
 public:
-    static ListListenerProcessor* instance(kvstore::KVStore* kvstore) {
-        return new ListListenerProcessor(kvstore);
+    static ListListenerProcessor* instance(kvstore::KVStore* kvstore,
+                                           const HeartbeatTable* hbTable = nullptr) {
+        return new ListListenerProcessor(kvstore, hbTable);
     }
 
     void process(const cpp2::ListListenerReq& req);
 
 private:
-    explicit ListListenerProcessor(kvstore::KVStore* kvstore)
-            : BaseProcessor<cpp2::ListListenerResp>(kvstore) {}
+    ListListenerProcessor(kvstore::KVStore* kvstore, const HeartbeatTable* hbTable)
+            : BaseProcessor<cpp2::ListListenerResp>(kvstore)
+            , hbTable_(hbTable) {}
+
+    const HeartbeatTable* hbTable_{nullptr};
 };
 
 }  // namespace meta
@@ -199,7 +199,7 @@ void CreateSpaceProcessor::process(const cpp2::CreateSpaceReq& req) {
                               MetaServiceUtils::partVal(partHosts));
         }
     } else {
-        auto hostsRet = ActiveHostsMan::getActiveHosts(kvstore_);
+        auto hostsRet = ActiveHostsMan::getActiveHosts(kvstore_, hbTable_);
         if (!nebula::ok(hostsRet)) {
             auto retCode = nebula::error(hostsRet);
             LOG(ERROR) << "Create Space Failed when get active host, error "
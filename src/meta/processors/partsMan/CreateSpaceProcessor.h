@@ -16,15 +16,17 @@ using Hosts = std::vector<HostAddr>;
 
 class CreateSpaceProcessor : public BaseProcessor<cpp2::ExecResp> {
 public:
-    static CreateSpaceProcessor* instance(kvstore::KVStore* kvstore) {
-        return new CreateSpaceProcessor(kvstore);
+    static CreateSpaceProcessor* instance(kvstore::KVStore* kvstore,
+                                          const HeartbeatTable* hbTable = nullptr) {
+        return new CreateSpaceProcessor(kvstore, hbTable);
     }
 
     void process(const cpp2::CreateSpaceReq& req);
 
 private:
-    explicit CreateSpaceProcessor(kvstore::KVStore* kvstore)
-            : BaseProcessor<cpp2::ExecResp>(kvstore) {}
+    CreateSpaceProcessor(kvstore::KVStore* kvstore, const HeartbeatTable* hbTable)
+            : BaseProcessor<cpp2::ExecResp>(kvstore)
+            , hbTable_(hbTable) {}
 
     Hosts pickHosts(PartitionID partId,
                     const Hosts& hosts,
@@ -45,6 +47,7 @@ private:
 private:
     std::unordered_map<std::string, int32_t> zoneLoading_;
     std::unordered_map<HostAddr, int32_t> hostLoading_;
+    const HeartbeatTable* hbTable_{nullptr};
 };
 
 }  // namespace meta
@@ -5,6 +5,7 @@
  */
 
 #include "meta/processors/partsMan/DropSpaceProcessor.h"
+#include "kvstore/PartLoad.h"
 
 namespace nebula {
 namespace meta {
@@ -100,6 +101,25 @@ void DropSpaceProcessor::process(const cpp2::DropSpaceReq& req) {
     auto statiskey = MetaServiceUtils::statisKey(spaceId);
     deleteKeys.emplace_back(statiskey);
 
+    // Delete the load of parts reported by storaged
+    auto loadPrefix = MetaServiceUtils::assembleSegmentKey(kvstore::PartLoad::segment(),
+                                                           kvstore::PartLoad::prefix(spaceId));
+    auto loadRet = doPrefix(loadPrefix);
+    if (!nebula::ok(loadRet)) {
+        auto retCode = nebula::error(loadRet);
+        LOG(ERROR) << "Drop space Failed, space " << spaceName
+                   << " error: " << apache::thrift::util::enumNameSafe(retCode);
+        handleErrorCode(retCode);
+        onFinished();
+        return;
+    }
+
+    auto loadIter = nebula::value(loadRet).get();
+    while (loadIter->valid()) {
+        deleteKeys.emplace_back(loadIter->key());
+        loadIter->next();
+    }
+
     doSyncMultiRemoveAndUpdate(std::move(deleteKeys));
     LOG(INFO) << "Drop space " << spaceName << ", id " << spaceId;
 }
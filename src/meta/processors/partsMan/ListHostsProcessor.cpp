@@ -121,6 +121,7 @@ cpp2::ErrorCode ListHostsProcessor::allHostsWithStatus(cpp2::HostRole role) {
 
         cpp2::HostItem item;
         auto host = MetaServiceUtils::parseHostKey(iter->key());
+        ActiveHostsMan::refreshHostInfo(hbTable_, host, info);
         item.set_hostAddr(std::move(host));
 
         item.set_role(info.role_);
@@ -153,7 +154,7 @@ cpp2::ErrorCode ListHostsProcessor::fillLeaders() {
     }
 
     // get hosts which have send heartbeat recently
-    auto activeHostsRet = ActiveHostsMan::getActiveHosts(kvstore_);
+    auto activeHostsRet = ActiveHostsMan::getActiveHosts(kvstore_, hbTable_);
     if (!nebula::ok(activeHostsRet)) {
         return nebula::error(activeHostsRet);
     }
@@ -14,15 +14,17 @@ namespace meta {
 
 class ListHostsProcessor : public BaseProcessor<cpp2::ListHostsResp> {
 public:
-    static ListHostsProcessor* instance(kvstore::KVStore* kvstore) {
-        return new ListHostsProcessor(kvstore);
+    static ListHostsProcessor* instance(kvstore::KVStore* kvstore,
+                                        const HeartbeatTable* hbTable = nullptr) {
+        return new ListHostsProcessor(kvstore, hbTable);
     }
 
     void process(const cpp2::ListHostsReq& req);
 
 private:
-    explicit ListHostsProcessor(kvstore::KVStore* kvstore)
-            : BaseProcessor<cpp2::ListHostsResp>(kvstore) {}
+    ListHostsProcessor(kvstore::KVStore* kvstore, const HeartbeatTable* hbTable)
+            : BaseProcessor<cpp2::ListHostsResp>(kvstore)
+            , hbTable_(hbTable) {}
 
     /**
      *  return online/offline, gitInfoSHA for the specific HostRole
@@ -51,6 +53,7 @@ private:
     std::vector<GraphSpaceID>                     spaceIds_;
     std::unordered_map<GraphSpaceID, std::string> spaceIdNameMap_;
     std::vector<cpp2::HostItem>                   hostItems_;
+    const HeartbeatTable*                         hbTable_{nullptr};
 };
 
 }  // namespace meta
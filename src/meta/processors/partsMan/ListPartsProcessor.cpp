@@ -49,7 +49,7 @@ void ListPartsProcessor::process(const cpp2::ListPartsReq& req) {
     }
 
     std::vector<cpp2::PartItem> partItems;
-    auto activeHostsRet = ActiveHostsMan::getActiveHosts(kvstore_);
+    auto activeHostsRet = ActiveHostsMan::getActiveHosts(kvstore_, hbTable_);
     if (!nebula::ok(activeHostsRet)) {
         handleErrorCode(nebula::error(activeHostsRet));
         onFinished();
@@ -111,7 +111,7 @@ ListPartsProcessor::getAllParts() {
 }
 
 cpp2::ErrorCode ListPartsProcessor::getLeaderDist(std::vector<cpp2::PartItem>& partItems) {
-    auto activeHostsRet = ActiveHostsMan::getActiveHosts(kvstore_);
+    auto activeHostsRet = ActiveHostsMan::getActiveHosts(kvstore_, hbTable_);
     if (!nebula::ok(activeHostsRet)) {
         return nebula::error(activeHostsRet);
     }
@@ -15,15 +15,17 @@ namespace meta {
 
 class ListPartsProcessor : public BaseProcessor<cpp2::ListPartsResp> {
 public:
-    static ListPartsProcessor* instance(kvstore::KVStore* kvstore) {
-        return new ListPartsProcessor(kvstore);
+    static ListPartsProcessor* instance(kvstore::KVStore* kvstore,
+                                        const HeartbeatTable* hbTable = nullptr) {
+        return new ListPartsProcessor(kvstore, hbTable);
     }
 
     void process(const cpp2::ListPartsReq& req);
 
 private:
-    explicit ListPartsProcessor(kvstore::KVStore* kvstore)
-            : BaseProcessor<cpp2::ListPartsResp>(kvstore) {}
+    ListPartsProcessor(kvstore::KVStore* kvstore, const HeartbeatTable* hbTable)
+            : BaseProcessor<cpp2::ListPartsResp>(kvstore)
+            , hbTable_(hbTable) {}
 
 
     // Get parts alloc information
@@ -37,6 +39,7 @@ private:
     GraphSpaceID                                        spaceId_;
     std::vector<PartitionID>                            partIds_;
     bool                                                showAllParts_{true};
+    const HeartbeatTable*                               hbTable_{nullptr};
 };
 
 }  // namespace meta
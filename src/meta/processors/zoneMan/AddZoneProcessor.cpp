@@ -30,7 +30,7 @@ void AddZoneProcessor::process(const cpp2::AddZoneReq& req) {
         return;
     }
 
-    auto activeHostsRet = ActiveHostsMan::getActiveHosts(kvstore_);
+    auto activeHostsRet = ActiveHostsMan::getActiveHosts(kvstore_, hbTable_);
     if (!nebula::ok(activeHostsRet)) {
         auto retCode = nebula::error(activeHostsRet);
         LOG(ERROR) << "Create zone failed, error: " << apache::thrift::util::enumNameSafe(retCode);
@@ -14,17 +14,22 @@ namespace meta {
 
 class AddZoneProcessor : public BaseProcessor<cpp2::ExecResp> {
 public:
-    static AddZoneProcessor* instance(kvstore::KVStore* kvstore) {
-        return new AddZoneProcessor(kvstore);
+    static AddZoneProcessor* instance(kvstore::KVStore* kvstore,
+                                      const HeartbeatTable* hbTable = nullptr) {
+        return new AddZoneProcessor(kvstore, hbTable);
     }
 
     void process(const cpp2::AddZoneReq& req);
 
 private:
-    explicit AddZoneProcessor(kvstore::KVStore* kvstore)
-        : BaseProcessor<cpp2::ExecResp>(kvstore) {}
+    AddZoneProcessor(kvstore::KVStore* kvstore, const HeartbeatTable* hbTable)
+        : BaseProcessor<cpp2::ExecResp>(kvstore)
+        , hbTable_(hbTable) {}
 
     cpp2::ErrorCode checkHostNotOverlap(const std::vector<HostAddr>& nodes);
+
+private:
+    const HeartbeatTable* hbTable_{nullptr};
 };
 
 }  // namespace meta
@@ -45,7 +45,7 @@ void AddHostIntoZoneProcessor::process(const cpp2::AddHostIntoZoneReq& req) {
         return;
     }
 
-    auto activeHostsRet = ActiveHostsMan::getActiveHosts(kvstore_);
+    auto activeHostsRet = ActiveHostsMan::getActiveHosts(kvstore_, hbTable_);
     if (!nebula::ok(activeHostsRet)) {
         auto retCode = nebula::error(activeHostsRet);
         LOG(ERROR) << "Get hosts failed, error: " << apache::thrift::util::enumNameSafe(retCode);
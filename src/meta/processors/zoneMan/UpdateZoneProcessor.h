@@ -14,15 +14,19 @@ namespace meta {
 
 class AddHostIntoZoneProcessor : public BaseProcessor<cpp2::ExecResp> {
 public:
-    static AddHostIntoZoneProcessor* instance(kvstore::KVStore* kvstore) {
-        return new AddHostIntoZoneProcessor(kvstore);
+    static AddHostIntoZoneProcessor* instance(kvstore::KVStore* kvstore,
+                                              const HeartbeatTable* hbTable = nullptr) {
+        return new AddHostIntoZoneProcessor(kvstore, hbTable);
     }
 
     void process(const cpp2::AddHostIntoZoneReq& req);
 
 private:
-    explicit AddHostIntoZoneProcessor(kvstore::KVStore* kvstore)
-        : BaseProcessor<cpp2::ExecResp>(kvstore) {}
+    AddHostIntoZoneProcessor(kvstore::KVStore* kvstore, const HeartbeatTable* hbTable)
+        : BaseProcessor<cpp2::ExecResp>(kvstore)
+        , hbTable_(hbTable) {}
+
+    const HeartbeatTable* hbTable_{nullptr};
 };
 
 class DropHostFromZoneProcessor : public BaseProcessor<cpp2::ExecResp> {
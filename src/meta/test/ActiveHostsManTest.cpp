@@ -13,6 +13,7 @@
 
 DECLARE_int32(heartbeat_interval_secs);
 DECLARE_uint32(expired_time_factor);
+DECLARE_int32(host_info_persist_interval_secs);
 
 namespace nebula {
 namespace meta {
@@ -51,19 +52,24 @@ TEST(ActiveHostsManTest, EncodeDecodeHostInfoV2) {
 TEST(ActiveHostsManTest, NormalTest) {
     fs::TempDir rootPath("/tmp/ActiveHostsManTest.XXXXXX");
     FLAGS_heartbeat_interval_secs = 1;
+    // persist every heartbeat, so we could check the host info in kvstore
+    FLAGS_host_info_persist_interval_secs = 0;
+    SCOPE_EXIT {
+        FLAGS_host_info_persist_interval_secs = 20;
+    };
     std::unique_ptr<kvstore::KVStore> kv(MockCluster::initMetaKV(rootPath.path()));
     auto now = time::WallClock::fastNowInMilliSec();
     HostInfo info1(now, cpp2::HostRole::STORAGE, gitInfoSha());
-    ActiveHostsMan::updateHostInfo(kv.get(), HostAddr("0", 0), info1);
-    ActiveHostsMan::updateHostInfo(kv.get(), HostAddr("0", 1), info1);
-    ActiveHostsMan::updateHostInfo(kv.get(), HostAddr("0", 2), info1);
-    auto hostsRet = ActiveHostsMan::getActiveHosts(kv.get());
+    ActiveHostsMan::updateHostInfo(kv.get(), nullptr, HostAddr("0", 0), info1);
+    ActiveHostsMan::updateHostInfo(kv.get(), nullptr, HostAddr("0", 1), info1);
+    ActiveHostsMan::updateHostInfo(kv.get(), nullptr, HostAddr("0", 2), info1);
+    auto hostsRet = ActiveHostsMan::getActiveHosts(kv.get(), nullptr);
     ASSERT_TRUE(nebula::ok(hostsRet));
     ASSERT_EQ(3, nebula::value(hostsRet).size());
 
     HostInfo info2(now + 2000, cpp2::HostRole::STORAGE, gitInfoSha());
-    ActiveHostsMan::updateHostInfo(kv.get(), HostAddr("0", 0), info2);
-    hostsRet = ActiveHostsMan::getActiveHosts(kv.get());
+    ActiveHostsMan::updateHostInfo(kv.get(), nullptr, HostAddr("0", 0), info2);
+    hostsRet = ActiveHostsMan::getActiveHosts(kv.get(), nullptr);
     ASSERT_TRUE(nebula::ok(hostsRet));
     ASSERT_EQ(3, nebula::value(hostsRet).size());
 
@@ -89,7 +95,7 @@ TEST(ActiveHostsManTest, NormalTest) {
     }
 
     sleep(FLAGS_heartbeat_interval_secs * FLAGS_expired_time_factor + 1);
-    hostsRet = ActiveHostsMan::getActiveHosts(kv.get());
+    hostsRet = ActiveHostsMan::getActiveHosts(kv.get(), nullptr);
     ASSERT_TRUE(nebula::ok(hostsRet));
     ASSERT_EQ(1, nebula::value(hostsRet).size());
 }
@@ -102,10 +108,10 @@ TEST(ActiveHostsManTest, LeaderTest) {
 
     HostInfo hInfo1(now, cpp2::HostRole::STORAGE, gitInfoSha());
     HostInfo hInfo2(now + 2000, cpp2::HostRole::STORAGE, gitInfoSha());
-    ActiveHostsMan::updateHostInfo(kv.get(), HostAddr("0", 0), hInfo1);
-    ActiveHostsMan::updateHostInfo(kv.get(), HostAddr("0", 1), hInfo1);
-    ActiveHostsMan::updateHostInfo(kv.get(), HostAddr("0", 2), hInfo1);
-    auto hostsRet = ActiveHostsMan::getActiveHosts(kv.get());
+    ActiveHostsMan::updateHostInfo(kv.get(), nullptr, HostAddr("0", 0), hInfo1);
+    ActiveHostsMan::updateHostInfo(kv.get(), nullptr, HostAddr("0", 1), hInfo1);
+    ActiveHostsMan::updateHostInfo(kv.get(), nullptr, HostAddr("0", 2), hInfo1);
+    auto hostsRet = ActiveHostsMan::getActiveHosts(kv.get(), nullptr);
     ASSERT_TRUE(nebula::ok(hostsRet));
     ASSERT_EQ(3, nebula::value(hostsRet).size());
 
@@ -135,8 +141,8 @@ TEST(ActiveHostsManTest, LeaderTest) {
     std::unordered_map<GraphSpaceID, std::vector<cpp2::LeaderInfo>> leaderIds;
     leaderIds.emplace(1, std::vector<cpp2::LeaderInfo>{part1, part2});
     leaderIds.emplace(2, std::vector<cpp2::LeaderInfo>{part3});
-    ActiveHostsMan::updateHostInfo(kv.get(), host, hInfo2, &leaderIds);
-    hostsRet = ActiveHostsMan::getActiveHosts(kv.get());
+    ActiveHostsMan::updateHostInfo(kv.get(), nullptr, host, hInfo2, &leaderIds);
+    hostsRet = ActiveHostsMan::getActiveHosts(kv.get(), nullptr);
     ASSERT_TRUE(nebula::ok(hostsRet));
     ASSERT_EQ(3, nebula::value(hostsRet).size());
 
@@ -168,11 +174,62 @@ TEST(ActiveHostsManTest, LeaderTest) {
     }
 
     sleep(FLAGS_heartbeat_interval_secs * FLAGS_expired_time_factor + 1);
-    hostsRet = ActiveHostsMan::getActiveHosts(kv.get());
+    hostsRet = ActiveHostsMan::getActiveHosts(kv.get(), nullptr);
     ASSERT_TRUE(nebula::ok(hostsRet));
     ASSERT_EQ(1, nebula::value(hostsRet).size());
 }
 
+TEST(ActiveHostsManTest, PersistIntervalTest) {
+    fs::TempDir rootPath("/tmp/ActiveHostsManTest.XXXXXX");
+    FLAGS_heartbeat_interval_secs = 1;
+    FLAGS_host_info_persist_interval_secs = 60;
+    std::unique_ptr<kvstore::KVStore> kv(MockCluster::initMetaKV(rootPath.path()));
+    auto now = time::WallClock::fastNowInMilliSec();
+    HostAddr host("0", 0);
+    auto hostKey = MetaServiceUtils::hostKey(host.host, host.port);
+    HeartbeatTable hbTable;
+
+    // a new host is persisted at once
+    HostInfo info1(now, cpp2::HostRole::STORAGE, gitInfoSha());
+    ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED,
+              ActiveHostsMan::updateHostInfo(kv.get(), &hbTable, host, info1));
+    std::string val;
+    ASSERT_EQ(kvstore::ResultCode::SUCCEEDED,
+              kv->get(kDefaultSpaceId, kDefaultPartId, hostKey, &val));
+    ASSERT_EQ(info1, HostInfo::decode(val));
+
+    // a later heartbeat within the interval is only kept in memory
+    HostInfo info2(now + 10000, cpp2::HostRole::STORAGE, gitInfoSha());
+    ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED,
+              ActiveHostsMan::updateHostInfo(kv.get(), &hbTable, host, info2));
+    ASSERT_EQ(kvstore::ResultCode::SUCCEEDED,
+              kv->get(kDefaultSpaceId, kDefaultPartId, hostKey, &val));
+    ASSERT_EQ(info1, HostInfo::decode(val));
+    auto infoRet = ActiveHostsMan::getHostInfo(kv.get(), &hbTable, host);
+    ASSERT_TRUE(nebula::ok(infoRet));
+    ASSERT_EQ(info2, nebula::value(infoRet));
+    // without the table, only the persisted info is seen
+    infoRet = ActiveHostsMan::getHostInfo(kv.get(), nullptr, host);
+    ASSERT_TRUE(nebula::ok(infoRet));
+    ASSERT_EQ(info1, nebula::value(infoRet));
+
+    // the host is still alive by the heartbeat time in memory
+    sleep(FLAGS_heartbeat_interval_secs * FLAGS_expired_time_factor + 1);
+    auto hostsRet = ActiveHostsMan::getActiveHosts(kv.get(), &hbTable);
+    ASSERT_TRUE(nebula::ok(hostsRet));
+    ASSERT_EQ(1, nebula::value(hostsRet).size());
+
+    // the changed host info is persisted at once
+    HostInfo info3(now + 10000, cpp2::HostRole::STORAGE, "new_git_sha");
+    ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED,
+              ActiveHostsMan::updateHostInfo(kv.get(), &hbTable, host, info3));
+    ASSERT_EQ(kvstore::ResultCode::SUCCEEDED,
+              kv->get(kDefaultSpaceId, kDefaultPartId, hostKey, &val));
+    ASSERT_EQ("new_git_sha", HostInfo::decode(val).gitInfoSha_);
+
+    FLAGS_host_info_persist_interval_secs = 20;
+}
+
 TEST(LastUpdateTimeManTest, NormalTest) {
     fs::TempDir rootPath("/tmp/LastUpdateTimeManTest.XXXXXX");
     std::unique_ptr<kvstore::KVStore> kv(MockCluster::initMetaKV(rootPath.path()));
@@ -314,9 +314,9 @@ TEST(AdminClientTest, SnapshotTest) {
     auto now = time::WallClock::fastNowInMilliSec();
     HostAddr host(localIp, rpcServer->port_);
     HostAddr storageHost = Utils::getStoreAddrFromAdminAddr(host);
-    ActiveHostsMan::updateHostInfo(kv.get(), storageHost,
+    ActiveHostsMan::updateHostInfo(kv.get(), nullptr, storageHost,
                                    HostInfo(now, meta::cpp2::HostRole::STORAGE, ""));
-    auto hostsRet = ActiveHostsMan::getActiveHosts(kv.get());
+    auto hostsRet = ActiveHostsMan::getActiveHosts(kv.get(), nullptr);
     ASSERT_TRUE(nebula::ok(hostsRet));
     ASSERT_EQ(1, nebula::value(hostsRet).size());
 
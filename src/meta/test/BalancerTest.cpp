@@ -18,6 +18,7 @@ DECLARE_uint32(task_concurrency);
 DECLARE_int32(heartbeat_interval_secs);
 DECLARE_uint32(expired_time_factor);
 DECLARE_double(leader_balance_deviation);
+DECLARE_int32(balance_max_parts_into_host);
 
 namespace nebula {
 namespace meta {
@@ -778,6 +779,79 @@ TEST(BalanceTest, BalancePartsTest) {
     }
 }
 
+TEST(BalanceTest, LoadAwareBalancePartsTest) {
+    fs::TempDir rootPath("/tmp/LoadAwareBalancePartsTest.XXXXXX");
+    auto store = MockCluster::initMetaKV(rootPath.path());
+    auto* kv = dynamic_cast<kvstore::KVStore*>(store.get());
+    DefaultValue<folly::Future<Status>>::SetFactory([] {
+        return folly::Future<Status>(Status::OK());
+    });
+    NiceMock<MockAdminClient> client;
+    Balancer balancer(kv, &client);
+    auto now = time::WallClock::fastNowInSec();
+    {
+        // The expired load is ignored and removed
+        std::unordered_map<PartitionID, kvstore::PartLoad> loads;
+        loads[1].bytes_ = 100;
+        loads[1].reportTime_ = now - 3600;
+        TestUtils::mockPartLoads(kv, 1, loads);
+        balancer.loadPartCosts(1);
+        EXPECT_TRUE(balancer.partCosts_.empty());
+        auto prefix = MetaServiceUtils::assembleSegmentKey(kvstore::PartLoad::segment(),
+                                                           kvstore::PartLoad::prefix(1));
+        std::unique_ptr<kvstore::KVIterator> iter;
+        ASSERT_EQ(kvstore::ResultCode::SUCCEEDED, kv->prefix(0, 0, prefix, &iter));
+        EXPECT_FALSE(iter->valid());
+    }
+    {
+        // The count of parts is balanced, but part 1 is 7 times larger than the others
+        std::unordered_map<PartitionID, kvstore::PartLoad> loads;
+        for (PartitionID partId = 1; partId <= 8; partId++) {
+            loads[partId].bytes_ = partId == 1 ? 70 : 10;
+            loads[partId].reportTime_ = now;
+        }
+        TestUtils::mockPartLoads(kv, 1, loads);
+        balancer.loadPartCosts(1);
+        EXPECT_EQ(8, balancer.partCosts_.size());
+        EXPECT_LT(balancer.replicaCost(2), balancer.replicaCost(1));
+
+        HostParts hostParts;
+        hostParts.emplace(HostAddr("0", 0), std::vector<PartitionID>{1, 2, 3, 4});
+        hostParts.emplace(HostAddr("1", 0), std::vector<PartitionID>{5, 6, 7, 8});
+        std::vector<BalanceTask> tasks;
+        ASSERT_TRUE(balancer.balanceParts(0, 1, hostParts, 8, tasks));
+        // Only a small part is moved, moving part 1 would overload the other host
+        ASSERT_EQ(1, tasks.size());
+        EXPECT_EQ(HostAddr("0", 0), tasks[0].src_);
+        EXPECT_NE(1, tasks[0].partId_);
+        EXPECT_EQ(3, hostParts[HostAddr("0", 0)].size());
+        EXPECT_EQ(5, hostParts[HostAddr("1", 0)].size());
+    }
+    {
+        // A new host takes at most FLAGS_balance_max_parts_into_host parts in a plan
+        auto maxPartsIntoHost = FLAGS_balance_max_parts_into_host;
+        std::unordered_map<PartitionID, kvstore::PartLoad> loads;
+        for (PartitionID partId = 1; partId <= 8; partId++) {
+            loads[partId].bytes_ = 10;
+            loads[partId].reportTime_ = now;
+        }
+        TestUtils::mockPartLoads(kv, 1, loads);
+        balancer.loadPartCosts(1);
+        for (auto limit : {0, 1}) {
+            FLAGS_balance_max_parts_into_host = limit;
+            HostParts hostParts;
+            hostParts.emplace(HostAddr("0", 0), std::vector<PartitionID>{1, 2, 3, 4});
+            hostParts.emplace(HostAddr("1", 0), std::vector<PartitionID>{5, 6, 7, 8});
+            hostParts.emplace(HostAddr("2", 0), std::vector<PartitionID>{});
+            std::vector<BalanceTask> tasks;
+            ASSERT_TRUE(balancer.balanceParts(0, 1, hostParts, 8, tasks));
+            EXPECT_EQ(limit == 0 ? 2 : 1, tasks.size());
+            EXPECT_EQ(tasks.size(), hostParts[HostAddr("2", 0)].size());
+        }
+        FLAGS_balance_max_parts_into_host = maxPartsIntoHost;
+    }
+}
+
 TEST(BalanceTest, DispatchTasksTest) {
     {
         FLAGS_task_concurrency = 10;
@@ -1643,6 +1717,99 @@ TEST(BalanceTest, ManyHostsLeaderBalancePlanTest) {
     }
 }
 
+TEST(BalanceTest, LoadAwareLeaderBalancePlanTest) {
+    fs::TempDir rootPath("/tmp/LoadAwareLeaderBalancePlanTest.XXXXXX");
+    auto store = MockCluster::initMetaKV(rootPath.path());
+    auto* kv = dynamic_cast<kvstore::KVStore*>(store.get());
+    std::vector<HostAddr> hosts = {{"0", 0}, {"1", 1}, {"2", 2}};
+    TestUtils::createSomeHosts(kv, hosts);
+    // 9 partition in space 1, 3 replica, 3 hosts
+    TestUtils::assembleSpace(kv, 1, 9, 3, 3);
+    // Part 1 serves 10 times more reads than the others
+    auto now = time::WallClock::fastNowInSec();
+    std::unordered_map<PartitionID, kvstore::PartLoad> loads;
+    for (PartitionID partId = 1; partId <= 9; partId++) {
+        loads[partId].bytes_ = 10;
+        loads[partId].readQps_ = partId == 1 ? 100 : 10;
+        loads[partId].reportTime_ = now;
+    }
+    TestUtils::mockPartLoads(kv, 1, loads);
+
+    DefaultValue<folly::Future<Status>>::SetFactory([] {
+        return folly::Future<Status>(Status::OK());
+    });
+    NiceMock<MockAdminClient> client;
+    Balancer balancer(kv, &client);
+    FLAGS_leader_balance_deviation = 0.05;
+
+    HostLeaderMap hostLeaderMap;
+    hostLeaderMap[HostAddr("0", 0)][1] = {1, 2, 3};
+    hostLeaderMap[HostAddr("1", 1)][1] = {4, 5, 6};
+    hostLeaderMap[HostAddr("2", 2)][1] = {7, 8, 9};
+    LeaderBalancePlan plan;
+    auto leaderBalanceResult = balancer.buildLeaderBalancePlan(&hostLeaderMap, 1, 3,
+                                                               false, plan, false);
+    ASSERT_TRUE(nebula::ok(leaderBalanceResult) && nebula::value(leaderBalanceResult));
+    // The count is balanced, but the host leading part 1 gives up its other leaders
+    ASSERT_EQ(2, plan.size());
+    for (const auto& task : plan) {
+        EXPECT_EQ(HostAddr("0", 0), std::get<2>(task));
+        EXPECT_NE(1, std::get<1>(task));
+    }
+    verifyLeaderBalancePlan(hostLeaderMap, plan, 1, 4);
+    EXPECT_EQ(std::vector<PartitionID>{1}, hostLeaderMap[HostAddr("0", 0)][1]);
+
+    // Nothing is moved back by the count of leaders
+    plan.clear();
+    leaderBalanceResult = balancer.buildLeaderBalancePlan(&hostLeaderMap, 1, 3,
+                                                          false, plan, false);
+    ASSERT_TRUE(nebula::ok(leaderBalanceResult) && nebula::value(leaderBalanceResult));
+    EXPECT_TRUE(plan.empty());
+}
+
+TEST(BalanceTest, LoadAwareLeaderBalanceStableTest) {
+    fs::TempDir rootPath("/tmp/LoadAwareLeaderBalanceStableTest.XXXXXX");
+    auto store = MockCluster::initMetaKV(rootPath.path());
+    auto* kv = dynamic_cast<kvstore::KVStore*>(store.get());
+    std::vector<HostAddr> hosts = {{"0", 0}, {"1", 1}, {"2", 2}};
+    TestUtils::createSomeHosts(kv, hosts);
+    TestUtils::assembleSpace(kv, 1, 9, 3, 3);
+    // Part 9 is written much more than the others
+    auto now = time::WallClock::fastNowInSec();
+    std::unordered_map<PartitionID, kvstore::PartLoad> loads;
+    for (PartitionID partId = 1; partId <= 9; partId++) {
+        loads[partId].bytes_ = 10;
+        loads[partId].writeRate_ = partId == 9 ? 200 : 10;
+        loads[partId].reportTime_ = now;
+    }
+    TestUtils::mockPartLoads(kv, 1, loads);
+
+    DefaultValue<folly::Future<Status>>::SetFactory([] {
+        return folly::Future<Status>(Status::OK());
+    });
+    NiceMock<MockAdminClient> client;
+    Balancer balancer(kv, &client);
+    FLAGS_leader_balance_deviation = 0.05;
+
+    HostLeaderMap hostLeaderMap;
+    hostLeaderMap[HostAddr("0", 0)][1] = {1, 2, 3, 4, 5};
+    hostLeaderMap[HostAddr("1", 1)][1] = {6, 7, 8};
+    hostLeaderMap[HostAddr("2", 2)][1] = {9};
+    // Run the leader balance several times, as the leaders are transferred by each plan
+    for (int32_t round = 0; round < 3; round++) {
+        LeaderBalancePlan plan;
+        auto leaderBalanceResult = balancer.buildLeaderBalancePlan(&hostLeaderMap, 1, 3,
+                                                                   false, plan, false);
+        ASSERT_TRUE(nebula::ok(leaderBalanceResult) && nebula::value(leaderBalanceResult));
+        if (round == 0) {
+            EXPECT_FALSE(plan.empty());
+        } else {
+            EXPECT_TRUE(plan.empty());
+        }
+        verifyLeaderBalancePlan(hostLeaderMap, plan, 0, 9);
+    }
+}
+
 TEST(BalanceTest, LeaderBalanceTest) {
     fs::TempDir rootPath("/tmp/LeaderBalanceTest.XXXXXX");
     auto store = MockCluster::initMetaKV(rootPath.path());
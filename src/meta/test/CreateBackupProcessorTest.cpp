@@ -76,7 +76,7 @@ TEST(ProcessorTest, CreateBackupTest) {
     auto now = time::WallClock::fastNowInMilliSec();
     HostAddr host(localIp, rpcServer->port_);
     ActiveHostsMan::updateHostInfo(
-        kv.get(), host, HostInfo(now, meta::cpp2::HostRole::STORAGE, ""));
+        kv.get(), nullptr, host, HostInfo(now, meta::cpp2::HostRole::STORAGE, ""));
 
     HostAddr storageHost = Utils::getStoreAddrFromAdminAddr(host);
 
@@ -359,6 +359,7 @@ TEST_F(GetStatisTest, MockSingleMachineTest) {
         auto now = time::WallClock::fastNowInMilliSec();
         auto ret = ActiveHostsMan::updateHostInfo(
             kv_.get(),
+            nullptr,
             entry.first,
             HostInfo(now, cpp2::HostRole::STORAGE, gitInfoSha()),
             &entry.second);
@@ -476,6 +477,7 @@ TEST_F(GetStatisTest, MockMultiMachineTest) {
         auto now = time::WallClock::fastNowInMilliSec();
         auto ret = ActiveHostsMan::updateHostInfo(
             kv_.get(),
+            nullptr,
             entry.first,
             HostInfo(now, cpp2::HostRole::STORAGE, gitInfoSha()),
             &entry.second);
@@ -18,6 +18,7 @@
 #include "meta/processors/jobMan/JobManager.h"
 
 DECLARE_int32(ws_storage_http_port);
+DECLARE_int32(max_running_jobs_per_host);
 using ResultCode = nebula::kvstore::ResultCode;
 
 namespace nebula {
@@ -215,6 +216,44 @@ TEST_F(JobManagerTest, JobDeduplication) {
     jobMgr->status_ = JobManager::JbmgrStatus::IDLE;
 }
 
+TEST_F(JobManagerTest, AdmitJob) {
+    // For preventting job schedule in JobManager
+    jobMgr->status_ = JobManager::JbmgrStatus::STOPPED;
+
+    // Another space on the same host as test_space
+    GraphSpaceID otherSpace = 2;
+    jobMgr->save(MetaServiceUtils::indexSpaceKey("other_space"),
+                 std::string(reinterpret_cast<const char*>(&otherSpace), sizeof(GraphSpaceID)));
+    jobMgr->save(MetaServiceUtils::partKey(otherSpace, 1),
+                 MetaServiceUtils::partVal({HostAddr("0", 0)}));
+
+    std::vector<std::string> paras{"test_space"};
+    std::vector<std::string> otherParas{"other_space"};
+    JobDescription compact(19, cpp2::AdminCmd::COMPACT, paras);
+    JobDescription statis(20, cpp2::AdminCmd::STATS, paras);
+    JobDescription flush(21, cpp2::AdminCmd::FLUSH, otherParas);
+
+    ASSERT_TRUE(jobMgr->admitJob(compact));
+    // The jobs of the same space run one by one
+    ASSERT_FALSE(jobMgr->admitJob(statis));
+    // The jobs of different spaces run at the same time
+    ASSERT_TRUE(jobMgr->admitJob(flush));
+    jobMgr->releaseJob(compact.getJobId());
+    ASSERT_TRUE(jobMgr->admitJob(statis));
+    jobMgr->releaseJob(statis.getJobId());
+    jobMgr->releaseJob(flush.getJobId());
+    ASSERT_EQ(JobManager::JbmgrStatus::STOPPED, jobMgr->status_);
+
+    FLAGS_max_running_jobs_per_host = 1;
+    ASSERT_TRUE(jobMgr->admitJob(compact));
+    // The host is full
+    ASSERT_FALSE(jobMgr->admitJob(flush));
+    jobMgr->releaseJob(compact.getJobId());
+    ASSERT_TRUE(jobMgr->admitJob(flush));
+    jobMgr->releaseJob(flush.getJobId());
+    FLAGS_max_running_jobs_per_host = 2;
+}
+
 TEST_F(JobManagerTest, loadJobDescription) {
     std::vector<std::string> paras{"test_space"};
     JobDescription job1(1, cpp2::AdminCmd::COMPACT, paras);
@@ -228,19 +228,19 @@ TEST(ProcessorTest, ListPartsTest) {
         for (int i = 1; i < 6; ++i) {
             allLeaders[spaceId].emplace_back(makeLeaderInfo(i));
         }
-        auto ret = ActiveHostsMan::updateHostInfo(kv.get(), {"0", 0}, info, &allLeaders);
+        auto ret = ActiveHostsMan::updateHostInfo(kv.get(), nullptr, {"0", 0}, info, &allLeaders);
         ASSERT_EQ(ret, cpp2::ErrorCode::SUCCEEDED);
 
         allLeaders.clear();
         for (int i = 6; i < 9; ++i) {
             allLeaders[spaceId].emplace_back(makeLeaderInfo(i));
         }
-        ret = ActiveHostsMan::updateHostInfo(kv.get(), {"1", 1}, info, &allLeaders);
+        ret = ActiveHostsMan::updateHostInfo(kv.get(), nullptr, {"1", 1}, info, &allLeaders);
         ASSERT_EQ(ret, cpp2::ErrorCode::SUCCEEDED);
 
         allLeaders.clear();
         allLeaders[spaceId].emplace_back(makeLeaderInfo(9));
-        ret = ActiveHostsMan::updateHostInfo(kv.get(), {"2", 2}, info, &allLeaders);
+        ret = ActiveHostsMan::updateHostInfo(kv.get(), nullptr, {"2", 2}, info, &allLeaders);
         ASSERT_EQ(ret, cpp2::ErrorCode::SUCCEEDED);
     }
 
@@ -381,6 +381,13 @@ TEST(ProcessorTest, SpaceTest) {
         }
     }
     {
+        std::unordered_map<PartitionID, kvstore::PartLoad> loads;
+        for (PartitionID partId = 1; partId <= 8; partId++) {
+            loads[partId].bytes_ = 10;
+            loads[partId].reportTime_ = time::WallClock::fastNowInSec();
+        }
+        TestUtils::mockPartLoads(kv.get(), 1, loads);
+
         cpp2::DropSpaceReq req;
         req.set_space_name("default_space");
         auto* processor = DropSpaceProcessor::instance(kv.get());
@@ -388,6 +395,13 @@ TEST(ProcessorTest, SpaceTest) {
         processor->process(req);
         auto resp = std::move(f).get();
         ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, resp.get_code());
+
+        // The load of parts of the space is removed along with it
+        auto prefix = MetaServiceUtils::assembleSegmentKey(kvstore::PartLoad::segment(),
+                                                           kvstore::PartLoad::prefix(1));
+        std::unique_ptr<kvstore::KVIterator> iter;
+        ASSERT_EQ(kvstore::ResultCode::SUCCEEDED, kv->prefix(0, 0, prefix, &iter));
+        EXPECT_FALSE(iter->valid());
     }
     {
         cpp2::ListSpacesReq req;
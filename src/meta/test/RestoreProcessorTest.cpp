@@ -29,7 +29,7 @@ TEST(RestoreProcessorTest, RestoreTest) {
 
     for (auto h : hosts) {
         ActiveHostsMan::updateHostInfo(
-            kv.get(), h, HostInfo(now, meta::cpp2::HostRole::STORAGE, ""));
+            kv.get(), nullptr, h, HostInfo(now, meta::cpp2::HostRole::STORAGE, ""));
     }
 
     meta::TestUtils::registerHB(kv.get(), hosts);
@@ -15,6 +15,7 @@
 #include "mock/MockCluster.h"
 #include "kvstore/KVStore.h"
 #include "kvstore/PartManager.h"
+#include "kvstore/PartLoad.h"
 #include "kvstore/NebulaStore.h"
 #include "meta/processors/partsMan/ListHostsProcessor.h"
 #include "meta/MetaServiceHandler.h"
@@ -68,7 +69,8 @@ public:
                         const std::string& gitInfoSha) {
         auto now = time::WallClock::fastNowInMilliSec();
         for (auto& h : hosts) {
-            auto ret = ActiveHostsMan::updateHostInfo(kv, h, HostInfo(now, role, gitInfoSha));
+            auto ret = ActiveHostsMan::updateHostInfo(
+                kv, nullptr, h, HostInfo(now, role, gitInfoSha));
             ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, ret);
         }
     }
@@ -240,6 +242,26 @@ public:
         baton.wait();
     }
 
+    // mock the load of parts reported by storaged
+    static void mockPartLoads(kvstore::KVStore* kv,
+                              GraphSpaceID spaceId,
+                              const std::unordered_map<PartitionID, kvstore::PartLoad>& loads) {
+        std::vector<nebula::kvstore::KV> data;
+        for (const auto& entry : loads) {
+            data.emplace_back(MetaServiceUtils::assembleSegmentKey(
+                                  kvstore::PartLoad::segment(),
+                                  kvstore::PartLoad::key(spaceId, entry.first)),
+                              entry.second.encode());
+        }
+        folly::Baton<true, std::atomic> baton;
+        kv->asyncMultiPut(0, 0, std::move(data),
+                          [&] (kvstore::ResultCode code) {
+                              ASSERT_EQ(kvstore::ResultCode::SUCCEEDED, code);
+                              baton.post();
+                          });
+        baton.wait();
+    }
+
     static void mockTag(kvstore::KVStore* kv, int32_t tagNum,
                         SchemaVer version = 0, bool nullable = false) {
         std::vector<nebula::kvstore::KV> tags;
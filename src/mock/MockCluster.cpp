@@ -15,6 +15,8 @@
 #include "storage/GraphStorageServiceHandler.h"
 #include "storage/GeneralStorageServiceHandler.h"
 #include "storage/CompactionFilter.h"
+#include "storage/MergeOperator.h"
+#include "storage/StorageFlags.h"
 
 
 DECLARE_int32(heartbeat_interval_secs);
@@ -212,6 +214,16 @@ void MockCluster::initStorageKV(const char* dataPath,
                                                                    indexMan_.get()));
         options.cffBuilder_ = std::move(cffBuilder);
     }
+    options.mergeOp_ = std::make_shared<storage::NebulaOperator>(schemaMan_.get());
+    std::shared_ptr<storage::AdjacencyCache> adjCache;
+    if (FLAGS_enable_adjacency_cache) {
+        adjCache = std::make_shared<storage::AdjacencyCache>(
+            FLAGS_adjacency_cache_capacity_mb * 1024 * 1024,
+            FLAGS_adjacency_cache_bucket_exp,
+            FLAGS_adjacency_cache_degree_threshold,
+            FLAGS_adjacency_cache_ttl_secs);
+        options.commitListener_ = adjCache;
+    }
     storageKV_ = initKV(std::move(options), addr);
     waitUntilAllElected(storageKV_.get(), 1, parts);
 
@@ -222,6 +234,7 @@ void MockCluster::initStorageKV(const char* dataPath,
     storageEnv_->rebuildIndexGuard_ = std::make_unique<storage::IndexGuard>();
     storageEnv_->verticesML_ = std::make_unique<storage::VerticesMemLock>();
     storageEnv_->edgesML_ = std::make_unique<storage::EdgesMemLock>();
+    storageEnv_->adjCache_ = std::move(adjCache);
 }
 
 void MockCluster::startStorage(HostAddr addr,
@@ -0,0 +1,343 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/AdjacencyCache.h"
+#include "common/time/WallClock.h"
+#include "utils/NebulaKeyUtils.h"
+#include <folly/hash/Hash.h>
+
+namespace nebula {
+namespace storage {
+
+namespace {
+
+// Memory of the list node, the hash map entry and the AdjacencyList besides the edges
+constexpr size_t kEntryOverhead = 160;
+
+const CacheCounters& counters() {
+    static CacheCounters counters("adjacency_cache");
+    return counters;
+}
+
+}  // namespace
+
+
+size_t AdjacencyList::lowerBound(folly::StringPiece target) const {
+    // All keys share the prefix, so compare the prefix once
+    auto head = target.subpiece(0, prefix_.size());
+    int cmp = folly::StringPiece(prefix_).compare(head);
+    if (cmp > 0 || (cmp == 0 && target.size() <= prefix_.size())) {
+        return 0;
+    }
+    if (cmp < 0) {
+        return size();
+    }
+    auto rest = target.subpiece(prefix_.size());
+    size_t lo = 0, hi = size();
+    while (lo < hi) {
+        auto mid = lo + (hi - lo) / 2;
+        if (suffix(mid) < rest) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+
+class AdjacencyCache::Shard final : public CacheShard {
+public:
+    Shard(size_t capacity, int64_t ttlSecs)
+        : capacity_(capacity)
+        , ttlSecs_(ttlSecs) {}
+
+    std::shared_ptr<const AdjacencyList> get(const Key& key) {
+        std::lock_guard<std::mutex> g(lock_);
+        auto it = map_.find(key);
+        if (it != map_.end() && it->second->expireAt_ < time::WallClock::fastNowInSec()) {
+            remove(it->second);
+            it = map_.end();
+        }
+        if (it == map_.end()) {
+            miss();
+            return nullptr;
+        }
+        hit();
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->list_;
+    }
+
+    uint64_t epoch() const {
+        std::lock_guard<std::mutex> g(lock_);
+        return epoch_;
+    }
+
+    void insert(const Key& key, uint64_t epoch, std::shared_ptr<const AdjacencyList> list) {
+        size_t charge = list->bytes() + kEntryOverhead;
+        std::lock_guard<std::mutex> g(lock_);
+        if (epoch != epoch_ || charge > capacity_) {
+            // some edges may have been written after list was read
+            rejected();
+            return;
+        }
+        auto it = map_.find(key);
+        if (it != map_.end()) {
+            remove(it->second);
+        }
+        while (bytes_ + charge > capacity_) {
+            remove(std::prev(lru_.end()));
+        }
+        lru_.emplace_front(Entry{key, std::move(list), charge,
+                                 time::WallClock::fastNowInSec() + ttlSecs_});
+        map_.emplace(key, lru_.begin());
+        bytes_ += charge;
+    }
+
+    void invalidate(const Key& key) {
+        std::lock_guard<std::mutex> g(lock_);
+        epoch_++;
+        auto it = map_.find(key);
+        if (it != map_.end()) {
+            remove(it->second);
+        }
+    }
+
+    void invalidate(GraphSpaceID spaceId, PartitionID partId) {
+        std::lock_guard<std::mutex> g(lock_);
+        epoch_++;
+        for (auto it = lru_.begin(); it != lru_.end();) {
+            auto entry = it++;
+            if (std::get<0>(entry->key_) == spaceId && std::get<1>(entry->key_) == partId) {
+                remove(entry);
+            }
+        }
+    }
+
+private:
+    struct Entry {
+        Key                                    key_;
+        std::shared_ptr<const AdjacencyList>   list_;
+        size_t                                 charge_;
+        int64_t                                expireAt_;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return AdjacencyCache::hash(key);
+        }
+    };
+
+    size_t entries() const override {
+        return map_.size();
+    }
+
+    void remove(EntryList::iterator entry) {
+        bytes_ -= entry->charge_;
+        map_.erase(entry->key_);
+        lru_.erase(entry);
+        evicted();
+    }
+
+private:
+    const size_t                                                capacity_;
+    const int64_t                                               ttlSecs_;
+    uint64_t                                                    epoch_{0};
+
+    EntryList                                                   lru_;
+    std::unordered_map<Key, EntryList::iterator, KeyHash>       map_;
+};
+
+
+// Passes the edges of the kvstore iterator through, and copies them into an AdjacencyList
+// once there turn out to be degreeThreshold_ of them
+class AdjacencyCache::FillIterator final : public kvstore::KVIterator {
+public:
+    FillIterator(AdjacencyCache* cache,
+                 const Key& key,
+                 uint64_t epoch,
+                 folly::StringPiece prefix,
+                 std::unique_ptr<kvstore::KVIterator> iter)
+        : cache_(cache)
+        , key_(key)
+        , epoch_(epoch)
+        , prefix_(prefix.str())
+        , iter_(std::move(iter)) {
+        if (iter_->valid()) {
+            read_ = 1;
+            startBuffer();
+        }
+    }
+
+    bool valid() const override {
+        return iter_->valid();
+    }
+
+    void next() override {
+        iter_->next();
+        if (!iter_->valid()) {
+            finish();
+            return;
+        }
+        read_++;
+        if (list_ != nullptr) {
+            append();
+        } else {
+            startBuffer();
+        }
+    }
+
+    void prev() override {
+        abandon();
+        iter_->prev();
+    }
+
+    void seek(folly::StringPiece target) override {
+        abandon();
+        iter_->seek(target);
+    }
+
+    folly::StringPiece key() const override {
+        return iter_->key();
+    }
+
+    folly::StringPiece val() const override {
+        return iter_->val();
+    }
+
+private:
+    void startBuffer() {
+        if (abandoned_ || read_ < cache_->degreeThreshold_) {
+            return;
+        }
+        // Read the edges passed again, the iterator is on a snapshot so they are the same
+        list_ = std::make_shared<AdjacencyList>(prefix_);
+        iter_->seek(prefix_);
+        for (size_t i = 1; i < read_; i++) {
+            append();
+            iter_->next();
+        }
+        append();
+    }
+
+    void append() {
+        if (list_ == nullptr) {
+            return;
+        }
+        list_->append(iter_->key(), iter_->val());
+        if (list_->bytes() > cache_->maxEntryBytes_) {
+            VLOG(2) << "Adjacency list of vertex " << std::get<2>(key_) << " edge type "
+                    << std::get<3>(key_) << " exceeds " << cache_->maxEntryBytes_ << " bytes";
+            abandon();
+        }
+    }
+
+    void finish() {
+        if (list_ != nullptr) {
+            list_->shrink();
+            cache_->shard(hash(key_)).insert(key_, epoch_, std::move(list_));
+            list_.reset();
+        }
+    }
+
+    // The edges are not cached if they are not all visited in order
+    void abandon() {
+        abandoned_ = true;
+        list_.reset();
+    }
+
+    AdjacencyCache*                         cache_;
+    const Key                               key_;
+    const uint64_t                          epoch_;
+    const std::string                       prefix_;
+    std::unique_ptr<kvstore::KVIterator>    iter_;
+    // The number of edges visited, including the current one
+    size_t                                  read_{0};
+    std::shared_ptr<AdjacencyList>          list_;
+    bool                                    abandoned_{false};
+};
+
+
+AdjacencyCache::AdjacencyCache(size_t capacity,
+                               uint32_t bucketsExp,
+                               size_t degreeThreshold,
+                               int64_t ttlSecs)
+        : ShardedCache("adjacency-cache", counters(), bucketsExp, [=] {
+            return std::make_unique<Shard>(capacity >> bucketsExp, ttlSecs);
+        })
+        , degreeThreshold_(degreeThreshold) {
+    // offsets in AdjacencyList are 32 bits
+    maxEntryBytes_ = std::min<size_t>(capacity >> bucketsExp,
+                                      std::numeric_limits<uint32_t>::max());
+}
+
+
+AdjacencyCache::Shard& AdjacencyCache::shard(size_t hash) const {
+    return static_cast<Shard&>(shardOf(hash));
+}
+
+
+std::shared_ptr<const AdjacencyList> AdjacencyCache::get(const Key& key) {
+    return shard(hash(key)).get(key);
+}
+
+
+uint64_t AdjacencyCache::epoch(const Key& key) const {
+    return shard(hash(key)).epoch();
+}
+
+
+std::unique_ptr<kvstore::KVIterator>
+AdjacencyCache::fill(const Key& key,
+                     uint64_t epoch,
+                     folly::StringPiece prefix,
+                     std::unique_ptr<kvstore::KVIterator> iter) {
+    return std::make_unique<FillIterator>(this, key, epoch, prefix, std::move(iter));
+}
+
+
+void AdjacencyCache::invalidate(const Key& key) {
+    shard(hash(key)).invalidate(key);
+}
+
+
+void AdjacencyCache::invalidate(GraphSpaceID spaceId, PartitionID partId) {
+    for (size_t i = 0; i < numShards(); i++) {
+        static_cast<Shard&>(shardAt(i)).invalidate(spaceId, partId);
+    }
+}
+
+
+void AdjacencyCache::onCommitted(GraphSpaceID spaceId,
+                                 PartitionID partId,
+                                 const std::vector<std::string>& keys) {
+    // The edges of the same src and edge type are usually written next to each other
+    folly::StringPiece last;
+    for (const auto& key : keys) {
+        if (key.size() <= static_cast<size_t>(kEdgeLen) || (key.size() - kEdgeLen) % 2 != 0) {
+            continue;
+        }
+        size_t vIdLen = (key.size() - kEdgeLen) / 2;
+        if (!NebulaKeyUtils::isEdge(vIdLen, key)) {
+            continue;
+        }
+        auto prefix = folly::StringPiece(key).subpiece(
+            0, sizeof(PartitionID) + vIdLen + sizeof(EdgeType));
+        if (prefix == last) {
+            continue;
+        }
+        last = prefix;
+        invalidate(std::make_tuple(spaceId,
+                                   partId,
+                                   NebulaKeyUtils::getSrcId(vIdLen, key).str(),
+                                   NebulaKeyUtils::getEdgeType(vIdLen, key)));
+    }
+}
+
+}  // namespace storage
+}  // namespace nebula
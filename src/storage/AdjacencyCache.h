@@ -0,0 +1,207 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_ADJACENCYCACHE_H_
+#define STORAGE_ADJACENCYCACHE_H_
+
+#include "common/base/Base.h"
+#include "common/thrift/ThriftTypes.h"
+#include "kvstore/Common.h"
+#include "kvstore/KVIterator.h"
+#include "storage/ShardedCache.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * All edges of one edge type of a vertex, kept in a single buffer. The common prefix
+ * (part, src, edge type) is stored once, and each edge only keeps the rest of its key
+ * (rank, dst and version) followed by its encoded row.
+ * */
+class AdjacencyList final {
+public:
+    explicit AdjacencyList(folly::StringPiece prefix)
+        : prefix_(prefix.str()) {
+        offsets_.emplace_back(0);
+    }
+
+    // key must start with the prefix, and keys must be appended in order
+    void append(folly::StringPiece key, folly::StringPiece val) {
+        DCHECK(key.startsWith(prefix_));
+        key.advance(prefix_.size());
+        data_.append(key.data(), key.size());
+        offsets_.emplace_back(data_.size());
+        data_.append(val.data(), val.size());
+        offsets_.emplace_back(data_.size());
+    }
+
+    size_t size() const {
+        return offsets_.size() / 2;
+    }
+
+    // Memory used by the edges
+    size_t bytes() const {
+        return prefix_.size() + data_.capacity() + offsets_.capacity() * sizeof(uint32_t);
+    }
+
+    const std::string& prefix() const {
+        return prefix_;
+    }
+
+    // The key of the i-th edge without the prefix
+    folly::StringPiece suffix(size_t i) const {
+        return folly::StringPiece(data_.data() + offsets_[2 * i],
+                                  offsets_[2 * i + 1] - offsets_[2 * i]);
+    }
+
+    folly::StringPiece val(size_t i) const {
+        return folly::StringPiece(data_.data() + offsets_[2 * i + 1],
+                                  offsets_[2 * i + 2] - offsets_[2 * i + 1]);
+    }
+
+    // Index of the first edge whose key is not less than target
+    size_t lowerBound(folly::StringPiece target) const;
+
+    // Release the spare capacity once no more edges will be appended
+    void shrink() {
+        data_.shrink_to_fit();
+        offsets_.shrink_to_fit();
+    }
+
+private:
+    std::string             prefix_;
+    std::string             data_;
+    // The offsets of the key suffix and value of each edge in data_, and the end of data_
+    std::vector<uint32_t>   offsets_;
+};
+
+
+// KVIterator over an AdjacencyList, which behaves the same as a prefix iterator on the kvstore
+class AdjacencyListIterator final : public kvstore::KVIterator {
+public:
+    explicit AdjacencyListIterator(std::shared_ptr<const AdjacencyList> list)
+        : list_(std::move(list)) {
+        setKey();
+    }
+
+    bool valid() const override {
+        return idx_ < list_->size();
+    }
+
+    void next() override {
+        ++idx_;
+        setKey();
+    }
+
+    void prev() override {
+        idx_ = idx_ == 0 ? list_->size() : idx_ - 1;
+        setKey();
+    }
+
+    void seek(folly::StringPiece target) override {
+        idx_ = list_->lowerBound(target);
+        setKey();
+    }
+
+    folly::StringPiece key() const override {
+        return key_;
+    }
+
+    folly::StringPiece val() const override {
+        return list_->val(idx_);
+    }
+
+private:
+    void setKey() {
+        if (valid()) {
+            auto suffix = list_->suffix(idx_);
+            key_.resize(list_->prefix().size());
+            key_.append(suffix.data(), suffix.size());
+        }
+    }
+
+    std::shared_ptr<const AdjacencyList>   list_;
+    size_t                                 idx_{0};
+    // prefix and the suffix of current edge
+    std::string                            key_{list_->prefix()};
+};
+
+
+/**
+ * AdjacencyCache keeps the edges of super vertices, keyed by (space, part, src, edgeType).
+ *
+ * On a miss, fill() wraps the kvstore iterator, the edges are passed through as they are
+ * read. Once degreeThreshold edges have been read, the iterator reads them again into an
+ * AdjacencyList and keeps appending the following ones, and the list is cached when the
+ * iteration reaches the end. So a GetNeighbors on a super vertex only scans the LSM once,
+ * later ones are served from memory until the edges of that edge type are written, and
+ * the vertices with few edges are not copied at all.
+ *
+ * The capacity is a memory budget in bytes, split evenly among the shards, each shard is
+ * an LRU list. An adjacency list larger than a shard is never cached. Entries expire after
+ * ttlSecs.
+ *
+ * The cache listens to the commits of all parts, so the edges written on this host are
+ * invalidated whether it is the leader or a follower, and whether they come from logs,
+ * snapshots or ingested files. Each shard has an epoch which is bumped by every
+ * invalidation, and a fill whose epoch is older than the shard's is not cached, since the
+ * edges it read may be older than the write.
+ * */
+class AdjacencyCache final : public ShardedCache, public kvstore::CommitListener {
+public:
+    // The src is padded to the vid length of the space, the same as it is in the edge key
+    using Key = std::tuple<GraphSpaceID, PartitionID, VertexID, EdgeType>;
+
+    AdjacencyCache(size_t capacity, uint32_t bucketsExp, size_t degreeThreshold,
+                   int64_t ttlSecs);
+
+    // Returns nullptr on a miss
+    std::shared_ptr<const AdjacencyList> get(const Key& key);
+
+    // Must be called before the iterator passed to fill() is created
+    uint64_t epoch(const Key& key) const;
+
+    // iter is a prefix iterator on the prefix of key, which is taken over by the returned
+    // iterator. It visits the same edges as iter would, and caches them if it reaches the end
+    // without being seeked or moved back.
+    std::unique_ptr<kvstore::KVIterator> fill(const Key& key,
+                                              uint64_t epoch,
+                                              folly::StringPiece prefix,
+                                              std::unique_ptr<kvstore::KVIterator> iter);
+
+    void invalidate(const Key& key);
+
+    // Drop all entries of a part
+    void invalidate(GraphSpaceID spaceId, PartitionID partId);
+
+    void onCommitted(GraphSpaceID spaceId,
+                     PartitionID partId,
+                     const std::vector<std::string>& keys) override;
+
+    void onReset(GraphSpaceID spaceId, PartitionID partId) override {
+        invalidate(spaceId, partId);
+    }
+
+private:
+    class Shard;
+    class FillIterator;
+
+    Shard& shard(size_t hash) const;
+
+    static size_t hash(const Key& key) {
+        return folly::hash::hash_combine(std::get<0>(key), std::get<1>(key),
+                                         std::get<2>(key), std::get<3>(key));
+    }
+
+private:
+    size_t                                degreeThreshold_;
+    // The largest adjacency list which could be cached, a shard at most
+    size_t                                maxEntryBytes_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_ADJACENCYCACHE_H_
@@ -15,6 +15,7 @@
 #include <folly/futures/Future.h>
 #include <thrift/lib/cpp/util/EnumUtils.h>
 #include "storage/CommonUtils.h"
+#include "storage/MergeOperator.h"
 #include "codec/RowReaderWrapper.h"
 #include "codec/RowWriterV2.h"
 #include "utils/IndexKeyUtils.h"
@@ -80,6 +81,9 @@ protected:
                                   PartitionID partId,
                                   std::vector<kvstore::KV>&& data);
 
+    // Blind write of MergeOperand encoded values, see storage/MergeOperator.h
+    void doMerge(GraphSpaceID spaceId, PartitionID partId, std::vector<kvstore::KV>&& data);
+
     void doRemove(GraphSpaceID spaceId,
                   PartitionID partId,
                   std::vector<std::string>&& keys);
@@ -89,6 +93,10 @@ protected:
                        const std::string& start,
                        const std::string& end);
 
+    // Read the values of keys by one multiGet, the keys not found are left out of the map
+    ErrorOr<kvstore::ResultCode, std::unordered_map<std::string, std::string>>
+    doMultiGet(GraphSpaceID spaceId, PartitionID partId, const std::vector<std::string>& keys);
+
     cpp2::ErrorCode to(kvstore::ResultCode code);
 
     cpp2::ErrorCode writeResultTo(WriteResult code, bool isEdge);
@@ -117,6 +125,13 @@ protected:
                                        const std::vector<Value>& props,
                                        WriteResult& wRet);
 
+    // Run task(0) ... task(total - 1) in executor, with at most `concurrency` of them running at
+    // the same time. The returned future is fulfilled in executor when all tasks have finished.
+    folly::Future<folly::Unit> runConcurrently(folly::Executor* executor,
+                                               size_t total,
+                                               size_t concurrency,
+                                               std::function<void(size_t)> task);
+
 protected:
     StorageEnv*                                     env_{nullptr};
     const ProcessorCounters*                        counters_;
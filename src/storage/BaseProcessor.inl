@@ -151,6 +151,28 @@ void BaseProcessor<RESP>::doPut(GraphSpaceID spaceId,
     });
 }
 
+template <typename RESP>
+void BaseProcessor<RESP>::doMerge(GraphSpaceID spaceId,
+                                  PartitionID partId,
+                                  std::vector<kvstore::KV>&& data) {
+    // A bad operand fails every later merge of its key, so it is never written
+    for (const auto& kv : data) {
+        GraphSpaceID operandSpace = 0;
+        std::vector<MergeOp> ops;
+        if (!MergeOperand::decode(kv.second, operandSpace, ops) ||
+            operandSpace != spaceId ||
+            ops.empty()) {
+            LOG(ERROR) << "Bad merge operand of key " << folly::hexlify(kv.first);
+            handleAsync(spaceId, partId, kvstore::ResultCode::ERR_INVALID_ARGUMENT);
+            return;
+        }
+    }
+    this->env_->kvstore_->asyncMultiMerge(
+        spaceId, partId, std::move(data), [spaceId, partId, this](kvstore::ResultCode code) {
+            handleAsync(spaceId, partId, code);
+    });
+}
+
 template <typename RESP>
 kvstore::ResultCode BaseProcessor<RESP>::doSyncPut(GraphSpaceID spaceId,
                                                    PartitionID partId,
@@ -191,6 +213,36 @@ void BaseProcessor<RESP>::doRemoveRange(GraphSpaceID spaceId,
         });
 }
 
+template <typename RESP>
+ErrorOr<kvstore::ResultCode, std::unordered_map<std::string, std::string>>
+BaseProcessor<RESP>::doMultiGet(GraphSpaceID spaceId,
+                                PartitionID partId,
+                                const std::vector<std::string>& keys) {
+    std::unordered_map<std::string, std::string> kvs;
+    if (keys.empty()) {
+        return kvs;
+    }
+    std::vector<std::string> values;
+    auto ret = env_->kvstore_->multiGet(spaceId, partId, keys, &values);
+    if (ret.first != kvstore::ResultCode::SUCCEEDED &&
+        ret.first != kvstore::ResultCode::ERR_PARTIAL_RESULT) {
+        LOG(ERROR) << "MultiGet failed, ret = " << static_cast<int32_t>(ret.first)
+                   << ", spaceId " << spaceId << ", partId " << partId;
+        return ret.first;
+    }
+    kvs.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (ret.second[i].ok()) {
+            kvs.emplace(keys[i], std::move(values[i]));
+        } else if (!ret.second[i].isKeyNotFound()) {
+            LOG(ERROR) << "MultiGet failed, spaceId " << spaceId << ", partId " << partId
+                       << ", status " << ret.second[i];
+            return kvstore::ResultCode::ERR_IO_ERROR;
+        }
+    }
+    return kvs;
+}
+
 template <typename RESP>
 StatusOr<std::string>
 BaseProcessor<RESP>::encodeRowVal(const meta::NebulaSchemaProvider* schema,
@@ -224,5 +276,26 @@ BaseProcessor<RESP>::encodeRowVal(const meta::NebulaSchemaProvider* schema,
     return std::move(rowWrite).moveEncodedStr();
 }
 
+template <typename RESP>
+folly::Future<folly::Unit>
+BaseProcessor<RESP>::runConcurrently(folly::Executor* executor,
+                                     size_t total,
+                                     size_t concurrency,
+                                     std::function<void(size_t)> task) {
+    auto next = std::make_shared<std::atomic<size_t>>(0);
+    concurrency = std::max<size_t>(1, std::min(concurrency, total));
+    std::vector<folly::Future<folly::Unit>> futures;
+    futures.reserve(concurrency);
+    for (size_t i = 0; i < concurrency; i++) {
+        futures.emplace_back(folly::via(executor, [next, total, task] {
+            size_t idx;
+            while ((idx = next->fetch_add(1, std::memory_order_relaxed)) < total) {
+                task(idx);
+            }
+        }));
+    }
+    return folly::collectAll(futures).via(executor).thenValue([] (auto&&) {});
+}
+
 }  // namespace storage
 }  // namespace nebula
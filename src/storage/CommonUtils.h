@@ -11,11 +11,12 @@
 #include "common/stats/StatsManager.h"
 #include "common/meta/SchemaManager.h"
 #include "common/meta/IndexManager.h"
-#include "common/base/ConcurrentLRUCache.h"
 #include "common/interface/gen-cpp2/storage_types.h"
 #include "codec/RowReader.h"
 #include "kvstore/KVStore.h"
 #include "utils/MemoryLockWrapper.h"
+#include "storage/VertexCache.h"
+#include "storage/AdjacencyCache.h"
 #include <folly/concurrency/ConcurrentHashMap.h>
 
 
@@ -56,7 +57,6 @@ enum class IndexState {
     FINISHED,  // The part is building index successfully.
 };
 
-using VertexCache = ConcurrentLRUCache<std::pair<VertexID, TagID>, std::string>;
 using IndexKey    = std::tuple<GraphSpaceID, PartitionID>;
 using IndexGuard  = folly::ConcurrentHashMap<IndexKey, IndexState>;
 
@@ -82,6 +82,8 @@ public:
     TransactionManager*                             txnMan_{nullptr};
     std::unique_ptr<VerticesMemLock>                verticesML_{nullptr};
     std::unique_ptr<EdgesMemLock>                   edgesML_{nullptr};
+    // Only built when enable_adjacency_cache is on, it listens to the commits of all parts
+    std::shared_ptr<AdjacencyCache>                 adjCache_{nullptr};
 
 
     IndexState getIndexState(GraphSpaceID space, PartitionID part) {
@@ -175,6 +177,10 @@ public:
 
     // used for toss version
     int64_t                             defaultEdgeVer_ = 0L;
+
+    // vertices read in batch by multiGet before running the plan, keyed by vertex key, none
+    // means the vertex does not exist
+    std::unordered_map<std::string, folly::Optional<std::string>> vertices_;
 };
 
 class CommonUtils final {
@@ -29,7 +29,8 @@ namespace storage {
 
 GraphStorageServiceHandler::GraphStorageServiceHandler(StorageEnv* env)
         : env_(env)
-        , vertexCache_(FLAGS_vertex_cache_num, FLAGS_vertex_cache_bucket_exp) {
+        , vertexCache_(FLAGS_vertex_cache_capacity_mb * 1024 * 1024,
+                       FLAGS_vertex_cache_bucket_exp) {
     if (FLAGS_reader_handlers_type == "io") {
         auto tf = std::make_shared<folly::NamedThreadFactory>("reader-pool");
         readerPool_ = std::make_shared<folly::IOThreadPoolExecutor>(FLAGS_reader_handlers,
@@ -8,13 +8,180 @@
 #define KVSTORE_MERGEOPERATOR_H_
 
 #include "common/base/Base.h"
+#include "common/datatypes/Value.h"
+#include "common/meta/SchemaManager.h"
+#include "codec/RowReaderWrapper.h"
+#include "codec/RowWriterV2.h"
+#include "utils/NebulaKeyUtils.h"
 #include <rocksdb/merge_operator.h>
 
 namespace nebula {
 namespace storage {
 
+enum class MergeOpType : int8_t {
+    ADD     = 0x01,
+    MAX     = 0x02,
+    MIN     = 0x03,
+    APPEND  = 0x04,
+};
+
+struct MergeOp {
+    MergeOpType type_;
+    std::string prop_;
+    // only int, float and string are supported
+    Value       value_;
+};
+
+/**
+ * Codec of the merge operand written by KVStore::asyncMultiMerge.
+ * Layout: spaceId (int32) | op count (uint32) | ops...
+ * Each op: type (int8) | prop len (uint32) | prop | value type (char) | value
+ * */
+class MergeOperand final {
+public:
+    static std::string encode(GraphSpaceID spaceId, const std::vector<MergeOp>& ops) {
+        std::string encoded;
+        encoded.reserve(sizeof(GraphSpaceID) + sizeof(uint32_t) + ops.size() * 32);
+        encoded.append(reinterpret_cast<const char*>(&spaceId), sizeof(GraphSpaceID));
+        uint32_t count = ops.size();
+        encoded.append(reinterpret_cast<const char*>(&count), sizeof(uint32_t));
+        for (const auto& op : ops) {
+            appendOp(op, encoded);
+        }
+        return encoded;
+    }
+
+    static bool decode(folly::StringPiece encoded,
+                       GraphSpaceID& spaceId,
+                       std::vector<MergeOp>& ops) {
+        if (!read(encoded, spaceId)) {
+            return false;
+        }
+        uint32_t count = 0;
+        if (!read(encoded, count)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            MergeOp op;
+            int8_t type = 0;
+            uint32_t len = 0;
+            if (!read(encoded, type) || !read(encoded, len) || encoded.size() < len) {
+                return false;
+            }
+            if (type < static_cast<int8_t>(MergeOpType::ADD) ||
+                type > static_cast<int8_t>(MergeOpType::APPEND)) {
+                return false;
+            }
+            op.type_ = static_cast<MergeOpType>(type);
+            op.prop_ = encoded.subpiece(0, len).str();
+            encoded.advance(len);
+            if (!readValue(encoded, op.value_)) {
+                return false;
+            }
+            ops.emplace_back(std::move(op));
+        }
+        return encoded.empty();
+    }
+
+private:
+    static void appendOp(const MergeOp& op, std::string& encoded) {
+        encoded.append(1, static_cast<char>(op.type_));
+        uint32_t len = op.prop_.size();
+        encoded.append(reinterpret_cast<const char*>(&len), sizeof(uint32_t));
+        encoded.append(op.prop_);
+        switch (op.value_.type()) {
+            case Value::Type::INT: {
+                int64_t v = op.value_.getInt();
+                encoded.append(1, 'i');
+                encoded.append(reinterpret_cast<const char*>(&v), sizeof(int64_t));
+                break;
+            }
+            case Value::Type::FLOAT: {
+                double v = op.value_.getFloat();
+                encoded.append(1, 'f');
+                encoded.append(reinterpret_cast<const char*>(&v), sizeof(double));
+                break;
+            }
+            case Value::Type::STRING: {
+                const auto& v = op.value_.getStr();
+                uint32_t strLen = v.size();
+                encoded.append(1, 's');
+                encoded.append(reinterpret_cast<const char*>(&strLen), sizeof(uint32_t));
+                encoded.append(v);
+                break;
+            }
+            default:
+                LOG(FATAL) << "Unsupported merge value " << op.value_;
+        }
+    }
+
+    template <typename T>
+    static bool read(folly::StringPiece& encoded, T& v) {
+        if (encoded.size() < sizeof(T)) {
+            return false;
+        }
+        memcpy(&v, encoded.data(), sizeof(T));
+        encoded.advance(sizeof(T));
+        return true;
+    }
+
+    static bool readValue(folly::StringPiece& encoded, Value& v) {
+        char type = 0;
+        if (!read(encoded, type)) {
+            return false;
+        }
+        switch (type) {
+            case 'i': {
+                int64_t val = 0;
+                if (!read(encoded, val)) {
+                    return false;
+                }
+                v = val;
+                return true;
+            }
+            case 'f': {
+                double val = 0;
+                if (!read(encoded, val)) {
+                    return false;
+                }
+                v = val;
+                return true;
+            }
+            case 's': {
+                uint32_t len = 0;
+                if (!read(encoded, len) || encoded.size() < len) {
+                    return false;
+                }
+                v = encoded.subpiece(0, len).str();
+                encoded.advance(len);
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+};
+
+/**
+ * Merge operator of vertex and edge rows. Each operand carries a list of MergeOp,
+ * which are applied in order on the RowWriterV2 encoded row. A missing row is
+ * treated as a row with all merged props unset (0 for ADD, "" for APPEND),
+ * other props get their default or null value from the latest schema.
+ *
+ * A merge never drops an operand or writes a broken row: a bad operand, an op which
+ * does not fit the prop, or a row which can't be encoded fails the merge, so rocksdb
+ * reports a corruption instead of returning a wrong value.
+ *
+ * Merge is a blind write, so neither index nor vertex cache is maintained,
+ * the caller must not merge on indexed props and has to evict the cache itself.
+ * */
 class NebulaOperator : public rocksdb::MergeOperator {
 public:
+    explicit NebulaOperator(meta::SchemaManager* schemaMan)
+        : schemaMan_(schemaMan) {
+        CHECK_NOTNULL(schemaMan_);
+    }
+
     const char* Name() const override {
         return "NebulaMergeOperator";
     }
@@ -22,27 +189,190 @@ public:
 private:
     bool FullMergeV2(const MergeOperationInput& merge_in,
                      MergeOperationOutput* merge_out) const override {
-        UNUSED(merge_in);
-        UNUSED(merge_out);
-        LOG(ERROR) << "NebulaMergeOperator not supported yet";
-        return false;
+        folly::StringPiece key = toPiece(merge_in.key);
+        GraphSpaceID spaceId = 0;
+        std::vector<MergeOp> ops;
+        for (size_t i = 0; i < merge_in.operand_list.size(); i++) {
+            GraphSpaceID operandSpace = 0;
+            if (!MergeOperand::decode(toPiece(merge_in.operand_list[i]), operandSpace, ops)) {
+                LOG(ERROR) << "Bad format merge operand of key " << folly::hexlify(key);
+                return false;
+            }
+            if (i > 0 && operandSpace != spaceId) {
+                LOG(ERROR) << "Merge operands of key " << folly::hexlify(key)
+                           << " are from space " << spaceId << " and " << operandSpace;
+                return false;
+            }
+            spaceId = operandSpace;
+        }
+
+        auto existing = merge_in.existing_value;
+        auto vIdLen = schemaMan_->getSpaceVidLen(spaceId);
+        if (ops.empty() || !vIdLen.ok()) {
+            return keepExisting(merge_in, merge_out);
+        }
+
+        RowReaderWrapper reader;
+        std::shared_ptr<const meta::NebulaSchemaProvider> schema;
+        if (NebulaKeyUtils::isVertex(vIdLen.value(), key)) {
+            auto tagId = NebulaKeyUtils::getTagId(vIdLen.value(), key);
+            schema = schemaMan_->getTagSchema(spaceId, tagId);
+            if (existing != nullptr) {
+                reader = RowReaderWrapper::getTagPropReader(schemaMan_, spaceId, tagId,
+                                                            toPiece(*existing));
+            }
+        } else if (NebulaKeyUtils::isEdge(vIdLen.value(), key)) {
+            auto edgeType = std::abs(NebulaKeyUtils::getEdgeType(vIdLen.value(), key));
+            schema = schemaMan_->getEdgeSchema(spaceId, edgeType);
+            if (existing != nullptr) {
+                reader = RowReaderWrapper::getEdgePropReader(schemaMan_, spaceId, edgeType,
+                                                             toPiece(*existing));
+            }
+        }
+        if (schema == nullptr || (existing != nullptr && reader == nullptr)) {
+            LOG(ERROR) << "Can't merge on key " << folly::hexlify(key);
+            return keepExisting(merge_in, merge_out);
+        }
+
+        // Keep the schema version of existing row, a new row is written in latest schema
+        auto writer = reader != nullptr ? std::make_unique<RowWriterV2>(*reader)
+                                        : std::make_unique<RowWriterV2>(schema.get());
+        std::unordered_map<std::string, Value> merged;
+        for (auto& op : ops) {
+            auto found = merged.find(op.prop_);
+            if (found == merged.end()) {
+                auto base = reader != nullptr ? reader->getValueByName(op.prop_)
+                                              : Value(NullType::__NULL__);
+                found = merged.emplace(op.prop_, std::move(base)).first;
+            }
+            if (!apply(op, found->second)) {
+                LOG(ERROR) << "Can't merge prop " << op.prop_ << " with " << op.value_
+                           << " on " << found->second << " of key " << folly::hexlify(key);
+                return false;
+            }
+        }
+        for (auto& prop : merged) {
+            if (prop.second.isNull()) {
+                continue;
+            }
+            auto ret = writer->setValue(prop.first, prop.second);
+            if (ret != WriteResult::SUCCEEDED) {
+                LOG(ERROR) << "Fail to write merged prop " << prop.first
+                           << " of key " << folly::hexlify(key);
+                return false;
+            }
+        }
+        if (writer->finish() != WriteResult::SUCCEEDED) {
+            LOG(ERROR) << "Fail to encode merged row of key " << folly::hexlify(key);
+            return false;
+        }
+        merge_out->new_value = writer->moveEncodedStr();
+        return true;
     }
 
     bool PartialMerge(const rocksdb::Slice& key, const rocksdb::Slice& left_operand,
                       const rocksdb::Slice& right_operand, std::string* new_value,
                       rocksdb::Logger* logger) const override {
         UNUSED(key);
-        UNUSED(left_operand);
-        UNUSED(right_operand);
-        UNUSED(new_value);
         UNUSED(logger);
-        LOG(ERROR) << "NebulaMergeOperator not supported yet";
+        GraphSpaceID leftSpace = 0, rightSpace = 0;
+        std::vector<MergeOp> ops;
+        if (!MergeOperand::decode(toPiece(left_operand), leftSpace, ops) ||
+            !MergeOperand::decode(toPiece(right_operand), rightSpace, ops) ||
+            leftSpace != rightSpace) {
+            // let rocksdb keep both operands, they will be handled in FullMergeV2
+            return false;
+        }
+        *new_value = MergeOperand::encode(leftSpace, ops);
+        return true;
+    }
+
+    // Apply op on base in place, null base means the prop has not been set yet
+    static bool apply(const MergeOp& op, Value& base) {
+        const auto& v = op.value_;
+        switch (op.type_) {
+            case MergeOpType::ADD: {
+                if (!v.isNumeric()) {
+                    return false;
+                }
+                if (base.isNull()) {
+                    base = v;
+                    return true;
+                }
+                if (!base.isNumeric()) {
+                    return false;
+                }
+                if (base.isInt() && v.isInt()) {
+                    base = base.getInt() + v.getInt();
+                } else {
+                    base = toDouble(base) + toDouble(v);
+                }
+                return true;
+            }
+            case MergeOpType::MAX:
+            case MergeOpType::MIN: {
+                if (base.isNull()) {
+                    base = v;
+                    return true;
+                }
+                if (base.isNumeric() && v.isNumeric()) {
+                    bool less = toDouble(v) < toDouble(base);
+                    if (less == (op.type_ == MergeOpType::MIN)) {
+                        base = v;
+                    }
+                    return true;
+                }
+                if (base.isStr() && v.isStr()) {
+                    bool less = v.getStr() < base.getStr();
+                    if (less == (op.type_ == MergeOpType::MIN)) {
+                        base = v;
+                    }
+                    return true;
+                }
+                return false;
+            }
+            case MergeOpType::APPEND: {
+                if (!v.isStr()) {
+                    return false;
+                }
+                if (base.isNull()) {
+                    base = v;
+                    return true;
+                }
+                if (!base.isStr()) {
+                    return false;
+                }
+                base.mutableStr().append(v.getStr());
+                return true;
+            }
+        }
         return false;
     }
+
+    static double toDouble(const Value& v) {
+        return v.isInt() ? static_cast<double>(v.getInt()) : v.getFloat();
+    }
+
+    static folly::StringPiece toPiece(const rocksdb::Slice& slice) {
+        return folly::StringPiece(slice.data(), slice.size());
+    }
+
+    // The operands can't be applied, keep the existing row untouched. Without one there is no
+    // row to keep, and the merge fails rather than writing an empty value.
+    static bool keepExisting(const MergeOperationInput& merge_in,
+                             MergeOperationOutput* merge_out) {
+        if (merge_in.existing_value == nullptr) {
+            return false;
+        }
+        merge_out->existing_operand = *merge_in.existing_value;
+        return true;
+    }
+
+private:
+    meta::SchemaManager* schemaMan_{nullptr};
 };
 
 
 }  // namespace storage
 }  // namespace nebula
 #endif  // KVSTORE_MERGEOPERATOR_H_
-
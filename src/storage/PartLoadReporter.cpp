@@ -0,0 +1,111 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/PartLoadReporter.h"
+#include "common/time/WallClock.h"
+#include "kvstore/Part.h"
+#include "storage/StorageFlags.h"
+#include "utils/IndexKeyUtils.h"
+#include "utils/NebulaKeyUtils.h"
+
+namespace nebula {
+namespace storage {
+
+bool PartLoadReporter::start() {
+    if (FLAGS_part_load_report_interval_secs <= 0) {
+        LOG(INFO) << "The load of parts is not reported";
+        return true;
+    }
+    worker_ = std::make_unique<thread::GenericWorker>();
+    if (!worker_->start("part-load")) {
+        LOG(ERROR) << "Start the part load reporter failed";
+        return false;
+    }
+    worker_->addRepeatTask(FLAGS_part_load_report_interval_secs * 1000,
+                           &PartLoadReporter::report,
+                           this);
+    return true;
+}
+
+void PartLoadReporter::stop() {
+    if (worker_ != nullptr) {
+        worker_->stop();
+        worker_->wait();
+        worker_.reset();
+    }
+}
+
+void PartLoadReporter::report() {
+    auto loads = collect();
+    if (loads.empty()) {
+        return;
+    }
+    auto ret = metaClient_->multiPut(kvstore::PartLoad::segment(), std::move(loads)).get();
+    if (!ret.ok()) {
+        LOG(WARNING) << "Report the load of parts failed: " << ret.status();
+    }
+}
+
+std::vector<std::pair<std::string, std::string>> PartLoadReporter::collect() {
+    std::unordered_map<GraphSpaceID, std::vector<meta::cpp2::LeaderInfo>> leaders;
+    kvstore_->allLeader(leaders);
+
+    auto now = time::WallClock::fastNowInMilliSec();
+    std::vector<std::pair<std::string, std::string>> loads;
+    std::unordered_map<std::pair<GraphSpaceID, PartitionID>, Sample> samples;
+    for (const auto& entry : leaders) {
+        auto spaceId = entry.first;
+        for (const auto& leader : entry.second) {
+            auto partId = leader.get_part_id();
+            auto partRet = kvstore_->part(spaceId, partId);
+            if (!nebula::ok(partRet)) {
+                continue;
+            }
+            auto part = nebula::value(partRet);
+            Sample sample{part->reads(), part->writtenBytes(), now};
+            auto key = std::make_pair(spaceId, partId);
+            auto last = samples_.find(key);
+            samples.emplace(key, sample);
+            if (last == samples_.end() || sample.timeMs_ <= last->second.timeMs_) {
+                continue;
+            }
+
+            double secs = (sample.timeMs_ - last->second.timeMs_) / 1000.0;
+            kvstore::PartLoad load;
+            load.bytes_ = partSize(part->engine(), partId);
+            load.readQps_ = (sample.reads_ - last->second.reads_) / secs;
+            load.writeRate_ = (sample.writtenBytes_ - last->second.writtenBytes_) / secs;
+            load.reportTime_ = now / 1000;
+            loads.emplace_back(kvstore::PartLoad::key(spaceId, partId), load.encode());
+        }
+    }
+    // The parts no longer led by the host are forgotten
+    samples_ = std::move(samples);
+    return loads;
+}
+
+int64_t PartLoadReporter::partSize(kvstore::KVEngine* engine, PartitionID partId) {
+    std::vector<std::string> prefixes = {NebulaKeyUtils::vertexPrefix(partId),
+                                         NebulaKeyUtils::edgePrefix(partId),
+                                         IndexKeyUtils::indexPrefix(partId)};
+    int64_t size = 0;
+    for (const auto& prefix : prefixes) {
+        // All keys with the prefix are less than the prefix plus one
+        std::string end = prefix;
+        for (auto i = end.size(); i > 0; i--) {
+            auto& c = end[i - 1];
+            c = static_cast<char>(static_cast<uint8_t>(c) + 1);
+            if (c != 0) {
+                break;
+            }
+        }
+        size += engine->approximateSize(prefix, end);
+    }
+    return size;
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,64 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_PARTLOADREPORTER_H_
+#define STORAGE_PARTLOADREPORTER_H_
+
+#include "common/base/Base.h"
+#include "common/clients/meta/MetaClient.h"
+#include "common/thread/GenericWorker.h"
+#include "kvstore/KVStore.h"
+#include "kvstore/PartLoad.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * Reports the size and load of the parts led by the local host to meta every
+ * FLAGS_part_load_report_interval_secs, the balancer weighs the parts by them.
+ *
+ * The rates are measured between two reports, so a part is reported from the second round after
+ * the host becomes its leader.
+ * */
+class PartLoadReporter final {
+public:
+    PartLoadReporter(kvstore::KVStore* kvstore, meta::MetaClient* metaClient)
+        : kvstore_(kvstore)
+        , metaClient_(metaClient) {}
+
+    ~PartLoadReporter() {
+        stop();
+    }
+
+    bool start();
+
+    void stop();
+
+    // Measure the parts led by the local host since the last call, in the key and value saved
+    std::vector<std::pair<std::string, std::string>> collect();
+
+private:
+    void report();
+
+    int64_t partSize(kvstore::KVEngine* engine, PartitionID partId);
+
+private:
+    struct Sample {
+        int64_t     reads_;
+        int64_t     writtenBytes_;
+        int64_t     timeMs_;
+    };
+
+    kvstore::KVStore*                                                   kvstore_;
+    meta::MetaClient*                                                   metaClient_;
+    std::unique_ptr<thread::GenericWorker>                              worker_;
+    // Only accessed in the worker
+    std::unordered_map<std::pair<GraphSpaceID, PartitionID>, Sample>    samples_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_PARTLOADREPORTER_H_
@@ -0,0 +1,72 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/ShardedCache.h"
+
+namespace nebula {
+namespace storage {
+
+namespace {
+
+// Report to StatsManager every so many milliseconds
+constexpr int64_t kStatsFlushIntervalMs = 1000;
+
+}  // namespace
+
+
+void CacheShard::flushStats(const CacheCounters& counters) {
+    Counts pending;
+    {
+        std::lock_guard<std::mutex> g(lock_);
+        std::swap(pending, pending_);
+    }
+    if (pending.hits_ > 0) {
+        stats::StatsManager::addValue(counters.hits_, pending.hits_);
+    }
+    if (pending.misses_ > 0) {
+        stats::StatsManager::addValue(counters.misses_, pending.misses_);
+    }
+    if (pending.evicts_ > 0) {
+        stats::StatsManager::addValue(counters.evicts_, pending.evicts_);
+    }
+    if (pending.rejects_ > 0) {
+        stats::StatsManager::addValue(counters.rejects_, pending.rejects_);
+    }
+}
+
+
+ShardedCache::ShardedCache(const std::string& name,
+                           const CacheCounters& counters,
+                           uint32_t bucketsExp,
+                           ShardFactory newShard)
+        : counters_(counters)
+        , mask_((1UL << bucketsExp) - 1) {
+    size_t numShards = 1UL << bucketsExp;
+    shards_.reserve(numShards);
+    for (size_t i = 0; i < numShards; i++) {
+        shards_.emplace_back(newShard());
+    }
+    statsWorker_ = std::make_unique<thread::GenericWorker>();
+    CHECK(statsWorker_->start(name));
+    statsWorker_->addRepeatTask(kStatsFlushIntervalMs, &ShardedCache::flushStats, this);
+}
+
+
+ShardedCache::~ShardedCache() {
+    statsWorker_->stop();
+    statsWorker_->wait();
+    flushStats();
+}
+
+
+void ShardedCache::flushStats() {
+    for (auto& s : shards_) {
+        s->flushStats(counters_);
+    }
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,199 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_SHARDEDCACHE_H_
+#define STORAGE_SHARDEDCACHE_H_
+
+#include "common/base/Base.h"
+#include "common/stats/StatsManager.h"
+#include "common/thread/GenericWorker.h"
+
+namespace nebula {
+namespace storage {
+
+// The counters of a cache in StatsManager, named <name>_hits, <name>_misses and so on
+struct CacheCounters {
+    stats::CounterId hits_;
+    stats::CounterId misses_;
+    stats::CounterId evicts_;
+    stats::CounterId rejects_;
+
+    explicit CacheCounters(const std::string& name) {
+        hits_ = stats::StatsManager::registerStats(name + "_hits", "rate, sum");
+        misses_ = stats::StatsManager::registerStats(name + "_misses", "rate, sum");
+        evicts_ = stats::StatsManager::registerStats(name + "_evicts", "rate, sum");
+        rejects_ = stats::StatsManager::registerStats(name + "_rejects", "rate, sum");
+    }
+};
+
+
+/**
+ * One shard of a ShardedCache. The derived shard keeps the entries, guarded by lock_, and
+ * records the lookups, evictions and rejections while it holds lock_. The counts are kept
+ * both in total and as pending since they were last reported to StatsManager.
+ * */
+class CacheShard {
+public:
+    virtual ~CacheShard() = default;
+
+    uint64_t hits() const {
+        std::lock_guard<std::mutex> g(lock_);
+        return total_.hits_;
+    }
+
+    // The number of lookups
+    uint64_t total() const {
+        std::lock_guard<std::mutex> g(lock_);
+        return total_.hits_ + total_.misses_;
+    }
+
+    uint64_t evicts() const {
+        std::lock_guard<std::mutex> g(lock_);
+        return total_.evicts_;
+    }
+
+    uint64_t rejects() const {
+        std::lock_guard<std::mutex> g(lock_);
+        return total_.rejects_;
+    }
+
+    size_t bytes() const {
+        std::lock_guard<std::mutex> g(lock_);
+        return bytes_;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> g(lock_);
+        return entries();
+    }
+
+    // Report the pending counts
+    void flushStats(const CacheCounters& counters);
+
+protected:
+    // The number of entries, called with lock_ held
+    virtual size_t entries() const = 0;
+
+    void hit() {
+        total_.hits_++;
+        pending_.hits_++;
+    }
+
+    void miss() {
+        total_.misses_++;
+        pending_.misses_++;
+    }
+
+    void evicted() {
+        total_.evicts_++;
+        pending_.evicts_++;
+    }
+
+    void rejected() {
+        total_.rejects_++;
+        pending_.rejects_++;
+    }
+
+protected:
+    mutable std::mutex   lock_;
+    // Memory charged for all entries
+    size_t               bytes_{0};
+
+private:
+    struct Counts {
+        uint64_t hits_{0};
+        uint64_t misses_{0};
+        uint64_t evicts_{0};
+        uint64_t rejects_{0};
+    };
+
+    Counts               total_;
+    // Not reported to StatsManager yet
+    Counts               pending_;
+};
+
+
+/**
+ * The part shared by the caches in storage. The entries are spread among 1 << bucketsExp
+ * shards by the low bits of the key hash, each shard has its own lock. The counts of all
+ * shards are reported to StatsManager every second by a background worker, so they are not
+ * held back by a shard which is idle or only written, and once more on destruction.
+ * */
+class ShardedCache {
+public:
+    uint64_t hits() const {
+        return sum(&CacheShard::hits);
+    }
+
+    // The number of lookups
+    uint64_t total() const {
+        return sum(&CacheShard::total);
+    }
+
+    // The number of entries removed, either invalidated or pushed out by the memory budget
+    uint64_t evicts() const {
+        return sum(&CacheShard::evicts);
+    }
+
+    // The number of entries refused
+    uint64_t rejects() const {
+        return sum(&CacheShard::rejects);
+    }
+
+    // Memory used by all entries
+    size_t bytes() const {
+        return sum(&CacheShard::bytes);
+    }
+
+    size_t size() const {
+        return sum(&CacheShard::size);
+    }
+
+protected:
+    using ShardFactory = std::function<std::unique_ptr<CacheShard>()>;
+
+    // counters must outlive the cache, the worker thread is named after name
+    ShardedCache(const std::string& name,
+                 const CacheCounters& counters,
+                 uint32_t bucketsExp,
+                 ShardFactory newShard);
+
+    ~ShardedCache();
+
+    CacheShard& shardOf(size_t hash) const {
+        return *shards_[hash & mask_];
+    }
+
+    size_t numShards() const {
+        return shards_.size();
+    }
+
+    CacheShard& shardAt(size_t i) const {
+        return *shards_[i];
+    }
+
+private:
+    template <typename T>
+    T sum(T (CacheShard::*fn)() const) const {
+        T total = 0;
+        for (const auto& s : shards_) {
+            total += ((*s).*fn)();
+        }
+        return total;
+    }
+
+    void flushStats();
+
+private:
+    const CacheCounters&                      counters_;
+    size_t                                    mask_;
+    std::vector<std::unique_ptr<CacheShard>>  shards_;
+    std::unique_ptr<thread::GenericWorker>    statsWorker_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_SHARDEDCACHE_H_
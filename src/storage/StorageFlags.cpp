@@ -26,12 +26,35 @@ DEFINE_int32(rebuild_index_batch_num, 1024,
 DEFINE_int32(rebuild_index_locked_threshold, 1024,
              "The locked threshold will refuse writing.");
 
-DEFINE_int32(vertex_cache_num, 16 * 1000 * 1000, "Total keys inside the cache");
+DEFINE_bool(rebuild_index_by_sst, false,
+            "Ingest the rebuilt index of a part without other replicas as local sst files");
 
-DEFINE_int32(vertex_cache_bucket_exp, 4, "Total buckets number is 1 << cache_bucket_exp");
+DEFINE_int32(rebuild_index_sst_buffer_mb, 64,
+             "Memory buffered for each sst file when rebuilding index by sst");
+
+DEFINE_int32(rebuild_index_inflight_batches, 4,
+             "The number of batches in flight when rebuilding index by raft");
+
+DEFINE_int64(vertex_cache_capacity_mb, 1024, "Memory budget of the vertex cache in MB");
+
+DEFINE_int32(vertex_cache_bucket_exp, 8, "Total buckets number is 1 << cache_bucket_exp");
 
 DEFINE_bool(enable_vertex_cache, true, "Enable vertex cache");
 
+DEFINE_bool(enable_adjacency_cache, false,
+            "Serve the edges of vertices with large out degree from memory in GetNeighbors");
+
+DEFINE_int64(adjacency_cache_capacity_mb, 1024, "Memory budget of the adjacency cache in MB");
+
+DEFINE_int32(adjacency_cache_bucket_exp, 4,
+             "Total buckets number of the adjacency cache is 1 << adjacency_cache_bucket_exp");
+
+DEFINE_int32(adjacency_cache_degree_threshold, 1000,
+             "Edges of a vertex and edge type are cached when there are at least so many");
+
+DEFINE_int32(adjacency_cache_ttl_secs, 600,
+             "Seconds a cached adjacency list is served before it is read again");
+
 DEFINE_int32(reader_handlers, 32, "Total reader handlers");
 
 DEFINE_uint64(default_mvcc_ver, 0L, "vertex/edge version if enable_multi_versions set to false."
@@ -43,5 +66,31 @@ DEFINE_string(reader_handlers_type, "cpu", "Type of reader handlers, options: cp
 
 DEFINE_bool(trace_toss, false, "output verbose log of toss");
 
+DEFINE_int32(toss_worker_threads, 16,
+             "Number of threads committing toss transactions, apart from the reader handlers");
+
 DEFINE_int32(max_edge_returned_per_vertex, INT_MAX,
              "Max edge number returnred searching vertex");
+
+DEFINE_bool(query_concurrently, false,
+            "Whether to split a query into sub tasks and run them concurrently in reader handlers,"
+            " only GetNeighbors and LookupIndex are supported for now");
+
+DEFINE_int32(max_concurrent_tasks_per_query, 8,
+             "Max number of sub tasks of a query running at the same time");
+
+DEFINE_int32(max_vids_per_query_task, 0,
+             "Max number of vertices handled by a sub task of a concurrent query, "
+             "0 means each part would be a sub task");
+
+DEFINE_int64(max_scan_bytes_per_response, 0,
+             "Max bytes of keys and values read by a ScanVertex or ScanEdge request, the rest "
+             "are left to the next request by the cursor. 0 means only the row limit is used");
+
+DEFINE_int32(vertex_multiget_batch_size, 256,
+             "Max number of vertex keys read by one multiGet when fetching vertices, "
+             "0 means TagNode reads vertices one by one");
+
+DEFINE_int32(part_load_report_interval_secs, 60,
+             "Interval to report the size and load of the parts led by the host to meta, which "
+             "the balancer weighs the parts by. 0 means not to report");
@@ -23,12 +23,28 @@ DECLARE_int32(rebuild_index_batch_num);
 
 DECLARE_int32(rebuild_index_locked_threshold);
 
-DECLARE_int32(vertex_cache_num);
+DECLARE_bool(rebuild_index_by_sst);
+
+DECLARE_int32(rebuild_index_sst_buffer_mb);
+
+DECLARE_int32(rebuild_index_inflight_batches);
+
+DECLARE_int64(vertex_cache_capacity_mb);
 
 DECLARE_int32(vertex_cache_bucket_exp);
 
 DECLARE_bool(enable_vertex_cache);
 
+DECLARE_bool(enable_adjacency_cache);
+
+DECLARE_int64(adjacency_cache_capacity_mb);
+
+DECLARE_int32(adjacency_cache_bucket_exp);
+
+DECLARE_int32(adjacency_cache_degree_threshold);
+
+DECLARE_int32(adjacency_cache_ttl_secs);
+
 DECLARE_int32(reader_handlers);
 
 DECLARE_uint64(default_mvcc_ver);
@@ -37,6 +53,20 @@ DECLARE_string(reader_handlers_type);
 
 DECLARE_bool(trace_toss);
 
+DECLARE_int32(toss_worker_threads);
+
 DECLARE_int32(max_edge_returned_per_vertex);
 
+DECLARE_bool(query_concurrently);
+
+DECLARE_int32(max_concurrent_tasks_per_query);
+
+DECLARE_int32(max_vids_per_query_task);
+
+DECLARE_int32(vertex_multiget_batch_size);
+
+DECLARE_int64(max_scan_bytes_per_response);
+
+DECLARE_int32(part_load_report_interval_secs);
+
 #endif  // STORAGE_STORAGEFLAGS_H_
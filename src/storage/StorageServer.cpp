@@ -16,6 +16,7 @@
 #include "common/version/Version.h"
 #include "storage/BaseProcessor.h"
 #include "storage/CompactionFilter.h"
+#include "storage/MergeOperator.h"
 #include "storage/StorageFlags.h"
 #include "storage/StorageAdminServiceHandler.h"
 #include "storage/InternalStorageServiceHandler.h"
@@ -60,7 +61,16 @@ std::unique_ptr<kvstore::KVStore> StorageServer::getStoreInstance() {
                                                 metaClient_.get());
     options.cffBuilder_ = std::make_unique<StorageCompactionFilterFactoryBuilder>(schemaMan_.get(),
                                                                                   indexMan_.get());
+    options.mergeOp_ = std::make_shared<NebulaOperator>(schemaMan_.get());
     options.schemaMan_ = schemaMan_.get();
+    if (FLAGS_enable_adjacency_cache) {
+        adjCache_ = std::make_shared<AdjacencyCache>(
+            FLAGS_adjacency_cache_capacity_mb * 1024 * 1024,
+            FLAGS_adjacency_cache_bucket_exp,
+            FLAGS_adjacency_cache_degree_threshold,
+            FLAGS_adjacency_cache_ttl_secs);
+        options.commitListener_ = adjCache_;
+    }
     if (FLAGS_store_type == "nebula") {
         auto nbStore = std::make_unique<kvstore::NebulaStore>(std::move(options),
                                                               ioThreadPool_,
@@ -173,6 +183,15 @@ bool StorageServer::start() {
 
     env_->verticesML_ = std::make_unique<VerticesMemLock>();
     env_->edgesML_ = std::make_unique<EdgesMemLock>();
+    env_->adjCache_ = adjCache_;
+
+    if (listenerPath_.empty()) {
+        loadReporter_ = std::make_unique<PartLoadReporter>(kvstore_.get(), metaClient_.get());
+        if (!loadReporter_->start()) {
+            LOG(ERROR) << "Start part load reporter failed!";
+            return false;
+        }
+    }
 
     storageThread_.reset(new std::thread([this] {
         try {
@@ -284,6 +303,8 @@ void StorageServer::stop() {
     ServiceStatus interStorageExpected = ServiceStatus::STATUS_RUNNING;
     internalStorageSvcStatus_.compare_exchange_strong(interStorageExpected, STATUS_STTOPED);
 
+    // The reporter reads the parts of kvstore
+    loadReporter_.reset();
     // kvstore need to stop back ground job before http server dctor
     if (kvstore_) {
         kvstore_->stop();
@@ -15,6 +15,7 @@
 #include <thrift/lib/cpp2/server/ThriftServer.h>
 #include "kvstore/NebulaStore.h"
 #include "storage/CommonUtils.h"
+#include "storage/PartLoadReporter.h"
 #include "storage/admin/AdminTaskManager.h"
 
 namespace nebula {
@@ -83,6 +84,9 @@ private:
 
     AdminTaskManager* taskMgr_{nullptr};
     std::unique_ptr<TransactionManager> txnMan_;
+    std::unique_ptr<PartLoadReporter> loadReporter_;
+    // Listens to the commits of the kvstore, when enable_adjacency_cache is on
+    std::shared_ptr<AdjacencyCache> adjCache_;
 };
 
 }  // namespace storage
@@ -0,0 +1,263 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/VertexCache.h"
+#include <folly/hash/Hash.h>
+#include <folly/lang/Bits.h>
+
+namespace nebula {
+namespace storage {
+
+namespace {
+
+// Memory of the list node and the hash map entry besides the key and value
+constexpr size_t kEntryOverhead = 96;
+// Used to size the sketch, one counter per entry of this size
+constexpr size_t kAvgEntrySize = 256;
+
+const CacheCounters& counters() {
+    static CacheCounters counters("vertex_cache");
+    return counters;
+}
+
+/**
+ * Count-min sketch with 4 rows of 4-bit (saturated at 15) counters. All counters are
+ * halved once there have been 10 * width additions, so the old popularity fades out.
+ * */
+class FrequencySketch final {
+public:
+    explicit FrequencySketch(size_t width)
+        : width_(width)
+        , table_(kDepth * width, 0)
+        , resetAt_(10 * width) {
+        CHECK_EQ(0, width & (width - 1));
+    }
+
+    void add(size_t hash) {
+        for (size_t i = 0; i < kDepth; i++) {
+            auto& counter = table_[index(hash, i)];
+            if (counter < kMaxCount) {
+                counter++;
+            }
+        }
+        if (++additions_ >= resetAt_) {
+            reset();
+        }
+    }
+
+    uint8_t estimate(size_t hash) const {
+        uint8_t freq = kMaxCount;
+        for (size_t i = 0; i < kDepth; i++) {
+            freq = std::min(freq, table_[index(hash, i)]);
+        }
+        return freq;
+    }
+
+private:
+    size_t index(size_t hash, size_t i) const {
+        auto h = folly::hash::twang_mix64(hash + i * 0x9E3779B97F4A7C15ULL);
+        return i * width_ + (h & (width_ - 1));
+    }
+
+    void reset() {
+        for (auto& counter : table_) {
+            counter >>= 1;
+        }
+        additions_ /= 2;
+    }
+
+private:
+    static constexpr size_t  kDepth = 4;
+    static constexpr uint8_t kMaxCount = 15;
+
+    size_t               width_;
+    std::vector<uint8_t> table_;
+    size_t               resetAt_;
+    size_t               additions_{0};
+};
+
+}  // namespace
+
+
+class VertexCache::Shard final : public CacheShard {
+public:
+    explicit Shard(size_t capacity)
+        : capacity_(capacity)
+        , protectedCapacity_(capacity * 8 / 10)
+        , sketch_(sketchWidth(capacity)) {}
+
+    StatusOr<std::string> get(const Key& key, size_t hash) {
+        std::lock_guard<std::mutex> g(lock_);
+        sketch_.add(hash);
+        auto it = map_.find(key);
+        if (it == map_.end()) {
+            miss();
+            return Status::Error();
+        }
+        hit();
+
+        auto entry = it->second;
+        if (entry->protected_) {
+            protected_.splice(protected_.begin(), protected_, entry);
+        } else {
+            promote(entry);
+        }
+        return entry->value_;
+    }
+
+    void insert(const Key& key, size_t hash, std::string value) {
+        size_t charge = key.first.size() + value.size() + kEntryOverhead;
+        std::lock_guard<std::mutex> g(lock_);
+        auto it = map_.find(key);
+        if (charge > capacity_) {
+            if (it != map_.end()) {
+                remove(it->second);
+            }
+            rejected();
+            return;
+        }
+
+        if (it != map_.end()) {
+            // Refresh the value in place
+            auto entry = it->second;
+            bytes_ = bytes_ - entry->charge_ + charge;
+            if (entry->protected_) {
+                protectedBytes_ = protectedBytes_ - entry->charge_ + charge;
+            }
+            entry->charge_ = charge;
+            entry->value_ = std::move(value);
+            while (bytes_ > capacity_) {
+                removeTail();
+            }
+            return;
+        }
+
+        if (bytes_ + charge > capacity_) {
+            // The new entry has to be more popular than the one it would evict
+            const auto& victim = probation_.empty() ? protected_.back() : probation_.back();
+            if (sketch_.estimate(hash) <= sketch_.estimate(victim.hash_)) {
+                rejected();
+                return;
+            }
+            while (bytes_ + charge > capacity_) {
+                removeTail();
+            }
+        }
+        probation_.emplace_front(Entry{key, hash, std::move(value), charge, false});
+        map_.emplace(key, probation_.begin());
+        bytes_ += charge;
+    }
+
+    void evict(const Key& key) {
+        std::lock_guard<std::mutex> g(lock_);
+        auto it = map_.find(key);
+        if (it != map_.end()) {
+            remove(it->second);
+        }
+    }
+
+private:
+    struct Entry {
+        Key         key_;
+        size_t      hash_;
+        std::string value_;
+        size_t      charge_;
+        bool        protected_;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    static size_t sketchWidth(size_t capacity) {
+        size_t width = std::max<size_t>(capacity / kAvgEntrySize, 64);
+        return folly::nextPowTwo(std::min<size_t>(width, 1 << 20));
+    }
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return VertexCache::hash(key);
+        }
+    };
+
+    size_t entries() const override {
+        return map_.size();
+    }
+
+    // Move an entry hit in probation to the head of protected, and demote the tail of
+    // protected back to probation if protected is over its budget
+    void promote(EntryList::iterator entry) {
+        protected_.splice(protected_.begin(), probation_, entry);
+        entry->protected_ = true;
+        protectedBytes_ += entry->charge_;
+        while (protectedBytes_ > protectedCapacity_ && protected_.size() > 1) {
+            auto demoted = std::prev(protected_.end());
+            probation_.splice(probation_.begin(), protected_, demoted);
+            demoted->protected_ = false;
+            protectedBytes_ -= demoted->charge_;
+        }
+    }
+
+    void removeTail() {
+        DCHECK(!probation_.empty() || !protected_.empty());
+        if (!probation_.empty()) {
+            remove(std::prev(probation_.end()));
+        } else {
+            remove(std::prev(protected_.end()));
+        }
+    }
+
+    void remove(EntryList::iterator entry) {
+        bytes_ -= entry->charge_;
+        map_.erase(entry->key_);
+        if (entry->protected_) {
+            protectedBytes_ -= entry->charge_;
+            protected_.erase(entry);
+        } else {
+            probation_.erase(entry);
+        }
+        evicted();
+    }
+
+private:
+    const size_t                                                capacity_;
+    const size_t                                                protectedCapacity_;
+    size_t                                                      protectedBytes_{0};
+
+    EntryList                                                   probation_;
+    EntryList                                                   protected_;
+    std::unordered_map<Key, EntryList::iterator, KeyHash>       map_;
+    FrequencySketch                                             sketch_;
+};
+
+
+VertexCache::VertexCache(size_t capacity, uint32_t bucketsExp)
+        : ShardedCache("vertex-cache", counters(), bucketsExp, [=] {
+            return std::make_unique<Shard>(capacity >> bucketsExp);
+        }) {}
+
+
+VertexCache::Shard& VertexCache::shard(size_t hash) const {
+    return static_cast<Shard&>(shardOf(hash));
+}
+
+
+StatusOr<std::string> VertexCache::get(const Key& key) {
+    auto h = hash(key);
+    return shard(h).get(key, h);
+}
+
+
+void VertexCache::insert(const Key& key, std::string value) {
+    auto h = hash(key);
+    shard(h).insert(key, h, std::move(value));
+}
+
+
+void VertexCache::evict(const Key& key) {
+    shard(hash(key)).evict(key);
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,56 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_VERTEXCACHE_H_
+#define STORAGE_VERTEXCACHE_H_
+
+#include "common/base/Base.h"
+#include "common/base/StatusOr.h"
+#include "common/thrift/ThriftTypes.h"
+#include "storage/ShardedCache.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * VertexCache keeps the encoded rows of hot vertices, keyed by (vid, tagId).
+ *
+ * The capacity is a memory budget in bytes, split evenly among the shards. Inside a shard
+ * the entries are kept in a segmented LRU: a new entry goes into the probation segment,
+ * and is promoted into the protected segment (at most 80% of the shard) once it is hit
+ * again. So a scan only churns the probation segment.
+ *
+ * When a shard is full, a new entry has to win against the entry it would evict. The
+ * access frequency of both is estimated by a count-min sketch (TinyLFU), which is halved
+ * periodically so that it follows the recent traffic. Entries seen only once, such as
+ * those of a scan, won't push out the frequently accessed ones.
+ * */
+class VertexCache final : public ShardedCache {
+public:
+    using Key = std::pair<VertexID, TagID>;
+
+    VertexCache(size_t capacity, uint32_t bucketsExp);
+
+    StatusOr<std::string> get(const Key& key);
+
+    // The entry may not be admitted if the cache is full
+    void insert(const Key& key, std::string value);
+
+    void evict(const Key& key);
+
+private:
+    class Shard;
+
+    Shard& shard(size_t hash) const;
+
+    static size_t hash(const Key& key) {
+        return folly::hash::hash_combine(key.first, key.second);
+    }
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_VERTEXCACHE_H_
@@ -11,6 +11,11 @@
 #include "storage/admin/RebuildEdgeIndexTask.h"
 #include "storage/admin/StatisTask.h"
 
+DECLARE_uint32(max_concurrent_subtasks);
+DEFINE_uint32(max_ranges_per_part, 8,
+              "The max number of ranges a part is split into, which are scanned by the sub tasks"
+              " of an admin task in parallel");
+
 namespace nebula {
 namespace storage {
 
@@ -40,5 +45,52 @@ AdminTaskFactory::createAdminTask(StorageEnv* env, TaskContext&& ctx) {
     return ret;
 }
 
+int32_t AdminTask::rangesPerPart(size_t partNum) const {
+    if (partNum == 0) {
+        return 1;
+    }
+    size_t count = (FLAGS_max_concurrent_subtasks + partNum - 1) / partNum;
+    count = std::min(count, static_cast<size_t>(FLAGS_max_ranges_per_part));
+    return std::max(static_cast<int32_t>(count), 1);
+}
+
+std::vector<std::pair<std::string, std::string>>
+AdminTask::splitPart(GraphSpaceID space,
+                     PartitionID part,
+                     const std::string& prefix,
+                     size_t alignLen,
+                     int32_t count) {
+    // All keys with the prefix are less than the prefix plus one
+    std::string end = prefix;
+    for (auto i = end.size(); i > 0; i--) {
+        auto& c = end[i - 1];
+        c = static_cast<char>(static_cast<uint8_t>(c) + 1);
+        if (c != 0) {
+            break;
+        }
+    }
+
+    std::vector<std::string> keys;
+    if (count > 1) {
+        auto partRet = env_->kvstore_->part(space, part);
+        if (nebula::ok(partRet)) {
+            keys = nebula::value(partRet)->engine()->splitRange(prefix, end, count);
+        }
+    }
+
+    std::vector<std::pair<std::string, std::string>> ranges;
+    std::string start = prefix;
+    for (const auto& key : keys) {
+        auto boundary = key.substr(0, alignLen);
+        if (boundary <= start) {
+            continue;
+        }
+        ranges.emplace_back(start, boundary);
+        start = std::move(boundary);
+    }
+    ranges.emplace_back(std::move(start), std::move(end));
+    return ranges;
+}
+
 }  // namespace storage
 }  // namespace nebula
@@ -138,6 +138,20 @@ public:
     std::atomic<size_t>         unFinishedSubTask_;
     SubTaskQueue                subtasks_;
 
+protected:
+    // The number of ranges each part is split into, so that the sub tasks could keep
+    // FLAGS_max_concurrent_subtasks threads busy even if there are only a few parts
+    int32_t rangesPerPart(size_t partNum) const;
+
+    // Split the keys with the prefix in a part into at most count ranges [start, end) of about
+    // the same size on disk. A boundary is cut to its first alignLen bytes, so that the keys
+    // sharing them, e.g. the keys of a vertex, are always in the same range.
+    std::vector<std::pair<std::string, std::string>> splitPart(GraphSpaceID space,
+                                                               PartitionID part,
+                                                               const std::string& prefix,
+                                                               size_t alignLen,
+                                                               int32_t count);
+
 protected:
     StorageEnv*                     env_;
     TaskContext                     ctx_;
@@ -6,6 +6,7 @@
 
 #include "storage/StorageFlags.h"
 #include "storage/admin/RebuildEdgeIndexTask.h"
+#include "storage/admin/RebuildIndexWriter.h"
 #include "utils/IndexKeyUtils.h"
 #include "codec/RowReaderWrapper.h"
 
@@ -24,7 +25,10 @@ RebuildEdgeIndexTask::getIndex(GraphSpaceID space, IndexID index) {
 
 kvstore::ResultCode RebuildEdgeIndexTask::buildIndexGlobal(GraphSpaceID space,
                                                            PartitionID part,
-                                                           const IndexItems& items) {
+                                                           const IndexItems& items,
+                                                           const std::string& start,
+                                                           const std::string& end,
+                                                           int32_t rangeId) {
     if (canceled_) {
         LOG(ERROR) << "Rebuild Edge Index is Canceled";
         return kvstore::ResultCode::SUCCEEDED;
@@ -43,8 +47,7 @@ kvstore::ResultCode RebuildEdgeIndexTask::buildIndexGlobal(GraphSpaceID space,
 
     auto vidSize = vidSizeRet.value();
     std::unique_ptr<kvstore::KVIterator> iter;
-    auto prefix = NebulaKeyUtils::edgePrefix(part);
-    auto ret = env_->kvstore_->prefix(space, part, prefix, &iter);
+    auto ret = env_->kvstore_->range(space, part, start, end, &iter);
     if (ret != kvstore::ResultCode::SUCCEEDED) {
         LOG(ERROR) << "Processing Part " << part << " Failed";
         return ret;
@@ -53,8 +56,7 @@ kvstore::ResultCode RebuildEdgeIndexTask::buildIndexGlobal(GraphSpaceID space,
     VertexID currentSrcVertex = "";
     VertexID currentDstVertex = "";
     EdgeRanking currentRanking = 0;
-    std::vector<kvstore::KV> data;
-    data.reserve(FLAGS_rebuild_index_batch_num);
+    RebuildIndexWriter writer(env_, space, part, rangeId);
     RowReaderWrapper reader;
     while (iter && iter->valid()) {
         if (canceled_) {
@@ -62,15 +64,6 @@ kvstore::ResultCode RebuildEdgeIndexTask::buildIndexGlobal(GraphSpaceID space,
             return kvstore::ResultCode::SUCCEEDED;
         }
 
-        if (static_cast<int32_t>(data.size()) == FLAGS_rebuild_index_batch_num) {
-            auto result = writeData(space, part, data);
-            if (result != kvstore::ResultCode::SUCCEEDED) {
-                LOG(ERROR) << "Write Part " << part << " Index Failed";
-                return result;
-            }
-            data.clear();
-        }
-
         auto key = iter->key();
         auto val = iter->val();
 
@@ -152,13 +145,17 @@ kvstore::ResultCode RebuildEdgeIndexTask::buildIndexGlobal(GraphSpaceID space,
                                                             ranking,
                                                             destination.toString(),
                                                             std::move(valuesRet).value());
-                data.emplace_back(std::move(indexKey), indexVal);
+                auto result = writer.put(std::move(indexKey), indexVal);
+                if (result != kvstore::ResultCode::SUCCEEDED) {
+                    LOG(ERROR) << "Write Part " << part << " Index Failed";
+                    return result;
+                }
             }
         }
         iter->next();
     }
 
-    auto result = writeData(space, part, std::move(data));
+    auto result = writer.finish();
     if (result != kvstore::ResultCode::SUCCEEDED) {
         LOG(ERROR) << "Write Part " << part << " Index Failed";
         return kvstore::ResultCode::ERR_IO_ERROR;
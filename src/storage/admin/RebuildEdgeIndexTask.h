@@ -8,6 +8,7 @@
 #define STORAGE_ADMIN_REBUILDEDGEINDEXTASK_H_
 
 #include "storage/admin/RebuildIndexTask.h"
+#include "utils/NebulaKeyUtils.h"
 
 namespace nebula {
 namespace storage {
@@ -25,9 +26,16 @@ private:
     StatusOr<std::shared_ptr<meta::cpp2::IndexItem>>
     getIndex(GraphSpaceID space, IndexID index) override;
 
+    std::string scanPrefix(PartitionID part) override {
+        return NebulaKeyUtils::edgePrefix(part);
+    }
+
     kvstore::ResultCode buildIndexGlobal(GraphSpaceID space,
                                          PartitionID part,
-                                         const IndexItems& items) override;
+                                         const IndexItems& items,
+                                         const std::string& start,
+                                         const std::string& end,
+                                         int32_t rangeId) override;
 };
 
 }  // namespace storage
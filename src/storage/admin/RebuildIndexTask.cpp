@@ -54,38 +54,71 @@ RebuildIndexTask::genSubTasks() {
         }
     }
 
+    auto vIdLenRet = env_->schemaMan_->getSpaceVidLen(space_);
+    if (!vIdLenRet.ok()) {
+        LOG(ERROR) << "Get space vid length failed";
+        return cpp2::ErrorCode::E_SPACE_NOT_FOUND;
+    }
+
+    // The keys of a vertex, or the edges of a source vertex, are always in the same range
+    auto alignLen = sizeof(PartitionID) + vIdLenRet.value();
+    auto count = rangesPerPart(parts.size());
     for (const auto& part : parts) {
         env_->rebuildIndexGuard_->insert_or_assign(std::make_tuple(space_, part),
                                                    IndexState::STARTING);
-        std::function<kvstore::ResultCode()> task =
-            std::bind(&RebuildIndexTask::invoke, this, space_, part, items);
-        tasks.emplace_back(std::move(task));
+        auto ranges = splitPart(space_, part, scanPrefix(part), alignLen, count);
+        auto state = std::make_unique<PartState>();
+        state->unfinishedRanges_ = ranges.size();
+        partStates_[part] = std::move(state);
+        for (size_t i = 0; i < ranges.size(); i++) {
+            std::function<kvstore::ResultCode()> task =
+                std::bind(&RebuildIndexTask::invoke, this, space_, part, items,
+                          ranges[i].first, ranges[i].second, static_cast<int32_t>(i));
+            tasks.emplace_back(std::move(task));
+        }
     }
+    LOG(INFO) << "Rebuild index of " << parts.size() << " parts in " << tasks.size()
+              << " ranges";
     return tasks;
 }
 
 kvstore::ResultCode RebuildIndexTask::invoke(GraphSpaceID space,
                                              PartitionID part,
-                                             const IndexItems& items) {
-    auto result = removeLegacyLogs(space, part);
-    if (result != kvstore::ResultCode::SUCCEEDED) {
-        LOG(ERROR) << "Remove legacy logs at part: " << part << " failed";
-        return kvstore::ResultCode::ERR_BUILD_INDEX_FAILED;
-    } else {
+                                             const IndexItems& items,
+                                             const std::string& start,
+                                             const std::string& end,
+                                             int32_t rangeId) {
+    auto& state = *partStates_.at(part);
+    std::call_once(state.prepared_, [this, space, part, &state] {
+        auto ret = removeLegacyLogs(space, part);
+        if (ret != kvstore::ResultCode::SUCCEEDED) {
+            LOG(ERROR) << "Remove legacy logs at part: " << part << " failed";
+            state.prepareResult_ = kvstore::ResultCode::ERR_BUILD_INDEX_FAILED;
+            return;
+        }
         VLOG(1) << "Remove legacy logs at part: " << part << " successful";
-    }
 
-    // todo(doodle): this place has potential bug is that we'd better lock the part at first,
-    // then switch to BUILDING, otherwise some data won't build index in worst case.
-    env_->rebuildIndexGuard_->assign(std::make_tuple(space, part), IndexState::BUILDING);
+        // todo(doodle): this place has potential bug is that we'd better lock the part at
+        // first, then switch to BUILDING, otherwise some data won't build index in worst case.
+        env_->rebuildIndexGuard_->assign(std::make_tuple(space, part), IndexState::BUILDING);
+    });
+    if (state.prepareResult_ != kvstore::ResultCode::SUCCEEDED) {
+        return state.prepareResult_;
+    }
 
     LOG(INFO) << "Start building index";
-    result = buildIndexGlobal(space, part, items);
+    auto result = buildIndexGlobal(space, part, items, start, end, rangeId);
     if (result != kvstore::ResultCode::SUCCEEDED) {
         LOG(ERROR) << "Building index failed";
         return kvstore::ResultCode::ERR_BUILD_INDEX_FAILED;
     } else {
-        LOG(INFO) << folly::sformat("Building index successful, space={}, part={}", space, part);
+        LOG(INFO) << folly::sformat("Building index successful, space={}, part={}, range={}",
+                                    space, part, rangeId);
+    }
+
+    // The operation logs are replayed after all ranges of the part are built
+    if (--state.unfinishedRanges_ > 0) {
+        return kvstore::ResultCode::SUCCEEDED;
     }
 
     LOG(INFO) << folly::sformat("Processing operation logs, space={}, part={}", space, part);
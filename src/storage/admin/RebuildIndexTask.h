@@ -35,10 +35,17 @@ protected:
     virtual StatusOr<std::shared_ptr<meta::cpp2::IndexItem>>
     getIndex(GraphSpaceID space, IndexID index) = 0;
 
+    // The prefix of the data to build the index from
+    virtual std::string scanPrefix(PartitionID part) = 0;
+
+    // Build the index from the data in range [start, end) of a part
     virtual kvstore::ResultCode
     buildIndexGlobal(GraphSpaceID space,
                      PartitionID part,
-                     const IndexItems& items) = 0;
+                     const IndexItems& items,
+                     const std::string& start,
+                     const std::string& end,
+                     int32_t rangeId) = 0;
 
     void cancel() override {
         canceled_ = true;
@@ -66,11 +73,24 @@ protected:
 
     kvstore::ResultCode invoke(GraphSpaceID space,
                                PartitionID part,
-                               const IndexItems& items);
+                               const IndexItems& items,
+                               const std::string& start,
+                               const std::string& end,
+                               int32_t rangeId);
 
 protected:
-    std::atomic<bool>   canceled_{false};
-    GraphSpaceID        space_;
+    // A part is split into ranges built by different subtasks. The first one to run removes
+    // the legacy operation logs, and the last one to finish replays the operation logs.
+    struct PartState {
+        std::once_flag                  prepared_;
+        kvstore::ResultCode             prepareResult_{kvstore::ResultCode::SUCCEEDED};
+        std::atomic<size_t>             unfinishedRanges_{0};
+    };
+
+    std::atomic<bool>                                           canceled_{false};
+    GraphSpaceID                                                space_;
+    // Built before any subtask runs, and read only after that
+    std::unordered_map<PartitionID, std::unique_ptr<PartState>> partStates_;
 };
 
 }  // namespace storage
@@ -0,0 +1,175 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/admin/RebuildIndexWriter.h"
+#include "common/fs/FileUtils.h"
+#include "kvstore/Part.h"
+#include "storage/StorageFlags.h"
+#include <rocksdb/sst_file_writer.h>
+
+namespace nebula {
+namespace storage {
+
+RebuildIndexWriter::RebuildIndexWriter(StorageEnv* env,
+                                       GraphSpaceID space,
+                                       PartitionID part,
+                                       int32_t rangeId)
+    : env_(env)
+    , space_(space)
+    , part_(part) {
+    data_.reserve(FLAGS_rebuild_index_batch_num);
+    if (!FLAGS_rebuild_index_by_sst) {
+        return;
+    }
+    auto partRet = env_->kvstore_->part(space_, part_);
+    if (!nebula::ok(partRet)) {
+        return;
+    }
+    auto partPtr = nebula::value(partRet);
+    // The peers include the part itself
+    if (partPtr->peers().size() != 1) {
+        LOG(INFO) << "Space " << space_ << ", part " << part_
+                  << " has other replicas, write the index by raft";
+        return;
+    }
+
+    auto* engine = partPtr->engine();
+    path_ = folly::stringPrintf("%s/rebuild_index/%d/%d", engine->getDataRoot(), part_, rangeId);
+    // The files left by a former task are useless
+    removeFiles();
+    if (!fs::FileUtils::makeDir(path_)) {
+        LOG(ERROR) << "Failed to create dir " << path_ << ", write the index by raft";
+        return;
+    }
+    engine_ = engine;
+    LOG(INFO) << "Space " << space_ << ", part " << part_ << " writes the index by sst in "
+              << path_;
+}
+
+RebuildIndexWriter::~RebuildIndexWriter() {
+    waitInflight(0);
+    if (bySst()) {
+        removeFiles();
+    }
+}
+
+kvstore::ResultCode RebuildIndexWriter::put(std::string key, std::string val) {
+    bytes_ += key.size() + val.size();
+    data_.emplace_back(std::move(key), std::move(val));
+    if (bySst()) {
+        if (bytes_ >= static_cast<size_t>(FLAGS_rebuild_index_sst_buffer_mb) * 1024 * 1024) {
+            return spill();
+        }
+    } else if (static_cast<int32_t>(data_.size()) >= FLAGS_rebuild_index_batch_num) {
+        return sendBatch();
+    }
+    return kvstore::ResultCode::SUCCEEDED;
+}
+
+kvstore::ResultCode RebuildIndexWriter::finish() {
+    if (!bySst()) {
+        if (!data_.empty()) {
+            auto code = sendBatch();
+            if (code != kvstore::ResultCode::SUCCEEDED) {
+                waitInflight(0);
+                return code;
+            }
+        }
+        return waitInflight(0);
+    }
+
+    if (!data_.empty()) {
+        auto code = spill();
+        if (code != kvstore::ResultCode::SUCCEEDED) {
+            return code;
+        }
+    }
+    // The files may overlap with each other, so they are ingested one by one
+    for (const auto& file : files_) {
+        LOG(INFO) << "Ingest the index file " << file;
+        auto code = engine_->ingest(std::vector<std::string>({file}));
+        if (code != kvstore::ResultCode::SUCCEEDED) {
+            LOG(ERROR) << "Ingest the index file " << file << " failed";
+            return code;
+        }
+    }
+    files_.clear();
+    return kvstore::ResultCode::SUCCEEDED;
+}
+
+kvstore::ResultCode RebuildIndexWriter::sendBatch() {
+    auto code = waitInflight(std::max(FLAGS_rebuild_index_inflight_batches, 1) - 1);
+    if (code != kvstore::ResultCode::SUCCEEDED) {
+        return code;
+    }
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        inflight_++;
+    }
+
+    std::vector<kvstore::KV> batch;
+    batch.swap(data_);
+    data_.reserve(FLAGS_rebuild_index_batch_num);
+    bytes_ = 0;
+    env_->kvstore_->asyncMultiPut(space_, part_, std::move(batch),
+                                  [this](kvstore::ResultCode ret) {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (ret != kvstore::ResultCode::SUCCEEDED) {
+            LOG(ERROR) << "Modify the index failed";
+            if (result_ == kvstore::ResultCode::SUCCEEDED) {
+                result_ = ret;
+            }
+        }
+        inflight_--;
+        cond_.notify_all();
+    });
+    return kvstore::ResultCode::SUCCEEDED;
+}
+
+kvstore::ResultCode RebuildIndexWriter::waitInflight(int32_t limit) {
+    std::unique_lock<std::mutex> guard(lock_);
+    cond_.wait(guard, [this, limit] { return inflight_ <= limit; });
+    return result_;
+}
+
+kvstore::ResultCode RebuildIndexWriter::spill() {
+    std::sort(data_.begin(), data_.end(), [] (const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    auto file = folly::stringPrintf("%s/%lu.sst", path_.c_str(), files_.size());
+    rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), rocksdb::Options());
+    auto status = writer.Open(file);
+    for (size_t i = 0; status.ok() && i < data_.size(); i++) {
+        // The keys must be strictly increasing in a sst file
+        if (i > 0 && data_[i].first == data_[i - 1].first) {
+            continue;
+        }
+        status = writer.Put(data_[i].first, data_[i].second);
+    }
+    if (status.ok()) {
+        status = writer.Finish();
+    }
+    if (!status.ok()) {
+        LOG(ERROR) << "Write the index file " << file << " failed: " << status.ToString();
+        fs::FileUtils::remove(file.c_str());
+        return kvstore::ResultCode::ERR_IO_ERROR;
+    }
+    VLOG(1) << "Write " << data_.size() << " index keys into " << file;
+    files_.emplace_back(std::move(file));
+    data_.clear();
+    bytes_ = 0;
+    return kvstore::ResultCode::SUCCEEDED;
+}
+
+void RebuildIndexWriter::removeFiles() {
+    if (fs::FileUtils::exist(path_) && !fs::FileUtils::remove(path_.c_str(), true)) {
+        LOG(WARNING) << "Failed to remove " << path_;
+    }
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,77 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_ADMIN_REBUILDINDEXWRITER_H_
+#define STORAGE_ADMIN_REBUILDINDEXWRITER_H_
+
+#include "common/base/Base.h"
+#include "kvstore/Common.h"
+#include "kvstore/KVEngine.h"
+#include "storage/CommonUtils.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * Writes the index keys which RebuildIndexTask builds by scanning a part.
+ *
+ * When FLAGS_rebuild_index_by_sst is on and the part has no other replica or listener, the
+ * keys are sorted into local sst files under the data root of the part, and finish() ingests
+ * them into the engine directly. Ingesting is not replicated by raft, so any other part falls
+ * back to raft, in batches of FLAGS_rebuild_index_batch_num with at most
+ * FLAGS_rebuild_index_inflight_batches of them in flight.
+ *
+ * Either way, the keys are visible only after finish() returns SUCCEEDED.
+ * */
+class RebuildIndexWriter final {
+public:
+    // The keys of different ranges of a part are written by different writers
+    RebuildIndexWriter(StorageEnv* env, GraphSpaceID space, PartitionID part, int32_t rangeId);
+
+    ~RebuildIndexWriter();
+
+    kvstore::ResultCode put(std::string key, std::string val);
+
+    // Write the rest of keys, and wait until all of them are written
+    kvstore::ResultCode finish();
+
+    bool bySst() const {
+        return engine_ != nullptr;
+    }
+
+private:
+    // Send the buffered keys by raft without waiting for the result
+    kvstore::ResultCode sendBatch();
+
+    // Wait until no more than limit batches are in flight, return the first failure
+    kvstore::ResultCode waitInflight(int32_t limit);
+
+    // Sort the buffered keys and write them into a new sst file
+    kvstore::ResultCode spill();
+
+    void removeFiles();
+
+private:
+    StorageEnv*                     env_;
+    GraphSpaceID                    space_;
+    PartitionID                     part_;
+    // Not null if the keys are ingested as sst files
+    kvstore::KVEngine*              engine_{nullptr};
+    std::string                     path_;
+
+    std::vector<kvstore::KV>        data_;
+    size_t                          bytes_{0};
+    std::vector<std::string>        files_;
+
+    std::mutex                      lock_;
+    std::condition_variable         cond_;
+    int32_t                         inflight_{0};
+    kvstore::ResultCode             result_{kvstore::ResultCode::SUCCEEDED};
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_ADMIN_REBUILDINDEXWRITER_H_
@@ -53,7 +53,6 @@ ErrorOr<cpp2::ErrorCode, std::vector<AdminSubTask>>
 StatisTask::genSubTasks() {
     spaceId_ = *ctx_.parameters_.space_id_ref();
     auto parts = *ctx_.parameters_.parts_ref();
-    subTaskSize_ = parts.size();
 
     auto ret = getSchemas(spaceId_);
     if (ret != cpp2::ErrorCode::SUCCEEDED) {
@@ -61,76 +60,73 @@ StatisTask::genSubTasks() {
         return ret;
     }
 
-    std::vector<AdminSubTask> tasks;
-    for (const auto& part : parts) {
-        std::function<kvstore::ResultCode()> task = std::bind(&StatisTask::genSubTask,
-                                                              this, spaceId_, part,
-                                                              tags_, edges_);
-        tasks.emplace_back(std::move(task));
-    }
-    return tasks;
-}
-
-// Statis the specified tags and edges
-kvstore::ResultCode
-StatisTask::genSubTask(GraphSpaceID spaceId,
-                       PartitionID part,
-                       std::unordered_map<TagID, std::string> tags,
-                       std::unordered_map<EdgeType, std::string> edges) {
-    auto vIdLenRet = env_->schemaMan_->getSpaceVidLen(spaceId);
+    auto vIdLenRet = env_->schemaMan_->getSpaceVidLen(spaceId_);
     if (!vIdLenRet.ok()) {
         LOG(ERROR) << "Get space vid length failed";
-        return kvstore::ResultCode::ERR_SPACE_NOT_FOUND;
+        return cpp2::ErrorCode::E_SPACE_NOT_FOUND;
     }
+    vIdLen_ = vIdLenRet.value();
 
-    auto vIdType = this->env_->schemaMan_->getSpaceVidType(spaceId);
+    auto vIdType = env_->schemaMan_->getSpaceVidType(spaceId_);
     if (!vIdType.ok()) {
         LOG(ERROR) << "Get space vid type failed";
-        return kvstore::ResultCode::ERR_SPACE_NOT_FOUND;
+        return cpp2::ErrorCode::E_SPACE_NOT_FOUND;
     }
+    isIntId_ = (vIdType.value() == meta::cpp2::PropertyType::INT64);
 
-    auto vIdLen = vIdLenRet.value();
-    bool isIntId = (vIdType.value() == meta::cpp2::PropertyType::INT64);
-    auto partitionNumRet = env_->schemaMan_->getPartsNum(spaceId);
+    auto partitionNumRet = env_->schemaMan_->getPartsNum(spaceId_);
     if (!partitionNumRet.ok()) {
         LOG(ERROR) << "Get space partition number failed";
-        return kvstore::ResultCode::ERR_SPACE_NOT_FOUND;
+        return cpp2::ErrorCode::E_SPACE_NOT_FOUND;
     }
+    partitionNum_ = partitionNumRet.value();
 
-    auto partitionNum = partitionNumRet.value();
-    LOG(INFO) << "Start statis task";
+    // The vertices and edges of a part are split into ranges at the boundaries of source
+    // vertices, so a vertex is never counted twice.
     CHECK_NOTNULL(env_->kvstore_);
-    auto vertexPrefix = NebulaKeyUtils::vertexPrefix(part);
-    std::unique_ptr<kvstore::KVIterator> vertexIter;
-    auto edgePrefix = NebulaKeyUtils::edgePrefix(part);
-    std::unique_ptr<kvstore::KVIterator> edgeIter;
+    auto alignLen = sizeof(PartitionID) + vIdLen_;
+    auto count = rangesPerPart(parts.size());
+    std::vector<AdminSubTask> tasks;
+    for (const auto& part : parts) {
+        auto vertexRanges = splitPart(spaceId_, part, NebulaKeyUtils::vertexPrefix(part),
+                                      alignLen, count);
+        for (auto& range : vertexRanges) {
+            std::function<kvstore::ResultCode()> task = std::bind(&StatisTask::statisVertices,
+                                                                  this, spaceId_, part,
+                                                                  range.first, range.second);
+            tasks.emplace_back(std::move(task));
+        }
+        auto edgeRanges = splitPart(spaceId_, part, NebulaKeyUtils::edgePrefix(part),
+                                    alignLen, count);
+        for (auto& range : edgeRanges) {
+            std::function<kvstore::ResultCode()> task = std::bind(&StatisTask::statisEdges,
+                                                                  this, spaceId_, part,
+                                                                  range.first, range.second);
+            tasks.emplace_back(std::move(task));
+        }
+    }
+    subTaskSize_ = tasks.size();
+    LOG(INFO) << "Statis " << parts.size() << " parts in " << subTaskSize_ << " ranges";
+    return tasks;
+}
 
+kvstore::ResultCode
+StatisTask::statisVertices(GraphSpaceID spaceId,
+                           PartitionID part,
+                           const std::string& start,
+                           const std::string& end) {
     // When the storage occurs leader change, continue to read data from the follower
     // instead of reporting an error.
-    auto ret = env_->kvstore_->prefix(spaceId, part, vertexPrefix, &vertexIter, true);
-    if (ret != kvstore::ResultCode::SUCCEEDED) {
-        LOG(ERROR) << "Statis task failed";
-        return ret;
-    }
-    ret = env_->kvstore_->prefix(spaceId, part, edgePrefix, &edgeIter, true);
+    std::unique_ptr<kvstore::KVIterator> vertexIter;
+    auto ret = env_->kvstore_->range(spaceId, part, start, end, &vertexIter, true);
     if (ret != kvstore::ResultCode::SUCCEEDED) {
         LOG(ERROR) << "Statis task failed";
         return ret;
     }
 
-    std::unordered_map<TagID, int64_t>       tagsVertices;
-    std::unordered_map<EdgeType, int64_t>    edgetypeEdges;
-    std::unordered_map<PartitionID, int64_t> positiveRelevancy;
-    std::unordered_map<PartitionID, int64_t> negativeRelevancy;
-    int64_t                                  spaceVertices = 0;
-    int64_t                                  spaceEdges = 0;
-
-    for (auto tag : tags) {
-        tagsVertices[tag.first] = 0;
-    }
-
-    for (auto edge : edges) {
-        edgetypeEdges[edge.first] = 0;
+    PartStatis statis;
+    for (auto tag : tags_) {
+        statis.tagsVertices_[tag.first] = 0;
     }
 
     VertexID                              lastVertexId = "";
@@ -145,26 +141,45 @@ StatisTask::genSubTask(GraphSpaceID spaceId,
     // 3     1
     while (vertexIter && vertexIter->valid()) {
         auto key = vertexIter->key();
-        auto vId = NebulaKeyUtils::getVertexId(vIdLen, key).str();
-        auto tagId = NebulaKeyUtils::getTagId(vIdLen, key);
+        auto vId = NebulaKeyUtils::getVertexId(vIdLen_, key).str();
+        auto tagId = NebulaKeyUtils::getTagId(vIdLen_, key);
 
-        auto it = tagsVertices.find(tagId);
-        if (it == tagsVertices.end()) {
+        auto it = statis.tagsVertices_.find(tagId);
+        if (it == statis.tagsVertices_.end()) {
             // Invalid data
             vertexIter->next();
             continue;
         }
 
-        if (vId == lastVertexId) {
-            tagsVertices[tagId] += 1;
-        } else {
-            tagsVertices[tagId] += 1;
-            spaceVertices++;
+        it->second += 1;
+        if (vId != lastVertexId) {
+            statis.spaceVertices_++;
             lastVertexId  = vId;
         }
         vertexIter->next();
     }
 
+    mergeStatis(part, std::move(statis));
+    return kvstore::ResultCode::SUCCEEDED;
+}
+
+kvstore::ResultCode
+StatisTask::statisEdges(GraphSpaceID spaceId,
+                        PartitionID part,
+                        const std::string& start,
+                        const std::string& end) {
+    std::unique_ptr<kvstore::KVIterator> edgeIter;
+    auto ret = env_->kvstore_->range(spaceId, part, start, end, &edgeIter, true);
+    if (ret != kvstore::ResultCode::SUCCEEDED) {
+        LOG(ERROR) << "Statis task failed";
+        return ret;
+    }
+
+    PartStatis statis;
+    for (auto edge : edges_) {
+        statis.edgetypeEdges_[edge.first] = 0;
+    }
+
     // Only statis valid edge data, no multi version
     // For example
     // src edgetype rank dst
@@ -175,62 +190,90 @@ StatisTask::genSubTask(GraphSpaceID spaceId,
     while (edgeIter && edgeIter->valid()) {
         auto key = edgeIter->key();
 
-        auto edgeType = NebulaKeyUtils::getEdgeType(vIdLen, key);
+        auto edgeType = NebulaKeyUtils::getEdgeType(vIdLen_, key);
         // Because edge lock in toss and edge are the same except for the last byte.
         // But only the in-edge has a lock.
-        if (edgetypeEdges.find(std::abs(edgeType)) == edgetypeEdges.end()) {
+        if (statis.edgetypeEdges_.find(std::abs(edgeType)) == statis.edgetypeEdges_.end()) {
             edgeIter->next();
             continue;
         }
 
-        auto source = NebulaKeyUtils::getSrcId(vIdLen, key).str();
-        auto destination = NebulaKeyUtils::getDstId(vIdLen, key).str();
+        auto source = NebulaKeyUtils::getSrcId(vIdLen_, key).str();
+        auto destination = NebulaKeyUtils::getDstId(vIdLen_, key).str();
         if (edgeType > 0) {
-            spaceEdges++;
-            edgetypeEdges[edgeType] += 1;
+            statis.spaceEdges_++;
+            statis.edgetypeEdges_[edgeType] += 1;
 
             uint64_t destinationVid = 0;
-            if (isIntId) {
+            if (isIntId_) {
                 memcpy(static_cast<void*>(&destinationVid), destination.data(), 8);
             } else {
                 nebula::MurmurHash2 hash;
                 destinationVid = hash(destination.data());
             }
-            positiveRelevancy[destinationVid % partitionNum + 1]++;
+            statis.positiveRelevancy_[destinationVid % partitionNum_ + 1]++;
         } else {
             uint64_t sourceVid = 0;
-            if (isIntId) {
+            if (isIntId_) {
                 memcpy(static_cast<void*>(&sourceVid), source.data(), 8);
             } else {
                 nebula::MurmurHash2 hash;
                 sourceVid = hash(source.data());
             }
-            negativeRelevancy[sourceVid % partitionNum + 1]++;
+            statis.negativeRelevancy_[sourceVid % partitionNum_ + 1]++;
         }
         edgeIter->next();
     }
 
+    mergeStatis(part, std::move(statis));
+    return kvstore::ResultCode::SUCCEEDED;
+}
+
+void StatisTask::mergeStatis(PartitionID part, PartStatis&& statis) {
+    std::lock_guard<std::mutex> guard(lock_);
+    auto& total = statistics_[part];
+    for (const auto& entry : statis.tagsVertices_) {
+        total.tagsVertices_[entry.first] += entry.second;
+    }
+    for (const auto& entry : statis.edgetypeEdges_) {
+        total.edgetypeEdges_[entry.first] += entry.second;
+    }
+    for (const auto& entry : statis.positiveRelevancy_) {
+        total.positiveRelevancy_[entry.first] += entry.second;
+    }
+    for (const auto& entry : statis.negativeRelevancy_) {
+        total.negativeRelevancy_[entry.first] += entry.second;
+    }
+    total.spaceVertices_ += statis.spaceVertices_;
+    total.spaceEdges_ += statis.spaceEdges_;
+    finishedRanges_++;
+    VLOG(1) << "Statis of part " << part << " merged, " << finishedRanges_ << " ranges done";
+}
+
+nebula::meta::cpp2::StatisItem
+StatisTask::toStatisItem(PartitionID part, const PartStatis& statis) {
     nebula::meta::cpp2::StatisItem statisItem;
 
     // convert tagId/edgeType to tagName/edgeName
-    for (auto &tagElem : tagsVertices) {
+    for (auto &tagElem : statis.tagsVertices_) {
         auto iter = tags_.find(tagElem.first);
         if (iter != tags_.end()) {
             (*statisItem.tag_vertices_ref()).emplace(iter->second, tagElem.second);
         }
     }
-    for (auto &edgeElem : edgetypeEdges) {
+    for (auto &edgeElem : statis.edgetypeEdges_) {
         auto iter = edges_.find(edgeElem.first);
         if (iter != edges_.end()) {
             (*statisItem.edges_ref()).emplace(iter->second, edgeElem.second);
         }
     }
 
-    statisItem.set_space_vertices(spaceVertices);
+    auto spaceEdges = statis.spaceEdges_;
+    statisItem.set_space_vertices(statis.spaceVertices_);
     statisItem.set_space_edges(spaceEdges);
     using Correlativiyties = std::vector<nebula::meta::cpp2::Correlativity>;
     Correlativiyties positiveCorrelativity;
-    for (const auto& entry : positiveRelevancy) {
+    for (const auto& entry : statis.positiveRelevancy_) {
         nebula::meta::cpp2::Correlativity partProportion;
         partProportion.set_part_id(entry.first);
         double proportion = static_cast<double>(entry.second) / static_cast<double>(spaceEdges);
@@ -239,7 +282,7 @@ StatisTask::genSubTask(GraphSpaceID spaceId,
     }
 
     Correlativiyties negativeCorrelativity;
-    for (const auto& entry : negativeRelevancy) {
+    for (const auto& entry : statis.negativeRelevancy_) {
         nebula::meta::cpp2::Correlativity partProportion;
         partProportion.set_part_id(entry.first);
         double proportion = static_cast<double>(entry.second) / static_cast<double>(spaceEdges);
@@ -264,10 +307,7 @@ StatisTask::genSubTask(GraphSpaceID spaceId,
     std::unordered_map<PartitionID, Correlativiyties> negativePartCorrelativiyties;
     negativePartCorrelativiyties[part] = negativeCorrelativity;
     statisItem.set_negative_part_correlativity(std::move(negativePartCorrelativiyties));
-
-    statistics_.emplace(part, std::move(statisItem));
-    LOG(INFO) << "Statis task finished";
-    return kvstore::ResultCode::SUCCEEDED;
+    return statisItem;
 }
 
 void StatisTask::finish(cpp2::ErrorCode rc) {
@@ -276,11 +316,12 @@ void StatisTask::finish(cpp2::ErrorCode rc) {
     nebula::meta::cpp2::StatisItem  result;
     result.set_status(nebula::meta::cpp2::JobStatus::FAILED);
 
-    if (rc == cpp2::ErrorCode::SUCCEEDED && statistics_.size() == subTaskSize_) {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (rc == cpp2::ErrorCode::SUCCEEDED && finishedRanges_ == subTaskSize_) {
         result.set_space_vertices(0);
         result.set_space_edges(0);
         for (auto& elem : statistics_) {
-            auto item = elem.second;
+            auto item = toStatisItem(elem.first, elem.second);
             *result.space_vertices_ref() += *item.space_vertices_ref();
             *result.space_edges_ref() += *item.space_edges_ref();
 
@@ -316,7 +357,7 @@ void StatisTask::finish(cpp2::ErrorCode rc) {
     } else if (rc != cpp2::ErrorCode::SUCCEEDED) {
         ctx_.onFinish_(rc, result);
     } else {
-        LOG(ERROR) << "The number of subtasks is not equal to the number of parts";
+        LOG(ERROR) << "The number of finished ranges is not equal to the number of subtasks";
         ctx_.onFinish_(cpp2::ErrorCode::E_PART_NOT_FOUND, result);
     }
 }
@@ -35,17 +35,41 @@ protected:
         canceled_ = true;
     }
 
-    kvstore::ResultCode genSubTask(GraphSpaceID space,
-                                   PartitionID part,
-                                   std::unordered_map<TagID, std::string> tags,
-                                   std::unordered_map<EdgeType, std::string> edges);
+    // Count the vertices in range [start, end) of a part
+    kvstore::ResultCode statisVertices(GraphSpaceID space,
+                                       PartitionID part,
+                                       const std::string& start,
+                                       const std::string& end);
+
+    // Count the edges in range [start, end) of a part
+    kvstore::ResultCode statisEdges(GraphSpaceID space,
+                                    PartitionID part,
+                                    const std::string& start,
+                                    const std::string& end);
 
 private:
+    // The counters of a part, the ones of each range are added up when the range is done
+    struct PartStatis {
+        std::unordered_map<TagID, int64_t>          tagsVertices_;
+        std::unordered_map<EdgeType, int64_t>       edgetypeEdges_;
+        std::unordered_map<PartitionID, int64_t>    positiveRelevancy_;
+        std::unordered_map<PartitionID, int64_t>    negativeRelevancy_;
+        int64_t                                     spaceVertices_{0};
+        int64_t                                     spaceEdges_{0};
+    };
+
     cpp2::ErrorCode getSchemas(GraphSpaceID spaceId);
 
+    void mergeStatis(PartitionID part, PartStatis&& statis);
+
+    nebula::meta::cpp2::StatisItem toStatisItem(PartitionID part, const PartStatis& statis);
+
 protected:
     std::atomic<bool>                           canceled_{false};
     GraphSpaceID                                spaceId_;
+    size_t                                      vIdLen_{0};
+    bool                                        isIntId_{false};
+    int32_t                                     partitionNum_{0};
 
     // All tagIds and tagName of the spaceId
     std::unordered_map<TagID, std::string>      tags_;
@@ -53,9 +77,12 @@ protected:
     // All edgeTypes and edgeName of the spaceId
     std::unordered_map<EdgeType, std::string>   edges_;
 
-    folly::ConcurrentHashMap<PartitionID, nebula::meta::cpp2::StatisItem> statistics_;
+    std::mutex                                  lock_;
+    std::unordered_map<PartitionID, PartStatis> statistics_;
+    // The number of ranges done, it equals to the number of subtasks if all of them succeed
+    size_t                                      finishedRanges_{0};
 
-    // The number of subtasks equals to the number of parts in request
+    // The number of subtasks, one for each range of the vertices or edges of the parts
     size_t                                      subTaskSize_{0};
 };
 
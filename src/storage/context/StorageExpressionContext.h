@@ -121,21 +121,21 @@ public:
     }
 
 
-    // index key
-    void reset(const std::string& key) {
+    // index key, the key must be valid until next reset
+    void reset(folly::StringPiece key) {
         key_ = key;
     }
 
-    // isEdge_ set in ctor
+    // isEdge_ set in ctor, the reader and key must be valid until next reset
     void reset(RowReader* reader,
-               const std::string& key) {
+               folly::StringPiece key) {
         reader_ = reader;
         key_ = key;
     }
 
     void reset() {
         reader_ = nullptr;
-        key_ = "";
+        key_ = folly::StringPiece();
         name_ = "";
         schema_ = nullptr;
     }
@@ -169,17 +169,37 @@ public:
 
     Value getIndexValue(const std::string& prop, bool isEdge) const;
 
+    RowReader* reader() const {
+        return reader_;
+    }
+
+    const std::string& name() const {
+        return name_;
+    }
+
+    const meta::NebulaSchemaProvider* schema() const {
+        return schema_;
+    }
+
+    bool isEdge() const {
+        return isEdge_;
+    }
+
+    bool isIndex() const {
+        return isIndex_;
+    }
+
 private:
     size_t                             vIdLen_;
     bool                               isIntId_;
 
-    RowReader                         *reader_;
-    std::string                        key_;
+    RowReader                         *reader_{nullptr};
+    folly::StringPiece                 key_;
     // tag or edge name
     std::string                        name_;
     // tag or edge latest schema
-    const meta::NebulaSchemaProvider  *schema_;
-    bool                               isEdge_;
+    const meta::NebulaSchemaProvider  *schema_{nullptr};
+    bool                               isEdge_{false};
 
     // index
     bool isIndex_ = false;
@@ -0,0 +1,408 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_EXEC_COMPILEDFILTER_H_
+#define STORAGE_EXEC_COMPILEDFILTER_H_
+
+#include "common/base/Base.h"
+#include "common/expression/Expression.h"
+#include "common/expression/LogicalExpression.h"
+#include "common/expression/PropertyExpression.h"
+#include "common/expression/RelationalExpression.h"
+#include "common/expression/UnaryExpression.h"
+#include "common/expression/TypeCastingExpression.h"
+#include "common/expression/ArithmeticExpression.h"
+#include "storage/context/StorageExpressionContext.h"
+
+namespace nebula {
+namespace storage {
+
+/*
+CompiledFilter is built once per plan from the filter pushed down. Compared with evaluating
+the expression on each row, it:
+    1. folds the constant subtrees, such as `e.a > 1 + 2`
+    2. binds the property of the row to the field index of each schema, so there is no name
+       lookup per row
+    3. compares int, float and string props in place against the constant, without
+       building a Value
+
+All kinds of expression it doesn't understand, and rows it can't decide in place (null
+value, props not in the row, index key ...) are evaluated by the original expression, so
+the result is always the same as evaluating the filter directly. A row passes only when
+the filter is evaluated to the bool true.
+
+It is not thread-safe, each plan needs its own.
+*/
+class CompiledFilter final {
+public:
+    // Return nullptr if there is no filter. The expression and the context must outlive the
+    // compiled filter
+    static std::unique_ptr<CompiledFilter> compile(Expression* exp,
+                                                   StorageExpressionContext* expCtx) {
+        if (exp == nullptr || expCtx == nullptr) {
+            return nullptr;
+        }
+        return std::unique_ptr<CompiledFilter>(new CompiledFilter(exp, expCtx));
+    }
+
+    // Reset the context to the row and return whether the row passes the filter
+    bool check(RowReader* reader, folly::StringPiece key) {
+        expCtx_->reset(reader, key);
+        return eval(root_) == Result::kTrue;
+    }
+
+    // Same as above, but the filter is evaluated on the key alone, such as an index key
+    bool check(folly::StringPiece key) {
+        expCtx_->reset(key);
+        return eval(root_) == Result::kTrue;
+    }
+
+private:
+    enum class NodeType : int8_t {
+        kConstant,
+        kAnd,
+        kOr,
+        kCompare,
+        kGeneric,
+    };
+
+    enum class Result : int8_t {
+        kFalse,
+        kTrue,
+        // not a bool, such as null
+        kUnknown,
+    };
+
+    // How to read the prop in place, decided by its type in schema
+    enum class ReadType : int8_t {
+        kNone,
+        kInt,
+        kFloat,
+        kStr,
+    };
+
+    struct Binding {
+        int64_t  index_;
+        ReadType type_;
+    };
+
+    struct Node {
+        NodeType                                                     type_;
+        // the original expression, evaluated when the node can't be decided in place
+        Expression                                                  *exp_;
+        std::vector<Node>                                            children_;
+        // kConstant
+        Result                                                       result_;
+        // kCompare: `prop op operand_`, prop has been swapped to the left
+        Expression::Kind                                             op_;
+        bool                                                         isEdge_;
+        const std::string                                           *sym_;
+        const std::string                                           *prop_;
+        Value                                                        operand_;
+        // schema of row -> field index, filled in lazily
+        std::unordered_map<const meta::SchemaProviderIf*, Binding>   bindings_;
+    };
+
+    CompiledFilter(Expression* exp, StorageExpressionContext* expCtx)
+        : expCtx_(expCtx) {
+        root_ = compile(exp);
+    }
+
+    Node compile(Expression* exp) {
+        Node node;
+        node.type_ = NodeType::kGeneric;
+        node.exp_ = exp;
+        if (isConstant(exp)) {
+            // evaluated only once here
+            node.type_ = NodeType::kConstant;
+            node.result_ = toResult(exp->eval(*expCtx_));
+            return node;
+        }
+
+        switch (exp->kind()) {
+            case Expression::Kind::kLogicalAnd:
+            case Expression::Kind::kLogicalOr: {
+                auto* logExp = static_cast<LogicalExpression*>(exp);
+                for (auto& operand : logExp->operands()) {
+                    node.children_.emplace_back(compile(operand.get()));
+                }
+                node.type_ = exp->kind() == Expression::Kind::kLogicalAnd ? NodeType::kAnd
+                                                                          : NodeType::kOr;
+                break;
+            }
+            case Expression::Kind::kRelEQ:
+            case Expression::Kind::kRelNE:
+            case Expression::Kind::kRelLT:
+            case Expression::Kind::kRelLE:
+            case Expression::Kind::kRelGT:
+            case Expression::Kind::kRelGE: {
+                auto* relExp = static_cast<RelationalExpression*>(exp);
+                auto op = exp->kind();
+                Expression* prop = relExp->left();
+                Expression* operand = relExp->right();
+                if (!isRowProp(prop)) {
+                    std::swap(prop, operand);
+                    op = swapOp(op);
+                }
+                if (!isRowProp(prop) || !isConstant(operand)) {
+                    break;
+                }
+                node.operand_ = operand->eval(*expCtx_);
+                if (!node.operand_.isInt() && !node.operand_.isFloat() &&
+                    !node.operand_.isStr()) {
+                    break;
+                }
+                auto* propExp = static_cast<PropertyExpression*>(prop);
+                node.type_ = NodeType::kCompare;
+                node.op_ = op;
+                // `tag.prop` reads the vertex row the same as `$^.tag.prop`
+                node.isEdge_ = prop->kind() == Expression::Kind::kEdgeProperty;
+                node.sym_ = propExp->sym();
+                node.prop_ = propExp->prop();
+                break;
+            }
+            default:
+                break;
+        }
+        return node;
+    }
+
+    Result eval(Node& node) {
+        switch (node.type_) {
+            case NodeType::kConstant:
+                return node.result_;
+            case NodeType::kAnd:
+            case NodeType::kOr: {
+                // short circuit on the first false for AND, on the first true for OR
+                auto stop = node.type_ == NodeType::kAnd ? Result::kFalse : Result::kTrue;
+                for (auto& child : node.children_) {
+                    auto ret = eval(child);
+                    if (ret == Result::kUnknown) {
+                        return evalGeneric(node);
+                    }
+                    if (ret == stop) {
+                        return stop;
+                    }
+                }
+                return stop == Result::kFalse ? Result::kTrue : Result::kFalse;
+            }
+            case NodeType::kCompare: {
+                auto ret = compare(node);
+                if (ret == Result::kUnknown) {
+                    return evalGeneric(node);
+                }
+                return ret;
+            }
+            case NodeType::kGeneric:
+                return evalGeneric(node);
+        }
+        return Result::kUnknown;
+    }
+
+    Result evalGeneric(Node& node) {
+        return toResult(node.exp_->eval(*expCtx_));
+    }
+
+    Result compare(Node& node) {
+        auto* reader = expCtx_->reader();
+        if (reader == nullptr || expCtx_->isIndex() || expCtx_->isEdge() != node.isEdge_) {
+            return Result::kUnknown;
+        }
+        const auto* binding = bind(node, reader);
+        if (binding == nullptr) {
+            return Result::kUnknown;
+        }
+        switch (binding->type_) {
+            case ReadType::kInt: {
+                int64_t v;
+                if (!reader->getInt(binding->index_, v)) {
+                    return Result::kUnknown;
+                }
+                return compare(node.op_, v, node.operand_.getInt());
+            }
+            case ReadType::kFloat: {
+                double v;
+                if (!reader->getFloat(binding->index_, v)) {
+                    return Result::kUnknown;
+                }
+                return compare(node.op_, v, node.operand_.getFloat());
+            }
+            case ReadType::kStr: {
+                folly::StringPiece v;
+                if (!reader->getStr(binding->index_, v)) {
+                    return Result::kUnknown;
+                }
+                return compare(node.op_, v, folly::StringPiece(node.operand_.getStr()));
+            }
+            case ReadType::kNone:
+                return Result::kUnknown;
+        }
+        return Result::kUnknown;
+    }
+
+    // Bind the prop to the field of the schema of current row
+    const Binding* bind(Node& node, RowReader* reader) {
+        const auto* schema = reader->getSchema();
+        auto found = node.bindings_.find(schema);
+        if (found != node.bindings_.end()) {
+            return found->second.type_ == ReadType::kNone ? nullptr : &found->second;
+        }
+
+        Binding binding{-1, ReadType::kNone};
+        // Same as StorageExpressionContext, the prop must be in the latest schema, and
+        // props in key or filled with default value are left to the expression
+        const auto* latest = expCtx_->schema();
+        if (latest != nullptr && *node.sym_ == expCtx_->name() &&
+            latest->field(*node.prop_) != nullptr) {
+            auto index = schema->getFieldIndex(*node.prop_);
+            if (index >= 0) {
+                binding.index_ = index;
+                binding.type_ = readType(schema->getFieldType(index), node.operand_);
+            }
+        }
+        auto& ret = node.bindings_.emplace(schema, binding).first->second;
+        return ret.type_ == ReadType::kNone ? nullptr : &ret;
+    }
+
+    template <typename T>
+    static Result compare(Expression::Kind op, const T& lhs, const T& rhs) {
+        bool ret = false;
+        switch (op) {
+            case Expression::Kind::kRelEQ:
+                ret = lhs == rhs;
+                break;
+            case Expression::Kind::kRelNE:
+                ret = lhs != rhs;
+                break;
+            case Expression::Kind::kRelLT:
+                ret = lhs < rhs;
+                break;
+            case Expression::Kind::kRelLE:
+                ret = lhs <= rhs;
+                break;
+            case Expression::Kind::kRelGT:
+                ret = lhs > rhs;
+                break;
+            case Expression::Kind::kRelGE:
+                ret = lhs >= rhs;
+                break;
+            default:
+                return Result::kUnknown;
+        }
+        return ret ? Result::kTrue : Result::kFalse;
+    }
+
+    // Only the prop and the operand of same kind are compared in place
+    static ReadType readType(meta::cpp2::PropertyType type, const Value& operand) {
+        switch (type) {
+            case meta::cpp2::PropertyType::INT8:
+            case meta::cpp2::PropertyType::INT16:
+            case meta::cpp2::PropertyType::INT32:
+            case meta::cpp2::PropertyType::INT64:
+            case meta::cpp2::PropertyType::TIMESTAMP:
+                return operand.isInt() ? ReadType::kInt : ReadType::kNone;
+            case meta::cpp2::PropertyType::FLOAT:
+            case meta::cpp2::PropertyType::DOUBLE:
+                return operand.isFloat() ? ReadType::kFloat : ReadType::kNone;
+            case meta::cpp2::PropertyType::STRING:
+            case meta::cpp2::PropertyType::FIXED_STRING:
+                return operand.isStr() ? ReadType::kStr : ReadType::kNone;
+            default:
+                return ReadType::kNone;
+        }
+    }
+
+    static Expression::Kind swapOp(Expression::Kind op) {
+        switch (op) {
+            case Expression::Kind::kRelLT:
+                return Expression::Kind::kRelGT;
+            case Expression::Kind::kRelLE:
+                return Expression::Kind::kRelGE;
+            case Expression::Kind::kRelGT:
+                return Expression::Kind::kRelLT;
+            case Expression::Kind::kRelGE:
+                return Expression::Kind::kRelLE;
+            default:
+                return op;
+        }
+    }
+
+    // The props of the row itself, `$^.tag.prop` or `tag.prop` on tag and `edge.prop` on edge
+    static bool isRowProp(const Expression* exp) {
+        if (exp->kind() != Expression::Kind::kEdgeProperty &&
+            exp->kind() != Expression::Kind::kSrcProperty &&
+            exp->kind() != Expression::Kind::kTagProperty) {
+            return false;
+        }
+        const auto* prop = static_cast<const PropertyExpression*>(exp)->prop();
+        return *prop != kVid && *prop != kTag && *prop != kSrc &&
+               *prop != kDst && *prop != kRank && *prop != kType;
+    }
+
+    // Whether the expression depends on nothing but constants
+    static bool isConstant(const Expression* exp) {
+        switch (exp->kind()) {
+            case Expression::Kind::kConstant:
+                return true;
+            case Expression::Kind::kAdd:
+            case Expression::Kind::kMinus:
+            case Expression::Kind::kMultiply:
+            case Expression::Kind::kDivision:
+            case Expression::Kind::kMod: {
+                auto* ariExp = static_cast<const ArithmeticExpression*>(exp);
+                return isConstant(ariExp->left()) && isConstant(ariExp->right());
+            }
+            case Expression::Kind::kRelEQ:
+            case Expression::Kind::kRelNE:
+            case Expression::Kind::kRelLT:
+            case Expression::Kind::kRelLE:
+            case Expression::Kind::kRelGT:
+            case Expression::Kind::kRelGE: {
+                auto* relExp = static_cast<const RelationalExpression*>(exp);
+                return isConstant(relExp->left()) && isConstant(relExp->right());
+            }
+            case Expression::Kind::kUnaryPlus:
+            case Expression::Kind::kUnaryNegate:
+            case Expression::Kind::kUnaryNot: {
+                auto* unaExp = static_cast<const UnaryExpression*>(exp);
+                return isConstant(unaExp->operand());
+            }
+            case Expression::Kind::kTypeCasting: {
+                auto* typExp = static_cast<const TypeCastingExpression*>(exp);
+                return isConstant(typExp->operand());
+            }
+            case Expression::Kind::kLogicalAnd:
+            case Expression::Kind::kLogicalOr:
+            case Expression::Kind::kLogicalXor: {
+                auto* logExp = static_cast<const LogicalExpression*>(exp);
+                for (const auto& operand : logExp->operands()) {
+                    if (!isConstant(operand.get())) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    static Result toResult(const Value& value) {
+        if (!value.isBool()) {
+            return Result::kUnknown;
+        }
+        return value.getBool() ? Result::kTrue : Result::kFalse;
+    }
+
+private:
+    StorageExpressionContext    *expCtx_;
+    Node                         root_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+
+#endif  // STORAGE_EXEC_COMPILEDFILTER_H_
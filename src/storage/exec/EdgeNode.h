@@ -172,12 +172,18 @@ public:
 
         VLOG(1) << "partId " << partId << ", vId " << vId << ", edgeType " << edgeType_
                 << ", prop size " << props_->size();
+        bool enableToss = planContext_->env_->txnMan_ &&
+                          planContext_->env_->txnMan_->enableToss(planContext_->spaceId_);
+        auto* adjCache = planContext_->env_->adjCache_.get();
+        if (FLAGS_enable_adjacency_cache && adjCache != nullptr && !enableToss) {
+            return executeWithCache(adjCache, partId, vId);
+        }
+
         std::unique_ptr<kvstore::KVIterator> iter;
         prefix_ = NebulaKeyUtils::edgePrefix(planContext_->vIdLen_, partId, vId, edgeType_);
         ret = planContext_->env_->kvstore_->prefix(planContext_->spaceId_, partId, prefix_, &iter);
         if (ret == kvstore::ResultCode::SUCCEEDED && iter && iter->valid()) {
-            if (planContext_->env_->txnMan_ &&
-                planContext_->env_->txnMan_->enableToss(planContext_->spaceId_)) {
+            if (enableToss) {
                 bool stopAtFirstEdge = false;
                 iter_.reset(new TossEdgeIterator(
                     planContext_, std::move(iter), edgeType_, schemas_, &ttl_, stopAtFirstEdge));
@@ -190,6 +196,124 @@ public:
         }
         return ret;
     }
+
+private:
+    // The edges are read from the adjacency cache if it is a hit, otherwise from the kvstore,
+    // and the cache is filled if the vertex has enough edges of the edge type.
+    kvstore::ResultCode executeWithCache(AdjacencyCache* adjCache,
+                                         PartitionID partId,
+                                         const VertexID& vId) {
+        prefix_ = NebulaKeyUtils::edgePrefix(planContext_->vIdLen_, partId, vId, edgeType_);
+        // The src is padded as it is in the edge keys, which the cache is invalidated by
+        auto key = std::make_tuple(planContext_->spaceId_,
+                                   partId,
+                                   prefix_.substr(sizeof(PartitionID), planContext_->vIdLen_),
+                                   edgeType_);
+        std::unique_ptr<kvstore::KVIterator> iter;
+        auto list = adjCache->get(key);
+        if (list != nullptr) {
+            iter = std::make_unique<AdjacencyListIterator>(std::move(list));
+        } else {
+            auto epoch = adjCache->epoch(key);
+            auto ret = planContext_->env_->kvstore_->prefix(
+                planContext_->spaceId_, partId, prefix_, &iter);
+            if (ret != kvstore::ResultCode::SUCCEEDED || !iter) {
+                iter_.reset();
+                return ret;
+            }
+            iter = adjCache->fill(key, epoch, prefix_, std::move(iter));
+        }
+        if (iter->valid()) {
+            iter_.reset(new SingleEdgeIterator(
+                planContext_, std::move(iter), edgeType_, schemas_, &ttl_));
+        } else {
+            iter_.reset();
+        }
+        return kvstore::ResultCode::SUCCEEDED;
+    }
+};
+
+// FusedEdgeNode is used to scan the edges of all edge types in EdgeContext of the same srcId by
+// a single prefix iterator, rather than one SingleEdgeNode for each edge type. It is not used
+// when toss is enabled, since the TossEdgeIterator works on a single edge type.
+class FusedEdgeNode final : public IterateNode<VertexID> {
+public:
+    using RelNode::execute;
+
+    FusedEdgeNode(PlanContext* planCtx, EdgeContext* ctx)
+        : planContext_(planCtx)
+        , edgeContext_(ctx) {
+        for (const auto& ec : edgeContext_->propContexts_) {
+            auto edgeType = ec.first;
+            auto schemaIter = edgeContext_->schemas_.find(std::abs(edgeType));
+            CHECK(schemaIter != edgeContext_->schemas_.end());
+            CHECK(!schemaIter->second.empty());
+            ttls_.emplace_back(QueryUtils::getEdgeTTLInfo(edgeContext_, std::abs(edgeType)));
+            edgeTypes_.emplace_back(FusedEdgeIterator::EdgeTypeInfo{edgeType,
+                                                                    &(schemaIter->second),
+                                                                    nullptr});
+        }
+        // ttls_ won't be resized anymore, so it is safe to point to its elements now
+        for (size_t i = 0; i < edgeTypes_.size(); i++) {
+            edgeTypes_[i].ttl_ = &ttls_[i];
+        }
+    }
+
+    kvstore::ResultCode execute(PartitionID partId, const VertexID& vId) override {
+        auto ret = RelNode::execute(partId, vId);
+        if (ret != kvstore::ResultCode::SUCCEEDED) {
+            return ret;
+        }
+
+        VLOG(1) << "partId " << partId << ", vId " << vId << ", edge types "
+                << edgeTypes_.size();
+        std::unique_ptr<kvstore::KVIterator> iter;
+        prefix_ = NebulaKeyUtils::edgePrefix(planContext_->vIdLen_, partId, vId);
+        ret = planContext_->env_->kvstore_->prefix(planContext_->spaceId_, partId, prefix_, &iter);
+        if (ret == kvstore::ResultCode::SUCCEEDED && iter && iter->valid()) {
+            iter_.reset(new FusedEdgeIterator(planContext_, std::move(iter), partId, vId,
+                                              &edgeTypes_));
+        } else {
+            iter_.reset();
+        }
+        return ret;
+    }
+
+    MultiEdgeIterator* iter() {
+        return iter_.get();
+    }
+
+    bool valid() const override {
+        return iter_ && iter_->valid();
+    }
+
+    void next() override {
+        iter_->next();
+    }
+
+    folly::StringPiece key() const override {
+        return iter_->key();
+    }
+
+    folly::StringPiece val() const override {
+        return iter_->val();
+    }
+
+    RowReader* reader() const override {
+        if (iter_) {
+            return iter_->reader();
+        }
+        return nullptr;
+    }
+
+private:
+    PlanContext*                                                    planContext_;
+    EdgeContext*                                                    edgeContext_;
+    std::vector<folly::Optional<std::pair<std::string, int64_t>>>   ttls_;
+    std::vector<FusedEdgeIterator::EdgeTypeInfo>                    edgeTypes_;
+
+    std::unique_ptr<FusedEdgeIterator>                              iter_;
+    std::string                                                     prefix_;
 };
 
 }  // namespace storage
@@ -11,6 +11,7 @@
 #include "common/expression/Expression.h"
 #include "storage/exec/HashJoinNode.h"
 #include "storage/context/StorageExpressionContext.h"
+#include "storage/exec/CompiledFilter.h"
 
 namespace nebula {
 namespace storage {
@@ -36,8 +37,7 @@ public:
                Expression* exp = nullptr)
         : IterateNode<T>(upstream)
         , planContext_(planCtx)
-        , expCtx_(expCtx)
-        , filterExp_(exp) {}
+        , compiledFilter_(CompiledFilter::compile(exp, expCtx)) {}
 
     kvstore::ResultCode execute(PartitionID partId, const T& vId) override {
         auto ret = RelNode<T>::execute(partId, vId);
@@ -62,24 +62,15 @@ public:
 private:
     // return true when the value iter points to a value which can filter
     bool check() override {
-        if (filterExp_ != nullptr) {
-            expCtx_->reset(this->reader(), this->key().str());
-            // result is false when filter out
-            auto result = filterExp_->eval(*expCtx_);
-            // NULL is always false
-            auto ret = result.toBool();
-            if (ret.isBool() && ret.getBool()) {
-                return true;
-            }
-            return false;
+        if (compiledFilter_ != nullptr) {
+            return compiledFilter_->check(this->reader(), this->key());
         }
         return true;
     }
 
 private:
     PlanContext                      *planContext_;
-    StorageExpressionContext         *expCtx_;
-    Expression                       *filterExp_;
+    std::unique_ptr<CompiledFilter>   compiledFilter_;
 };
 
 }  // namespace storage
@@ -47,7 +47,11 @@ public:
             return kvstore::ResultCode::ERR_INVALID_DATA;
         }
 
+        // the tag result is built for each vertex, so just move it into the row
+        auto& tagResult = hashJoinNode_->mutableResult().mutableList();
         std::vector<Value> row;
+        // vid, stat, tags, edges and the last column of yield expression
+        row.reserve(2 + tagResult.size() + edgeContext_->propContexts_.size() + 1);
         // vertexId is the first column
         if (planContext_->isIntId_) {
             row.emplace_back(*reinterpret_cast<const int64_t*>(vId.data()));
@@ -57,7 +61,6 @@ public:
         // second column is reserved for stat
         row.emplace_back(Value());
 
-        auto tagResult = hashJoinNode_->result().getList();
         for (auto& value : tagResult.values) {
             row.emplace_back(std::move(value));
         }
@@ -86,30 +89,33 @@ protected:
     GetNeighborsNode() = default;
 
     virtual kvstore::ResultCode iterateEdges(std::vector<Value>& row) {
+        // Each edge is built in place in its cell of the row, which is handed over to the
+        // response at last, so nothing is copied or moved afterwards
         int64_t edgeRowCount = 0;
-        nebula::List list;
-        for (; upstream_->valid(); upstream_->next(), ++edgeRowCount) {
-            if (edgeRowCount >= limit_) {
-                return kvstore::ResultCode::SUCCEEDED;
-            }
+        nebula::List* cell = nullptr;
+        size_t cellIdx = 0;
+        for (; upstream_->valid() && edgeRowCount < limit_; upstream_->next(), ++edgeRowCount) {
             auto key = upstream_->key();
             auto reader = upstream_->reader();
             auto props = planContext_->props_;
             auto columnIdx = planContext_->columnIdx_;
+            // the edges of an edge type come one after another, so the cell is only looked up
+            // when the edge type changes
+            if (cell == nullptr || cellIdx != columnIdx) {
+                if (row[columnIdx].empty()) {
+                    row[columnIdx].setList(nebula::List());
+                }
+                cell = &row[columnIdx].mutableList();
+                cellIdx = columnIdx;
+            }
 
-            list.reserve(props->size());
+            cell->values.emplace_back(nebula::List());
+            auto& list = cell->values.back().mutableList();
             // collect props need to return
             if (!QueryUtils::collectEdgeProps(key, planContext_->vIdLen_, planContext_->isIntId_,
                                               reader, props, list).ok()) {
                 return kvstore::ResultCode::ERR_EDGE_PROP_NOT_FOUND;
             }
-
-            // add edge prop value to the target column
-            if (row[columnIdx].empty()) {
-                row[columnIdx].setList(nebula::List());
-            }
-            auto& cell = row[columnIdx].mutableList();
-            cell.values.emplace_back(std::move(list));
         }
         return kvstore::ResultCode::SUCCEEDED;
     }
@@ -17,7 +17,8 @@ namespace nebula {
 namespace storage {
 
 // HashJoinNode has input of serveral TagNode and EdgeNode, the EdgeNode is several
-// SingleEdgeNode of different edge types all edges of a vertex.
+// SingleEdgeNode of different edge types all edges of a vertex, or a FusedEdgeNode which scans
+// all edge types by itself.
 // The output would be the result of tag, it is a List, each cell save a list of property values,
 // if tag not found, it will be a empty value.
 // Also it will return a iterator of edges which can pass ttl check and ready to be read.
@@ -40,6 +41,21 @@ public:
         UNUSED(tagContext_);
     }
 
+    HashJoinNode(PlanContext* planCtx,
+                 const std::vector<TagNode*>& tagNodes,
+                 FusedEdgeNode* fusedEdgeNode,
+                 TagContext* tagContext,
+                 EdgeContext* edgeContext,
+                 StorageExpressionContext* expCtx)
+        : planContext_(planCtx)
+        , tagNodes_(tagNodes)
+        , fusedEdgeNode_(fusedEdgeNode)
+        , tagContext_(tagContext)
+        , edgeContext_(edgeContext)
+        , expCtx_(expCtx) {
+        UNUSED(tagContext_);
+    }
+
     kvstore::ResultCode execute(PartitionID partId, const VertexID& vId) override {
         auto ret = RelNode::execute(partId, vId);
         if (ret != kvstore::ResultCode::SUCCEEDED) {
@@ -96,19 +112,24 @@ public:
             }
         }
 
-        std::vector<SingleEdgeIterator*> iters;
-        for (auto* edgeNode : edgeNodes_) {
-            iters.emplace_back(edgeNode->iter());
+        if (fusedEdgeNode_ != nullptr) {
+            iter_ = fusedEdgeNode_->iter();
+        } else {
+            std::vector<SingleEdgeIterator*> iters;
+            for (auto* edgeNode : edgeNodes_) {
+                iters.emplace_back(edgeNode->iter());
+            }
+            multiIter_.reset(new MultiEdgeIterator(std::move(iters)));
+            iter_ = multiIter_.get();
         }
-        iter_.reset(new MultiEdgeIterator(std::move(iters)));
-        if (iter_->valid()) {
+        if (valid()) {
             setCurrentEdgeInfo();
         }
         return kvstore::ResultCode::SUCCEEDED;
     }
 
     bool valid() const override {
-        return iter_->valid();
+        return iter_ != nullptr && iter_->valid();
     }
 
     void next() override {
@@ -147,7 +168,9 @@ private:
             // idx is the index in all edges need to return
             auto idx = idxIter->second;
             planContext_->edgeType_ = type;
-            planContext_->edgeName_ = edgeNodes_[iter_->getIdx()]->getEdgeName();
+            auto nameIter = edgeContext_->edgeNames_.find(type);
+            CHECK(nameIter != edgeContext_->edgeNames_.end());
+            planContext_->edgeName_ = nameIter->second;
             // the columnIdx_ would be the column index in a response row, so need to add
             // the offset of tags and other fields
             planContext_->columnIdx_ = edgeContext_->offset_ + idx;
@@ -161,11 +184,14 @@ private:
     PlanContext* planContext_;
     std::vector<TagNode*> tagNodes_;
     std::vector<EdgeNode<VertexID>*> edgeNodes_;
+    FusedEdgeNode* fusedEdgeNode_{nullptr};
     TagContext* tagContext_;
     EdgeContext* edgeContext_;
     StorageExpressionContext* expCtx_;
 
-    std::unique_ptr<MultiEdgeIterator> iter_;
+    std::unique_ptr<MultiEdgeIterator> multiIter_;
+    // points to multiIter_ or the iterator of fusedEdgeNode_
+    MultiEdgeIterator* iter_{nullptr};
 };
 
 }  // namespace storage
@@ -12,8 +12,10 @@
 namespace nebula {
 namespace storage {
 
+// IndexEdgeNode reads the edge data of the index key which IndexScanNode points to. It only
+// reads the edge when the scan node moves forward, so no index keys would be buffered.
 template<typename T>
-class IndexEdgeNode final : public RelNode<T> {
+class IndexEdgeNode final : public IterateNode<T> {
 public:
     using RelNode<T>::execute;
 
@@ -21,62 +23,48 @@ public:
                   IndexScanNode<T>* indexScanNode,
                   const std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>>& schemas,
                   const std::string& schemaName)
-        : planContext_(planCtx)
+        : IterateNode<T>(indexScanNode)
+        , planContext_(planCtx)
         , indexScanNode_(indexScanNode)
         , schemas_(schemas)
-        , schemaName_(schemaName) {}
+        , schemaName_(schemaName)
+        , code_(kvstore::ResultCode::SUCCEEDED) {}
 
     kvstore::ResultCode execute(PartitionID partId) override {
         auto ret = RelNode<T>::execute(partId);
         if (ret != kvstore::ResultCode::SUCCEEDED) {
             return ret;
         }
+        partId_ = partId;
+        code_ = kvstore::ResultCode::SUCCEEDED;
+        seekToValidEdge();
+        return code_;
+    }
 
-        auto ttlProp = CommonUtils::ttlProps(planContext_->edgeSchema_);
-
-        data_.clear();
-        std::vector<storage::cpp2::EdgeKey> edges;
-        auto* iter = static_cast<EdgeIndexIterator*>(indexScanNode_->iterator());
-        while (iter && iter->valid()) {
-            if (!iter->val().empty() && ttlProp.first) {
-                auto v = IndexKeyUtils::parseIndexTTL(iter->val());
-                if (CommonUtils::checkDataExpiredForTTL(planContext_->edgeSchema_,
-                                                        std::move(v),
-                                                        ttlProp.second.second,
-                                                        ttlProp.second.first)) {
-                    iter->next();
-                    continue;
-                }
-            }
-            storage::cpp2::EdgeKey edge;
-            edge.set_src(iter->srcId());
-            edge.set_edge_type(planContext_->edgeType_);
-            edge.set_ranking(iter->ranking());
-            edge.set_dst(iter->dstId());
-            edges.emplace_back(std::move(edge));
-            iter->next();
-        }
-        for (const auto& edge : edges) {
-            auto prefix = NebulaKeyUtils::edgePrefix(planContext_->vIdLen_,
-                                                     partId,
-                                                     (*edge.src_ref()).getStr(),
-                                                     planContext_->edgeType_,
-                                                     edge.get_ranking(),
-                                                     (*edge.dst_ref()).getStr());
-            std::unique_ptr<kvstore::KVIterator> eIter;
-            ret = planContext_->env_->kvstore_->prefix(planContext_->spaceId_,
-                                                       partId, prefix, &eIter);
-            if (ret == kvstore::ResultCode::SUCCEEDED && eIter && eIter->valid()) {
-                data_.emplace_back(eIter->key(), eIter->val());
-            } else {
-                return ret;
-            }
-        }
-        return kvstore::ResultCode::SUCCEEDED;
+    bool valid() const override {
+        return code_ == kvstore::ResultCode::SUCCEEDED && indexScanNode_->valid();
+    }
+
+    void next() override {
+        indexScanNode_->next();
+        seekToValidEdge();
+    }
+
+    folly::StringPiece key() const override {
+        return key_;
+    }
+
+    folly::StringPiece val() const override {
+        return val_;
+    }
+
+    RowReader* reader() const override {
+        return reader_.get();
     }
 
-    std::vector<kvstore::KV> moveData() {
-        return std::move(data_);
+    // The error met when reading edge data during iteration
+    kvstore::ResultCode code() const {
+        return code_;
     }
 
     const std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>>& getSchemas() {
@@ -87,12 +75,51 @@ public:
         return schemaName_;
     }
 
+private:
+    // Move the scan node forward until it points to an index key whose edge exists
+    void seekToValidEdge() {
+        while (valid()) {
+            auto* iter = static_cast<EdgeIndexIterator*>(indexScanNode_->iterator());
+            auto prefix = NebulaKeyUtils::edgePrefix(planContext_->vIdLen_,
+                                                     partId_,
+                                                     iter->srcId(),
+                                                     planContext_->edgeType_,
+                                                     iter->ranking(),
+                                                     iter->dstId());
+            std::unique_ptr<kvstore::KVIterator> eIter;
+            auto ret = planContext_->env_->kvstore_->prefix(planContext_->spaceId_,
+                                                            partId_, prefix, &eIter);
+            if (ret != kvstore::ResultCode::SUCCEEDED) {
+                code_ = ret;
+                return;
+            }
+            if (eIter && eIter->valid()) {
+                key_ = eIter->key().str();
+                val_ = eIter->val().str();
+                reader_ = RowReaderWrapper::getRowReader(schemas_, val_);
+                if (!reader_) {
+                    VLOG(1) << "Can't get edge reader";
+                    code_ = kvstore::ResultCode::ERR_EDGE_NOT_FOUND;
+                }
+                return;
+            }
+            VLOG(1) << "Edge of index not found, src " << iter->srcId()
+                    << ", dst " << iter->dstId();
+            indexScanNode_->next();
+        }
+    }
+
 private:
     PlanContext*                                                          planContext_;
     IndexScanNode<T>*                                                     indexScanNode_;
     const std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>>& schemas_;
     const std::string&                                                    schemaName_;
-    std::vector<kvstore::KV>                                              data_;
+
+    PartitionID                                                           partId_{0};
+    kvstore::ResultCode                                                   code_;
+    std::string                                                           key_;
+    std::string                                                           val_;
+    RowReaderWrapper                                                      reader_;
 };
 
 }  // namespace storage
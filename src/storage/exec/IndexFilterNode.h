@@ -10,12 +10,16 @@
 #include "common/expression/Expression.h"
 #include "common/context/ExpressionContext.h"
 #include "storage/exec/RelNode.h"
+#include "storage/exec/CompiledFilter.h"
 
 namespace nebula {
 namespace storage {
 
+// IndexFilterNode is a volcano node just like FilterNode, every time `next` is called, it moves
+// the upstream forward until the upstream points to an index key or a row which could pass the
+// filter.
 template<typename T>
-class IndexFilterNode final : public RelNode<T> {
+class IndexFilterNode final : public IterateNode<T> {
 public:
     using RelNode<T>::execute;
 
@@ -24,71 +28,58 @@ public:
                     StorageExpressionContext* exprCtx = nullptr,
                     Expression* exp = nullptr,
                     bool isEdge = false)
-        : indexScanNode_(indexScanNode)
+        : IterateNode<T>(indexScanNode)
         , exprCtx_(exprCtx)
         , filterExp_(exp)
         , isEdge_(isEdge) {
         evalExprByIndex_ = true;
+        compile();
     }
 
     // evalExprByIndex_ is false, some fileds in filter is out of index, which need to read data.
     IndexFilterNode(IndexEdgeNode<T>* indexEdgeNode,
                     StorageExpressionContext* exprCtx = nullptr,
                     Expression* exp = nullptr)
-        : indexEdgeNode_(indexEdgeNode)
+        : IterateNode<T>(indexEdgeNode)
+        , indexEdgeNode_(indexEdgeNode)
         , exprCtx_(exprCtx)
         , filterExp_(exp) {
         evalExprByIndex_ = false;
         isEdge_ = true;
+        compile();
     }
 
     // evalExprByIndex_ is false, some fileds in filter is out of index, which need to read data.
     IndexFilterNode(IndexVertexNode<T>* indexVertexNode,
                     StorageExpressionContext* exprCtx = nullptr,
                     Expression* exp = nullptr)
-        : indexVertexNode_(indexVertexNode)
+        : IterateNode<T>(indexVertexNode)
+        , indexVertexNode_(indexVertexNode)
         , exprCtx_(exprCtx)
         , filterExp_(exp) {
         evalExprByIndex_ = false;
         isEdge_ = false;
+        compile();
     }
 
     kvstore::ResultCode execute(PartitionID partId) override {
-        data_.clear();
         auto ret = RelNode<T>::execute(partId);
         if (ret != kvstore::ResultCode::SUCCEEDED) {
             return ret;
         }
-        std::vector<kvstore::KV> data;
-        if (evalExprByIndex_) {
-            data = indexScanNode_->moveData();
-        } else if (isEdge_) {
-            data = indexEdgeNode_->moveData();
-        } else {
-            data = indexVertexNode_->moveData();
-        }
-        for (const auto& k : data) {
-            if (evalExprByIndex_) {
-                if (check(k.first)) {
-                    data_.emplace_back(k.first, k.second);
-                }
-            } else {
-                const auto& schemas = isEdge_ ? indexEdgeNode_->getSchemas()
-                                              : indexVertexNode_->getSchemas();
-                auto reader = RowReaderWrapper::getRowReader(schemas, k.second);
-                if (!reader) {
-                    continue;
-                }
-                if (check(reader.get(), k.first)) {
-                    data_.emplace_back(k.first, k.second);
-                }
-            }
+        // move to the first record which could pass the filter
+        while (this->upstream_->valid() && !check()) {
+            this->upstream_->next();
         }
         return kvstore::ResultCode::SUCCEEDED;
     }
 
-    std::vector<kvstore::KV> moveData() {
-        return std::move(data_);
+    // The error met when reading data during iteration
+    kvstore::ResultCode code() const {
+        if (evalExprByIndex_) {
+            return kvstore::ResultCode::SUCCEEDED;
+        }
+        return isEdge_ ? indexEdgeNode_->code() : indexVertexNode_->code();
     }
 
     const std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>>& getSchemas() {
@@ -105,41 +96,28 @@ public:
     }
 
 private:
-    bool check(const std::string& raw) {
-        if (filterExp_ != nullptr) {
-            exprCtx_->reset(raw);
-            auto result = filterExp_->eval(*exprCtx_);
-            if (result.type() == Value::Type::BOOL) {
-                return result.getBool();
-            } else {
-                return false;
-            }
-        }
-        return false;
+    void compile() {
+        compiledFilter_ = CompiledFilter::compile(filterExp_, exprCtx_);
     }
 
-    bool check(RowReader* reader, const std::string& raw) {
-        if (filterExp_ != nullptr) {
-            exprCtx_->reset(reader, raw);
-            auto result = filterExp_->eval(*exprCtx_);
-            if (result.type() == Value::Type::BOOL) {
-                return result.getBool();
-            } else {
-                return false;
-            }
+    bool check() override {
+        if (compiledFilter_ == nullptr) {
+            return false;
+        }
+        if (evalExprByIndex_) {
+            return compiledFilter_->check(this->key());
         }
-        return false;
+        return compiledFilter_->check(this->reader(), this->key());
     }
 
 private:
-    IndexScanNode<T>*                                 indexScanNode_{nullptr};
     IndexEdgeNode<T>*                                 indexEdgeNode_{nullptr};
     IndexVertexNode<T>*                               indexVertexNode_{nullptr};
     StorageExpressionContext                          *exprCtx_;
     Expression                                        *filterExp_;
     bool                                              isEdge_;
     bool                                              evalExprByIndex_;
-    std::vector<kvstore::KV>                          data_{};
+    std::unique_ptr<CompiledFilter>                   compiledFilter_;
 };
 
 }  // namespace storage
@@ -88,36 +88,36 @@ public:
         }
 
         switch (type_) {
-            case IndexResultType::kEdgeFromIndexScan: {
-                ret = collectResult(indexScanNode_->moveData());
+            case IndexResultType::kEdgeFromIndexScan:
+            case IndexResultType::kVertexFromIndexScan: {
+                ret = collectRowsFromIndex(indexScanNode_);
                 break;
             }
-            case IndexResultType::kEdgeFromIndexFilter: {
-                ret = collectResult(indexFilterNode_->moveData());
+            case IndexResultType::kEdgeFromIndexFilter:
+            case IndexResultType::kVertexFromIndexFilter: {
+                ret = collectRowsFromIndex(indexFilterNode_);
                 break;
             }
             case IndexResultType::kEdgeFromDataScan: {
-                ret = collectResult(indexEdgeNode_->moveData());
-                break;
-            }
-            case IndexResultType::kEdgeFromDataFilter: {
-                ret = collectResult(indexFilterNode_->moveData());
-                break;
-            }
-            case IndexResultType::kVertexFromIndexScan: {
-                ret = collectResult(indexScanNode_->moveData());
-                break;
-            }
-            case IndexResultType::kVertexFromIndexFilter: {
-                ret = collectResult(indexFilterNode_->moveData());
+                ret = collectRowsFromData(indexEdgeNode_, indexEdgeNode_->getSchemas());
+                if (ret == kvstore::ResultCode::SUCCEEDED) {
+                    ret = indexEdgeNode_->code();
+                }
                 break;
             }
             case IndexResultType::kVertexFromDataScan: {
-                ret = collectResult(indexVertexNode_->moveData());
+                ret = collectRowsFromData(indexVertexNode_, indexVertexNode_->getSchemas());
+                if (ret == kvstore::ResultCode::SUCCEEDED) {
+                    ret = indexVertexNode_->code();
+                }
                 break;
             }
+            case IndexResultType::kEdgeFromDataFilter:
             case IndexResultType::kVertexFromDataFilter: {
-                ret = collectResult(indexFilterNode_->moveData());
+                ret = collectRowsFromData(indexFilterNode_, indexFilterNode_->getSchemas());
+                if (ret == kvstore::ResultCode::SUCCEEDED) {
+                    ret = indexFilterNode_->code();
+                }
                 break;
             }
         }
@@ -125,63 +125,14 @@ public:
     }
 
 private:
-    kvstore::ResultCode collectResult(const std::vector<kvstore::KV>& data) {
-        kvstore::ResultCode ret = kvstore::ResultCode::SUCCEEDED;
-        switch (type_) {
-            case IndexResultType::kEdgeFromIndexScan:
-            case IndexResultType::kEdgeFromIndexFilter: {
-                ret = edgeRowsFromIndex(data);
-                break;
-            }
-            case IndexResultType::kEdgeFromDataScan:
-            case IndexResultType::kEdgeFromDataFilter: {
-                ret = edgeRowsFromData(data);
-                break;
-            }
-            case IndexResultType::kVertexFromIndexScan:
-            case IndexResultType::kVertexFromIndexFilter: {
-                ret = vertexRowsFromIndex(data);
-                break;
-            }
-            case IndexResultType::kVertexFromDataScan:
-            case IndexResultType::kVertexFromDataFilter: {
-                ret = vertexRowsFromData(data);
-                break;
-            }
-        }
-        return ret;
-    }
-
-    kvstore::ResultCode vertexRowsFromData(const std::vector<kvstore::KV>& data) {
-        const auto& schemas = type_ == IndexResultType::kVertexFromDataScan
-                              ? indexVertexNode_->getSchemas()
-                              : indexFilterNode_->getSchemas();
-        if (schemas.empty()) {
-            return kvstore::ResultCode::ERR_TAG_NOT_FOUND;
-        }
-        for (const auto& val : data) {
-            Row row;
-            auto reader = RowReaderWrapper::getRowReader(schemas, val.second);
-            if (!reader) {
-                VLOG(1) << "Can't get tag reader";
-                return kvstore::ResultCode::ERR_TAG_NOT_FOUND;
-            }
-            for (const auto& col : result_->colNames) {
-                auto ret = addIndexValue(row, reader.get(), val, col, schemas.back().get());
-                if (!ret.ok()) {
-                    return kvstore::ResultCode::ERR_INVALID_DATA;
-                }
-            }
-            result_->rows.emplace_back(std::move(row));
-        }
-        return kvstore::ResultCode::SUCCEEDED;
-    }
-
-    kvstore::ResultCode vertexRowsFromIndex(const std::vector<kvstore::KV>& data) {
-        for (const auto& val : data) {
+    // Pull the index keys from upstream one by one, and build the rows from the index key
+    kvstore::ResultCode collectRowsFromIndex(IterateNode<T>* upstream) {
+        for (; upstream->valid(); upstream->next()) {
+            auto key = upstream->key();
             Row row;
+            row.values.reserve(result_->colNames.size());
             for (const auto& col : result_->colNames) {
-                auto ret = addIndexValue(row, val, col);
+                auto ret = addIndexValue(row, key, col);
                 if (!ret.ok()) {
                     return kvstore::ResultCode::ERR_INVALID_DATA;
                 }
@@ -191,36 +142,21 @@ private:
         return kvstore::ResultCode::SUCCEEDED;
     }
 
-    kvstore::ResultCode edgeRowsFromData(const std::vector<kvstore::KV>& data) {
-        const auto& schemas = type_ == IndexResultType::kEdgeFromDataScan
-                              ? indexEdgeNode_->getSchemas()
-                              : indexFilterNode_->getSchemas();
+    // Pull the data from upstream one by one, and build the rows from the vertex or edge data
+    kvstore::ResultCode collectRowsFromData(
+            IterateNode<T>* upstream,
+            const std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>>& schemas) {
         if (schemas.empty()) {
-            return kvstore::ResultCode::ERR_EDGE_NOT_FOUND;
-        }
-        for (const auto& val : data) {
-            Row row;
-            auto reader = RowReaderWrapper::getRowReader(schemas, val.second);
-            if (!reader) {
-                VLOG(1) << "Can't get tag reader";
-                return kvstore::ResultCode::ERR_EDGE_NOT_FOUND;
-            }
-            for (const auto& col : result_->colNames) {
-                auto ret = addIndexValue(row, reader.get(), val, col, schemas.back().get());
-                if (!ret.ok()) {
-                    return kvstore::ResultCode::ERR_INVALID_DATA;
-                }
-            }
-            result_->rows.emplace_back(std::move(row));
+            return planContext_->isEdge_ ? kvstore::ResultCode::ERR_EDGE_NOT_FOUND
+                                         : kvstore::ResultCode::ERR_TAG_NOT_FOUND;
         }
-        return kvstore::ResultCode::SUCCEEDED;
-    }
-
-    kvstore::ResultCode edgeRowsFromIndex(const std::vector<kvstore::KV>& data) {
-        for (const auto& val : data) {
+        for (; upstream->valid(); upstream->next()) {
+            auto key = upstream->key();
+            auto* reader = upstream->reader();
             Row row;
+            row.values.reserve(result_->colNames.size());
             for (const auto& col : result_->colNames) {
-                auto ret = addIndexValue(row, val, col);
+                auto ret = addIndexValue(row, reader, key, col, schemas.back().get());
                 if (!ret.ok()) {
                     return kvstore::ResultCode::ERR_INVALID_DATA;
                 }
@@ -232,11 +168,11 @@ private:
 
     // Add the value by data val
     Status addIndexValue(Row& row, RowReader* reader,
-                         const kvstore::KV& data, const std::string& col,
+                         folly::StringPiece key, const std::string& col,
                          const meta::NebulaSchemaProvider* schema) {
         switch (QueryUtils::toReturnColType(col)) {
             case QueryUtils::ReturnColType::kVid : {
-                auto vId = NebulaKeyUtils::getVertexId(planContext_->vIdLen_, data.first);
+                auto vId = NebulaKeyUtils::getVertexId(planContext_->vIdLen_, key);
                 if (planContext_->isIntId_) {
                     row.emplace_back(*reinterpret_cast<const int64_t*>(vId.data()));
                 } else {
@@ -245,11 +181,11 @@ private:
                 break;
             }
             case QueryUtils::ReturnColType::kTag : {
-                row.emplace_back(NebulaKeyUtils::getTagId(planContext_->vIdLen_, data.first));
+                row.emplace_back(NebulaKeyUtils::getTagId(planContext_->vIdLen_, key));
                 break;
             }
             case QueryUtils::ReturnColType::kSrc : {
-                auto src = NebulaKeyUtils::getSrcId(planContext_->vIdLen_, data.first);
+                auto src = NebulaKeyUtils::getSrcId(planContext_->vIdLen_, key);
                 if (planContext_->isIntId_) {
                     row.emplace_back(*reinterpret_cast<const int64_t*>(src.data()));
                 } else {
@@ -258,15 +194,15 @@ private:
                 break;
             }
             case QueryUtils::ReturnColType::kType : {
-                row.emplace_back(NebulaKeyUtils::getEdgeType(planContext_->vIdLen_, data.first));
+                row.emplace_back(NebulaKeyUtils::getEdgeType(planContext_->vIdLen_, key));
                 break;
             }
             case QueryUtils::ReturnColType::kRank : {
-                row.emplace_back(NebulaKeyUtils::getRank(planContext_->vIdLen_, data.first));
+                row.emplace_back(NebulaKeyUtils::getRank(planContext_->vIdLen_, key));
                 break;
             }
             case QueryUtils::ReturnColType::kDst : {
-                auto dst = NebulaKeyUtils::getDstId(planContext_->vIdLen_, data.first);
+                auto dst = NebulaKeyUtils::getDstId(planContext_->vIdLen_, key);
                 if (planContext_->isIntId_) {
                     row.emplace_back(*reinterpret_cast<const int64_t*>(dst.data()));
                 } else {
@@ -287,10 +223,10 @@ private:
     }
 
     // Add the value by index key
-    Status addIndexValue(Row& row, const kvstore::KV& data, const std::string& col) {
+    Status addIndexValue(Row& row, folly::StringPiece key, const std::string& col) {
         switch (QueryUtils::toReturnColType(col)) {
             case QueryUtils::ReturnColType::kVid : {
-                auto vId = IndexKeyUtils::getIndexVertexID(planContext_->vIdLen_, data.first);
+                auto vId = IndexKeyUtils::getIndexVertexID(planContext_->vIdLen_, key);
                 if (planContext_->isIntId_) {
                     row.emplace_back(*reinterpret_cast<const int64_t*>(vId.data()));
                 } else {
@@ -303,7 +239,7 @@ private:
                 break;
             }
             case QueryUtils::ReturnColType::kSrc : {
-                auto src = IndexKeyUtils::getIndexSrcId(planContext_->vIdLen_, data.first);
+                auto src = IndexKeyUtils::getIndexSrcId(planContext_->vIdLen_, key);
                 if (planContext_->isIntId_) {
                     row.emplace_back(*reinterpret_cast<const int64_t*>(src.data()));
                 } else {
@@ -316,11 +252,11 @@ private:
                 break;
             }
             case QueryUtils::ReturnColType::kRank : {
-                row.emplace_back(IndexKeyUtils::getIndexRank(planContext_->vIdLen_, data.first));
+                row.emplace_back(IndexKeyUtils::getIndexRank(planContext_->vIdLen_, key));
                 break;
             }
             case QueryUtils::ReturnColType::kDst : {
-                auto dst = IndexKeyUtils::getIndexDstId(planContext_->vIdLen_, data.first);
+                auto dst = IndexKeyUtils::getIndexDstId(planContext_->vIdLen_, key);
                 if (planContext_->isIntId_) {
                     row.emplace_back(*reinterpret_cast<const int64_t*>(dst.data()));
                 } else {
@@ -330,7 +266,7 @@ private:
             }
             default: {
                 auto v = IndexKeyUtils::getValueFromIndexKey(planContext_->vIdLen_,
-                                                             data.first,
+                                                             key,
                                                              col,
                                                              fields_,
                                                              planContext_->isEdge_,
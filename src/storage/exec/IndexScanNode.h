@@ -13,8 +13,12 @@
 
 namespace nebula {
 namespace storage {
+
+// IndexScanNode is the source of the lookup pipeline, it iterates over the index keys of a part
+// lazily. The index keys which have been expired are skipped, so downstream nodes will only
+// see the valid ones via `valid`, `next` and `key`.
 template<typename T>
-class IndexScanNode : public RelNode<T> {
+class IndexScanNode : public IterateNode<T> {
 public:
     using RelNode<T>::execute;
 
@@ -64,6 +68,9 @@ public:
             iter_.reset();
             return ret;
         }
+        schema_ = planContext_->isEdge_ ? planContext_->edgeSchema_ : planContext_->tagSchema_;
+        ttlProp_ = CommonUtils::ttlProps(schema_);
+        skipExpired();
         return kvstore::ResultCode::SUCCEEDED;
     }
 
@@ -71,28 +78,44 @@ public:
         return iter_.get();
     }
 
-    std::vector<kvstore::KV> moveData() {
-        auto* sh = planContext_->isEdge_ ? planContext_->edgeSchema_ : planContext_->tagSchema_;
-        auto ttlProp = CommonUtils::ttlProps(sh);
-        data_.clear();
-        while (!!iter_ && iter_->valid()) {
-            if (!iter_->val().empty() && ttlProp.first) {
-                auto v = IndexKeyUtils::parseIndexTTL(iter_->val());
-                if (CommonUtils::checkDataExpiredForTTL(sh,
-                                                        std::move(v),
-                                                        ttlProp.second.second,
-                                                        ttlProp.second.first)) {
-                    iter_->next();
-                    continue;
-                }
+    bool valid() const override {
+        return !!iter_ && iter_->valid();
+    }
+
+    void next() override {
+        iter_->next();
+        skipExpired();
+    }
+
+    folly::StringPiece key() const override {
+        return iter_->key();
+    }
+
+    folly::StringPiece val() const override {
+        return iter_->val();
+    }
+
+    RowReader* reader() const override {
+        return nullptr;
+    }
+
+private:
+    void skipExpired() {
+        if (!ttlProp_.first) {
+            return;
+        }
+        while (valid()) {
+            if (iter_->val().empty() ||
+                !CommonUtils::checkDataExpiredForTTL(schema_,
+                                                     IndexKeyUtils::parseIndexTTL(iter_->val()),
+                                                     ttlProp_.second.second,
+                                                     ttlProp_.second.first)) {
+                return;
             }
-            data_.emplace_back(iter_->key(), "");
             iter_->next();
         }
-        return std::move(data_);
     }
 
-private:
     StatusOr<std::pair<std::string, std::string>> scanStr(PartitionID partId) {
         auto iRet = planContext_->isEdge_
                     ? planContext_->env_->indexMan_->getEdgeIndex(planContext_->spaceId_, indexId_)
@@ -179,7 +202,8 @@ private:
     std::unique_ptr<IndexIterator>      iter_;
     std::pair<std::string, std::string> scanPair_;
     std::vector<cpp2::IndexColumnHint>  columnHints_;
-    std::vector<kvstore::KV>            data_;
+    const meta::NebulaSchemaProvider*   schema_{nullptr};
+    std::pair<bool, std::pair<int64_t, std::string>> ttlProp_;
 };
 
 }  // namespace storage
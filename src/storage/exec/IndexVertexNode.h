@@ -8,13 +8,17 @@
 
 #include "common/base/Base.h"
 #include "storage/exec/RelNode.h"
+#include "storage/StorageFlags.h"
 #include "storage/exec/IndexScanNode.h"
 
 namespace nebula {
 namespace storage {
 
+// IndexVertexNode reads the vertex data of the index keys which IndexScanNode points to. It pulls
+// at most --vertex_multiget_batch_size index keys from the scan node each time, and reads their
+// vertices by one multiGet, so there is no need to create an iterator for each vertex.
 template<typename T>
-class IndexVertexNode final : public RelNode<T> {
+class IndexVertexNode final : public IterateNode<T> {
 public:
     using RelNode<T>::execute;
 
@@ -23,69 +27,52 @@ public:
                     IndexScanNode<T>* indexScanNode,
                     const std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>>& schemas,
                     const std::string& schemaName)
-        : planContext_(planCtx)
+        : IterateNode<T>(indexScanNode)
+        , planContext_(planCtx)
         , vertexCache_(vertexCache)
         , indexScanNode_(indexScanNode)
         , schemas_(schemas)
-        , schemaName_(schemaName) {}
+        , schemaName_(schemaName)
+        , code_(kvstore::ResultCode::SUCCEEDED) {}
 
     kvstore::ResultCode execute(PartitionID partId) override {
         auto ret = RelNode<T>::execute(partId);
         if (ret != kvstore::ResultCode::SUCCEEDED) {
             return ret;
         }
+        partId_ = partId;
+        code_ = kvstore::ResultCode::SUCCEEDED;
+        fetchVertices();
+        return code_;
+    }
 
-        auto ttlProp = CommonUtils::ttlProps(planContext_->tagSchema_);
-
-        data_.clear();
-        std::vector<VertexID> vids;
-        auto* iter = static_cast<VertexIndexIterator*>(indexScanNode_->iterator());
-        while (iter && iter->valid()) {
-            if (!iter->val().empty() && ttlProp.first) {
-                auto v = IndexKeyUtils::parseIndexTTL(iter->val());
-                if (CommonUtils::checkDataExpiredForTTL(planContext_->tagSchema_,
-                                                        std::move(v),
-                                                        ttlProp.second.second,
-                                                        ttlProp.second.first)) {
-                    iter->next();
-                    continue;
-                }
-            }
-            vids.emplace_back(iter->vId());
-            iter->next();
-        }
-        for (const auto& vId : vids) {
-            VLOG(1) << "partId " << partId << ", vId " << vId << ", tagId " << planContext_->tagId_;
-            if (FLAGS_enable_vertex_cache && vertexCache_ != nullptr) {
-                auto result = vertexCache_->get(std::make_pair(vId, planContext_->tagId_));
-                if (result.ok()) {
-                    auto vertexKey = NebulaKeyUtils::vertexKey(planContext_->vIdLen_,
-                                                               partId,
-                                                               vId,
-                                                               planContext_->tagId_);
-                    data_.emplace_back(std::move(vertexKey), std::move(result).value());
-                    continue;
-                } else {
-                    VLOG(1) << "Miss cache for vId " << vId << ", tagId " << planContext_->tagId_;
-                }
-            }
+    bool valid() const override {
+        return code_ == kvstore::ResultCode::SUCCEEDED && pos_ < vertices_.size();
+    }
 
-            std::unique_ptr<kvstore::KVIterator> vIter;
-            auto prefix = NebulaKeyUtils::vertexPrefix(planContext_->vIdLen_, partId,
-                                                       vId, planContext_->tagId_);
-            ret = planContext_->env_->kvstore_->prefix(planContext_->spaceId_,
-                                                       partId, prefix, &vIter);
-            if (ret == kvstore::ResultCode::SUCCEEDED && vIter && vIter->valid()) {
-                data_.emplace_back(vIter->key(), vIter->val());
-            } else {
-                return ret;
-            }
+    void next() override {
+        if (++pos_ < vertices_.size()) {
+            resetReader();
+        } else {
+            fetchVertices();
         }
-        return kvstore::ResultCode::SUCCEEDED;
     }
 
-    std::vector<kvstore::KV> moveData() {
-        return std::move(data_);
+    folly::StringPiece key() const override {
+        return vertices_[pos_].first;
+    }
+
+    folly::StringPiece val() const override {
+        return vertices_[pos_].second;
+    }
+
+    RowReader* reader() const override {
+        return reader_.get();
+    }
+
+    // The error met when reading vertex data during iteration
+    kvstore::ResultCode code() const {
+        return code_;
     }
 
     const std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>>& getSchemas() {
@@ -96,13 +83,107 @@ public:
         return schemaName_;
     }
 
+private:
+    // Pull the next batch of index keys from the scan node and read their vertices, the vertices
+    // not found are skipped. Stop when a batch has any vertex, or the scan node is exhausted.
+    void fetchVertices() {
+        vertices_.clear();
+        pos_ = 0;
+        auto batch = static_cast<size_t>(std::max(FLAGS_vertex_multiget_batch_size, 1));
+        auto tagId = planContext_->tagId_;
+        while (code_ == kvstore::ResultCode::SUCCEEDED &&
+               vertices_.empty() &&
+               indexScanNode_->valid()) {
+            std::vector<std::string> keys;
+            std::vector<folly::Optional<std::string>> values;
+            std::vector<size_t> missed;
+            while (keys.size() < batch && indexScanNode_->valid()) {
+                auto* iter = static_cast<VertexIndexIterator*>(indexScanNode_->iterator());
+                auto vId = iter->vId();
+                VLOG(1) << "partId " << partId_ << ", vId " << vId << ", tagId " << tagId;
+                keys.emplace_back(NebulaKeyUtils::vertexKey(planContext_->vIdLen_,
+                                                            partId_,
+                                                            vId,
+                                                            tagId));
+                values.emplace_back(readFromCache(vId));
+                if (!values.back().hasValue()) {
+                    missed.emplace_back(keys.size() - 1);
+                }
+                indexScanNode_->next();
+            }
+
+            if (!missed.empty()) {
+                std::vector<std::string> missedKeys;
+                missedKeys.reserve(missed.size());
+                for (auto idx : missed) {
+                    missedKeys.emplace_back(keys[idx]);
+                }
+                std::vector<std::string> missedValues;
+                auto ret = planContext_->env_->kvstore_->multiGet(planContext_->spaceId_,
+                                                                  partId_,
+                                                                  missedKeys,
+                                                                  &missedValues);
+                if (ret.first != kvstore::ResultCode::SUCCEEDED &&
+                    ret.first != kvstore::ResultCode::ERR_PARTIAL_RESULT) {
+                    code_ = ret.first;
+                    return;
+                }
+                for (size_t i = 0; i < missed.size(); i++) {
+                    if (ret.second[i].ok()) {
+                        values[missed[i]] = std::move(missedValues[i]);
+                    } else if (ret.second[i].isKeyNotFound()) {
+                        VLOG(1) << "Vertex of index not found, key "
+                                << folly::hexlify(missedKeys[i]);
+                    } else {
+                        code_ = kvstore::ResultCode::ERR_IO_ERROR;
+                        return;
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < keys.size(); i++) {
+                if (values[i].hasValue()) {
+                    vertices_.emplace_back(std::move(keys[i]), std::move(values[i]).value());
+                }
+            }
+        }
+        if (valid()) {
+            resetReader();
+        }
+    }
+
+    folly::Optional<std::string> readFromCache(const VertexID& vId) {
+        if (FLAGS_enable_vertex_cache && vertexCache_ != nullptr) {
+            auto result = vertexCache_->get(std::make_pair(vId, planContext_->tagId_));
+            if (result.ok()) {
+                return std::move(result).value();
+            }
+            VLOG(1) << "Miss cache for vId " << vId << ", tagId " << planContext_->tagId_;
+        }
+        return folly::none;
+    }
+
+    void resetReader() {
+        reader_ = RowReaderWrapper::getRowReader(schemas_, vertices_[pos_].second);
+        if (!reader_) {
+            VLOG(1) << "Can't get tag reader";
+            code_ = kvstore::ResultCode::ERR_TAG_NOT_FOUND;
+        }
+    }
+
 private:
     PlanContext*                                                          planContext_;
     VertexCache*                                                          vertexCache_;
     IndexScanNode<T>*                                                     indexScanNode_;
     const std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>>& schemas_;
     const std::string&                                                    schemaName_;
-    std::vector<kvstore::KV>                                              data_;
+
+    PartitionID                                                           partId_{0};
+    kvstore::ResultCode                                                   code_;
+    // key and value of the vertices in current batch
+    std::vector<std::pair<std::string, std::string>>                      vertices_;
+    size_t                                                                pos_{0};
+    RowReaderWrapper                                                      reader_;
 };
 
 }  // namespace storage
@@ -163,6 +163,8 @@ public:
                                      RowReader* reader,
                                      const std::vector<PropContext>* props,
                                      nebula::List& list) {
+        // The list is reserved with the props only used by filter as well, which are few
+        list.values.reserve(list.values.size() + props->size());
         for (const auto& prop : *props) {
             if (prop.returned_) {
                 VLOG(2) << "Collect prop " << prop.name_;
@@ -182,6 +184,7 @@ public:
                                    RowReader* reader,
                                    const std::vector<PropContext>* props,
                                    nebula::List& list) {
+        list.values.reserve(list.values.size() + props->size());
         for (const auto& prop : *props) {
             if (prop.returned_) {
                 VLOG(2) << "Collect prop " << prop.name_;
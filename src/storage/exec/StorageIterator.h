@@ -9,6 +9,7 @@
 
 #include "common/base/Base.h"
 #include "kvstore/KVIterator.h"
+#include "utils/NebulaKeyUtils.h"
 #include "storage/CommonUtils.h"
 #include "storage/StorageFlags.h"
 
@@ -164,15 +165,18 @@ public:
         return iters_[curIter_]->reader();
     }
 
-    EdgeType edgeType() const {
+    virtual EdgeType edgeType() const {
         return iters_[curIter_]->edgeType();
     }
 
     // return the index of multiple iterators
-    size_t getIdx() const {
+    virtual size_t getIdx() const {
         return curIter_;
     }
 
+protected:
+    MultiEdgeIterator() = default;
+
 private:
     void moveToNextValidIterator() {
         while (curIter_ < iters_.size()) {
@@ -188,6 +192,129 @@ private:
     size_t curIter_ = 0;
 };
 
+// Iterator of edges of multiple edge types of the same vertex, which only uses one KVIterator on
+// the edge prefix of the vertex. Edge types are visited in the given order, and it seeks to the
+// prefix of next edge type instead of opening a new KVIterator for each edge type.
+class FusedEdgeIterator final : public MultiEdgeIterator {
+public:
+    struct EdgeTypeInfo {
+        EdgeType                                                              edgeType_;
+        const std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>> *schemas_;
+        const folly::Optional<std::pair<std::string, int64_t>>               *ttl_;
+    };
+
+    // iter should be a prefix iterator on edgePrefix(vIdLen, partId, vId)
+    FusedEdgeIterator(PlanContext* planCtx,
+                      std::unique_ptr<kvstore::KVIterator> iter,
+                      PartitionID partId,
+                      const VertexID& vId,
+                      const std::vector<EdgeTypeInfo>* edgeTypes)
+        : planContext_(planCtx)
+        , iter_(std::move(iter))
+        , partId_(partId)
+        , vId_(vId)
+        , edgeTypes_(edgeTypes) {
+        CHECK(!!iter_);
+        moveToValidEdge(false);
+    }
+
+    bool valid() const override {
+        return curIdx_ < edgeTypes_->size();
+    }
+
+    void next() override {
+        iter_->next();
+        moveToValidEdge(true);
+    }
+
+    folly::StringPiece key() const override {
+        return iter_->key();
+    }
+
+    folly::StringPiece val() const override {
+        return iter_->val();
+    }
+
+    RowReader* reader() const override {
+        return reader_.get();
+    }
+
+    EdgeType edgeType() const override {
+        return (*edgeTypes_)[curIdx_].edgeType_;
+    }
+
+    size_t getIdx() const override {
+        return curIdx_;
+    }
+
+private:
+    // Stay at current record if it is a valid edge of current edge type, otherwise move to the
+    // next valid edge, across edge types if necessary.
+    void moveToValidEdge(bool inCurrentType) {
+        while (curIdx_ < edgeTypes_->size()) {
+            if (!inCurrentType) {
+                seekToEdgeType();
+            }
+            while (iter_->valid() && iter_->key().startsWith(typePrefix_)) {
+                if (check()) {
+                    return;
+                }
+                iter_->next();
+            }
+            ++curIdx_;
+            inCurrentType = false;
+        }
+        reader_.reset();
+    }
+
+    void seekToEdgeType() {
+        const auto& info = (*edgeTypes_)[curIdx_];
+        typePrefix_ = NebulaKeyUtils::edgePrefix(planContext_->vIdLen_,
+                                                 partId_,
+                                                 vId_,
+                                                 info.edgeType_);
+        // edges of two edge types may be adjacent, no need to seek in that case
+        if (!iter_->valid() || !iter_->key().startsWith(typePrefix_)) {
+            iter_->seek(typePrefix_);
+        }
+        hasTtl_ = info.ttl_->hasValue();
+        if (hasTtl_) {
+            ttlCol_ = info.ttl_->value().first;
+            ttlDuration_ = info.ttl_->value().second;
+        }
+    }
+
+    // return true when the iter points to a valid edge value
+    bool check() {
+        const auto* schemas = (*edgeTypes_)[curIdx_].schemas_;
+        reader_.reset(*schemas, iter_->val());
+        if (!reader_) {
+            planContext_->resultStat_ = ResultStatus::ILLEGAL_DATA;
+            return false;
+        }
+
+        if (hasTtl_ && CommonUtils::checkDataExpiredForTTL(schemas->back().get(), reader_.get(),
+                                                           ttlCol_, ttlDuration_)) {
+            reader_.reset();
+            return false;
+        }
+        return true;
+    }
+
+    PlanContext                                 *planContext_;
+    std::unique_ptr<kvstore::KVIterator>         iter_;
+    PartitionID                                  partId_;
+    VertexID                                     vId_;
+    const std::vector<EdgeTypeInfo>             *edgeTypes_;
+
+    size_t                                       curIdx_ = 0;
+    std::string                                  typePrefix_;
+    bool                                         hasTtl_ = false;
+    std::string                                  ttlCol_;
+    int64_t                                      ttlDuration_ = 0;
+    RowReaderWrapper                             reader_;
+};
+
 class IndexIterator : public StorageIterator {
 public:
     explicit IndexIterator(std::unique_ptr<kvstore::KVIterator> iter)
@@ -62,6 +62,20 @@ public:
             }
         }
 
+        // the vertex may have been read in batch by QueryBaseProcessor::prefetchVertices
+        if (!planContext_->vertices_.empty()) {
+            auto key = NebulaKeyUtils::vertexKey(planContext_->vIdLen_, partId, vId, tagId_);
+            auto found = planContext_->vertices_.find(key);
+            if (found != planContext_->vertices_.end()) {
+                if (found->second.hasValue()) {
+                    key_ = std::move(key);
+                    value_ = found->second.value();
+                    resetReader(vId);
+                }
+                return kvstore::ResultCode::SUCCEEDED;
+            }
+        }
+
         std::unique_ptr<kvstore::KVIterator> iter;
         auto prefix = NebulaKeyUtils::vertexPrefix(planContext_->vIdLen_, partId, vId, tagId_);
         ret = planContext_->env_->kvstore_->prefix(planContext_->spaceId_, partId, prefix, &iter);
@@ -46,26 +46,37 @@ protected:
 
     bool isOutsideIndex(Expression* filter, const meta::cpp2::IndexItem* index);
 
-    StatusOr<StoragePlan<IndexID>> buildPlan();
+    StatusOr<StoragePlan<IndexID>> buildPlan(PlanContext* planCtx,
+                                             nebula::DataSet* result,
+                                             IndexFilterItem* filterItems);
 
     std::unique_ptr<IndexOutputNode<IndexID>>
     buildPlanBasic(const cpp2::IndexQueryContext& ctx,
                    StoragePlan<IndexID>& plan,
+                   PlanContext* planCtx,
+                   nebula::DataSet* result,
                    bool hasNullableCol,
                    const std::vector<meta::cpp2::ColumnDef>& fields);
 
     std::unique_ptr<IndexOutputNode<IndexID>>
-    buildPlanWithData(const cpp2::IndexQueryContext& ctx, StoragePlan<IndexID>& plan);
+    buildPlanWithData(const cpp2::IndexQueryContext& ctx,
+                      StoragePlan<IndexID>& plan,
+                      PlanContext* planCtx,
+                      nebula::DataSet* result);
 
     std::unique_ptr<IndexOutputNode<IndexID>>
     buildPlanWithFilter(const cpp2::IndexQueryContext& ctx,
                         StoragePlan<IndexID>& plan,
+                        PlanContext* planCtx,
+                        nebula::DataSet* result,
                         StorageExpressionContext* exprCtx,
                         Expression* exp);
 
     std::unique_ptr<IndexOutputNode<IndexID>>
     buildPlanWithDataAndFilter(const cpp2::IndexQueryContext& ctx,
                                StoragePlan<IndexID>& plan,
+                               PlanContext* planCtx,
+                               nebula::DataSet* result,
                                StorageExpressionContext* exprCtx,
                                Expression* exp);
 
@@ -155,10 +155,13 @@ bool LookupBaseProcessor<REQ, RESP>::isOutsideIndex(Expression* filter,
 **/
 
 template<typename REQ, typename RESP>
-StatusOr<StoragePlan<IndexID>> LookupBaseProcessor<REQ, RESP>::buildPlan() {
+StatusOr<StoragePlan<IndexID>> LookupBaseProcessor<REQ, RESP>::buildPlan(
+        PlanContext* planCtx,
+        nebula::DataSet* result,
+        IndexFilterItem* filterItems) {
     StoragePlan<IndexID> plan;
-    auto IndexAggr = std::make_unique<AggregateNode<IndexID>>(&resultDataSet_);
-    auto deDup = std::make_unique<DeDupNode<IndexID>>(&resultDataSet_, deDupColPos_);
+    auto IndexAggr = std::make_unique<AggregateNode<IndexID>>(result);
+    auto deDup = std::make_unique<DeDupNode<IndexID>>(result, deDupColPos_);
     int32_t filterId = 0;
     std::unique_ptr<IndexOutputNode<IndexID>> out;
 
@@ -170,7 +173,7 @@ StatusOr<StoragePlan<IndexID>> LookupBaseProcessor<REQ, RESP>::buildPlan() {
         // If a non-indexed column appears in the WHERE clause or YIELD clause,
         // That means need to query the corresponding data.
         bool needData = false;
-        auto index = planContext_->isEdge_
+        auto index = planCtx->isEdge_
             ? this->env_->indexMan_->getEdgeIndex(spaceId_, indexId)
             : this->env_->indexMan_->getTagIndex(spaceId_, indexId);
         if (!index.ok()) {
@@ -217,39 +220,43 @@ StatusOr<StoragePlan<IndexID>> LookupBaseProcessor<REQ, RESP>::buildPlan() {
         }
 
         if (!needData && !needFilter) {
-            out = buildPlanBasic(ctx, plan, hasNullableCol, fields);
+            out = buildPlanBasic(ctx, plan, planCtx, result, hasNullableCol, fields);
         } else if (needData && !needFilter) {
-            out = buildPlanWithData(ctx, plan);
+            out = buildPlanWithData(ctx, plan, planCtx, result);
         } else if (!needData && needFilter) {
             auto expr = Expression::decode(ctx.get_filter());
-            auto exprCtx = std::make_unique<StorageExpressionContext>(planContext_->vIdLen_,
-                                                                        planContext_->isIntId_,
+            auto exprCtx = std::make_unique<StorageExpressionContext>(planCtx->vIdLen_,
+                                                                        planCtx->isIntId_,
                                                                         hasNullableCol,
                                                                         fields);
-            filterItems_.emplace(filterId, std::make_pair(std::move(exprCtx), std::move(expr)));
+            filterItems->emplace(filterId, std::make_pair(std::move(exprCtx), std::move(expr)));
             out = buildPlanWithFilter(ctx,
-                                        plan,
-                                        filterItems_[filterId].first.get(),
-                                        filterItems_[filterId].second.get());
+                                      plan,
+                                      planCtx,
+                                      result,
+                                      (*filterItems)[filterId].first.get(),
+                                      (*filterItems)[filterId].second.get());
             filterId++;
         } else {
             auto expr = Expression::decode(ctx.get_filter());
             // Need to get columns in data, expr ctx need to be aware of schema
-            const auto& schemaName = planContext_->isEdge_ ? planContext_->edgeName_ :
-                                                             planContext_->tagName_;
+            const auto& schemaName = planCtx->isEdge_ ? planCtx->edgeName_ :
+                                                             planCtx->tagName_;
             if (schemas_.empty()) {
                 return Status::Error("Schema not found");
             }
-            auto exprCtx = std::make_unique<StorageExpressionContext>(planContext_->vIdLen_,
-                                                                      planContext_->isIntId_,
+            auto exprCtx = std::make_unique<StorageExpressionContext>(planCtx->vIdLen_,
+                                                                      planCtx->isIntId_,
                                                                       schemaName,
                                                                       schemas_.back().get(),
-                                                                      planContext_->isEdge_);
-            filterItems_.emplace(filterId, std::make_pair(std::move(exprCtx), std::move(expr)));
+                                                                      planCtx->isEdge_);
+            filterItems->emplace(filterId, std::make_pair(std::move(exprCtx), std::move(expr)));
             out = buildPlanWithDataAndFilter(ctx,
                                              plan,
-                                             filterItems_[filterId].first.get(),
-                                             filterItems_[filterId].second.get());
+                                             planCtx,
+                                             result,
+                                             (*filterItems)[filterId].first.get(),
+                                             (*filterItems)[filterId].second.get());
             filterId++;
         }
         if (out == nullptr) {
@@ -284,16 +291,18 @@ std::unique_ptr<IndexOutputNode<IndexID>>
 LookupBaseProcessor<REQ, RESP>::buildPlanBasic(
     const cpp2::IndexQueryContext& ctx,
     StoragePlan<IndexID>& plan,
+    PlanContext* planCtx,
+    nebula::DataSet* result,
     bool hasNullableCol,
     const std::vector<meta::cpp2::ColumnDef>& fields) {
     auto indexId = ctx.get_index_id();
     auto colHints = ctx.get_column_hints();
-    auto indexScan = std::make_unique<IndexScanNode<IndexID>>(planContext_.get(),
+    auto indexScan = std::make_unique<IndexScanNode<IndexID>>(planCtx,
                                                               indexId,
                                                               std::move(colHints));
 
-    auto output = std::make_unique<IndexOutputNode<IndexID>>(&resultDataSet_,
-                                                             planContext_.get(),
+    auto output = std::make_unique<IndexOutputNode<IndexID>>(result,
+                                                             planCtx,
                                                              indexScan.get(),
                                                              hasNullableCol,
                                                              fields);
@@ -325,35 +334,37 @@ LookupBaseProcessor<REQ, RESP>::buildPlanBasic(
 template<typename REQ, typename RESP>
 std::unique_ptr<IndexOutputNode<IndexID>>
 LookupBaseProcessor<REQ, RESP>::buildPlanWithData(const cpp2::IndexQueryContext& ctx,
-                                                  StoragePlan<IndexID>& plan) {
+                                                  StoragePlan<IndexID>& plan,
+                                                  PlanContext* planCtx,
+                                                  nebula::DataSet* result) {
     auto indexId = ctx.get_index_id();
     auto colHints = ctx.get_column_hints();
 
-    auto indexScan = std::make_unique<IndexScanNode<IndexID>>(planContext_.get(),
+    auto indexScan = std::make_unique<IndexScanNode<IndexID>>(planCtx,
                                                               indexId,
                                                               std::move(colHints));
-    if (planContext_->isEdge_) {
-        auto edge = std::make_unique<IndexEdgeNode<IndexID>>(planContext_.get(),
+    if (planCtx->isEdge_) {
+        auto edge = std::make_unique<IndexEdgeNode<IndexID>>(planCtx,
                                                              indexScan.get(),
                                                              schemas_,
-                                                             planContext_->edgeName_);
+                                                             planCtx->edgeName_);
         edge->addDependency(indexScan.get());
-        auto output = std::make_unique<IndexOutputNode<IndexID>>(&resultDataSet_,
-                                                                 planContext_.get(),
+        auto output = std::make_unique<IndexOutputNode<IndexID>>(result,
+                                                                 planCtx,
                                                                  edge.get());
         output->addDependency(edge.get());
         plan.addNode(std::move(indexScan));
         plan.addNode(std::move(edge));
         return output;
     } else {
-        auto vertex = std::make_unique<IndexVertexNode<IndexID>>(planContext_.get(),
+        auto vertex = std::make_unique<IndexVertexNode<IndexID>>(planCtx,
                                                                  this->vertexCache_,
                                                                  indexScan.get(),
                                                                  schemas_,
-                                                                 planContext_->tagName_);
+                                                                 planCtx->tagName_);
         vertex->addDependency(indexScan.get());
-        auto output = std::make_unique<IndexOutputNode<IndexID>>(&resultDataSet_,
-                                                                 planContext_.get(),
+        auto output = std::make_unique<IndexOutputNode<IndexID>>(result,
+                                                                 planCtx,
                                                                  vertex.get());
         output->addDependency(vertex.get());
         plan.addNode(std::move(indexScan));
@@ -386,22 +397,24 @@ template<typename REQ, typename RESP>
 std::unique_ptr<IndexOutputNode<IndexID>>
 LookupBaseProcessor<REQ, RESP>::buildPlanWithFilter(const cpp2::IndexQueryContext& ctx,
                                                     StoragePlan<IndexID>& plan,
+                                                    PlanContext* planCtx,
+                                                    nebula::DataSet* result,
                                                     StorageExpressionContext* exprCtx,
                                                     Expression* exp) {
     auto indexId = ctx.get_index_id();
     auto colHints = ctx.get_column_hints();
 
-    auto indexScan = std::make_unique<IndexScanNode<IndexID>>(planContext_.get(),
+    auto indexScan = std::make_unique<IndexScanNode<IndexID>>(planCtx,
                                                               indexId,
                                                               std::move(colHints));
 
     auto filter = std::make_unique<IndexFilterNode<IndexID>>(indexScan.get(),
                                                              exprCtx,
                                                              exp,
-                                                             planContext_->isEdge_);
+                                                             planCtx->isEdge_);
     filter->addDependency(indexScan.get());
-    auto output = std::make_unique<IndexOutputNode<IndexID>>(&resultDataSet_,
-                                                             planContext_.get(),
+    auto output = std::make_unique<IndexOutputNode<IndexID>>(result,
+                                                             planCtx,
                                                              filter.get(), true);
     output->addDependency(filter.get());
     plan.addNode(std::move(indexScan));
@@ -441,27 +454,29 @@ template<typename REQ, typename RESP>
 std::unique_ptr<IndexOutputNode<IndexID>>
 LookupBaseProcessor<REQ, RESP>::buildPlanWithDataAndFilter(const cpp2::IndexQueryContext& ctx,
                                                            StoragePlan<IndexID>& plan,
+                                                           PlanContext* planCtx,
+                                                           nebula::DataSet* result,
                                                            StorageExpressionContext* exprCtx,
                                                            Expression* exp) {
     auto indexId = ctx.get_index_id();
     auto colHints = ctx.get_column_hints();
 
-    auto indexScan = std::make_unique<IndexScanNode<IndexID>>(planContext_.get(),
+    auto indexScan = std::make_unique<IndexScanNode<IndexID>>(planCtx,
                                                               indexId,
                                                               std::move(colHints));
-    if (planContext_->isEdge_) {
-        auto edge = std::make_unique<IndexEdgeNode<IndexID>>(planContext_.get(),
+    if (planCtx->isEdge_) {
+        auto edge = std::make_unique<IndexEdgeNode<IndexID>>(planCtx,
                                                              indexScan.get(),
                                                              schemas_,
-                                                             planContext_->edgeName_);
+                                                             planCtx->edgeName_);
         edge->addDependency(indexScan.get());
         auto filter = std::make_unique<IndexFilterNode<IndexID>>(edge.get(),
                                                                  exprCtx,
                                                                  exp);
         filter->addDependency(edge.get());
 
-        auto output = std::make_unique<IndexOutputNode<IndexID>>(&resultDataSet_,
-                                                                 planContext_.get(),
+        auto output = std::make_unique<IndexOutputNode<IndexID>>(result,
+                                                                 planCtx,
                                                                  filter.get());
         output->addDependency(filter.get());
         plan.addNode(std::move(indexScan));
@@ -469,19 +484,19 @@ LookupBaseProcessor<REQ, RESP>::buildPlanWithDataAndFilter(const cpp2::IndexQuer
         plan.addNode(std::move(filter));
         return output;
     } else {
-        auto vertex = std::make_unique<IndexVertexNode<IndexID>>(planContext_.get(),
+        auto vertex = std::make_unique<IndexVertexNode<IndexID>>(planCtx,
                                                                  this->vertexCache_,
                                                                  indexScan.get(),
                                                                  schemas_,
-                                                                 planContext_->tagName_);
+                                                                 planCtx->tagName_);
         vertex->addDependency(indexScan.get());
         auto filter = std::make_unique<IndexFilterNode<IndexID>>(vertex.get(),
                                                                  exprCtx,
                                                                  exp);
         filter->addDependency(vertex.get());
 
-        auto output = std::make_unique<IndexOutputNode<IndexID>>(&resultDataSet_,
-                                                                 planContext_.get(),
+        auto output = std::make_unique<IndexOutputNode<IndexID>>(result,
+                                                                 planCtx,
                                                                  filter.get());
         output->addDependency(filter.get());
         plan.addNode(std::move(indexScan));
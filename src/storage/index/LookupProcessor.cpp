@@ -20,6 +20,7 @@ void LookupProcessor::process(const cpp2::LookupIndexRequest& req) {
         doProcess(req);
     }
 }
+
 void LookupProcessor::doProcess(const cpp2::LookupIndexRequest& req) {
     auto retCode = requestCheck(req);
     if (retCode != cpp2::ErrorCode::SUCCEEDED) {
@@ -30,7 +31,15 @@ void LookupProcessor::doProcess(const cpp2::LookupIndexRequest& req) {
         return;
     }
 
-    auto plan = buildPlan();
+    if (FLAGS_query_concurrently && req.get_parts().size() > 1) {
+        runInMultipleThread(req);
+    } else {
+        runInSingleThread(req);
+    }
+}
+
+void LookupProcessor::runInSingleThread(const cpp2::LookupIndexRequest& req) {
+    auto plan = buildPlan(planContext_.get(), &resultDataSet_, &filterItems_);
     if (!plan.ok()) {
         for (auto& p : req.get_parts()) {
             pushResultCode(cpp2::ErrorCode::E_INDEX_NOT_FOUND, p);
@@ -53,6 +62,61 @@ void LookupProcessor::doProcess(const cpp2::LookupIndexRequest& req) {
     onFinished();
 }
 
+void LookupProcessor::runInMultipleThread(const cpp2::LookupIndexRequest& req) {
+    tasks_.resize(req.get_parts().size());
+    for (size_t i = 0; i < tasks_.size(); i++) {
+        auto& task = tasks_[i];
+        task.partId_ = req.get_parts()[i];
+        task.planContext_ = std::make_unique<PlanContext>(*planContext_);
+        task.result_.colNames = resultDataSet_.colNames;
+        auto plan = buildPlan(task.planContext_.get(), &task.result_, &task.filterItems_);
+        if (!plan.ok()) {
+            for (auto& p : req.get_parts()) {
+                pushResultCode(cpp2::ErrorCode::E_INDEX_NOT_FOUND, p);
+            }
+            onFinished();
+            return;
+        }
+        task.plan_ = std::move(plan).value();
+    }
+
+    if (executor_ == nullptr) {
+        for (auto& task : tasks_) {
+            task.code_ = task.plan_.go(task.partId_);
+        }
+        mergeTaskResults();
+        onProcessFinished();
+        onFinished();
+        return;
+    }
+
+    runConcurrently(executor_,
+                    tasks_.size(),
+                    FLAGS_max_concurrent_tasks_per_query,
+                    [this] (size_t idx) {
+                        auto& task = tasks_[idx];
+                        task.code_ = task.plan_.go(task.partId_);
+                    })
+        .thenValue([this] (auto&&) {
+            mergeTaskResults();
+            onProcessFinished();
+            onFinished();
+        });
+}
+
+void LookupProcessor::mergeTaskResults() {
+    for (auto& task : tasks_) {
+        if (task.code_ != kvstore::ResultCode::SUCCEEDED) {
+            handleErrorCode(task.code_, spaceId_, task.partId_);
+            continue;
+        }
+        auto& rows = task.result_.rows;
+        resultDataSet_.rows.insert(resultDataSet_.rows.end(),
+                                   std::make_move_iterator(rows.begin()),
+                                   std::make_move_iterator(rows.end()));
+    }
+}
+
 void LookupProcessor::onProcessFinished() {
     if (planContext_->isEdge_) {
         std::transform(resultDataSet_.colNames.begin(),
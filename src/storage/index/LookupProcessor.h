@@ -9,6 +9,7 @@
 
 #include "common/base/Base.h"
 #include "storage/index/LookupBaseProcessor.h"
+#include "storage/StorageFlags.h"
 
 namespace nebula {
 namespace storage {
@@ -39,6 +40,26 @@ protected:
             env, counters, executor, cache) {}
 
     void onProcessFinished() override;
+
+    void runInSingleThread(const cpp2::LookupIndexRequest& req);
+
+    // Each part is a sub task with its own plan, run them in executor_ with at most
+    // --max_concurrent_tasks_per_query tasks at the same time.
+    void runInMultipleThread(const cpp2::LookupIndexRequest& req);
+
+private:
+    struct TaskContext {
+        PartitionID                                 partId_{0};
+        std::unique_ptr<PlanContext>                planContext_;
+        IndexFilterItem                             filterItems_;
+        nebula::DataSet                             result_;
+        StoragePlan<IndexID>                        plan_;
+        kvstore::ResultCode                         code_{kvstore::ResultCode::SUCCEEDED};
+    };
+
+    void mergeTaskResults();
+
+    std::vector<TaskContext>                        tasks_;
 };
 
 }  // namespace storage
@@ -22,9 +22,6 @@ namespace storage {
 
 ProcessorCounters kAddEdgesAtomicCounters;
 
-// use localPart vs remotePart to identify different channel.
-using ChainId = std::pair<PartitionID, PartitionID>;
-
 void AddEdgesAtomicProcessor::process(const cpp2::AddEdgesRequest& req) {
     propNames_ = req.get_prop_names();
     spaceId_ = req.get_space_id();
@@ -95,37 +92,31 @@ void AddEdgesAtomicProcessor::processByChain(const cpp2::AddEdgesRequest& req) {
         processor_->indexes_ = stIndex.value();
     }
 
-    std::list<folly::Future<folly::Unit>> futures;
-    for (auto& chain : edgesByChain) {
-        auto localPart = chain.first.first;
-        auto remotePart = chain.first.second;
-        auto& localData = chain.second;
-
-        futures.emplace_back(
-            env_->txnMan_
-                ->addSamePartEdges(
-                    vIdLen_, spaceId_, localPart, remotePart, localData, processor_.get())
-                .thenTry([=](auto&& t) {
-                    auto code = cpp2::ErrorCode::SUCCEEDED;
-                    if (!t.hasValue()) {
-                        code = cpp2::ErrorCode::E_UNKNOWN;
-                    } else if (t.value() != cpp2::ErrorCode::SUCCEEDED) {
-                        code = t.value();
-                    }
+    std::vector<PartitionID> parts;
+    for (auto& part : req.get_parts()) {
+        parts.emplace_back(part.first);
+    }
+    // all chains are committed in one transaction, so that the chains of the same
+    // remote part share one RPC request
+    env_->txnMan_
+        ->addEdgesByChains(vIdLen_, spaceId_, std::move(edgesByChain), processor_.get())
+        .thenTry([this, parts = std::move(parts)](auto&& t) {
+            if (!t.hasValue()) {
+                for (auto partId : parts) {
+                    pushResultCode(cpp2::ErrorCode::E_UNKNOWN, partId);
+                }
+            } else {
+                for (auto& part : t.value()) {
                     LOG_IF(INFO, FLAGS_trace_toss) << folly::sformat(
-                        "addSamePartEdges: (space,localPart,remotePart)=({},{},{}), code={}",
+                        "addEdgesByChains: (space,localPart)=({},{}), code={}",
                         spaceId_,
-                        localPart,
-                        remotePart,
-                        apache::thrift::util::enumNameSafe(code));
-                    if (code != cpp2::ErrorCode::SUCCEEDED) {
-                        pushResultCode(code, localPart);
-                    }
-                }));
-    }
-    folly::collectAll(futures).via(env_->txnMan_->getExecutor()).thenValue([=](auto&&){
-        onFinished();
-    });
+                        part.first,
+                        apache::thrift::util::enumNameSafe(part.second));
+                    pushResultCode(part.second, part.first);
+                }
+            }
+            onFinished();
+        });
 }
 
 cpp2::ErrorCode AddEdgesAtomicProcessor::encodeSingleEdgeProps(const cpp2::NewEdge& e,
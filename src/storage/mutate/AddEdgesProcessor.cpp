@@ -64,6 +64,16 @@ void AddEdgesProcessor::doProcess(const cpp2::AddEdgesRequest& req) {
         auto partId = part.first;
         const auto& newEdges = part.second;
 
+        std::unordered_map<std::string, std::string> oldValues;
+        if (ifNotExists_) {
+            auto ret = findOldValues(partId, newEdges);
+            if (!nebula::ok(ret)) {
+                handleAsync(spaceId_, partId, to(nebula::error(ret)));
+                continue;
+            }
+            oldValues = std::move(nebula::value(ret));
+        }
+
         std::vector<kvstore::KV> data;
         data.reserve(32);
         cpp2::ErrorCode code = cpp2::ErrorCode::SUCCEEDED;
@@ -93,19 +103,14 @@ void AddEdgesProcessor::doProcess(const cpp2::AddEdgesRequest& req) {
                                                *edgeKey.edge_type_ref(),
                                                *edgeKey.ranking_ref(),
                                                (*edgeKey.dst_ref()).getStr());
-           if (ifNotExists_) {
+            if (ifNotExists_) {
                 if (!visited.emplace(key).second) {
                     continue;
                 }
-                auto obsIdx = findOldValue(partId, key);
-                if (nebula::ok(obsIdx)) {
+                auto it = oldValues.find(key);
+                if (it != oldValues.end() && !it->second.empty()) {
                     // already exists in kvstore
-                    if (!nebula::value(obsIdx).empty()) {
-                        continue;
-                    }
-                } else {
-                    code = to(nebula::error(obsIdx));
-                    break;
+                    continue;
                 }
             }
             auto schema = env_->schemaMan_->getEdgeSchema(spaceId_,
@@ -149,6 +154,13 @@ void AddEdgesProcessor::doProcessWithIndex(const cpp2::AddEdgesRequest& req) {
         dummyLock.reserve(newEdges.size());
         cpp2::ErrorCode code = cpp2::ErrorCode::SUCCEEDED;
 
+        auto ret = findOldValues(partId, newEdges);
+        if (!nebula::ok(ret)) {
+            handleAsync(spaceId_, partId, to(nebula::error(ret)));
+            continue;
+        }
+        const auto& oldValues = nebula::value(ret);
+
         std::unordered_set<std::string> visited;
         visited.reserve(newEdges.size());
         for (auto& newEdge : newEdges) {
@@ -197,21 +209,16 @@ void AddEdgesProcessor::doProcessWithIndex(const cpp2::AddEdgesRequest& req) {
             if (*edgeKey.edge_type_ref() > 0) {
                 RowReaderWrapper nReader;
                 RowReaderWrapper oReader;
-                auto obsIdx = findOldValue(partId, key);
-                if (nebula::ok(obsIdx)) {
+                auto oldIter = oldValues.find(key);
+                if (oldIter != oldValues.end() && !oldIter->second.empty()) {
                     // already exists in kvstore
-                    if (ifNotExists_ && !nebula::value(obsIdx).empty()) {
+                    if (ifNotExists_) {
                         continue;
                     }
-                    if (!nebula::value(obsIdx).empty()) {
-                        oReader = RowReaderWrapper::getEdgePropReader(env_->schemaMan_,
-                                                                      spaceId_,
-                                                                      *edgeKey.edge_type_ref(),
-                                                                      nebula::value(obsIdx));
-                    }
-                } else {
-                    code = to(nebula::error(obsIdx));
-                    break;
+                    oReader = RowReaderWrapper::getEdgePropReader(env_->schemaMan_,
+                                                                  spaceId_,
+                                                                  *edgeKey.edge_type_ref(),
+                                                                  oldIter->second);
                 }
                 if (!retEnc.value().empty()) {
                     nReader = RowReaderWrapper::getEdgePropReader(env_->schemaMan_,
@@ -333,6 +340,23 @@ AddEdgesProcessor::addEdges(PartitionID partId, const std::vector<kvstore::KV>&
                       newEdges[e.first] = e.second;
                   });
 
+    // Read the old rows of all indexed edges at once
+    std::unordered_set<EdgeType> indexedTypes;
+    for (auto& index : indexes_) {
+        indexedTypes.emplace(index->get_schema_id().get_edge_type());
+    }
+    std::vector<std::string> keys;
+    for (auto& e : newEdges) {
+        if (indexedTypes.count(NebulaKeyUtils::getEdgeType(spaceVidLen_, e.first)) > 0) {
+            keys.emplace_back(e.first);
+        }
+    }
+    auto oldRet = doMultiGet(spaceId_, partId, keys);
+    if (!nebula::ok(oldRet)) {
+        return nebula::error(oldRet);
+    }
+    auto& oldValues = nebula::value(oldRet);
+
     for (auto& e : newEdges) {
         std::string val;
         RowReaderWrapper oReader;
@@ -349,11 +373,10 @@ AddEdgesProcessor::addEdges(PartitionID partId, const std::vector<kvstore::KV>&
                  * step 1 , Delete old version index if exists.
                  */
                 if (val.empty()) {
-                    auto obsIdx = findOldValue(partId, e.first);
-                    if (!nebula::ok(obsIdx)) {
-                        return nebula::error(obsIdx);
+                    auto oldIter = oldValues.find(e.first);
+                    if (oldIter != oldValues.end()) {
+                        val = std::move(oldIter->second);
                     }
-                    val = std::move(nebula::value(obsIdx));
                     if (!val.empty()) {
                         oReader = RowReaderWrapper::getEdgePropReader(env_->schemaMan_,
                                                                       spaceId_,
@@ -426,25 +449,32 @@ AddEdgesProcessor::addEdges(PartitionID partId, const std::vector<kvstore::KV>&
     return encodeBatchValue(batchHolder->getBatch());
 }
 
-ErrorOr<kvstore::ResultCode, std::string>
-AddEdgesProcessor::findOldValue(PartitionID partId, const folly::StringPiece& rawKey) {
-    auto prefix = NebulaKeyUtils::edgePrefix(spaceVidLen_,
-                                             partId,
-                                             NebulaKeyUtils::getSrcId(spaceVidLen_, rawKey).str(),
-                                             NebulaKeyUtils::getEdgeType(spaceVidLen_, rawKey),
-                                             NebulaKeyUtils::getRank(spaceVidLen_, rawKey),
-                                             NebulaKeyUtils::getDstId(spaceVidLen_, rawKey).str());
-    std::unique_ptr<kvstore::KVIterator> iter;
-    auto ret = env_->kvstore_->prefix(spaceId_, partId, prefix, &iter);
-    if (ret != kvstore::ResultCode::SUCCEEDED) {
-        LOG(ERROR) << "Error! ret = " << static_cast<int32_t>(ret)
-                   << ", spaceId " << spaceId_;
-        return ret;
-    }
-    if (iter && iter->valid()) {
-        return iter->val().str();
+ErrorOr<kvstore::ResultCode, std::unordered_map<std::string, std::string>>
+AddEdgesProcessor::findOldValues(PartitionID partId, const std::vector<cpp2::NewEdge>& edges) {
+    std::vector<std::string> keys;
+    std::unordered_set<std::string> visited;
+    for (auto& edge : edges) {
+        const auto& edgeKey = edge.get_key();
+        if (!indexes_.empty() && edgeKey.get_edge_type() < 0) {
+            // Only the out edges have indexes
+            continue;
+        }
+        if (!NebulaKeyUtils::isValidVidLen(
+                spaceVidLen_, edgeKey.get_src().getStr(), edgeKey.get_dst().getStr())) {
+            // Reported when the edge is written
+            continue;
+        }
+        auto key = NebulaKeyUtils::edgeKey(spaceVidLen_,
+                                           partId,
+                                           edgeKey.get_src().getStr(),
+                                           edgeKey.get_edge_type(),
+                                           edgeKey.get_ranking(),
+                                           edgeKey.get_dst().getStr());
+        if (visited.emplace(key).second) {
+            keys.emplace_back(std::move(key));
+        }
     }
-    return std::string();
+    return doMultiGet(spaceId_, partId, keys);
 }
 
 std::string AddEdgesProcessor::indexKey(PartitionID partId,
@@ -40,8 +40,10 @@ private:
     ErrorOr<kvstore::ResultCode, std::string> addEdges(PartitionID partId,
                                                        const std::vector<kvstore::KV>& edges);
 
-    ErrorOr<kvstore::ResultCode, std::string> findOldValue(PartitionID partId,
-                                                           const folly::StringPiece& rawKey);
+    // The current rows of all edges to write in a part are read by one multiGet before the
+    // index keys are computed, keyed by the edge key
+    ErrorOr<kvstore::ResultCode, std::unordered_map<std::string, std::string>>
+    findOldValues(PartitionID partId, const std::vector<cpp2::NewEdge>& edges);
 
     std::string indexKey(PartitionID partId,
                          RowReader* reader,
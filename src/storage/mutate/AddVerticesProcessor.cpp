@@ -65,6 +65,16 @@ void AddVerticesProcessor::doProcess(const cpp2::AddVerticesRequest& req) {
         auto partId = part.first;
         const auto& vertices = part.second;
 
+        std::unordered_map<std::string, std::string> oldValues;
+        if (ifNotExists_) {
+            auto ret = findOldValues(partId, vertices);
+            if (!nebula::ok(ret)) {
+                handleAsync(spaceId_, partId, to(nebula::error(ret)));
+                continue;
+            }
+            oldValues = std::move(nebula::value(ret));
+        }
+
         std::vector<kvstore::KV> data;
         data.reserve(32);
         cpp2::ErrorCode code = cpp2::ErrorCode::SUCCEEDED;
@@ -98,14 +108,9 @@ void AddVerticesProcessor::doProcess(const cpp2::AddVerticesRequest& req) {
                     if (!visited.emplace(key).second) {
                         continue;
                     }
-                    auto obsIdx = findOldValue(partId, vid, tagId);
-                    if (nebula::ok(obsIdx)) {
-                        if (!nebula::value(obsIdx).empty()) {
-                            continue;
-                        }
-                    } else {
-                        code = to(nebula::error(obsIdx));
-                        break;
+                    auto it = oldValues.find(key);
+                    if (it != oldValues.end() && !it->second.empty()) {
+                        continue;
                     }
                 }
                 auto props = newTag.get_props();
@@ -152,6 +157,13 @@ void AddVerticesProcessor::doProcessWithIndex(const cpp2::AddVerticesRequest& re
         dummyLock.reserve(vertices.size());
         cpp2::ErrorCode code = cpp2::ErrorCode::SUCCEEDED;
 
+        auto ret = findOldValues(partId, vertices);
+        if (!nebula::ok(ret)) {
+            handleAsync(spaceId_, partId, to(nebula::error(ret)));
+            continue;
+        }
+        const auto& oldValues = nebula::value(ret);
+
         // cache vertexKey
         std::unordered_set<std::string> visited;
         visited.reserve(vertices.size());
@@ -191,20 +203,15 @@ void AddVerticesProcessor::doProcessWithIndex(const cpp2::AddVerticesRequest& re
 
                 RowReaderWrapper nReader;
                 RowReaderWrapper oReader;
-                auto obsIdx = findOldValue(partId, vid, tagId);
-                if (nebula::ok(obsIdx)) {
-                    if (ifNotExists_ && !nebula::value(obsIdx).empty()) {
+                auto oldIter = oldValues.find(key);
+                if (oldIter != oldValues.end() && !oldIter->second.empty()) {
+                    if (ifNotExists_) {
                         continue;
                     }
-                    if (!nebula::value(obsIdx).empty()) {
-                        oReader = RowReaderWrapper::getTagPropReader(env_->schemaMan_,
-                                                                     spaceId_,
-                                                                     tagId,
-                                                                     nebula::value(obsIdx));
-                    }
-                } else {
-                    code = to(nebula::error(obsIdx));
-                    break;
+                    oReader = RowReaderWrapper::getTagPropReader(env_->schemaMan_,
+                                                                 spaceId_,
+                                                                 tagId,
+                                                                 oldIter->second);
                 }
 
                 WriteResult wRet;
@@ -316,20 +323,25 @@ void AddVerticesProcessor::doProcessWithIndex(const cpp2::AddVerticesRequest& re
     }
 }
 
-ErrorOr<kvstore::ResultCode, std::string>
-AddVerticesProcessor::findOldValue(PartitionID partId, const VertexID& vId, TagID tagId) {
-    auto prefix = NebulaKeyUtils::vertexPrefix(spaceVidLen_, partId, vId, tagId);
-    std::unique_ptr<kvstore::KVIterator> iter;
-    auto ret = env_->kvstore_->prefix(spaceId_, partId, prefix, &iter);
-    if (ret != kvstore::ResultCode::SUCCEEDED) {
-        LOG(ERROR) << "Error! ret = " << static_cast<int32_t>(ret)
-                   << ", spaceId " << spaceId_;
-        return ret;
-    }
-    if (iter && iter->valid()) {
-        return iter->val().str();
+ErrorOr<kvstore::ResultCode, std::unordered_map<std::string, std::string>>
+AddVerticesProcessor::findOldValues(PartitionID partId,
+                                    const std::vector<cpp2::NewVertex>& vertices) {
+    std::vector<std::string> keys;
+    std::unordered_set<std::string> visited;
+    for (auto& vertex : vertices) {
+        auto vid = vertex.get_id().getStr();
+        if (!NebulaKeyUtils::isValidVidLen(spaceVidLen_, vid)) {
+            // Reported when the vertex is written
+            continue;
+        }
+        for (auto& newTag : vertex.get_tags()) {
+            auto key = NebulaKeyUtils::vertexKey(spaceVidLen_, partId, vid, newTag.get_tag_id());
+            if (visited.emplace(key).second) {
+                keys.emplace_back(std::move(key));
+            }
+        }
     }
-    return std::string();
+    return doMultiGet(spaceId_, partId, keys);
 }
 
 std::string AddVerticesProcessor::indexKey(PartitionID partId,
@@ -8,7 +8,6 @@
 #define STORAGE_MUTATE_ADDVERTICESPROCESSOR_H_
 
 #include "common/base/Base.h"
-#include "common/base/ConcurrentLRUCache.h"
 #include "storage/BaseProcessor.h"
 #include "storage/CommonUtils.h"
 #include "kvstore/LogEncoder.h"
@@ -40,9 +39,10 @@ private:
         : BaseProcessor<cpp2::ExecResponse>(env, counters)
         , vertexCache_(cache) {}
 
-    ErrorOr<kvstore::ResultCode, std::string> findOldValue(PartitionID partId,
-                                                           const VertexID& vId,
-                                                           TagID tagId);
+    // The current rows of all vertices to write in a part are read by one multiGet before
+    // the index keys are computed, keyed by the vertex key
+    ErrorOr<kvstore::ResultCode, std::unordered_map<std::string, std::string>>
+    findOldValues(PartitionID partId, const std::vector<cpp2::NewVertex>& vertices);
 
     std::string indexKey(PartitionID partId, const VertexID& vId, RowReader* reader,
                          std::shared_ptr<nebula::meta::cpp2::IndexItem> index);
@@ -16,7 +16,7 @@
 namespace nebula {
 namespace storage {
 
-ProcessorCounters kGetNeighborsCounters;
+GetNeighborsCounters kGetNeighborsCounters;
 
 void GetNeighborsProcessor::process(const cpp2::GetNeighborsRequest& req) {
     if (executor_ != nullptr) {
@@ -61,12 +61,25 @@ void GetNeighborsProcessor::doProcess(const cpp2::GetNeighborsRequest& req) {
         }
     }
 
-    auto plan = buildPlan(&resultDataSet_, limit, random);
-    std::unordered_set<PartitionID> failedParts;
+    if (FLAGS_query_concurrently) {
+        runInMultipleThread(req, limit, random);
+    } else {
+        runInSingleThread(req, limit, random);
+    }
+}
+
+void GetNeighborsProcessor::runInSingleThread(const cpp2::GetNeighborsRequest& req,
+                                              int64_t limit,
+                                              bool random) {
+    auto plan = buildPlan(planContext_.get(), expCtx_.get(), filter_.get(),
+                          &resultDataSet_, limit, random);
     for (const auto& partEntry : req.get_parts()) {
         auto partId = partEntry.first;
+        std::vector<VertexID> vIds;
+        vIds.reserve(partEntry.second.size());
         for (const auto& row : partEntry.second) {
             CHECK_GE(row.values.size(), 1);
+            // the first column of each row would be the vertex id
             auto vId = row.values[0].getStr();
 
             if (!NebulaKeyUtils::isValidVidLen(spaceVidLen_, vId)) {
@@ -76,22 +89,111 @@ void GetNeighborsProcessor::doProcess(const cpp2::GetNeighborsRequest& req) {
                 onFinished();
                 return;
             }
+            vIds.emplace_back(std::move(vId));
+        }
 
-            // the first column of each row would be the vertex id
-            auto ret = plan.go(partId, vId);
-            if (ret != kvstore::ResultCode::SUCCEEDED) {
-                if (failedParts.find(partId) == failedParts.end()) {
-                    failedParts.emplace(partId);
-                    handleErrorCode(ret, spaceId_, partId);
-                }
-            }
+        auto ret = goVertices(plan, planContext_.get(), partId, vIds);
+        if (ret != kvstore::ResultCode::SUCCEEDED) {
+            handleErrorCode(ret, spaceId_, partId);
         }
     }
     onProcessFinished();
     onFinished();
 }
 
-StoragePlan<VertexID> GetNeighborsProcessor::buildPlan(nebula::DataSet* result,
+void GetNeighborsProcessor::runInMultipleThread(const cpp2::GetNeighborsRequest& req,
+                                                int64_t limit,
+                                                bool random) {
+    for (const auto& partEntry : req.get_parts()) {
+        auto partId = partEntry.first;
+        const auto& rows = partEntry.second;
+        size_t batch = rows.size();
+        if (FLAGS_max_vids_per_query_task > 0) {
+            batch = std::min(batch, static_cast<size_t>(FLAGS_max_vids_per_query_task));
+        }
+        for (size_t begin = 0; begin < rows.size(); begin += batch) {
+            TaskContext task;
+            task.partId_ = partId;
+            auto end = std::min(rows.size(), begin + batch);
+            task.vIds_.reserve(end - begin);
+            for (auto i = begin; i < end; i++) {
+                CHECK_GE(rows[i].values.size(), 1);
+                auto vId = rows[i].values[0].getStr();
+                if (!NebulaKeyUtils::isValidVidLen(spaceVidLen_, vId)) {
+                    LOG(ERROR) << "Space " << spaceId_ << ", vertex length invalid, "
+                               << " space vid len: " << spaceVidLen_ << ",  vid is " << vId;
+                    pushResultCode(cpp2::ErrorCode::E_INVALID_VID, partId);
+                    onFinished();
+                    return;
+                }
+                task.vIds_.emplace_back(std::move(vId));
+            }
+            tasks_.emplace_back(std::move(task));
+        }
+    }
+
+    // The plan keeps raw pointers to the members of its task, so build them only after all
+    // tasks have been put into tasks_.
+    for (auto& task : tasks_) {
+        task.planContext_ = std::make_unique<PlanContext>(env_, spaceId_, spaceVidLen_, isIntId_);
+        task.expCtx_ = std::make_unique<StorageExpressionContext>(spaceVidLen_, isIntId_);
+        if (filter_) {
+            task.filter_ = filter_->clone();
+        }
+        task.plan_ = buildPlan(task.planContext_.get(), task.expCtx_.get(), task.filter_.get(),
+                               &task.result_, limit, random);
+    }
+
+    if (executor_ == nullptr || tasks_.size() <= 1) {
+        for (auto& task : tasks_) {
+            runTask(task);
+        }
+        mergeTaskResults();
+        onProcessFinished();
+        onFinished();
+        return;
+    }
+
+    runConcurrently(executor_,
+                    tasks_.size(),
+                    FLAGS_max_concurrent_tasks_per_query,
+                    [this] (size_t idx) { runTask(tasks_[idx]); })
+        .thenValue([this] (auto&&) {
+            mergeTaskResults();
+            onProcessFinished();
+            onFinished();
+        });
+}
+
+void GetNeighborsProcessor::runTask(TaskContext& task) {
+    time::Duration duration;
+    task.code_ = goVertices(task.plan_, task.planContext_.get(), task.partId_, task.vIds_);
+    auto* counters = dynamic_cast<const GetNeighborsCounters*>(counters_);
+    if (counters != nullptr) {
+        stats::StatsManager::addValue(counters->numTasks_);
+        stats::StatsManager::addValue(counters->taskLatency_, duration.elapsedInUSec());
+    }
+}
+
+void GetNeighborsProcessor::mergeTaskResults() {
+    // merge in the order of tasks, so rows of the same part keep the order of request
+    std::unordered_set<PartitionID> failedParts;
+    for (auto& task : tasks_) {
+        if (task.code_ != kvstore::ResultCode::SUCCEEDED &&
+            failedParts.emplace(task.partId_).second) {
+            handleErrorCode(task.code_, spaceId_, task.partId_);
+        }
+        auto& rows = task.result_.rows;
+        resultDataSet_.rows.insert(resultDataSet_.rows.end(),
+                                   std::make_move_iterator(rows.begin()),
+                                   std::make_move_iterator(rows.end()));
+    }
+}
+
+StoragePlan<VertexID> GetNeighborsProcessor::buildPlan(PlanContext* planCtx,
+                                                       StorageExpressionContext* expCtx,
+                                                       Expression* filter,
+                                                       nebula::DataSet* result,
                                                        int64_t limit,
                                                        bool random) {
     /*
@@ -114,46 +216,60 @@ StoragePlan<VertexID> GetNeighborsProcessor::buildPlan(nebula::DataSet* result,
     +--------+---------+        +---------+--------+
     |     TagNodes     |        |     EdgeNodes    |
     +------------------+        +------------------+
+    When there are more than one edge types and toss is disabled, the EdgeNodes would be a
+    FusedEdgeNode which scans all edge types of a vertex with one iterator. The adjacency cache
+    is kept per edge type, so SingleEdgeNodes are used when it is enabled.
     */
     StoragePlan<VertexID> plan;
     std::vector<TagNode*> tags;
     for (const auto& tc : tagContext_.propContexts_) {
         auto tag = std::make_unique<TagNode>(
-                planContext_.get(), &tagContext_, tc.first, &tc.second);
+                planCtx, &tagContext_, tc.first, &tc.second);
         tags.emplace_back(tag.get());
         plan.addNode(std::move(tag));
     }
-    std::vector<EdgeNode<VertexID>*> edges;
-    for (const auto& ec : edgeContext_.propContexts_) {
-        auto edge = std::make_unique<SingleEdgeNode>(
-                planContext_.get(), &edgeContext_, ec.first, &ec.second);
-        edges.emplace_back(edge.get());
+    std::unique_ptr<HashJoinNode> hashJoin;
+    bool enableToss = env_->txnMan_ && env_->txnMan_->enableToss(spaceId_);
+    bool enableAdjCache = FLAGS_enable_adjacency_cache && env_->adjCache_ != nullptr;
+    if (edgeContext_.propContexts_.size() > 1 && !enableToss && !enableAdjCache) {
+        // scan all edge types of a vertex by one iterator
+        auto edge = std::make_unique<FusedEdgeNode>(planCtx, &edgeContext_);
+        hashJoin = std::make_unique<HashJoinNode>(
+                planCtx, tags, edge.get(), &tagContext_, &edgeContext_, expCtx);
+        hashJoin->addDependency(edge.get());
         plan.addNode(std::move(edge));
+    } else {
+        std::vector<EdgeNode<VertexID>*> edges;
+        for (const auto& ec : edgeContext_.propContexts_) {
+            auto edge = std::make_unique<SingleEdgeNode>(
+                    planCtx, &edgeContext_, ec.first, &ec.second);
+            edges.emplace_back(edge.get());
+            plan.addNode(std::move(edge));
+        }
+        hashJoin = std::make_unique<HashJoinNode>(
+                planCtx, tags, edges, &tagContext_, &edgeContext_, expCtx);
+        for (auto* edge : edges) {
+            hashJoin->addDependency(edge);
+        }
     }
-
-    auto hashJoin = std::make_unique<HashJoinNode>(
-            planContext_.get(), tags, edges, &tagContext_, &edgeContext_, expCtx_.get());
     for (auto* tag : tags) {
         hashJoin->addDependency(tag);
     }
-    for (auto* edge : edges) {
-        hashJoin->addDependency(edge);
-    }
     IterateNode<VertexID>* join = hashJoin.get();
     IterateNode<VertexID>* upstream = hashJoin.get();
     plan.addNode(std::move(hashJoin));
 
-    if (filter_) {
-        auto filter = std::make_unique<FilterNode<VertexID>>(
-                planContext_.get(), upstream, expCtx_.get(), filter_.get());
-        filter->addDependency(upstream);
-        upstream = filter.get();
-        plan.addNode(std::move(filter));
+    if (filter != nullptr) {
+        auto filterNode = std::make_unique<FilterNode<VertexID>>(
+                planCtx, upstream, expCtx, filter);
+        filterNode->addDependency(upstream);
+        upstream = filterNode.get();
+        plan.addNode(std::move(filterNode));
     }
 
     if (edgeContext_.statCount_ > 0) {
         auto agg = std::make_unique<AggregateNode<VertexID>>(
-                planContext_.get(), upstream, &edgeContext_);
+                planCtx, upstream, &edgeContext_);
         agg->addDependency(upstream);
         upstream = agg.get();
         plan.addNode(std::move(agg));
@@ -162,10 +278,10 @@ StoragePlan<VertexID> GetNeighborsProcessor::buildPlan(nebula::DataSet* result,
     std::unique_ptr<GetNeighborsNode> output;
     if (random) {
         output = std::make_unique<GetNeighborsSampleNode>(
-                planContext_.get(), join, upstream, &edgeContext_, result, limit);
+                planCtx, join, upstream, &edgeContext_, result, limit);
     } else {
         output = std::make_unique<GetNeighborsNode>(
-                planContext_.get(), join, upstream, &edgeContext_, result, limit);
+                planCtx, join, upstream, &edgeContext_, result, limit);
     }
     output->addDependency(upstream);
     plan.addNode(std::move(output));
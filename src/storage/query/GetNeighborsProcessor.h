@@ -15,7 +15,26 @@
 namespace nebula {
 namespace storage {
 
-extern ProcessorCounters kGetNeighborsCounters;
+struct GetNeighborsCounters final : public ProcessorCounters {
+    // sub tasks and their latency when a request is split by --query_concurrently
+    stats::CounterId numTasks_;
+    stats::CounterId taskLatency_;
+
+    void init(const std::string& counterName) override {
+        ProcessorCounters::init(counterName);
+        if (!numTasks_.valid()) {
+            numTasks_ = stats::StatsManager::registerStats("num_" + counterName + "_tasks",
+                                                           "rate, sum");
+            taskLatency_ = stats::StatsManager::registerHisto(counterName + "_task_latency_us",
+                                                              1000,
+                                                              0,
+                                                              20000,
+                                                              "avg, p75, p95, p99");
+        }
+    }
+};
+
+extern GetNeighborsCounters kGetNeighborsCounters;
 
 class GetNeighborsProcessor
     : public QueryBaseProcessor<cpp2::GetNeighborsRequest, cpp2::GetNeighborsResponse> {
@@ -45,10 +64,36 @@ protected:
                                                          executor,
                                                          cache) {}
 
-    StoragePlan<VertexID> buildPlan(nebula::DataSet* result,
+    // Each sub task owns a plan and everything the plan would modify during execution,
+    // so sub tasks of the same request could run in different threads.
+    struct TaskContext {
+        PartitionID                                 partId_{0};
+        std::vector<VertexID>                       vIds_;
+        std::unique_ptr<PlanContext>                planContext_;
+        std::unique_ptr<StorageExpressionContext>   expCtx_;
+        std::unique_ptr<Expression>                 filter_;
+        nebula::DataSet                             result_;
+        StoragePlan<VertexID>                       plan_;
+        kvstore::ResultCode                         code_{kvstore::ResultCode::SUCCEEDED};
+    };
+
+    StoragePlan<VertexID> buildPlan(PlanContext* planCtx,
+                                    StorageExpressionContext* expCtx,
+                                    Expression* filter,
+                                    nebula::DataSet* result,
                                     int64_t limit = 0,
                                     bool random = false);
 
+    void runInSingleThread(const cpp2::GetNeighborsRequest& req, int64_t limit, bool random);
+
+    // Split the request into sub tasks of at most --max_vids_per_query_task vertices, and run
+    // them in executor_ with at most --max_concurrent_tasks_per_query tasks at the same time.
+    void runInMultipleThread(const cpp2::GetNeighborsRequest& req, int64_t limit, bool random);
+
+    void runTask(TaskContext& task);
+
+    void mergeTaskResults();
+
     void onProcessFinished() override;
 
     cpp2::ErrorCode checkAndBuildContexts(const cpp2::GetNeighborsRequest& req) override;
@@ -66,6 +111,9 @@ protected:
 
 private:
     std::unique_ptr<StorageExpressionContext> expCtx_;
+
+    // used when running concurrently, tasks_ would not be resized once tasks are dispatched
+    std::vector<TaskContext>                  tasks_;
 };
 
 }  // namespace storage
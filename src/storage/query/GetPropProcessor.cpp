@@ -48,6 +48,8 @@ void GetPropProcessor::doProcess(const cpp2::GetPropRequest& req) {
         auto plan = buildTagPlan(&resultDataSet_);
         for (const auto& partEntry : req.get_parts()) {
             auto partId = partEntry.first;
+            std::vector<VertexID> vIds;
+            vIds.reserve(partEntry.second.size());
             for (const auto& row : partEntry.second) {
                 auto vId = row.values[0].getStr();
 
@@ -58,13 +60,12 @@ void GetPropProcessor::doProcess(const cpp2::GetPropRequest& req) {
                     onFinished();
                     return;
                 }
+                vIds.emplace_back(std::move(vId));
+            }
 
-                auto ret = plan.go(partId, vId);
-                if (ret != kvstore::ResultCode::SUCCEEDED &&
-                    failedParts.find(partId) == failedParts.end()) {
-                    failedParts.emplace(partId);
-                    handleErrorCode(ret, spaceId_, partId);
-                }
+            auto ret = goVertices(plan, planContext_.get(), partId, vIds);
+            if (ret != kvstore::ResultCode::SUCCEEDED) {
+                handleErrorCode(ret, spaceId_, partId);
             }
         }
     } else {
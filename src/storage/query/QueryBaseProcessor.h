@@ -166,6 +166,8 @@ protected:
     cpp2::ErrorCode handleEdgeProps(std::vector<cpp2::EdgeProp>& edgeProps);
 
     cpp2::ErrorCode buildFilter(const REQ& req);
+    // decode the encoded filter into filter_, and add the props it needs into the contexts
+    cpp2::ErrorCode buildFilter(const std::string& filterStr);
     cpp2::ErrorCode buildYields(const REQ& req);
 
     // build ttl info map
@@ -194,6 +196,21 @@ protected:
             bool filtered,
             const std::pair<size_t, cpp2::StatType>* statInfo = nullptr);
 
+    // Read the vertices of all tags in tagContext_ by one multiGet and save them in
+    // planCtx->vertices_, which would be used by TagNode instead of a prefix scan per vertex
+    kvstore::ResultCode prefetchVertices(PlanContext* planCtx,
+                                         PartitionID partId,
+                                         std::vector<VertexID>::const_iterator begin,
+                                         std::vector<VertexID>::const_iterator end);
+
+    // Run the plan on each vertex of a part, the vertices are prefetched in batches of
+    // --vertex_multiget_batch_size. Return the first error met.
+    template <typename Plan>
+    kvstore::ResultCode goVertices(Plan& plan,
+                                   PlanContext* planCtx,
+                                   PartitionID partId,
+                                   const std::vector<VertexID>& vIds);
+
 protected:
     GraphSpaceID                                        spaceId_;
     folly::Executor*                                    executor_{nullptr};
@@ -7,6 +7,7 @@
 DECLARE_int32(max_handlers_per_req);
 DECLARE_int32(min_vertices_per_bucket);
 DECLARE_bool(enable_vertex_cache);
+DECLARE_int32(vertex_multiget_batch_size);
 
 namespace nebula {
 namespace storage {
@@ -139,7 +140,11 @@ cpp2::ErrorCode QueryBaseProcessor<REQ, RESP>::buildFilter(const REQ& req) {
     if (!traverseSpec.filter_ref().has_value()) {
         return cpp2::ErrorCode::SUCCEEDED;
     }
-    const auto& filterStr = *traverseSpec.filter_ref();
+    return buildFilter(*traverseSpec.filter_ref());
+}
+
+template<typename REQ, typename RESP>
+cpp2::ErrorCode QueryBaseProcessor<REQ, RESP>::buildFilter(const std::string& filterStr) {
     if (!filterStr.empty()) {
         // the filter expression **must** return a bool
         filter_ = std::move(Expression::decode(filterStr));
@@ -607,5 +612,75 @@ void QueryBaseProcessor<REQ, RESP>::addPropContextIfNotExists(
     }
 }
 
+template<typename REQ, typename RESP>
+kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::prefetchVertices(
+        PlanContext* planCtx,
+        PartitionID partId,
+        std::vector<VertexID>::const_iterator begin,
+        std::vector<VertexID>::const_iterator end) {
+    planCtx->vertices_.clear();
+    std::vector<std::string> keys;
+    keys.reserve(std::distance(begin, end) * tagContext_.propContexts_.size());
+    for (auto it = begin; it != end; ++it) {
+        for (const auto& tc : tagContext_.propContexts_) {
+            keys.emplace_back(NebulaKeyUtils::vertexKey(planCtx->vIdLen_, partId, *it, tc.first));
+        }
+    }
+    if (keys.empty()) {
+        return kvstore::ResultCode::SUCCEEDED;
+    }
+
+    std::vector<std::string> values;
+    auto ret = this->env_->kvstore_->multiGet(spaceId_, partId, keys, &values);
+    if (ret.first != kvstore::ResultCode::SUCCEEDED &&
+        ret.first != kvstore::ResultCode::ERR_PARTIAL_RESULT) {
+        return ret.first;
+    }
+    // The vertex key has no version, so a missing key means the vertex does not exist. Keys met
+    // other errors are left out, and TagNode would read them by prefix again.
+    const auto& status = ret.second;
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (status[i].ok()) {
+            planCtx->vertices_.emplace(std::move(keys[i]), std::move(values[i]));
+        } else if (status[i].isKeyNotFound()) {
+            planCtx->vertices_.emplace(std::move(keys[i]), folly::none);
+        }
+    }
+    return kvstore::ResultCode::SUCCEEDED;
+}
+
+template<typename REQ, typename RESP>
+template<typename Plan>
+kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::goVertices(Plan& plan,
+                                                              PlanContext* planCtx,
+                                                              PartitionID partId,
+                                                              const std::vector<VertexID>& vIds) {
+    auto code = kvstore::ResultCode::SUCCEEDED;
+    size_t batch = vIds.size();
+    bool prefetch = FLAGS_vertex_multiget_batch_size > 0 && !tagContext_.propContexts_.empty();
+    if (prefetch) {
+        batch = static_cast<size_t>(FLAGS_vertex_multiget_batch_size);
+    }
+    for (size_t begin = 0; begin < vIds.size(); begin += batch) {
+        auto end = std::min(vIds.size(), begin + batch);
+        if (prefetch) {
+            auto ret = prefetchVertices(planCtx, partId, vIds.begin() + begin, vIds.begin() + end);
+            if (ret != kvstore::ResultCode::SUCCEEDED) {
+                VLOG(1) << "Prefetch vertices of part " << partId << " failed, code "
+                        << static_cast<int32_t>(ret);
+            }
+        }
+        for (auto i = begin; i < end; i++) {
+            auto ret = plan.go(partId, vIds[i]);
+            if (ret != kvstore::ResultCode::SUCCEEDED &&
+                code == kvstore::ResultCode::SUCCEEDED) {
+                code = ret;
+            }
+        }
+    }
+    planCtx->vertices_.clear();
+    return code;
+}
+
 }  // namespace storage
 }  // namespace nebula
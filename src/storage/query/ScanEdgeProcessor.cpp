@@ -60,10 +60,15 @@ void ScanEdgeProcessor::doProcess(const cpp2::ScanEdgeRequest& req) {
     }
 
     auto rowLimit = req.get_limit();
+    auto bytesLimit = FLAGS_max_scan_bytes_per_response;
+    int64_t readBytes = 0;
     RowReaderWrapper reader;
 
-    for (int64_t rowCount = 0; iter->valid() && rowCount < rowLimit; iter->next()) {
+    for (int64_t rowCount = 0;
+         iter->valid() && rowCount < rowLimit && (bytesLimit <= 0 || readBytes < bytesLimit);
+         iter->next()) {
         auto key = iter->key();
+        readBytes += key.size() + iter->val().size();
         if (!NebulaKeyUtils::isEdge(spaceVidLen_, key)) {
             continue;
         }
@@ -81,6 +86,9 @@ void ScanEdgeProcessor::doProcess(const cpp2::ScanEdgeRequest& req) {
         if (!reader) {
             continue;
         }
+        if (compiledFilter_ != nullptr && !compiledFilter_->check(reader.get(), key)) {
+            continue;
+        }
 
         nebula::List list;
         auto idx = edgeIter->second;
@@ -111,8 +119,34 @@ cpp2::ErrorCode ScanEdgeProcessor::checkAndBuildContexts(const cpp2::ScanEdgeReq
 
     std::vector<cpp2::EdgeProp> returnProps = {*req.return_columns_ref()};
     ret = handleEdgeProps(returnProps);
+    if (ret != cpp2::ErrorCode::SUCCEEDED) {
+        return ret;
+    }
     buildEdgeColName(returnProps);
-    return ret;
+    return buildScanFilter(req);
+}
+
+cpp2::ErrorCode ScanEdgeProcessor::buildScanFilter(const cpp2::ScanEdgeRequest& req) {
+    if (!req.filter_ref().has_value() || req.filter_ref()->empty()) {
+        return cpp2::ErrorCode::SUCCEEDED;
+    }
+    auto ret = buildFilter(*req.filter_ref());
+    if (ret != cpp2::ErrorCode::SUCCEEDED) {
+        return ret;
+    }
+    if (edgeContext_.propContexts_.size() != 1 || !tagContext_.propContexts_.empty()) {
+        VLOG(1) << "The filter of scan refers to other edge types or tags";
+        return cpp2::ErrorCode::E_INVALID_FILTER;
+    }
+    auto edgeType = edgeContext_.propContexts_.front().first;
+    expCtx_ = std::make_unique<StorageExpressionContext>(
+        spaceVidLen_,
+        isIntId_,
+        edgeContext_.edgeNames_[edgeType],
+        edgeContext_.schemas_[std::abs(edgeType)].back().get(),
+        true);
+    compiledFilter_ = CompiledFilter::compile(filter_.get(), expCtx_.get());
+    return cpp2::ErrorCode::SUCCEEDED;
 }
 
 void ScanEdgeProcessor::buildEdgeColName(const std::vector<cpp2::EdgeProp>& edgeProps) {
@@ -9,12 +9,18 @@
 
 #include "common/base/Base.h"
 #include "storage/query/QueryBaseProcessor.h"
+#include "storage/context/StorageExpressionContext.h"
+#include "storage/exec/CompiledFilter.h"
 
 namespace nebula {
 namespace storage {
 
 extern ProcessorCounters kScanEdgeCounters;
 
+// Scans the edges of the single part of the request, from its cursor. The rows are filtered
+// before they are built, and the scan stops at the row limit or the byte budget.
+// TODO: scan a set of parts concurrently and return a cursor per part, which needs
+// ScanEdgeRequest in the common thrift definitions to carry them first.
 class ScanEdgeProcessor
     : public QueryBaseProcessor<cpp2::ScanEdgeRequest, cpp2::ScanEdgeResponse> {
 public:
@@ -43,9 +49,14 @@ private:
 
     void buildEdgeColName(const std::vector<cpp2::EdgeProp>& edgeProps);
 
+    // The filter may only refer to the props of the scanned edge type
+    cpp2::ErrorCode buildScanFilter(const cpp2::ScanEdgeRequest& req);
+
     void onProcessFinished() override;
 
-    PartitionID partId_;
+    PartitionID                                     partId_;
+    std::unique_ptr<StorageExpressionContext>       expCtx_;
+    std::unique_ptr<CompiledFilter>                 compiledFilter_;
 };
 
 }  // namespace storage
@@ -60,9 +60,14 @@ void ScanVertexProcessor::doProcess(const cpp2::ScanVertexRequest& req) {
     }
 
     auto rowLimit = req.get_limit();
+    auto bytesLimit = FLAGS_max_scan_bytes_per_response;
+    int64_t readBytes = 0;
     RowReaderWrapper reader;
-    for (int64_t rowCount = 0; iter->valid() && rowCount < rowLimit; iter->next()) {
+    for (int64_t rowCount = 0;
+         iter->valid() && rowCount < rowLimit && (bytesLimit <= 0 || readBytes < bytesLimit);
+         iter->next()) {
         auto key = iter->key();
+        readBytes += key.size() + iter->val().size();
 
         auto tagId = NebulaKeyUtils::getTagId(spaceVidLen_, key);
         auto tagIter = tagContext_.indexMap_.find(tagId);
@@ -77,6 +82,9 @@ void ScanVertexProcessor::doProcess(const cpp2::ScanVertexRequest& req) {
         if (!reader) {
             continue;
         }
+        if (compiledFilter_ != nullptr && !compiledFilter_->check(reader.get(), key)) {
+            continue;
+        }
 
         nebula::List list;
         auto idx = tagIter->second;
@@ -107,8 +115,33 @@ cpp2::ErrorCode ScanVertexProcessor::checkAndBuildContexts(const cpp2::ScanVerte
 
     std::vector<cpp2::VertexProp> returnProps = {*req.return_columns_ref()};
     ret = handleVertexProps(returnProps);
+    if (ret != cpp2::ErrorCode::SUCCEEDED) {
+        return ret;
+    }
     buildTagColName(returnProps);
-    return ret;
+    return buildScanFilter(req);
+}
+
+cpp2::ErrorCode ScanVertexProcessor::buildScanFilter(const cpp2::ScanVertexRequest& req) {
+    if (!req.filter_ref().has_value() || req.filter_ref()->empty()) {
+        return cpp2::ErrorCode::SUCCEEDED;
+    }
+    auto ret = buildFilter(*req.filter_ref());
+    if (ret != cpp2::ErrorCode::SUCCEEDED) {
+        return ret;
+    }
+    if (tagContext_.propContexts_.size() != 1) {
+        VLOG(1) << "The filter of scan refers to other tags";
+        return cpp2::ErrorCode::E_INVALID_FILTER;
+    }
+    auto tagId = tagContext_.propContexts_.front().first;
+    expCtx_ = std::make_unique<StorageExpressionContext>(spaceVidLen_,
+                                                         isIntId_,
+                                                         tagContext_.tagNames_[tagId],
+                                                         tagContext_.schemas_[tagId].back().get(),
+                                                         false);
+    compiledFilter_ = CompiledFilter::compile(filter_.get(), expCtx_.get());
+    return cpp2::ErrorCode::SUCCEEDED;
 }
 
 void ScanVertexProcessor::buildTagColName(const std::vector<cpp2::VertexProp>& tagProps) {
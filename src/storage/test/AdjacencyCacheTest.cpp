@@ -0,0 +1,378 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "common/base/Base.h"
+#include "common/fs/TempDir.h"
+#include "common/interface/gen-cpp2/storage_types.h"
+#include "common/interface/gen-cpp2/common_types.h"
+#include "utils/NebulaKeyUtils.h"
+#include <gtest/gtest.h>
+#include "storage/AdjacencyCache.h"
+#include "storage/test/QueryTestUtils.h"
+#include "storage/mutate/DeleteEdgesProcessor.h"
+#include "storage/query/GetNeighborsProcessor.h"
+#include "mock/MockCluster.h"
+#include "mock/MockData.h"
+
+namespace nebula {
+namespace storage {
+
+// Prefix iterator over sorted key values in memory
+class VectorIterator final : public kvstore::KVIterator {
+public:
+    explicit VectorIterator(const std::vector<kvstore::KV>* data)
+        : data_(data) {}
+
+    bool valid() const override {
+        return idx_ < data_->size();
+    }
+
+    void next() override {
+        ++idx_;
+    }
+
+    void prev() override {
+        idx_ = idx_ == 0 ? data_->size() : idx_ - 1;
+    }
+
+    void seek(folly::StringPiece target) override {
+        idx_ = 0;
+        while (valid() && key() < target) {
+            ++idx_;
+        }
+    }
+
+    folly::StringPiece key() const override {
+        return (*data_)[idx_].first;
+    }
+
+    folly::StringPiece val() const override {
+        return (*data_)[idx_].second;
+    }
+
+private:
+    const std::vector<kvstore::KV>* data_;
+    size_t                          idx_{0};
+};
+
+static std::string mockPrefix() {
+    return NebulaKeyUtils::edgePrefix(8, 1, "src", 101);
+}
+
+static std::vector<kvstore::KV> mockEdges(size_t count) {
+    std::vector<kvstore::KV> data;
+    for (size_t i = 0; i < count; i++) {
+        auto key = NebulaKeyUtils::edgeKey(8, 1, "src", 101, i, folly::stringPrintf("dst%lu", i));
+        data.emplace_back(std::move(key), folly::stringPrintf("val_%lu", i));
+    }
+    return data;
+}
+
+static void checkSame(kvstore::KVIterator* iter, const std::vector<kvstore::KV>& data) {
+    size_t count = 0;
+    for (; iter->valid(); iter->next(), count++) {
+        ASSERT_LT(count, data.size());
+        EXPECT_EQ(data[count].first, iter->key());
+        EXPECT_EQ(data[count].second, iter->val());
+    }
+    EXPECT_EQ(data.size(), count);
+}
+
+TEST(AdjacencyCacheTest, ListIteratorTest) {
+    auto prefix = mockPrefix();
+    auto data = mockEdges(10);
+    auto list = std::make_shared<AdjacencyList>(prefix);
+    for (const auto& kv : data) {
+        list->append(kv.first, kv.second);
+    }
+    EXPECT_EQ(10, list->size());
+
+    AdjacencyListIterator iter(list);
+    checkSame(&iter, data);
+
+    iter.seek(data[5].first);
+    ASSERT_TRUE(iter.valid());
+    EXPECT_EQ(data[5].first, iter.key());
+    iter.prev();
+    ASSERT_TRUE(iter.valid());
+    EXPECT_EQ(data[4].first, iter.key());
+
+    // a target between two keys
+    iter.seek(data[5].first + "\x01");
+    ASSERT_TRUE(iter.valid());
+    EXPECT_EQ(data[6].first, iter.key());
+
+    iter.seek(prefix);
+    ASSERT_TRUE(iter.valid());
+    EXPECT_EQ(data[0].first, iter.key());
+
+    iter.seek(NebulaKeyUtils::edgePrefix(8, 1, "src", 102));
+    EXPECT_FALSE(iter.valid());
+}
+
+TEST(AdjacencyCacheTest, DegreeThresholdTest) {
+    AdjacencyCache cache(1024 * 1024, 0, 10, 600);
+    auto prefix = mockPrefix();
+    {
+        AdjacencyCache::Key key(1, 1, "small", 101);
+        auto data = mockEdges(9);
+        auto iter = cache.fill(key, cache.epoch(key), prefix,
+                               std::make_unique<VectorIterator>(&data));
+        checkSame(iter.get(), data);
+        EXPECT_EQ(nullptr, cache.get(key));
+    }
+    {
+        AdjacencyCache::Key key(1, 1, "large", 101);
+        auto data = mockEdges(10);
+        auto iter = cache.fill(key, cache.epoch(key), prefix,
+                               std::make_unique<VectorIterator>(&data));
+        checkSame(iter.get(), data);
+        auto list = cache.get(key);
+        ASSERT_NE(nullptr, list);
+        AdjacencyListIterator cached(list);
+        checkSame(&cached, data);
+    }
+    EXPECT_EQ(1, cache.size());
+    EXPECT_EQ(1, cache.hits());
+    EXPECT_EQ(2, cache.total());
+}
+
+TEST(AdjacencyCacheTest, InvalidateTest) {
+    AdjacencyCache cache(1024 * 1024, 0, 1, 600);
+    auto prefix = mockPrefix();
+    auto data = mockEdges(10);
+    AdjacencyCache::Key key(1, 1, "src", 101);
+
+    auto iter = cache.fill(key, cache.epoch(key), prefix, std::make_unique<VectorIterator>(&data));
+    checkSame(iter.get(), data);
+    ASSERT_NE(nullptr, cache.get(key));
+    cache.invalidate(key);
+    EXPECT_EQ(nullptr, cache.get(key));
+    EXPECT_EQ(0, cache.bytes());
+    EXPECT_EQ(1, cache.evicts());
+
+    // The edges are written after the iterator is created, they must not be cached
+    auto epoch = cache.epoch(key);
+    auto kvIter = std::make_unique<VectorIterator>(&data);
+    cache.invalidate(key);
+    iter = cache.fill(key, epoch, prefix, std::move(kvIter));
+    checkSame(iter.get(), data);
+    EXPECT_EQ(nullptr, cache.get(key));
+    EXPECT_EQ(1, cache.rejects());
+
+    iter = cache.fill(key, cache.epoch(key), prefix, std::make_unique<VectorIterator>(&data));
+    checkSame(iter.get(), data);
+    EXPECT_NE(nullptr, cache.get(key));
+}
+
+TEST(AdjacencyCacheTest, PartialIterateTest) {
+    AdjacencyCache cache(1024 * 1024, 0, 4, 600);
+    auto prefix = mockPrefix();
+    auto data = mockEdges(10);
+    AdjacencyCache::Key key(1, 1, "src", 101);
+    {
+        LOG(INFO) << "Stop before the end";
+        auto iter = cache.fill(key, cache.epoch(key), prefix,
+                               std::make_unique<VectorIterator>(&data));
+        for (size_t i = 0; i < 6; i++) {
+            ASSERT_TRUE(iter->valid());
+            EXPECT_EQ(data[i].first, iter->key());
+            EXPECT_EQ(data[i].second, iter->val());
+            iter->next();
+        }
+        iter.reset();
+        EXPECT_EQ(nullptr, cache.get(key));
+    }
+    {
+        LOG(INFO) << "Seek after the edges are buffered";
+        auto iter = cache.fill(key, cache.epoch(key), prefix,
+                               std::make_unique<VectorIterator>(&data));
+        for (size_t i = 0; i < 5; i++) {
+            iter->next();
+        }
+        iter->seek(data[2].first);
+        ASSERT_TRUE(iter->valid());
+        EXPECT_EQ(data[2].first, iter->key());
+        for (; iter->valid(); iter->next()) {}
+        EXPECT_EQ(nullptr, cache.get(key));
+    }
+    {
+        LOG(INFO) << "Visit all edges";
+        auto iter = cache.fill(key, cache.epoch(key), prefix,
+                               std::make_unique<VectorIterator>(&data));
+        checkSame(iter.get(), data);
+        auto list = cache.get(key);
+        ASSERT_NE(nullptr, list);
+        AdjacencyListIterator cached(list);
+        checkSame(&cached, data);
+    }
+}
+
+TEST(AdjacencyCacheTest, CommitListenerTest) {
+    AdjacencyCache cache(1024 * 1024, 2, 1, 600);
+    auto prefix = mockPrefix();
+    auto data = mockEdges(10);
+    // The src in the key is padded to the vid length
+    std::string src = NebulaKeyUtils::getSrcId(8, data[0].first).str();
+    AdjacencyCache::Key key(1, 1, src, 101);
+    AdjacencyCache::Key other(1, 2, src, 101);
+    auto fill = [&] (const AdjacencyCache::Key& k) {
+        auto iter = cache.fill(k, cache.epoch(k), prefix, std::make_unique<VectorIterator>(&data));
+        checkSame(iter.get(), data);
+        ASSERT_NE(nullptr, cache.get(k));
+    };
+    fill(key);
+    fill(other);
+
+    // vertices and edges of other types are not related
+    cache.onCommitted(1, 1, {NebulaKeyUtils::vertexKey(8, 1, "src", 1),
+                             NebulaKeyUtils::edgeKey(8, 1, "src", 102, 0, "dst")});
+    EXPECT_NE(nullptr, cache.get(key));
+    cache.onCommitted(1, 1, {NebulaKeyUtils::edgeKey(8, 1, "src", 101, 100, "dst")});
+    EXPECT_EQ(nullptr, cache.get(key));
+    EXPECT_NE(nullptr, cache.get(other));
+
+    fill(key);
+    cache.onReset(1, 2);
+    EXPECT_NE(nullptr, cache.get(key));
+    EXPECT_EQ(nullptr, cache.get(other));
+    EXPECT_EQ(1, cache.size());
+}
+
+TEST(AdjacencyCacheTest, TtlTest) {
+    AdjacencyCache cache(1024 * 1024, 0, 1, -1);
+    auto data = mockEdges(10);
+    AdjacencyCache::Key key(1, 1, "src", 101);
+    auto iter = cache.fill(key, cache.epoch(key), mockPrefix(),
+                           std::make_unique<VectorIterator>(&data));
+    checkSame(iter.get(), data);
+    EXPECT_EQ(nullptr, cache.get(key));
+    EXPECT_EQ(0, cache.size());
+}
+
+TEST(AdjacencyCacheTest, MemoryBudgetTest) {
+    size_t capacity = 64 * 1024;
+    AdjacencyCache cache(capacity, 2, 1, 600);
+    auto prefix = mockPrefix();
+    auto data = mockEdges(20);
+    for (int32_t i = 0; i < 1000; i++) {
+        AdjacencyCache::Key key(1, 1, folly::stringPrintf("src%d", i), 101);
+        auto iter = cache.fill(key, cache.epoch(key), prefix,
+                               std::make_unique<VectorIterator>(&data));
+        checkSame(iter.get(), data);
+        EXPECT_LE(cache.bytes(), capacity);
+    }
+    EXPECT_GT(cache.size(), 0);
+    EXPECT_LT(cache.size(), 1000);
+
+    {
+        // larger than a shard, the edges are passed through but never cached
+        AdjacencyCache::Key key(1, 1, "super", 101);
+        auto edges = mockEdges(5000);
+        auto iter = cache.fill(key, cache.epoch(key), prefix,
+                               std::make_unique<VectorIterator>(&edges));
+        checkSame(iter.get(), edges);
+        EXPECT_EQ(nullptr, cache.get(key));
+    }
+}
+
+TEST(AdjacencyCacheTest, GetNeighborsTest) {
+    FLAGS_enable_adjacency_cache = true;
+    FLAGS_adjacency_cache_degree_threshold = 2;
+    fs::TempDir rootPath("/tmp/AdjacencyCacheTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    auto totalParts = cluster.getTotalParts();
+    ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+    ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+    ASSERT_NE(nullptr, env->adjCache_);
+
+    TagID player = 1;
+    EdgeType serve = 101;
+    std::vector<VertexID> vertices = {"LeBron James"};
+    std::vector<EdgeType> over = {serve};
+    std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+    std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+    tags.emplace_back(player, std::vector<std::string>{"name", "age", "avgScore"});
+    edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear", "endYear"});
+    auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+
+    for (int i = 0; i < 2; i++) {
+        auto* processor = GetNeighborsProcessor::instance(env, nullptr, nullptr);
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+
+        ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+        // vId, stat, player, serve, expr
+        QueryTestUtils::checkResponse(*resp.vertices_ref(), vertices, over, tags, edges, 1, 5);
+    }
+    EXPECT_EQ(1, env->adjCache_->size());
+    EXPECT_EQ(1, env->adjCache_->hits());
+
+    {
+        LOG(INFO) << "Delete one serve edge";
+        cpp2::DeleteEdgesRequest delReq;
+        delReq.set_space_id(1);
+        PartitionID partId = std::hash<std::string>()("LeBron James") % totalParts + 1;
+        cpp2::EdgeKey edgeKey;
+        edgeKey.set_src("LeBron James");
+        edgeKey.set_edge_type(serve);
+        edgeKey.set_ranking(2010);
+        edgeKey.set_dst("Heat");
+        (*delReq.parts_ref())[partId].emplace_back(std::move(edgeKey));
+
+        auto* processor = DeleteEdgesProcessor::instance(env, nullptr);
+        auto fut = processor->getFuture();
+        processor->process(delReq);
+        auto resp = std::move(fut).get();
+        ASSERT_EQ(0, resp.result.failed_parts.size());
+        EXPECT_EQ(0, env->adjCache_->size());
+    }
+    {
+        auto* processor = GetNeighborsProcessor::instance(env, nullptr, nullptr);
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+
+        ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+        const auto& rows = (*resp.vertices_ref()).rows;
+        ASSERT_EQ(1, rows.size());
+        ASSERT_TRUE(rows[0].values[3].isList());
+        const auto& cell = rows[0].values[3].getList().values;
+        ASSERT_EQ(3, cell.size());
+        for (const auto& edge : cell) {
+            EXPECT_NE("Heat", edge.getList().values[0].getStr());
+        }
+    }
+    EXPECT_EQ(1, env->adjCache_->size());
+    {
+        LOG(INFO) << "Remove the edges of the part in kvstore directly";
+        PartitionID partId = std::hash<std::string>()("LeBron James") % totalParts + 1;
+        auto start = NebulaKeyUtils::edgePrefix(partId);
+        auto end = NebulaKeyUtils::edgePrefix(partId + 1);
+        folly::Baton<true, std::atomic> baton;
+        env->kvstore_->asyncRemoveRange(1, partId, start, end, [&] (kvstore::ResultCode code) {
+            EXPECT_EQ(kvstore::ResultCode::SUCCEEDED, code);
+            baton.post();
+        });
+        baton.wait();
+        EXPECT_EQ(0, env->adjCache_->size());
+    }
+    FLAGS_adjacency_cache_degree_threshold = 1000;
+    FLAGS_enable_adjacency_cache = false;
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+    return RUN_ALL_TESTS();
+}
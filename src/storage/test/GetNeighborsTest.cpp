@@ -7,6 +7,7 @@
 #include "common/base/Base.h"
 #include "common/fs/TempDir.h"
 #include <gtest/gtest.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include "storage/query/GetNeighborsProcessor.h"
 #include "storage/test/QueryTestUtils.h"
 
@@ -850,7 +851,7 @@ TEST(GetNeighborsTest, VertexCacheTest) {
     auto totalParts = cluster.getTotalParts();
     ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
     ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
-    VertexCache vertexCache(1000, 4);
+    VertexCache vertexCache(1024 * 1024, 4);
 
     TagID player = 1;
     EdgeType serve = 101;
@@ -1805,6 +1806,140 @@ TEST(GetNeighborsTest, FilterTest) {
             Value(),
             Value()});
     }
+    {
+        LOG(INFO) << "CompiledExp";
+        std::vector<VertexID> vertices = {"Tracy McGrady"};
+        std::vector<EdgeType> over = {serve};
+        std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+        std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+        tags.emplace_back(player, std::vector<std::string>{"name", "age", "avgScore"});
+        edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear", "endYear"});
+        auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+
+        {
+            // where 2000 + 4 <= serve.startYear && serve.teamName != "Magic", the constant
+            // is folded, and the props are compared in place
+            LogicalExpression exp(
+                Expression::Kind::kLogicalAnd,
+                new RelationalExpression(
+                    Expression::Kind::kRelLE,
+                    new ArithmeticExpression(
+                        Expression::Kind::kAdd,
+                        new ConstantExpression(Value(2000)),
+                        new ConstantExpression(Value(4))),
+                    new EdgePropertyExpression(
+                        new std::string(folly::to<std::string>(serve)),
+                        new std::string("startYear"))),
+                new RelationalExpression(
+                    Expression::Kind::kRelNE,
+                    new EdgePropertyExpression(
+                        new std::string(folly::to<std::string>(serve)),
+                        new std::string("teamName")),
+                    new ConstantExpression(Value("Magic"))));
+            (*req.traverse_spec_ref()).set_filter(Expression::encode(exp));
+        }
+
+        auto* processor = GetNeighborsProcessor::instance(env, nullptr, nullptr);
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+
+        ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+        // vId, stat, player, serve, expr
+        nebula::DataSet expected;
+        expected.colNames = {kVid,
+                             "_stats",
+                             "_tag:1:name:age:avgScore",
+                             "_edge:+101:teamName:startYear:endYear",
+                             "_expr"};
+        auto serveEdges = nebula::List();
+        serveEdges.values.emplace_back(nebula::List({"Rockets", 2004, 2010}));
+        nebula::Row row({"Tracy McGrady",
+                         Value(),
+                         nebula::List({"Tracy McGrady", 41, 19.6}),
+                         serveEdges,
+                         Value()});
+        expected.rows.emplace_back(std::move(row));
+        ASSERT_EQ(expected, *resp.vertices_ref());
+    }
+}
+
+TEST(GetNeighborsTest, QueryConcurrentlyTest) {
+    fs::TempDir rootPath("/tmp/GetNeighborsTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    auto totalParts = cluster.getTotalParts();
+    ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+    ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+
+    TagID player = 1;
+    EdgeType serve = 101;
+    EdgeType teammate = 102;
+
+    FLAGS_query_concurrently = true;
+    auto threadPool = std::make_shared<folly::CPUThreadPoolExecutor>(4);
+    std::vector<VertexID> vertices = {"Tim Duncan", "Tony Parker", "Manu Ginobili",
+                                      "Tracy McGrady", "Kobe Bryant", "LeBron James"};
+    std::vector<EdgeType> over = {serve, teammate};
+    std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+    std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+    tags.emplace_back(player, std::vector<std::string>{"name", "age", "avgScore"});
+    edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear", "endYear"});
+    edges.emplace_back(teammate, std::vector<std::string>{"player1", "player2", "teamName"});
+    for (auto vIdsPerTask : {0, 1, 2}) {
+        LOG(INFO) << "MaxVidsPerQueryTask " << vIdsPerTask;
+        FLAGS_max_vids_per_query_task = vIdsPerTask;
+        auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+
+        auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+
+        ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+        // vId, stat, player, serve, teammate, expr
+        QueryTestUtils::checkResponse(*resp.vertices_ref(), vertices, over, tags, edges, 6, 6);
+    }
+    {
+        LOG(INFO) << "Filter";
+        FLAGS_max_vids_per_query_task = 1;
+        std::vector<VertexID> players = {"Tim Duncan", "Tony Parker", "Kobe Bryant"};
+        std::vector<std::pair<EdgeType, std::vector<std::string>>> serveEdges;
+        serveEdges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear"});
+        auto req = QueryTestUtils::buildRequest(totalParts, players, {serve}, tags, serveEdges);
+        // only Spurs could pass the filter
+        RelationalExpression exp(
+            Expression::Kind::kRelEQ,
+            new EdgePropertyExpression(new std::string(folly::to<std::string>(serve)),
+                                       new std::string("teamName")),
+            new ConstantExpression("Spurs"));
+        (*req.traverse_spec_ref()).set_filter(Expression::encode(exp));
+
+        auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+
+        ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+        const auto& rows = (*resp.vertices_ref()).rows;
+        ASSERT_EQ(3, rows.size());
+        for (const auto& row : rows) {
+            // vId, stat, player, serve, expr
+            ASSERT_EQ(5, row.values.size());
+            const auto& cell = row.values[3];
+            if (row.values[0].getStr() == "Kobe Bryant") {
+                ASSERT_EQ(Value::Type::__EMPTY__, cell.type());
+                continue;
+            }
+            ASSERT_EQ(Value::Type::LIST, cell.type());
+            for (const auto& edge : cell.getList().values) {
+                ASSERT_EQ("Spurs", edge.getList().values[0].getStr());
+            }
+        }
+    }
+    FLAGS_max_vids_per_query_task = 0;
+    FLAGS_query_concurrently = false;
 }
 
 }  // namespace storage
@@ -7,6 +7,7 @@
 #include <gtest/gtest.h>
 #include "common/fs/TempDir.h"
 #include "kvstore/RocksEngineConfig.h"
+#include "storage/StorageFlags.h"
 #include "storage/query/GetPropProcessor.h"
 #include "storage/test/QueryTestUtils.h"
 
@@ -566,6 +567,45 @@ TEST(GetPropTest, AllPropertyInAllSchemaTest) {
     }
 }
 
+TEST(GetPropTest, BatchGetVertexTest) {
+    fs::TempDir rootPath("/tmp/GetPropTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    auto totalParts = cluster.getTotalParts();
+    ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+
+    TagID player = 1;
+    TagID team = 2;
+    std::vector<VertexID> vertices = {"Tim Duncan", "Spurs", "Tony Parker", "Not Existed",
+                                      "Manu Ginobili", "Rockets", "LeBron James"};
+    std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+    tags.emplace_back(player, std::vector<std::string>{"name", "age", "avgScore"});
+    tags.emplace_back(team, std::vector<std::string>{"name"});
+
+    auto getProps = [&] () {
+        auto req = buildVertexRequest(totalParts, vertices, tags);
+        auto* processor = GetPropProcessor::instance(env, nullptr, nullptr);
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+        EXPECT_EQ(0, (*resp.result_ref()).failed_parts.size());
+        return *resp.props_ref();
+    };
+
+    // read vertices one by one by prefix
+    FLAGS_vertex_multiget_batch_size = 0;
+    auto expected = getProps();
+    // no row for the vertex not existed
+    ASSERT_EQ(vertices.size() - 1, expected.rows.size());
+    for (auto batch : {1, 2, 256}) {
+        LOG(INFO) << "Read vertices by multiGet, batch size " << batch;
+        FLAGS_vertex_multiget_batch_size = batch;
+        ASSERT_EQ(expected, getProps());
+    }
+    FLAGS_vertex_multiget_batch_size = 256;
+}
+
 TEST(QueryVertexPropsTest, PrefixBloomFilterTest) {
     FLAGS_enable_rocksdb_statistics = true;
     FLAGS_enable_rocksdb_prefix_filtering = true;
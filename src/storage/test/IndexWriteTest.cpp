@@ -137,6 +137,86 @@ TEST(IndexTest, SimpleVerticesTest) {
     }
 }
 
+TEST(IndexTest, OverwriteVerticesTest) {
+    fs::TempDir rootPath("/tmp/OverwriteVerticesTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    auto vIdLen = env->schemaMan_->getSpaceVidLen(1).value();
+    int32_t vertexNum = 10;
+
+    auto addVertices = [&] (int64_t base, bool ifNotExists) {
+        cpp2::AddVerticesRequest req;
+        req.set_space_id(1);
+        req.set_if_not_exists(ifNotExists);
+        for (auto partId = 1; partId <= 6; partId++) {
+            for (int32_t i = 0; i < vertexNum; i++) {
+                nebula::storage::cpp2::NewVertex newVertex;
+                nebula::storage::cpp2::NewTag newTag;
+                newTag.set_tag_id(3);
+                const Date date = {2020, 2, 20};
+                const DateTime dt = {2020, 2, 20, 10, 30, 45, 0};
+                std::vector<Value>  props;
+                props.emplace_back(Value(true));
+                props.emplace_back(Value(base + i));
+                props.emplace_back(Value(1.1f));
+                props.emplace_back(Value(1.1f));
+                props.emplace_back(Value("string"));
+                props.emplace_back(Value(1L));
+                props.emplace_back(Value(1L));
+                props.emplace_back(Value(1L));
+                props.emplace_back(Value(1L));
+                props.emplace_back(Value(std::move(date)));
+                props.emplace_back(Value(std::move(dt)));
+                newTag.set_props(std::move(props));
+                std::vector<nebula::storage::cpp2::NewTag> newTags;
+                newTags.push_back(std::move(newTag));
+                newVertex.set_id(convertVertexId(vIdLen, partId * 100 + i));
+                newVertex.set_tags(std::move(newTags));
+                (*req.parts_ref())[partId].emplace_back(std::move(newVertex));
+            }
+        }
+        auto* processor = AddVerticesProcessor::instance(env, nullptr);
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+        EXPECT_EQ(0, resp.result.failed_parts.size());
+    };
+
+    auto checkIndex = [&] (int64_t base) {
+        for (auto partId = 1; partId <= 6; partId++) {
+            auto prefix = IndexKeyUtils::indexPrefix(partId, 3);
+            std::unique_ptr<kvstore::KVIterator> iter;
+            ASSERT_EQ(kvstore::ResultCode::SUCCEEDED,
+                      env->kvstore_->prefix(1, partId, prefix, &iter));
+            int32_t rowCount = 0;
+            for (; iter->valid(); iter->next(), rowCount++) {
+                auto vId = IndexKeyUtils::getIndexVertexID(vIdLen, iter->key());
+                int32_t i = *reinterpret_cast<const int32_t*>(vId.data()) - partId * 100;
+                auto values = IndexKeyUtils::encodeValues(
+                    {Value(true), Value(base + i), Value(1.1f), Value(1.1f),
+                     IndexKeyUtils::encodeValue(Value("string"), 20)},
+                    mock::MockData::mockGeneralTagIndexColumns());
+                auto expected = IndexKeyUtils::vertexIndexKey(vIdLen, partId, 3, vId.str(),
+                                                              std::move(values));
+                EXPECT_EQ(expected, iter->key());
+            }
+            EXPECT_EQ(vertexNum, rowCount);
+        }
+    };
+
+    addVertices(0, true);
+    checkIndex(0);
+
+    LOG(INFO) << "Overwrite the vertices, the index of the old values are removed";
+    addVertices(1000, false);
+    checkIndex(1000);
+
+    LOG(INFO) << "The vertices exist, nothing is written";
+    addVertices(2000, true);
+    checkIndex(1000);
+}
+
 TEST(IndexTest, SimpleEdgesTest) {
     fs::TempDir rootPath("/tmp/SimpleEdgesTest.XXXXXX");
     mock::MockCluster cluster;
@@ -7,6 +7,7 @@
 #include "common/base/Base.h"
 #include <gtest/gtest.h>
 #include <rocksdb/db.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include "common/fs/TempDir.h"
 #include "utils/IndexKeyUtils.h"
 #include "mock/AdHocIndexManager.h"
@@ -2972,6 +2973,59 @@ TEST(LookupIndexTest, DedupEdgeIndexTest) {
         QueryTestUtils::checkResponse(resp, expectCols, expectRows);
     }
 }
+
+TEST(LookupIndexTest, QueryConcurrentlyTest) {
+    fs::TempDir rootPath("/tmp/QueryConcurrentlyTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    GraphSpaceID spaceId = 1;
+    auto totalParts = cluster.getTotalParts();
+    ASSERT_TRUE(QueryTestUtils::mockVertexData(env, totalParts, true, false));
+
+    FLAGS_query_concurrently = true;
+    auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(3);
+    for (auto* ex : {static_cast<folly::Executor*>(nullptr),
+                     static_cast<folly::Executor*>(executor.get())}) {
+        auto* processor = LookupProcessor::instance(env, nullptr, ex);
+        cpp2::LookupIndexRequest req;
+        nebula::storage::cpp2::IndexSpec indices;
+        req.set_space_id(spaceId);
+        indices.set_tag_or_edge_id(1);
+        indices.set_is_edge(false);
+        std::vector<PartitionID> parts;
+        for (int32_t p = 1; p <= totalParts; p++) {
+            parts.emplace_back(p);
+        }
+        req.set_parts(std::move(parts));
+        cpp2::IndexQueryContext context1;
+        context1.set_filter("");
+        context1.set_index_id(4);
+        decltype(indices.contexts) contexts;
+        contexts.emplace_back(std::move(context1));
+        indices.set_contexts(std::move(contexts));
+        req.set_indices(std::move(indices));
+        req.set_return_columns({kVid, kTag});
+
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+        std::vector<std::string> expectCols = {std::string("1.").append(kVid),
+                                               std::string("1.").append(kTag)};
+        decltype(resp.get_data()->rows) expectRows;
+
+        auto playerVerticeId = mock::MockData::mockPlayerVerticeIds();
+        for (auto& vId : playerVerticeId) {
+            Row row;
+            row.emplace_back(vId);
+            row.emplace_back(1);
+            expectRows.emplace_back(std::move(row));
+        }
+
+        QueryTestUtils::checkResponse(resp, expectCols, expectRows);
+    }
+    FLAGS_query_concurrently = false;
+}
 }  // namespace storage
 }  // namespace nebula
 
@@ -0,0 +1,230 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "common/base/Base.h"
+#include "common/fs/TempDir.h"
+#include "utils/NebulaKeyUtils.h"
+#include <gtest/gtest.h>
+#include "storage/MergeOperator.h"
+#include "storage/test/QueryTestUtils.h"
+#include "codec/RowReaderWrapper.h"
+#include "mock/MockCluster.h"
+#include "mock/MockData.h"
+
+namespace nebula {
+namespace storage {
+
+kvstore::ResultCode syncMerge(StorageEnv* env,
+                              GraphSpaceID spaceId,
+                              PartitionID partId,
+                              const std::string& key,
+                              const std::vector<MergeOp>& ops) {
+    std::vector<kvstore::KV> data;
+    data.emplace_back(key, MergeOperand::encode(spaceId, ops));
+    folly::Baton<true, std::atomic> baton;
+    kvstore::ResultCode ret = kvstore::ResultCode::SUCCEEDED;
+    env->kvstore_->asyncMultiMerge(spaceId, partId, std::move(data),
+                                   [&ret, &baton] (kvstore::ResultCode code) {
+        ret = code;
+        baton.post();
+    });
+    baton.wait();
+    return ret;
+}
+
+TEST(MergeOperatorTest, MergeExistingVertexTest) {
+    fs::TempDir rootPath("/tmp/MergeOperatorTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    auto totalParts = cluster.getTotalParts();
+    ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+
+    GraphSpaceID spaceId = 1;
+    TagID tagId = 1;
+    VertexID vId = "Tim Duncan";
+    auto vIdLen = env->schemaMan_->getSpaceVidLen(spaceId).value();
+    PartitionID partId = (std::hash<std::string>()(vId) % totalParts) + 1;
+    auto key = NebulaKeyUtils::vertexKey(vIdLen, partId, vId, tagId);
+
+    std::string val;
+    ASSERT_EQ(kvstore::ResultCode::SUCCEEDED, env->kvstore_->get(spaceId, partId, key, &val));
+    auto reader = RowReaderWrapper::getTagPropReader(env->schemaMan_, spaceId, tagId, val);
+    ASSERT_TRUE(reader != nullptr);
+    auto games = reader->getValueByName("games").getInt();
+    auto avgScore = reader->getValueByName("avgScore").getFloat();
+    auto career = reader->getValueByName("career").getInt();
+    auto name = reader->getValueByName("name").getStr();
+
+    {
+        std::vector<MergeOp> ops;
+        ops.emplace_back(MergeOp{MergeOpType::ADD, "games", Value(10L)});
+        ops.emplace_back(MergeOp{MergeOpType::ADD, "avgScore", Value(0.5)});
+        ops.emplace_back(MergeOp{MergeOpType::MAX, "career", Value(100L)});
+        ASSERT_EQ(kvstore::ResultCode::SUCCEEDED, syncMerge(env, spaceId, partId, key, ops));
+    }
+    {
+        std::vector<MergeOp> ops;
+        ops.emplace_back(MergeOp{MergeOpType::ADD, "games", Value(-3L)});
+        ops.emplace_back(MergeOp{MergeOpType::MIN, "career", Value(1000L)});
+        ops.emplace_back(MergeOp{MergeOpType::APPEND, "name", Value("!")});
+        ASSERT_EQ(kvstore::ResultCode::SUCCEEDED, syncMerge(env, spaceId, partId, key, ops));
+    }
+
+    auto check = [&] () {
+        std::string merged;
+        ASSERT_EQ(kvstore::ResultCode::SUCCEEDED,
+                  env->kvstore_->get(spaceId, partId, key, &merged));
+        auto r = RowReaderWrapper::getTagPropReader(env->schemaMan_, spaceId, tagId, merged);
+        ASSERT_TRUE(r != nullptr);
+        EXPECT_EQ(games + 7, r->getValueByName("games").getInt());
+        EXPECT_DOUBLE_EQ(avgScore + 0.5, r->getValueByName("avgScore").getFloat());
+        EXPECT_EQ(std::max(career, 100L), r->getValueByName("career").getInt());
+        EXPECT_EQ(name + "!", r->getValueByName("name").getStr());
+        // props not merged keep their value
+        EXPECT_EQ(reader->getValueByName("age"), r->getValueByName("age"));
+        EXPECT_EQ(reader->getValueByName("country"), r->getValueByName("country"));
+    };
+    check();
+
+    // operands are folded into the value during compaction
+    auto* ns = dynamic_cast<kvstore::NebulaStore*>(env->kvstore_);
+    ns->flush(spaceId);
+    ns->compact(spaceId);
+    check();
+}
+
+TEST(MergeOperatorTest, MergeMissingVertexTest) {
+    fs::TempDir rootPath("/tmp/MergeOperatorTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+
+    GraphSpaceID spaceId = 1;
+    TagID tagId = 1;
+    PartitionID partId = 1;
+    VertexID vId = "Nobody";
+    auto vIdLen = env->schemaMan_->getSpaceVidLen(spaceId).value();
+    auto key = NebulaKeyUtils::vertexKey(vIdLen, partId, vId, tagId);
+
+    for (int32_t i = 0; i < 3; i++) {
+        std::vector<MergeOp> ops;
+        ops.emplace_back(MergeOp{MergeOpType::ADD, "age", Value(1L)});
+        ops.emplace_back(MergeOp{MergeOpType::APPEND, "name", Value("a")});
+        ASSERT_EQ(kvstore::ResultCode::SUCCEEDED, syncMerge(env, spaceId, partId, key, ops));
+    }
+
+    std::string val;
+    ASSERT_EQ(kvstore::ResultCode::SUCCEEDED, env->kvstore_->get(spaceId, partId, key, &val));
+    auto reader = RowReaderWrapper::getTagPropReader(env->schemaMan_, spaceId, tagId, val);
+    ASSERT_TRUE(reader != nullptr);
+    EXPECT_EQ(3, reader->getValueByName("age").getInt());
+    EXPECT_EQ("aaa", reader->getValueByName("name").getStr());
+    // unset props are filled with default value or null
+    EXPECT_EQ("America", reader->getValueByName("country").getStr());
+    EXPECT_EQ(10, reader->getValueByName("career").getInt());
+    EXPECT_TRUE(reader->getValueByName("champions").isNull());
+}
+
+TEST(MergeOperatorTest, MergeFailureTest) {
+    fs::TempDir rootPath("/tmp/MergeOperatorTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    auto totalParts = cluster.getTotalParts();
+    ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+
+    GraphSpaceID spaceId = 1;
+    TagID tagId = 1;
+    auto vIdLen = env->schemaMan_->getSpaceVidLen(spaceId).value();
+    auto keyOf = [&] (const VertexID& vId) {
+        PartitionID partId = (std::hash<std::string>()(vId) % totalParts) + 1;
+        return std::make_pair(partId, NebulaKeyUtils::vertexKey(vIdLen, partId, vId, tagId));
+    };
+    auto mergeRaw = [&] (PartitionID partId, const std::string& key, std::string operand) {
+        std::vector<kvstore::KV> data;
+        data.emplace_back(key, std::move(operand));
+        folly::Baton<true, std::atomic> baton;
+        kvstore::ResultCode ret = kvstore::ResultCode::SUCCEEDED;
+        env->kvstore_->asyncMultiMerge(spaceId, partId, std::move(data),
+                                       [&ret, &baton] (kvstore::ResultCode code) {
+            ret = code;
+            baton.post();
+        });
+        baton.wait();
+        ASSERT_EQ(kvstore::ResultCode::SUCCEEDED, ret);
+    };
+
+    {
+        LOG(INFO) << "A bad operand fails the merge instead of being skipped";
+        auto [partId, key] = keyOf("Tim Duncan");
+        std::vector<MergeOp> ops;
+        ops.emplace_back(MergeOp{MergeOpType::ADD, "games", Value(1L)});
+        ASSERT_EQ(kvstore::ResultCode::SUCCEEDED, syncMerge(env, spaceId, partId, key, ops));
+        mergeRaw(partId, key, "bad operand");
+        std::string val;
+        EXPECT_NE(kvstore::ResultCode::SUCCEEDED, env->kvstore_->get(spaceId, partId, key, &val));
+    }
+    {
+        LOG(INFO) << "An op which does not fit the prop fails the merge";
+        auto [partId, key] = keyOf("Tony Parker");
+        std::vector<MergeOp> ops;
+        ops.emplace_back(MergeOp{MergeOpType::ADD, "name", Value(1L)});
+        ASSERT_EQ(kvstore::ResultCode::SUCCEEDED, syncMerge(env, spaceId, partId, key, ops));
+        std::string val;
+        EXPECT_NE(kvstore::ResultCode::SUCCEEDED, env->kvstore_->get(spaceId, partId, key, &val));
+    }
+    {
+        LOG(INFO) << "A row which can't be encoded is not written as an empty value";
+        auto [partId, key] = keyOf("Nobody");
+        std::vector<MergeOp> ops;
+        ops.emplace_back(MergeOp{MergeOpType::APPEND, "age", Value("a")});
+        ASSERT_EQ(kvstore::ResultCode::SUCCEEDED, syncMerge(env, spaceId, partId, key, ops));
+        std::string val;
+        EXPECT_NE(kvstore::ResultCode::SUCCEEDED, env->kvstore_->get(spaceId, partId, key, &val));
+        EXPECT_TRUE(val.empty());
+    }
+}
+
+TEST(MergeOperatorTest, MergeOperandCodecTest) {
+    std::vector<MergeOp> ops;
+    ops.emplace_back(MergeOp{MergeOpType::ADD, "a", Value(1L)});
+    ops.emplace_back(MergeOp{MergeOpType::MAX, "b", Value(2.5)});
+    ops.emplace_back(MergeOp{MergeOpType::APPEND, "c", Value("xyz")});
+    auto encoded = MergeOperand::encode(7, ops);
+
+    GraphSpaceID spaceId = 0;
+    std::vector<MergeOp> decoded;
+    ASSERT_TRUE(MergeOperand::decode(encoded, spaceId, decoded));
+    EXPECT_EQ(7, spaceId);
+    ASSERT_EQ(3, decoded.size());
+    for (size_t i = 0; i < ops.size(); i++) {
+        EXPECT_EQ(ops[i].type_, decoded[i].type_);
+        EXPECT_EQ(ops[i].prop_, decoded[i].prop_);
+        EXPECT_EQ(ops[i].value_, decoded[i].value_);
+    }
+
+    decoded.clear();
+    EXPECT_FALSE(MergeOperand::decode(folly::StringPiece(encoded).subpiece(0, encoded.size() - 1),
+                                      spaceId, decoded));
+
+    // unknown op type
+    decoded.clear();
+    auto badType = encoded;
+    badType[sizeof(GraphSpaceID) + sizeof(uint32_t)] = 0x7f;
+    EXPECT_FALSE(MergeOperand::decode(badType, spaceId, decoded));
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+    return RUN_ALL_TESTS();
+}
@@ -10,66 +10,123 @@
 #include "common/fs/TempDir.h"
 #include "kvstore/RocksEngineConfig.h"
 #include "mock/MockCluster.h"
+#include "utils/IndexKeyUtils.h"
 #include "utils/NebulaKeyUtils.h"
 
 DEFINE_int64(vertex_per_part, 100, "vertex count with each partition");
+DEFINE_int32(edge_per_type, 10, "edge count of each edge type of a vertex");
 
 namespace nebula {
 namespace storage {
 
+// The same as the vid length of the space in MockCluster, so the prefixes are extracted
+static constexpr size_t kVIdLen = 32;
+static constexpr GraphSpaceID kSpaceId = 1;
+static constexpr IndexID kIndexId = 1;
+// Only the first edge types have edges, the last one is a miss of every vertex
+static constexpr EdgeType kEdgeTypes[] = {101, 102, 103, 104};
+static constexpr EdgeType kMissingEdgeType = 105;
+
 void mockData(StorageEnv* env, int32_t partCount) {
     LOG(INFO) << "Prepare data...";
-    size_t vIdLen = 16;
-    GraphSpaceID spaceId = 1;
     for (PartitionID partId = 1; partId <= partCount; partId++) {
         std::vector<kvstore::KV> data;
         for (int32_t vertexId = partId * FLAGS_vertex_per_part;
              vertexId < (partId + 1) * FLAGS_vertex_per_part;
              vertexId++) {
+            auto vId = std::to_string(vertexId);
             for (TagID tagId = 3001; tagId < 3010; tagId++) {
-                auto key = NebulaKeyUtils::vertexKey(
-                    vIdLen, partId, std::to_string(vertexId), tagId);
+                auto key = NebulaKeyUtils::vertexKey(kVIdLen, partId, vId, tagId);
                 auto val = folly::stringPrintf("%d_%d", vertexId, tagId);
                 data.emplace_back(std::move(key), std::move(val));
             }
+            for (auto edgeType : kEdgeTypes) {
+                for (int32_t i = 0; i < FLAGS_edge_per_type; i++) {
+                    auto key = NebulaKeyUtils::edgeKey(kVIdLen, partId, vId, edgeType, i,
+                                                       std::to_string(i));
+                    auto val = folly::stringPrintf("%d_%d_%d", vertexId, edgeType, i);
+                    data.emplace_back(std::move(key), std::move(val));
+                }
+            }
+            data.emplace_back(IndexKeyUtils::vertexIndexKey(kVIdLen, partId, kIndexId, vId,
+                                                            std::to_string(vertexId)),
+                              "");
         }
         folly::Baton<true, std::atomic> baton;
-        env->kvstore_->asyncMultiPut(spaceId, partId, std::move(data),
+        env->kvstore_->asyncMultiPut(kSpaceId, partId, std::move(data),
                                      [&](kvstore::ResultCode code) {
             CHECK_EQ(kvstore::ResultCode::SUCCEEDED, code);
             baton.post();
             folly::doNotOptimizeAway(code);
         });
         baton.wait();
-        CHECK_EQ(kvstore::ResultCode::SUCCEEDED, env->kvstore_->flush(spaceId));
+        CHECK_EQ(kvstore::ResultCode::SUCCEEDED, env->kvstore_->flush(kSpaceId));
+    }
+}
+
+void prefixSeek(StorageEnv* env, PartitionID partId, const std::string& prefix, bool exists) {
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto code = env->kvstore_->prefix(kSpaceId, partId, prefix, &iter);
+    CHECK_EQ(code, kvstore::ResultCode::SUCCEEDED);
+    CHECK_EQ(exists, iter->valid());
+    if (exists) {
+        iter->next();
     }
 }
 
 void testPrefixSeek(StorageEnv* env, int32_t partCount, int32_t iters) {
-    size_t vIdLen = 16;
-    GraphSpaceID spaceId = 1;
     for (decltype(iters) i = 0; i < iters; i++) {
         for (PartitionID partId = 1; partId <= partCount; partId++) {
             for (int32_t vertexId = partId * FLAGS_vertex_per_part;
                  vertexId < (partId + 1) * FLAGS_vertex_per_part;
                  vertexId++) {
                 auto prefix =
-                    NebulaKeyUtils::vertexPrefix(vIdLen, partId, std::to_string(vertexId));
-                std::unique_ptr<kvstore::KVIterator> iter;
-                auto code = env->kvstore_->prefix(spaceId, partId, prefix, &iter);
-                CHECK_EQ(code, kvstore::ResultCode::SUCCEEDED);
-                CHECK(iter->valid());
-                iter->next();
+                    NebulaKeyUtils::vertexPrefix(kVIdLen, partId, std::to_string(vertexId));
+                prefixSeek(env, partId, prefix, true);
             }
         }
     }
 }
 
-BENCHMARK(PrefixWithFilterOff, n) {
+// The seeks of GetNeighbors, one for each edge type of a vertex
+void testEdgePrefixSeek(StorageEnv* env, int32_t partCount, int32_t iters) {
+    for (decltype(iters) i = 0; i < iters; i++) {
+        for (PartitionID partId = 1; partId <= partCount; partId++) {
+            for (int32_t vertexId = partId * FLAGS_vertex_per_part;
+                 vertexId < (partId + 1) * FLAGS_vertex_per_part;
+                 vertexId++) {
+                auto vId = std::to_string(vertexId);
+                for (auto edgeType : kEdgeTypes) {
+                    auto prefix = NebulaKeyUtils::edgePrefix(kVIdLen, partId, vId, edgeType);
+                    prefixSeek(env, partId, prefix, true);
+                }
+                auto prefix = NebulaKeyUtils::edgePrefix(kVIdLen, partId, vId, kMissingEdgeType);
+                prefixSeek(env, partId, prefix, false);
+            }
+        }
+    }
+}
+
+// The seeks of index lookups, the index only exists in some of the parts
+void testIndexPrefixSeek(StorageEnv* env, int32_t partCount, int32_t iters) {
+    for (decltype(iters) i = 0; i < iters; i++) {
+        for (PartitionID partId = 1; partId <= partCount; partId++) {
+            for (IndexID indexId = kIndexId; indexId < kIndexId + 10; indexId++) {
+                auto prefix = IndexKeyUtils::indexPrefix(partId, indexId);
+                prefixSeek(env, partId, prefix, indexId == kIndexId);
+            }
+        }
+    }
+}
+
+void runBenchmark(bool filterOn,
+                  std::function<void(StorageEnv*, int32_t, int32_t)> test,
+                  int32_t iters) {
     folly::BenchmarkSuspender braces;
     FLAGS_rocksdb_column_family_options = R"({
         "level0_file_num_compaction_trigger":"100"
     })";
+    FLAGS_enable_rocksdb_prefix_filtering = filterOn;
     FLAGS_rocksdb_block_cache = 0;
     fs::TempDir rootPath("/tmp/GetPropTest.XXXXXX");
     mock::MockCluster cluster;
@@ -78,24 +135,35 @@ BENCHMARK(PrefixWithFilterOff, n) {
     auto* env = cluster.storageEnv_.get();
     mockData(env, partCount);
     braces.dismiss();
-    testPrefixSeek(env, partCount, n);
+    test(env, partCount, iters);
+}
+
+BENCHMARK(PrefixWithFilterOff, n) {
+    runBenchmark(false, testPrefixSeek, n);
 }
 
 BENCHMARK_RELATIVE(PrefixWithFilterOn, n) {
-    folly::BenchmarkSuspender braces;
-    FLAGS_rocksdb_column_family_options = R"({
-        "level0_file_num_compaction_trigger":"100"
-    })";
-    FLAGS_enable_rocksdb_prefix_filtering = true;
-    FLAGS_rocksdb_block_cache = 0;
-    fs::TempDir rootPath("/tmp/GetPropTest.XXXXXX");
-    mock::MockCluster cluster;
-    cluster.initStorageKV(rootPath.path());
-    auto partCount = cluster.getTotalParts();
-    auto* env = cluster.storageEnv_.get();
-    mockData(env, partCount);
-    braces.dismiss();
-    testPrefixSeek(env, partCount, n);
+    runBenchmark(true, testPrefixSeek, n);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(EdgePrefixWithFilterOff, n) {
+    runBenchmark(false, testEdgePrefixSeek, n);
+}
+
+BENCHMARK_RELATIVE(EdgePrefixWithFilterOn, n) {
+    runBenchmark(true, testEdgePrefixSeek, n);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(IndexPrefixWithFilterOff, n) {
+    runBenchmark(false, testIndexPrefixSeek, n);
+}
+
+BENCHMARK_RELATIVE(IndexPrefixWithFilterOn, n) {
+    runBenchmark(true, testIndexPrefixSeek, n);
 }
 
 }  // namespace storage
@@ -108,6 +176,9 @@ int main(int argc, char **argv) {
 }
 
 /*
+The results below were measured before the prefix depends on the key type, and only cover the
+vertex prefix seek.
+
 40 processors, Intel(R) Xeon(R) CPU E5-2650 v4 @ 2.20GHz
 
 --part_number=20 --vertex_per_part=100
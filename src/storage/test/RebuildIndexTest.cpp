@@ -554,6 +554,67 @@ TEST_F(RebuildIndexTest, RebuildEdgeIndex) {
     }
 }
 
+TEST_F(RebuildIndexTest, RebuildTagIndexBySst) {
+    FLAGS_rebuild_index_by_sst = true;
+    // Add Vertices
+    auto* processor = AddVerticesProcessor::instance(RebuildIndexTest::env_, nullptr);
+    cpp2::AddVerticesRequest req = mock::MockData::mockAddVerticesReq();
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, resp.result.failed_parts.size());
+
+    // Remove the index written by AddVertices, it must be rebuilt by the sst files
+    auto indexKeys = mock::MockData::mockPlayerIndexKeys();
+    for (auto& key : indexKeys) {
+        folly::Baton<true, std::atomic> baton;
+        RebuildIndexTest::env_->kvstore_->asyncRemove(
+            1, key.first, key.second, [&baton](kvstore::ResultCode code) {
+                EXPECT_EQ(kvstore::ResultCode::SUCCEEDED, code);
+                baton.post();
+            });
+        baton.wait();
+        std::string value;
+        auto code = RebuildIndexTest::env_->kvstore_->get(1, key.first, key.second, &value);
+        EXPECT_EQ(kvstore::ResultCode::ERR_KEY_NOT_FOUND, code);
+    }
+
+    cpp2::TaskPara parameter;
+    parameter.set_space_id(1);
+    std::vector<PartitionID> parts = {1, 2, 3, 4, 5, 6};
+    parameter.set_parts(std::move(parts));
+    parameter.set_task_specfic_paras({"4", "5"});
+
+    cpp2::AddAdminTaskRequest request;
+    request.set_cmd(meta::cpp2::AdminCmd::REBUILD_TAG_INDEX);
+    request.set_job_id(7);
+    request.set_task_id(17);
+    request.set_para(std::move(parameter));
+
+    auto callback = [](cpp2::ErrorCode, nebula::meta::cpp2::StatisItem&) {};
+    TaskContext context(request, callback);
+
+    auto task = std::make_shared<RebuildTagIndexTask>(RebuildIndexTest::env_, std::move(context));
+    manager_->addAsyncTask(task);
+
+    // Wait for the task finished
+    do {
+        usleep(50);
+    } while (!manager_->isFinished(context.jobId_, context.taskId_));
+
+    // Check the result
+    LOG(INFO) << "Check rebuild tag index by sst...";
+    for (auto& key : indexKeys) {
+        std::string value;
+        auto code = RebuildIndexTest::env_->kvstore_->get(1, key.first, key.second, &value);
+        EXPECT_EQ(kvstore::ResultCode::SUCCEEDED, code);
+    }
+
+    RebuildIndexTest::env_->rebuildIndexGuard_->clear();
+    FLAGS_rebuild_index_by_sst = false;
+    sleep(1);
+}
+
 }  // namespace storage
 }  // namespace nebula
 
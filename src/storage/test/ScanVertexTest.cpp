@@ -7,6 +7,7 @@
 #include "common/base/Base.h"
 #include "common/fs/TempDir.h"
 #include <gtest/gtest.h>
+#include "storage/StorageFlags.h"
 #include "storage/query/ScanVertexProcessor.h"
 #include "storage/test/QueryTestUtils.h"
 
@@ -193,7 +194,104 @@ TEST(ScanVertexTest, CursorTest) {
     }
 }
 
+TEST(ScanVertexTest, FilterTest) {
+    fs::TempDir rootPath("/tmp/ScanVertexTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    auto totalParts = cluster.getTotalParts();
+    ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+
+    TagID player = 1;
+    TagID team = 2;
+    {
+        LOG(INFO) << "Scan players older than 30, the filter prop is not returned";
+        auto tag = std::make_pair(player, std::vector<std::string>{kVid, "name"});
+        RelationalExpression exp(
+            Expression::Kind::kRelGT,
+            new SourcePropertyExpression(new std::string(folly::to<std::string>(player)),
+                                         new std::string("age")),
+            new ConstantExpression(Value(30)));
+        size_t totalRowCount = 0;
+        for (PartitionID partId = 1; partId <= totalParts; partId++) {
+            auto req = buildRequest(partId, "", tag);
+            req.set_filter(Expression::encode(exp));
+            auto* processor = ScanVertexProcessor::instance(env, nullptr);
+            auto f = processor->getFuture();
+            processor->process(req);
+            auto resp = std::move(f).get();
+
+            ASSERT_EQ(0, resp.result.failed_parts.size());
+            checkResponse(*resp.vertex_data_ref(), tag, tag.second.size(), totalRowCount);
+            for (const auto& row : (*resp.vertex_data_ref()).rows) {
+                auto iter = std::find_if(mock::MockData::players_.begin(),
+                                         mock::MockData::players_.end(),
+                                         [&] (const auto& p) {
+                                             return p.name_ == row.values[0].getStr();
+                                         });
+                ASSERT_TRUE(iter != mock::MockData::players_.end());
+                EXPECT_GT(iter->age_, 30);
+            }
+        }
+        size_t expected = std::count_if(mock::MockData::players_.begin(),
+                                        mock::MockData::players_.end(),
+                                        [] (const auto& p) { return p.age_ > 30; });
+        EXPECT_EQ(expected, totalRowCount);
+    }
+    {
+        LOG(INFO) << "The filter refers to another tag";
+        auto tag = std::make_pair(player, std::vector<std::string>{kVid, "name"});
+        RelationalExpression exp(
+            Expression::Kind::kRelEQ,
+            new SourcePropertyExpression(new std::string(folly::to<std::string>(team)),
+                                         new std::string("name")),
+            new ConstantExpression(Value("Spurs")));
+        auto req = buildRequest(1, "", tag);
+        req.set_filter(Expression::encode(exp));
+        auto* processor = ScanVertexProcessor::instance(env, nullptr);
+        auto f = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(f).get();
+        ASSERT_EQ(1, resp.result.failed_parts.size());
+        EXPECT_EQ(cpp2::ErrorCode::E_INVALID_FILTER, resp.result.failed_parts[0].code);
+    }
+}
+
+TEST(ScanVertexTest, BytesLimitTest) {
+    fs::TempDir rootPath("/tmp/ScanVertexTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    auto totalParts = cluster.getTotalParts();
+    ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+
+    // each response stops right after the first key read
+    FLAGS_max_scan_bytes_per_response = 1;
+    TagID player = 1;
+    auto tag = std::make_pair(player, std::vector<std::string>{kVid, "name", "age"});
+    size_t totalRowCount = 0;
+    for (PartitionID partId = 1; partId <= totalParts; partId++) {
+        bool hasNext = true;
+        std::string cursor = "";
+        while (hasNext) {
+            auto req = buildRequest(partId, cursor, tag);
+            auto* processor = ScanVertexProcessor::instance(env, nullptr);
+            auto f = processor->getFuture();
+            processor->process(req);
+            auto resp = std::move(f).get();
 
+            ASSERT_EQ(0, resp.result.failed_parts.size());
+            ASSERT_LE((*resp.vertex_data_ref()).rows.size(), 1);
+            checkResponse(*resp.vertex_data_ref(), tag, tag.second.size(), totalRowCount);
+            hasNext = resp.get_has_next();
+            if (hasNext) {
+                cursor = *resp.next_cursor_ref();
+            }
+        }
+    }
+    EXPECT_EQ(mock::MockData::players_.size(), totalRowCount);
+    FLAGS_max_scan_bytes_per_response = 0;
+}
 
 }  // namespace storage
 }  // namespace nebula
@@ -16,6 +16,7 @@
 #define oneReqTenEdges        1
 #define oneReqHundredEdges    1
 #define oneReqThousandEdges   1
+#define manySrcThousandEdges  1
 
 
 namespace nebula {
@@ -206,6 +207,36 @@ BENCHMARK_RELATIVE(bmOneReqThousandEdgesToss) {
 }
 #endif
 
+#if manySrcThousandEdges
+// The edges spread over all the parts, so many chains share the same remote part
+void addManySrcEdges(int32_t firstSrcId, bool toss, const char* name) {
+    size_t cnt = 1000;
+    size_t srcCnt = 100;
+    auto env = TossEnvironment::getInstance(kMetaName, kMetaPort);
+    std::vector<cpp2::NewEdge> edges;
+    edges.reserve(cnt);
+    for (auto i = 0U; i < cnt; ++i) {
+        int32_t srcId = firstSrcId + i % srcCnt;
+        std::vector<nebula::Value> vals(gTypes.size());
+        vals[0].setInt(srcId);
+        vals[1].setStr(std::string(name));
+        ++gAddedEdges[srcId];
+        auto dstId = gAddedEdges[srcId];
+        edges.emplace_back(env->generateEdge(srcId, gRank, vals, dstId));
+    }
+    env->addEdgesAsync(edges, toss).wait();
+}
+
+BENCHMARK_DRAW_LINE();
+BENCHMARK(bmManySrcThousandEdges) {
+    addManySrcEdges(90000, notToss, __func__);
+}
+
+BENCHMARK_RELATIVE(bmManySrcThousandEdgesToss) {
+    addManySrcEdges(100000, useToss, __func__);
+}
+#endif
+
 }  // namespace storage
 }  // namespace nebula
 
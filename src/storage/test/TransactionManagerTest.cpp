@@ -0,0 +1,167 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "common/base/Base.h"
+#include "common/fs/TempDir.h"
+#include <gtest/gtest.h>
+#include "mock/MockCluster.h"
+#include "storage/CommonUtils.h"
+#include "storage/transaction/TransactionManager.h"
+#include "storage/transaction/TransactionUtils.h"
+#include "utils/NebulaKeyUtils.h"
+
+namespace nebula {
+namespace storage {
+
+constexpr size_t kVIdLen = 8;
+constexpr GraphSpaceID kSpaceId = 1;
+
+// All parts are on the local kvstore, so the in-edges are applied here instead of being sent.
+// The parts in failedRemotes_ fail the forward.
+class FakeTransactionManager : public TransactionManager {
+public:
+    explicit FakeTransactionManager(StorageEnv* env) : TransactionManager(env) {}
+
+    std::unordered_set<PartitionID> failedRemotes_;
+
+protected:
+    folly::SemiFuture<cpp2::ErrorCode> forwardTransaction(int64_t,
+                                                          GraphSpaceID spaceId,
+                                                          PartitionID remotePart,
+                                                          std::string&& batch) override {
+        if (failedRemotes_.count(remotePart) > 0) {
+            return folly::makeSemiFuture(cpp2::ErrorCode::E_LEADER_CHANGED);
+        }
+        return commitBatch(spaceId, remotePart, std::move(batch))
+            .deferValue([](kvstore::ResultCode rc) {
+                return CommonUtils::to(rc);
+            });
+    }
+};
+
+std::vector<KV> mockEdges(PartitionID localPart, PartitionID remotePart, size_t num) {
+    std::vector<KV> edges;
+    for (size_t i = 0; i < num; i++) {
+        auto src = folly::stringPrintf("s%d_%d", localPart, remotePart);
+        auto dst = folly::stringPrintf("d%d_%zu", remotePart, i);
+        edges.emplace_back(NebulaKeyUtils::edgeKey(kVIdLen, localPart, src, 101, 0, dst),
+                           folly::stringPrintf("val_%s_%s", src.c_str(), dst.c_str()));
+    }
+    return edges;
+}
+
+bool keyExists(StorageEnv* env, PartitionID partId, const std::string& key) {
+    std::string val;
+    return env->kvstore_->get(kSpaceId, partId, key, &val) == kvstore::ResultCode::SUCCEEDED;
+}
+
+// Either the out-edges and in-edges are all written and the locks are removed, or no edge
+// is written on either side
+void checkChain(StorageEnv* env,
+                const ChainId& chain,
+                const std::vector<KV>& edges,
+                bool applied) {
+    for (auto& kv : edges) {
+        auto inEdge = TransactionUtils::reverseRawKey(kVIdLen, chain.second, kv.first);
+        EXPECT_EQ(applied, keyExists(env, chain.first, kv.first));
+        EXPECT_EQ(applied, keyExists(env, chain.second, inEdge));
+        if (applied) {
+            std::string val;
+            ASSERT_EQ(kvstore::ResultCode::SUCCEEDED,
+                      env->kvstore_->get(kSpaceId, chain.first, kv.first, &val));
+            EXPECT_EQ(kv.second, val);
+            ASSERT_EQ(kvstore::ResultCode::SUCCEEDED,
+                      env->kvstore_->get(kSpaceId, chain.second, inEdge, &val));
+            EXPECT_EQ(kv.second, val);
+            EXPECT_FALSE(keyExists(env, chain.first, NebulaKeyUtils::toLockKey(kv.first)));
+        }
+    }
+}
+
+TEST(TransactionManagerTest, ChainsTest) {
+    fs::TempDir rootPath("/tmp/TransactionManagerTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    FakeTransactionManager txnMan(env);
+
+    // Chains sharing the local part, the remote part, or both ways of a pair of parts
+    std::vector<ChainId> chains{{1, 2}, {1, 3}, {2, 3}, {3, 1}, {4, 2}, {5, 5}};
+    std::unordered_map<ChainId, std::vector<KV>> edgesByChain;
+    for (auto& chain : chains) {
+        edgesByChain[chain] = mockEdges(chain.first, chain.second, 5);
+    }
+    auto expected = edgesByChain;
+
+    auto failedParts = txnMan.addEdgesByChains(kVIdLen, kSpaceId, std::move(edgesByChain)).get();
+    EXPECT_TRUE(failedParts.empty());
+    for (auto& chain : chains) {
+        checkChain(env, chain, expected[chain], true);
+    }
+}
+
+TEST(TransactionManagerTest, FailedChainsTest) {
+    fs::TempDir rootPath("/tmp/TransactionManagerTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    FakeTransactionManager txnMan(env);
+
+    // The in-edges of part 2 can't be written, and part 7 doesn't exist so its persist locks
+    // can't be written
+    txnMan.failedRemotes_.emplace(2);
+    std::vector<ChainId> failed{{1, 2}, {3, 2}, {7, 1}};
+    std::vector<ChainId> succeeded{{1, 3}, {4, 5}, {6, 1}};
+    std::unordered_map<ChainId, std::vector<KV>> edgesByChain;
+    for (auto& chain : failed) {
+        edgesByChain[chain] = mockEdges(chain.first, chain.second, 5);
+    }
+    for (auto& chain : succeeded) {
+        edgesByChain[chain] = mockEdges(chain.first, chain.second, 5);
+    }
+    auto expected = edgesByChain;
+
+    auto failedParts = txnMan.addEdgesByChains(kVIdLen, kSpaceId, std::move(edgesByChain)).get();
+    EXPECT_EQ(3, failedParts.size());
+    EXPECT_EQ(cpp2::ErrorCode::E_LEADER_CHANGED, failedParts[1]);
+    EXPECT_EQ(cpp2::ErrorCode::E_LEADER_CHANGED, failedParts[3]);
+    EXPECT_EQ(cpp2::ErrorCode::E_PART_NOT_FOUND, failedParts[7]);
+
+    for (auto& chain : succeeded) {
+        checkChain(env, chain, expected[chain], true);
+    }
+    for (auto& chain : {ChainId{1, 2}, ChainId{3, 2}}) {
+        checkChain(env, chain, expected[chain], false);
+        // The persist locks are left to be resumed
+        for (auto& kv : expected[chain]) {
+            EXPECT_TRUE(keyExists(env, chain.first, NebulaKeyUtils::toLockKey(kv.first)));
+        }
+    }
+    for (auto& kv : expected[ChainId{7, 1}]) {
+        EXPECT_FALSE(keyExists(env, 1, TransactionUtils::reverseRawKey(kVIdLen, 1, kv.first)));
+    }
+
+    // The memory locks of the failed chains are released, so they can be written again
+    txnMan.failedRemotes_.clear();
+    std::unordered_map<ChainId, std::vector<KV>> retry;
+    retry[ChainId{1, 2}] = expected[ChainId{1, 2}];
+    retry[ChainId{3, 2}] = expected[ChainId{3, 2}];
+    failedParts = txnMan.addEdgesByChains(kVIdLen, kSpaceId, std::move(retry)).get();
+    EXPECT_TRUE(failedParts.empty());
+    checkChain(env, ChainId{1, 2}, expected[ChainId{1, 2}], true);
+    checkChain(env, ChainId{3, 2}, expected[ChainId{3, 2}], true);
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+    return RUN_ALL_TESTS();
+}
@@ -87,6 +87,64 @@ void checkCache(VertexCache* cache, uint64_t evicts, uint64_t hits, uint64_t tot
 }
 
 
+TEST(VertexCacheTest, MemoryBudgetTest) {
+    size_t capacity = 64 * 1024;
+    VertexCache cache(capacity, 2);
+    std::string value(200, 'v');
+    for (int32_t i = 0; i < 10000; i++) {
+        auto key = std::make_pair(folly::stringPrintf("vertex_%d", i), 1);
+        ASSERT_FALSE(cache.get(key).ok());
+        cache.insert(key, value);
+        ASSERT_LE(cache.bytes(), capacity);
+    }
+    EXPECT_GT(cache.size(), 0);
+    EXPECT_EQ(0, cache.hits());
+    EXPECT_EQ(10000, cache.total());
+
+    // An entry larger than the budget of a bucket is never admitted
+    auto key = std::make_pair(std::string("huge"), 1);
+    cache.insert(key, std::string(capacity, 'v'));
+    EXPECT_FALSE(cache.get(key).ok());
+}
+
+TEST(VertexCacheTest, ScanResistanceTest) {
+    // One bucket with room for about 10 entries
+    std::string value(100, 'v');
+    VertexCache cache(10 * 210, 0);
+    auto hotKey = [] (int32_t i) {
+        return std::make_pair(folly::stringPrintf("hot_%05d", i), 1);
+    };
+    auto coldKey = [] (int32_t i) {
+        return std::make_pair(folly::stringPrintf("cold_%04d", i), 1);
+    };
+
+    // Hot vertices are read again and again
+    for (int32_t i = 0; i < 5; i++) {
+        ASSERT_FALSE(cache.get(hotKey(i)).ok());
+        cache.insert(hotKey(i), value);
+        for (int32_t j = 0; j < 10; j++) {
+            ASSERT_TRUE(cache.get(hotKey(i)).ok());
+        }
+    }
+
+    // A scan reads every vertex once, which should not flush out the hot ones
+    for (int32_t i = 0; i < 1000; i++) {
+        if (!cache.get(coldKey(i)).ok()) {
+            cache.insert(coldKey(i), value);
+        }
+    }
+    EXPECT_GT(cache.rejects(), 0);
+    for (int32_t i = 0; i < 5; i++) {
+        auto ret = cache.get(hotKey(i));
+        ASSERT_TRUE(ret.ok());
+        EXPECT_EQ(value, ret.value());
+    }
+
+    // Evicted explicitly when the vertex is written
+    cache.evict(hotKey(0));
+    EXPECT_FALSE(cache.get(hotKey(0)).ok());
+}
+
 // In vertexCache, when the data of vertex is queried for the first time,
 // the data is put in lru.
 // When writing vertex data, if the data is in the vertexCache,
@@ -100,9 +158,8 @@ TEST(VertexCacheTest, OperationVertexTest) {
     auto* env = cluster.storageEnv_.get();
     auto parts = cluster.getTotalParts();
 
-    // Here ConcurrentLRUCache capacity is the size of the player data(51), and
-    // has a bucket.
-    VertexCache cache(51, 0);
+    // Here VertexCache has one bucket, which is large enough for all the player data(51)
+    VertexCache cache(1024 * 1024, 0);
 
     // Add vertices
     // VertexCache is empty, add vertice only evicts vertex from VertexCache
@@ -272,9 +329,8 @@ TEST(VertexCacheTest, GetNeighborsTest) {
     auto* env = cluster.storageEnv_.get();
     auto parts = cluster.getTotalParts();
 
-    // Here ConcurrentLRUCache capacity is the size of the player data(51), and
-    // has a bucket.
-    VertexCache cache(51, 0);
+    // Here VertexCache has one bucket, which is large enough for all the player data(51)
+    VertexCache cache(1024 * 1024, 0);
 
     // Add vertices
     // VertexCache is empty, add vertice only evicts vertex from VertexCache.
@@ -376,9 +432,8 @@ TEST(VertexCacheTest, GetVertexPropTest) {
     auto* env = cluster.storageEnv_.get();
     auto parts = cluster.getTotalParts();
 
-    // Here ConcurrentLRUCache capacity is the size of the player data(51), and
-    // has a bucket.
-    VertexCache cache(51, 0);
+    // Here VertexCache has one bucket, which is large enough for all the player data(51)
+    VertexCache cache(1024 * 1024, 0);
 
     // Add vertices
     // VertexCache is empty, add vertice only evicts vertex from VertexCache.
@@ -455,9 +510,8 @@ TEST(VertexCacheTest, GetVertexPropWithTTLTest) {
     auto* env = cluster.storageEnv_.get();
     auto parts = cluster.getTotalParts();
 
-    // Here ConcurrentLRUCache capacity is the size of the player data(51), and
-    // has a bucket.
-    VertexCache cache(51, 0);
+    // Here VertexCache has one bucket, which is large enough for all the player data(51)
+    VertexCache cache(1024 * 1024, 0);
 
     // Add vertices
     // VertexCache is empty, add vertice only evicts vertex from VertexCache.
@@ -5,6 +5,7 @@
  */
 
 #include <folly/container/Enumerate.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 
 #include "codec/RowWriterV2.h"
 #include "common/clients/storage/InternalStorageClient.h"
@@ -24,7 +25,9 @@ namespace storage {
  * lockKey : rawKey + lock suffix
  * */
 TransactionManager::TransactionManager(StorageEnv* env) : env_(env) {
-    exec_ = std::make_shared<folly::IOThreadPoolExecutor>(10);
+    exec_ = std::make_shared<folly::IOThreadPoolExecutor>(
+        FLAGS_toss_worker_threads,
+        std::make_shared<folly::NamedThreadFactory>("toss-worker"));
     interClient_ = std::make_unique<storage::InternalStorageClient>(
                             exec_,
                             env_->metaClient_);
@@ -54,22 +57,10 @@ folly::Future<cpp2::ErrorCode> TransactionManager::addSamePartEdges(
         }
     }
     // steps 1: lock edges in memory
-    bool setMemoryLock = true;
-    std::for_each(localEdges.begin(), localEdges.end(), [&](auto& kv){
-        auto keyWoVer = NebulaKeyUtils::keyWithNoVersion(kv.first).str();
-        if (!memLock_.insert(std::make_pair(keyWoVer, txnId)).second) {
-            setMemoryLock = false;
-        }
-    });
+    bool setMemoryLock = lockEdgesInMemory(txnId, localEdges);
 
     auto cleanup = [=]{
-        for (auto& kv : localEdges) {
-            auto keyWoVer = NebulaKeyUtils::keyWithNoVersion(kv.first).str();
-            auto cit = memLock_.find(keyWoVer);
-            if (cit != memLock_.end() && cit->second == txnId) {
-                memLock_.erase(keyWoVer);
-            }
-        }
+        unlockEdgesInMemory(txnId, localEdges);
     };
 
     if (!setMemoryLock) {
@@ -86,26 +77,7 @@ folly::Future<cpp2::ErrorCode> TransactionManager::addSamePartEdges(
     // insert don't have BatchGetter
     if (!optBatchGetter) {
         // insert don't have batch Getter
-        auto addEdgeErrorCode = cpp2::ErrorCode::SUCCEEDED;
-        std::transform(lockData.begin(), lockData.end(), lockData.begin(), [&](auto& kv) {
-            if (processor) {
-                processor->spaceId_ = spaceId;
-                processor->spaceVidLen_ = vIdLen;
-                std::vector<KV> data{std::make_pair(kv.first, kv.second)};
-                auto optVal = processor->addEdges(localPart, data);
-                if (nebula::ok(optVal)) {
-                    return std::make_pair(NebulaKeyUtils::toLockKey(kv.first),
-                                          nebula::value(optVal));
-                } else {
-                    addEdgeErrorCode = cpp2::ErrorCode::E_ATOMIC_OP_FAILED;
-                    return std::make_pair(NebulaKeyUtils::toLockKey(kv.first), std::string(""));
-                }
-            } else {
-                std::vector<KV> data{std::make_pair(kv.first, kv.second)};
-                return std::make_pair(NebulaKeyUtils::toLockKey(kv.first),
-                                      encodeBatch(std::move(data)));
-            }
-        });
+        auto addEdgeErrorCode = encodeLocks(vIdLen, spaceId, localPart, processor, lockData);
         if (addEdgeErrorCode != cpp2::ErrorCode::SUCCEEDED) {
             cleanup();
             return addEdgeErrorCode;
@@ -161,7 +133,7 @@ folly::Future<cpp2::ErrorCode> TransactionManager::addSamePartEdges(
 
             // steps 3: multi put remote edges
             LOG_IF(INFO, FLAGS_trace_toss) << "begin forwardTransaction, txnId=" << txnId;
-            interClient_->forwardTransaction(txnId, spaceId, remotePart, std::move(remoteBatch))
+            forwardTransaction(txnId, spaceId, remotePart, std::move(remoteBatch))
                 .via(exec_.get())
                 .thenTry([=, p = std::move(p)](auto&& _t) mutable {
                     auto _code = _t.hasValue() ? _t.value() : cpp2::ErrorCode::E_UNKNOWN;
@@ -184,31 +156,7 @@ folly::Future<cpp2::ErrorCode> TransactionManager::addSamePartEdges(
 
                     // steps 4 & 5: multi put local edges & multi remove persist locks
                     kvstore::BatchHolder bat;
-                    for (auto& lock : lockData) {
-                        LOG_IF(INFO, FLAGS_trace_toss)
-                            << "remove lock, hex=" << folly::hexlify(lock.first)
-                            << ", txnId=" << txnId;
-                        bat.remove(std::move(lock.first));
-                        auto operations = kvstore::decodeBatchValue(lock.second);
-                        for (auto& op : operations) {
-                            auto opType = op.first;
-                            auto& kv = op.second;
-                            LOG_IF(INFO, FLAGS_trace_toss)
-                                        << "bat op=" << static_cast<int32_t>(opType)
-                                        << ", hex=" << folly::hexlify(kv.first)
-                                        << ", txnId=" << txnId;
-                            switch (opType) {
-                                case kvstore::BatchLogType::OP_BATCH_PUT:
-                                    bat.put(kv.first.str(), kv.second.str());
-                                    break;
-                                case kvstore::BatchLogType::OP_BATCH_REMOVE:
-                                    bat.remove(kv.first.str());
-                                    break;
-                                default:
-                                    LOG(ERROR) << "unexpected opType: " << static_cast<int>(opType);
-                            }
-                        }
-                    }
+                    appendCommit(txnId, lockData, bat);
                     auto _batch = kvstore::encodeBatchValue(bat.getBatch());
                     commitBatch(spaceId, localPart, std::move(_batch))
                         .via(exec_.get())
@@ -224,6 +172,139 @@ folly::Future<cpp2::ErrorCode> TransactionManager::addSamePartEdges(
     return std::move(c.second).via(exec_.get());
 }
 
+/*
+ * all the chains of a request are committed together, so that
+ * 1. the persist locks of a local part are committed by one raft operation
+ * 2. the in-edges of a remote part are sent by one RPC request
+ * 3. the out-edges of a local part are committed by one raft operation
+ * a failed step only fails the chains it carries, the locks of those chains
+ * are left to be resumed, just like addSamePartEdges()
+ * */
+folly::Future<std::unordered_map<PartitionID, cpp2::ErrorCode>>
+TransactionManager::addEdgesByChains(size_t vIdLen,
+                                     GraphSpaceID spaceId,
+                                     std::unordered_map<ChainId, std::vector<KV>>&& edgesByChain,
+                                     AddEdgesProcessor* processor) {
+    auto txn = std::make_shared<ChainsTxn>();
+    txn->txnId_ = TransactionUtils::getSnowFlakeUUID();
+    auto txnId = txn->txnId_;
+    for (auto& chain : edgesByChain) {
+        Chain c;
+        c.localPart_ = chain.first.first;
+        c.remotePart_ = chain.first.second;
+        c.edges_ = std::move(chain.second);
+        // steps 1: lock edges in memory, and encode the persist locks
+        c.locked_ = lockEdgesInMemory(txnId, c.edges_);
+        if (!c.locked_) {
+            LOG(ERROR) << "set memory lock failed, txnId=" << txnId;
+            unlockEdgesInMemory(txnId, c.edges_);
+            c.code_ = cpp2::ErrorCode::E_MUTATE_EDGE_CONFLICT;
+        } else {
+            c.locks_ = c.edges_;
+            c.code_ = encodeLocks(vIdLen, spaceId, c.localPart_, processor, c.locks_);
+        }
+        txn->chains_.emplace_back(std::move(c));
+    }
+
+    // steps 2: batch commit persist locks of each local part
+    std::unordered_map<PartitionID, std::vector<size_t>> chainsByPart;
+    for (size_t i = 0; i < txn->chains_.size(); i++) {
+        if (txn->chains_[i].code_ == cpp2::ErrorCode::SUCCEEDED) {
+            chainsByPart[txn->chains_[i].localPart_].emplace_back(i);
+        }
+    }
+    std::vector<folly::Future<folly::Unit>> lockFutures;
+    for (auto& part : chainsByPart) {
+        std::vector<KV> lockData;
+        for (auto i : part.second) {
+            auto& locks = txn->chains_[i].locks_;
+            lockData.insert(lockData.end(), locks.begin(), locks.end());
+        }
+        lockFutures.emplace_back(
+            commitBatch(spaceId, part.first, encodeBatch(std::move(lockData)))
+                .via(exec_.get())
+                .thenTry([txn, chains = part.second](auto&& t) {
+                    txn->setCode(chains, toErrorCode(t));
+                }));
+    }
+
+    return folly::collectAll(lockFutures).via(exec_.get())
+        .thenValue([=](auto&&) {
+            // steps 3: multi put remote edges of each remote part
+            std::unordered_map<PartitionID, std::vector<size_t>> chainsByRemote;
+            for (size_t i = 0; i < txn->chains_.size(); i++) {
+                if (txn->chains_[i].code_ == cpp2::ErrorCode::SUCCEEDED) {
+                    chainsByRemote[txn->chains_[i].remotePart_].emplace_back(i);
+                }
+            }
+            std::vector<folly::Future<folly::Unit>> remoteFutures;
+            for (auto& part : chainsByRemote) {
+                auto remotePart = part.first;
+                std::vector<KV> remoteEdges;
+                for (auto i : part.second) {
+                    for (auto& kv : txn->chains_[i].edges_) {
+                        remoteEdges.emplace_back(
+                            TransactionUtils::reverseRawKey(vIdLen, remotePart, kv.first),
+                            kv.second);
+                    }
+                }
+                LOG_IF(INFO, FLAGS_trace_toss) << "begin forwardTransaction, txnId=" << txnId
+                                               << ", remotePart=" << remotePart;
+                remoteFutures.emplace_back(
+                    forwardTransaction(
+                            txnId, spaceId, remotePart, encodeBatch(std::move(remoteEdges)))
+                        .via(exec_.get())
+                        .thenTry([txn, chains = part.second](auto&& t) {
+                            auto code = t.hasValue() ? t.value() : cpp2::ErrorCode::E_UNKNOWN;
+                            txn->setCode(chains, code);
+                        }));
+            }
+            return folly::collectAll(remoteFutures);
+        })
+        .thenValue([=](auto&&) {
+            // steps 4 & 5: multi put local edges & multi remove persist locks of each local part
+            std::unordered_map<PartitionID, std::vector<size_t>> chainsToCommit;
+            for (size_t i = 0; i < txn->chains_.size(); i++) {
+                if (txn->chains_[i].code_ == cpp2::ErrorCode::SUCCEEDED) {
+                    chainsToCommit[txn->chains_[i].localPart_].emplace_back(i);
+                }
+            }
+            std::vector<folly::Future<folly::Unit>> commitFutures;
+            for (auto& part : chainsToCommit) {
+                kvstore::BatchHolder bat;
+                for (auto i : part.second) {
+                    appendCommit(txnId, txn->chains_[i].locks_, bat);
+                }
+                commitFutures.emplace_back(
+                    commitBatch(spaceId, part.first, kvstore::encodeBatchValue(bat.getBatch()))
+                        .via(exec_.get())
+                        .thenTry([txn, chains = part.second](auto&& t) {
+                            txn->setCode(chains, toErrorCode(t));
+                        }));
+            }
+            return folly::collectAll(commitFutures);
+        })
+        .thenValue([txn](auto&&) {
+            std::unordered_map<PartitionID, cpp2::ErrorCode> failedParts;
+            for (auto& c : txn->chains_) {
+                if (c.code_ != cpp2::ErrorCode::SUCCEEDED) {
+                    LOG_IF(INFO, FLAGS_trace_toss) << folly::sformat(
+                        "chain ({},{}) failed, code={}, txnId={}",
+                        c.localPart_, c.remotePart_, static_cast<int32_t>(c.code_), txn->txnId_);
+                    failedParts.emplace(c.localPart_, c.code_);
+                }
+            }
+            return failedParts;
+        })
+        .ensure([=]() {
+            for (auto& c : txn->chains_) {
+                if (c.locked_) {
+                    unlockEdgesInMemory(txnId, c.edges_);
+                }
+            }
+        });
+}
+
 folly::Future<cpp2::ErrorCode> TransactionManager::updateEdgeAtomic(size_t vIdLen,
                                                                     GraphSpaceID spaceId,
                                                                     PartitionID partId,
@@ -430,6 +511,110 @@ meta::cpp2::IsolationLevel TransactionManager::getSpaceIsolationLvel(GraphSpaceI
 }
 
 
+bool TransactionManager::lockEdgesInMemory(int64_t txnId, const std::vector<KV>& edges) {
+    bool setMemoryLock = true;
+    for (auto& kv : edges) {
+        auto keyWoVer = NebulaKeyUtils::keyWithNoVersion(kv.first).str();
+        if (!memLock_.insert(std::make_pair(keyWoVer, txnId)).second) {
+            setMemoryLock = false;
+        }
+    }
+    return setMemoryLock;
+}
+
+void TransactionManager::unlockEdgesInMemory(int64_t txnId, const std::vector<KV>& edges) {
+    for (auto& kv : edges) {
+        auto keyWoVer = NebulaKeyUtils::keyWithNoVersion(kv.first).str();
+        auto cit = memLock_.find(keyWoVer);
+        if (cit != memLock_.end() && cit->second == txnId) {
+            memLock_.erase(keyWoVer);
+        }
+    }
+}
+
+cpp2::ErrorCode TransactionManager::encodeLocks(size_t vIdLen,
+                                                GraphSpaceID spaceId,
+                                                PartitionID localPart,
+                                                AddEdgesProcessor* processor,
+                                                std::vector<KV>& edges) {
+    auto addEdgeErrorCode = cpp2::ErrorCode::SUCCEEDED;
+    std::transform(edges.begin(), edges.end(), edges.begin(), [&](auto& kv) {
+        if (processor) {
+            processor->spaceId_ = spaceId;
+            processor->spaceVidLen_ = vIdLen;
+            std::vector<KV> data{std::make_pair(kv.first, kv.second)};
+            auto optVal = processor->addEdges(localPart, data);
+            if (nebula::ok(optVal)) {
+                return std::make_pair(NebulaKeyUtils::toLockKey(kv.first),
+                                      nebula::value(optVal));
+            } else {
+                addEdgeErrorCode = cpp2::ErrorCode::E_ATOMIC_OP_FAILED;
+                return std::make_pair(NebulaKeyUtils::toLockKey(kv.first), std::string(""));
+            }
+        } else {
+            std::vector<KV> data{std::make_pair(kv.first, kv.second)};
+            return std::make_pair(NebulaKeyUtils::toLockKey(kv.first),
+                                  encodeBatch(std::move(data)));
+        }
+    });
+    return addEdgeErrorCode;
+}
+
+void TransactionManager::appendCommit(int64_t txnId,
+                                      std::vector<KV>& lockData,
+                                      kvstore::BatchHolder& bat) {
+    for (auto& lock : lockData) {
+        LOG_IF(INFO, FLAGS_trace_toss)
+            << "remove lock, hex=" << folly::hexlify(lock.first)
+            << ", txnId=" << txnId;
+        bat.remove(std::move(lock.first));
+        auto operations = kvstore::decodeBatchValue(lock.second);
+        for (auto& op : operations) {
+            auto opType = op.first;
+            auto& kv = op.second;
+            LOG_IF(INFO, FLAGS_trace_toss)
+                        << "bat op=" << static_cast<int32_t>(opType)
+                        << ", hex=" << folly::hexlify(kv.first)
+                        << ", txnId=" << txnId;
+            switch (opType) {
+                case kvstore::BatchLogType::OP_BATCH_PUT:
+                    bat.put(kv.first.str(), kv.second.str());
+                    break;
+                case kvstore::BatchLogType::OP_BATCH_REMOVE:
+                    bat.remove(kv.first.str());
+                    break;
+                default:
+                    LOG(ERROR) << "unexpected opType: " << static_cast<int>(opType);
+            }
+        }
+    }
+}
+
+folly::SemiFuture<cpp2::ErrorCode> TransactionManager::forwardTransaction(int64_t txnId,
+                                                                        GraphSpaceID spaceId,
+                                                                        PartitionID remotePart,
+                                                                        std::string&& batch) {
+    return interClient_->forwardTransaction(txnId, spaceId, remotePart, std::move(batch));
+}
+
+cpp2::ErrorCode TransactionManager::toErrorCode(const folly::Try<kvstore::ResultCode>& t) {
+    if (!t.hasValue()) {
+        LOG(INFO) << "commitBatch throw ex=" << t.exception();
+        return cpp2::ErrorCode::E_UNKNOWN;
+    }
+    return CommonUtils::to(t.value());
+}
+
+void TransactionManager::ChainsTxn::setCode(const std::vector<size_t>& chains,
+                                            cpp2::ErrorCode code) {
+    if (code == cpp2::ErrorCode::SUCCEEDED) {
+        return;
+    }
+    for (auto i : chains) {
+        chains_[i].code_ = code;
+    }
+}
+
 std::string TransactionManager::encodeBatch(std::vector<KV>&& data) {
     kvstore::BatchHolder bat;
     for (auto& kv : data) {
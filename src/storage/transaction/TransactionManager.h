@@ -30,12 +30,14 @@ using RawKeys = std::vector<std::string>;
 using MemEdgeLocks = folly::ConcurrentHashMap<std::string, int64_t>;
 using ResumedResult = std::shared_ptr<folly::Synchronized<KV>>;
 using GetBatchFunc = std::function<folly::Optional<std::string>()>;
+// use localPart vs remotePart to identify different channel.
+using ChainId = std::pair<PartitionID, PartitionID>;
 
 class TransactionManager {
 public:
     explicit TransactionManager(storage::StorageEnv* env);
 
-    ~TransactionManager() = default;
+    virtual ~TransactionManager() = default;
 
     /**
      * @brief edges have same localPart and remotePart will share
@@ -57,6 +59,22 @@ public:
         AddEdgesProcessor* processor = nullptr,
         folly::Optional<GetBatchFunc> optBatchGetter = folly::none);
 
+    /**
+     * @brief commit the chains of a request in one transaction, the chains
+     *        of the same localPart share the raft operations, and the chains
+     *        of the same remotePart share one single RPC request
+     * @param edgesByChain
+     *        <localPart, remotePart> -> <K, encodedValue>.
+     * @param processor
+     *        will set this if edge have index
+     * @return the code of each failed localPart
+     * */
+    folly::Future<std::unordered_map<PartitionID, cpp2::ErrorCode>> addEdgesByChains(
+        size_t vIdLen,
+        GraphSpaceID spaceId,
+        std::unordered_map<ChainId, std::vector<KV>>&& edgesByChain,
+        AddEdgesProcessor* processor = nullptr);
+
     /**
      * @brief update out-edge first, then in-edge
      * @param batchGetter
@@ -98,6 +116,48 @@ public:
     std::unordered_map<std::string, std::list<int64_t>> timer_;
 
 protected:
+    // The edges of a localPart and a remotePart
+    struct Chain {
+        PartitionID         localPart_;
+        PartitionID         remotePart_;
+        std::vector<KV>     edges_;
+        // <lockKey, the batch committed along with removing the lock>
+        std::vector<KV>     locks_;
+        bool                locked_{false};
+        cpp2::ErrorCode     code_{cpp2::ErrorCode::SUCCEEDED};
+    };
+
+    struct ChainsTxn {
+        // Fail the given chains unless the code is SUCCEEDED
+        void setCode(const std::vector<size_t>& chains, cpp2::ErrorCode code);
+
+        int64_t             txnId_;
+        std::vector<Chain>  chains_;
+    };
+
+    // return false if any edge has been locked by others
+    bool lockEdgesInMemory(int64_t txnId, const std::vector<KV>& edges);
+
+    void unlockEdgesInMemory(int64_t txnId, const std::vector<KV>& edges);
+
+    // turn each <K, encodedValue> into <lockKey, batch>
+    cpp2::ErrorCode encodeLocks(size_t vIdLen,
+                                GraphSpaceID spaceId,
+                                PartitionID localPart,
+                                AddEdgesProcessor* processor,
+                                std::vector<KV>& edges);
+
+    // remove the locks and apply the batches they carry
+    void appendCommit(int64_t txnId, std::vector<KV>& lockData, kvstore::BatchHolder& bat);
+
+    static cpp2::ErrorCode toErrorCode(const folly::Try<kvstore::ResultCode>& t);
+
+    // multi put the in-edges on the leader of remotePart, overridden in test
+    virtual folly::SemiFuture<cpp2::ErrorCode> forwardTransaction(int64_t txnId,
+                                                                  GraphSpaceID spaceId,
+                                                                  PartitionID remotePart,
+                                                                  std::string&& batch);
+
     folly::SemiFuture<kvstore::ResultCode> commitEdgeOut(GraphSpaceID spaceId,
                                                          PartitionID partId,
                                                          std::string&& key,
@@ -0,0 +1,847 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "tools/sst-builder/SstBuilder.h"
+#include "common/fs/FileUtils.h"
+#include "common/time/Duration.h"
+#include <fstream>
+#include <queue>
+#include <thread>
+#include <thrift/lib/cpp/util/EnumUtils.h>
+#include <rocksdb/sst_file_reader.h>
+#include <rocksdb/sst_file_writer.h>
+#include "codec/RowReaderWrapper.h"
+#include "codec/RowWriterV2.h"
+#include "kvstore/RocksEngineConfig.h"
+#include "storage/CommonUtils.h"
+#include "utils/IndexKeyUtils.h"
+#include "utils/NebulaKeyUtils.h"
+
+DEFINE_string(space_name, "", "The space name.");
+DEFINE_string(meta_server, "127.0.0.1:45500", "Meta servers' address.");
+DEFINE_string(tag_files, "", "The vertex files, in the form of tag:path, seperated by comma.");
+DEFINE_string(edge_files, "", "The edge files, in the form of edge:path, seperated by comma.");
+DEFINE_string(output_path, "", "The sst files of part N are written into <output_path>/N/.");
+DEFINE_string(tmp_path, "", "Path of the sorted runs, <output_path>/tmp by default.");
+DEFINE_string(delimiter, ",", "The field delimiter of the input files, \\t for tsv.");
+DEFINE_uint32(thread_num, 8, "The number of threads to encode files and merge parts.");
+DEFINE_uint32(memory_limit_mb, 4096, "Memory of the keys buffered by all threads.");
+DEFINE_uint32(sst_file_size_mb, 256, "The size of each sst file in the output path.");
+DEFINE_uint32(merge_fan_in, 64, "The max number of sorted runs opened by a merge.");
+
+namespace nebula {
+namespace storage {
+
+namespace {
+
+// Memory of a buffered key value besides the strings
+constexpr size_t kKVOverhead = 64;
+
+constexpr char kVidColumn[] = ":vid";
+constexpr char kSrcColumn[] = ":src";
+constexpr char kDstColumn[] = ":dst";
+constexpr char kRankColumn[] = ":rank";
+
+}  // namespace
+
+Status SstBuilder::init() {
+    auto status = initMeta();
+    if (!status.ok()) {
+        return status;
+    }
+
+    status = initSpace();
+    if (!status.ok()) {
+        return status;
+    }
+
+    status = initInputs();
+    if (!status.ok()) {
+        return status;
+    }
+
+    return initDirs();
+}
+
+Status SstBuilder::initMeta() {
+    auto addrs = network::NetworkUtils::toHosts(FLAGS_meta_server);
+    if (!addrs.ok()) {
+        return addrs.status();
+    }
+
+    ioExecutor_ = std::make_shared<folly::IOThreadPoolExecutor>(1);
+    meta::MetaClientOptions options;
+    options.skipConfig_ = true;
+    metaClient_ = std::make_unique<meta::MetaClient>(ioExecutor_,
+                                                     std::move(addrs.value()),
+                                                     options);
+    if (!metaClient_->waitForMetadReady(1)) {
+        return Status::Error("Meta is not ready: '%s'.", FLAGS_meta_server.c_str());
+    }
+    schemaMan_ = meta::ServerBasedSchemaManager::create(metaClient_.get());
+    indexMan_ = meta::ServerBasedIndexManager::create(metaClient_.get());
+    return Status::OK();
+}
+
+Status SstBuilder::initSpace() {
+    if (FLAGS_space_name.empty()) {
+        return Status::Error("Space name is not given.");
+    }
+    auto space = schemaMan_->toGraphSpaceID(FLAGS_space_name);
+    if (!space.ok()) {
+        return Status::Error("Space '%s' not found in meta server.", FLAGS_space_name.c_str());
+    }
+    spaceId_ = space.value();
+
+    auto spaceVidLen = metaClient_->getSpaceVidLen(spaceId_);
+    if (!spaceVidLen.ok()) {
+        return spaceVidLen.status();
+    }
+    spaceVidLen_ = spaceVidLen.value();
+
+    auto vIdType = schemaMan_->getSpaceVidType(spaceId_);
+    if (!vIdType.ok()) {
+        return vIdType.status();
+    }
+    isIntId_ = (vIdType.value() == meta::cpp2::PropertyType::INT64);
+
+    auto partNum = metaClient_->partsNum(spaceId_);
+    if (!partNum.ok()) {
+        return Status::Error("Get partition number from '%s' failed.", FLAGS_space_name.c_str());
+    }
+    partNum_ = partNum.value();
+
+    auto tagIndexes = indexMan_->getTagIndexes(spaceId_);
+    if (!tagIndexes.ok()) {
+        return tagIndexes.status();
+    }
+    for (auto& index : tagIndexes.value()) {
+        tagIndexes_[index->get_schema_id().get_tag_id()].emplace_back(index);
+    }
+    auto edgeIndexes = indexMan_->getEdgeIndexes(spaceId_);
+    if (!edgeIndexes.ok()) {
+        return edgeIndexes.status();
+    }
+    for (auto& index : edgeIndexes.value()) {
+        edgeIndexes_[index->get_schema_id().get_edge_type()].emplace_back(index);
+    }
+
+    // The same table options as the storaged, which reads the rocksdb flags
+    auto s = kvstore::initRocksdbOptions(options_, spaceVidLen_);
+    if (!s.ok()) {
+        return Status::Error("Init rocksdb options failed: %s", s.ToString().c_str());
+    }
+    return Status::OK();
+}
+
+Status SstBuilder::initInputs() {
+    auto status = parseInputs(FLAGS_tag_files, false);
+    if (!status.ok()) {
+        return status;
+    }
+    status = parseInputs(FLAGS_edge_files, true);
+    if (!status.ok()) {
+        return status;
+    }
+    if (inputs_.empty()) {
+        return Status::Error("Neither tag files nor edge files are given.");
+    }
+
+    if (FLAGS_delimiter == "\\t" || FLAGS_delimiter == "\t") {
+        delimiter_ = '\t';
+    } else if (FLAGS_delimiter.size() == 1) {
+        delimiter_ = FLAGS_delimiter[0];
+    } else {
+        return Status::Error("Bad delimiter '%s'.", FLAGS_delimiter.c_str());
+    }
+
+    if (FLAGS_thread_num == 0) {
+        return Status::Error("thread_num must be positive.");
+    }
+    if (FLAGS_merge_fan_in < 2) {
+        return Status::Error("merge_fan_in must be at least 2.");
+    }
+    bufferLimit_ = (static_cast<size_t>(FLAGS_memory_limit_mb) << 20) / FLAGS_thread_num;
+    return Status::OK();
+}
+
+Status SstBuilder::parseInputs(const std::string& flag, bool isEdge) {
+    std::vector<std::string> items;
+    folly::split(",", flag, items, true);
+    for (auto& item : items) {
+        auto pos = item.find(':');
+        if (pos == std::string::npos || pos == 0 || pos + 1 == item.size()) {
+            return Status::Error("Bad input file '%s', expect name:path.", item.c_str());
+        }
+        InputFile file;
+        file.name_ = folly::trimWhitespace(folly::StringPiece(item).subpiece(0, pos)).str();
+        file.path_ = folly::trimWhitespace(folly::StringPiece(item).subpiece(pos + 1)).str();
+        file.isEdge_ = isEdge;
+        if (isEdge) {
+            auto edgeType = schemaMan_->toEdgeType(spaceId_, file.name_);
+            if (!edgeType.ok()) {
+                return Status::Error("Edge '%s' not found in meta.", file.name_.c_str());
+            }
+            file.schemaId_ = edgeType.value();
+        } else {
+            auto tagId = schemaMan_->toTagID(spaceId_, file.name_);
+            if (!tagId.ok()) {
+                return Status::Error("Tag '%s' not found in meta.", file.name_.c_str());
+            }
+            file.schemaId_ = tagId.value();
+        }
+        if (!fs::FileUtils::exist(file.path_)) {
+            return Status::Error("File '%s' not exists.", file.path_.c_str());
+        }
+        inputs_.emplace_back(std::move(file));
+    }
+    return Status::OK();
+}
+
+Status SstBuilder::initDirs() {
+    if (FLAGS_output_path.empty()) {
+        return Status::Error("Output path is not given.");
+    }
+    if (FLAGS_tmp_path.empty()) {
+        FLAGS_tmp_path = fs::FileUtils::joinPath(FLAGS_output_path, "tmp");
+    }
+    if (fs::FileUtils::exist(FLAGS_tmp_path)) {
+        return Status::Error("Tmp path '%s' already exists.", FLAGS_tmp_path.c_str());
+    }
+    if (!fs::FileUtils::makeDir(FLAGS_tmp_path)) {
+        return Status::Error("Make tmp path '%s' failed.", FLAGS_tmp_path.c_str());
+    }
+    for (PartitionID partId = 1; partId <= partNum_; partId++) {
+        auto outPath = fs::FileUtils::joinPath(FLAGS_output_path, folly::to<std::string>(partId));
+        if (!fs::FileUtils::makeDir(outPath)) {
+            return Status::Error("Make dirs of part %d failed.", partId);
+        }
+    }
+    return Status::OK();
+}
+
+std::string SstBuilder::runPath(uint64_t runId) const {
+    // The run ids are of the same width, so the runs are listed from the oldest to the newest
+    return folly::stringPrintf("%s/%020lu.sst", FLAGS_tmp_path.c_str(), runId);
+}
+
+Status SstBuilder::run() {
+    time::Duration dur;
+    auto status = runInParallel(inputs_.size(), [this] (size_t i) {
+        return loadFile(inputs_[i]);
+    });
+    if (!status.ok()) {
+        return status;
+    }
+    LOG(INFO) << "Encoded " << vertexCount_ << " vertices and " << edgeCount_ << " edges into "
+              << runId_ << " sorted runs in " << dur.elapsedInSec() << " seconds, "
+              << errorCount_ << " lines skipped";
+
+    dur.reset();
+    auto runs = fs::FileUtils::listAllFilesInDir(FLAGS_tmp_path.c_str(), true, "*.sst");
+    std::sort(runs.begin(), runs.end());
+    status = compactRuns(&runs);
+    if (!status.ok()) {
+        return status;
+    }
+    status = runInParallel(partNum_, [this, &runs] (size_t i) {
+        return mergePart(static_cast<PartitionID>(i + 1), runs);
+    });
+    if (!status.ok()) {
+        return status;
+    }
+    fs::FileUtils::remove(FLAGS_tmp_path.c_str(), true);
+    LOG(INFO) << "Merged the sorted runs into " << partNum_ << " parts in "
+              << dur.elapsedInSec() << " seconds";
+    return Status::OK();
+}
+
+Status SstBuilder::runInParallel(size_t total, std::function<Status(size_t)> task) {
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::mutex lock;
+    Status status = Status::OK();
+    auto worker = [&] {
+        while (!failed) {
+            auto i = next++;
+            if (i >= total) {
+                break;
+            }
+            auto ret = task(i);
+            if (!ret.ok()) {
+                std::lock_guard<std::mutex> g(lock);
+                if (!failed) {
+                    status = std::move(ret);
+                    failed = true;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    auto threadNum = std::min<size_t>(FLAGS_thread_num, total);
+    for (size_t i = 0; i < threadNum; i++) {
+        threads.emplace_back(worker);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    return status;
+}
+
+Status SstBuilder::loadFile(const InputFile& file) {
+    LOG(INFO) << "Encode " << (file.isEdge_ ? "edge " : "tag ") << file.name_
+              << " from " << file.path_;
+    auto schema = file.isEdge_ ? schemaMan_->getEdgeSchema(spaceId_, file.schemaId_)
+                               : schemaMan_->getTagSchema(spaceId_, file.schemaId_);
+    if (schema == nullptr) {
+        return Status::Error("Schema of '%s' not found.", file.name_.c_str());
+    }
+
+    std::ifstream in(file.path_);
+    if (!in.is_open()) {
+        return Status::Error("Open '%s' failed.", file.path_.c_str());
+    }
+    std::string line;
+    if (!std::getline(in, line)) {
+        return Status::Error("File '%s' has no header.", file.path_.c_str());
+    }
+    auto columns = parseHeader(file, schema.get(), splitLine(line));
+    if (!columns.ok()) {
+        return columns.status();
+    }
+
+    Buffer buffer;
+    size_t lineNo = 1;
+    while (std::getline(in, line)) {
+        lineNo++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+        auto fields = splitLine(line);
+        Status status;
+        if (fields.size() != columns.value().count_) {
+            status = Status::Error("Expect the same number of fields as the header");
+        } else if (file.isEdge_) {
+            status = addEdge(file, schema.get(), columns.value(), fields, &buffer);
+        } else {
+            status = addVertex(file, schema.get(), columns.value(), fields, &buffer);
+        }
+        if (!status.ok()) {
+            // A bad line is skipped rather than failing the whole file
+            LOG(ERROR) << file.path_ << ":" << lineNo << " " << status;
+            errorCount_++;
+            continue;
+        }
+        if (buffer.bytes_ >= bufferLimit_) {
+            auto ret = spill(&buffer);
+            if (!ret.ok()) {
+                return ret;
+            }
+        }
+    }
+    if (in.bad()) {
+        return Status::Error("Read '%s' failed.", file.path_.c_str());
+    }
+    return spill(&buffer);
+}
+
+StatusOr<SstBuilder::Columns>
+SstBuilder::parseHeader(const InputFile& file,
+                        const meta::NebulaSchemaProvider* schema,
+                        const std::vector<std::string>& fields) {
+    Columns columns;
+    columns.count_ = fields.size();
+    for (int32_t i = 0; i < static_cast<int32_t>(fields.size()); i++) {
+        auto name = folly::trimWhitespace(fields[i]).str();
+        if (!file.isEdge_ && name == kVidColumn) {
+            columns.vid_ = i;
+        } else if (file.isEdge_ && name == kSrcColumn) {
+            columns.src_ = i;
+        } else if (file.isEdge_ && name == kDstColumn) {
+            columns.dst_ = i;
+        } else if (file.isEdge_ && name == kRankColumn) {
+            columns.rank_ = i;
+        } else if (schema->getFieldIndex(name) >= 0) {
+            columns.props_.emplace_back(i, std::move(name));
+        } else {
+            return Status::Error("Unknown column '%s' in the header of '%s'.",
+                                 name.c_str(), file.path_.c_str());
+        }
+    }
+    if (file.isEdge_ ? (columns.src_ < 0 || columns.dst_ < 0) : columns.vid_ < 0) {
+        return Status::Error("The header of '%s' has no %s column.", file.path_.c_str(),
+                             file.isEdge_ ? ":src or :dst" : ":vid");
+    }
+    return columns;
+}
+
+std::vector<std::string> SstBuilder::splitLine(const std::string& line) {
+    // A field could be quoted by ", in which the delimiter is kept and "" stands for a "
+    std::vector<std::string> fields;
+    std::string field;
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); i++) {
+        auto c = line[i];
+        if (quoted) {
+            if (c != '"') {
+                field.push_back(c);
+            } else if (i + 1 < line.size() && line[i + 1] == '"') {
+                field.push_back('"');
+                i++;
+            } else {
+                quoted = false;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == delimiter_) {
+            fields.emplace_back(std::move(field));
+            field.clear();
+        } else {
+            field.push_back(c);
+        }
+    }
+    fields.emplace_back(std::move(field));
+    return fields;
+}
+
+StatusOr<VertexID> SstBuilder::toVid(const std::string& field) {
+    if (isIntId_) {
+        auto vid = folly::tryTo<int64_t>(folly::trimWhitespace(field));
+        if (!vid.hasValue()) {
+            return Status::Error("Bad int vid '%s'", field.c_str());
+        }
+        int64_t v = vid.value();
+        return std::string(reinterpret_cast<const char*>(&v), sizeof(int64_t));
+    }
+    if (!NebulaKeyUtils::isValidVidLen(spaceVidLen_, field)) {
+        return Status::Error("Vid '%s' is longer than %d", field.c_str(), spaceVidLen_);
+    }
+    return field;
+}
+
+StatusOr<Value> SstBuilder::toValue(const std::string& field, meta::cpp2::PropertyType type) {
+    auto str = folly::trimWhitespace(field);
+    switch (type) {
+        case meta::cpp2::PropertyType::BOOL: {
+            if (str == "true" || str == "TRUE" || str == "1") {
+                return Value(true);
+            } else if (str == "false" || str == "FALSE" || str == "0") {
+                return Value(false);
+            }
+            break;
+        }
+        case meta::cpp2::PropertyType::INT8:
+        case meta::cpp2::PropertyType::INT16:
+        case meta::cpp2::PropertyType::INT32:
+        case meta::cpp2::PropertyType::INT64:
+        case meta::cpp2::PropertyType::TIMESTAMP: {
+            auto v = folly::tryTo<int64_t>(str);
+            if (v.hasValue()) {
+                return Value(v.value());
+            }
+            break;
+        }
+        case meta::cpp2::PropertyType::FLOAT:
+        case meta::cpp2::PropertyType::DOUBLE: {
+            auto v = folly::tryTo<double>(str);
+            if (v.hasValue()) {
+                return Value(v.value());
+            }
+            break;
+        }
+        case meta::cpp2::PropertyType::STRING:
+        case meta::cpp2::PropertyType::FIXED_STRING: {
+            // Strings are kept as they are
+            return Value(field);
+        }
+        case meta::cpp2::PropertyType::DATE: {
+            int32_t year, month, day;
+            if (sscanf(str.str().c_str(), "%d-%d-%d", &year, &month, &day) == 3) {
+                Date date;
+                date.year = year;
+                date.month = month;
+                date.day = day;
+                return Value(date);
+            }
+            break;
+        }
+        case meta::cpp2::PropertyType::DATETIME: {
+            // yyyy-mm-ddThh:mm:ss[.uuuuuu], the separator could also be a space
+            int32_t year, month, day, hour, minute, sec, microsec = 0;
+            if (sscanf(str.str().c_str(), "%d-%d-%d%*c%d:%d:%d.%d",
+                       &year, &month, &day, &hour, &minute, &sec, &microsec) >= 6) {
+                DateTime dt;
+                dt.year = year;
+                dt.month = month;
+                dt.day = day;
+                dt.hour = hour;
+                dt.minute = minute;
+                dt.sec = sec;
+                dt.microsec = microsec;
+                return Value(dt);
+            }
+            break;
+        }
+        case meta::cpp2::PropertyType::TIME: {
+            int32_t hour, minute, sec, microsec = 0;
+            if (sscanf(str.str().c_str(), "%d:%d:%d.%d",
+                       &hour, &minute, &sec, &microsec) >= 3) {
+                Time t;
+                t.hour = hour;
+                t.minute = minute;
+                t.sec = sec;
+                t.microsec = microsec;
+                return Value(t);
+            }
+            break;
+        }
+        default:
+            return Status::Error("Unsupported property type %s",
+                                 apache::thrift::util::enumNameSafe(type).c_str());
+    }
+    return Status::Error("Bad %s value '%s'",
+                         apache::thrift::util::enumNameSafe(type).c_str(), field.c_str());
+}
+
+StatusOr<std::string> SstBuilder::encodeRow(const meta::NebulaSchemaProvider* schema,
+                                            const Columns& columns,
+                                            const std::vector<std::string>& fields) {
+    RowWriterV2 writer(schema);
+    for (const auto& prop : columns.props_) {
+        const auto& field = fields[prop.first];
+        if (field.empty()) {
+            // The default value or null is used
+            continue;
+        }
+        auto index = schema->getFieldIndex(prop.second);
+        auto value = toValue(field, schema->getFieldType(index));
+        if (!value.ok()) {
+            return value.status();
+        }
+        auto wRet = writer.setValue(prop.second, std::move(value).value());
+        if (wRet != WriteResult::SUCCEEDED) {
+            return Status::Error("Write property '%s' failed: %d",
+                                 prop.second.c_str(), static_cast<int32_t>(wRet));
+        }
+    }
+    auto wRet = writer.finish();
+    if (wRet != WriteResult::SUCCEEDED) {
+        return Status::Error("Encode row failed: %d", static_cast<int32_t>(wRet));
+    }
+    return std::move(writer).moveEncodedStr();
+}
+
+Status SstBuilder::addVertex(const InputFile& file,
+                             const meta::NebulaSchemaProvider* schema,
+                             const Columns& columns,
+                             const std::vector<std::string>& fields,
+                             Buffer* buffer) {
+    auto vid = toVid(fields[columns.vid_]);
+    if (!vid.ok()) {
+        return vid.status();
+    }
+    auto partId = metaClient_->partId(spaceId_, vid.value());
+    if (!partId.ok()) {
+        return partId.status();
+    }
+    auto row = encodeRow(schema, columns, fields);
+    if (!row.ok()) {
+        return row.status();
+    }
+
+    auto tagId = file.schemaId_;
+    auto indexes = tagIndexes_.find(tagId);
+    if (indexes != tagIndexes_.end()) {
+        auto reader = RowReaderWrapper::getRowReader(schema, row.value());
+        if (reader == nullptr) {
+            return Status::Error("Bad format row");
+        }
+        auto ttl = CommonUtils::ttlValue(schema, reader.get());
+        for (const auto& index : indexes->second) {
+            auto values = IndexKeyUtils::collectIndexValues(reader.get(), index->get_fields());
+            if (!values.ok()) {
+                continue;
+            }
+            auto key = IndexKeyUtils::vertexIndexKey(spaceVidLen_, partId.value(),
+                                                     index->get_index_id(), vid.value(),
+                                                     std::move(values).value());
+            append(buffer, std::move(key),
+                   ttl.ok() ? IndexKeyUtils::indexVal(ttl.value()) : "");
+        }
+    }
+    append(buffer,
+           NebulaKeyUtils::vertexKey(spaceVidLen_, partId.value(), vid.value(), tagId),
+           std::move(row).value());
+    vertexCount_++;
+    return Status::OK();
+}
+
+Status SstBuilder::addEdge(const InputFile& file,
+                           const meta::NebulaSchemaProvider* schema,
+                           const Columns& columns,
+                           const std::vector<std::string>& fields,
+                           Buffer* buffer) {
+    auto src = toVid(fields[columns.src_]);
+    if (!src.ok()) {
+        return src.status();
+    }
+    auto dst = toVid(fields[columns.dst_]);
+    if (!dst.ok()) {
+        return dst.status();
+    }
+    EdgeRanking rank = 0;
+    if (columns.rank_ >= 0 && !folly::trimWhitespace(fields[columns.rank_]).empty()) {
+        auto ret = folly::tryTo<int64_t>(folly::trimWhitespace(fields[columns.rank_]));
+        if (!ret.hasValue()) {
+            return Status::Error("Bad rank '%s'", fields[columns.rank_].c_str());
+        }
+        rank = ret.value();
+    }
+    auto srcPart = metaClient_->partId(spaceId_, src.value());
+    if (!srcPart.ok()) {
+        return srcPart.status();
+    }
+    auto dstPart = metaClient_->partId(spaceId_, dst.value());
+    if (!dstPart.ok()) {
+        return dstPart.status();
+    }
+    auto row = encodeRow(schema, columns, fields);
+    if (!row.ok()) {
+        return row.status();
+    }
+
+    // Only the out edge has indexes
+    EdgeType edgeType = file.schemaId_;
+    auto indexes = edgeIndexes_.find(edgeType);
+    if (indexes != edgeIndexes_.end()) {
+        auto reader = RowReaderWrapper::getRowReader(schema, row.value());
+        if (reader == nullptr) {
+            return Status::Error("Bad format row");
+        }
+        auto ttl = CommonUtils::ttlValue(schema, reader.get());
+        for (const auto& index : indexes->second) {
+            auto values = IndexKeyUtils::collectIndexValues(reader.get(), index->get_fields());
+            if (!values.ok()) {
+                continue;
+            }
+            auto key = IndexKeyUtils::edgeIndexKey(spaceVidLen_, srcPart.value(),
+                                                   index->get_index_id(), src.value(), rank,
+                                                   dst.value(), std::move(values).value());
+            append(buffer, std::move(key),
+                   ttl.ok() ? IndexKeyUtils::indexVal(ttl.value()) : "");
+        }
+    }
+    append(buffer,
+           NebulaKeyUtils::edgeKey(spaceVidLen_, srcPart.value(), src.value(), edgeType, rank,
+                                   dst.value()),
+           row.value());
+    append(buffer,
+           NebulaKeyUtils::edgeKey(spaceVidLen_, dstPart.value(), dst.value(), -edgeType, rank,
+                                   src.value()),
+           std::move(row).value());
+    edgeCount_++;
+    return Status::OK();
+}
+
+void SstBuilder::append(Buffer* buffer, std::string key, std::string val) {
+    buffer->bytes_ += key.size() + val.size() + kKVOverhead;
+    buffer->data_.emplace_back(std::move(key), std::move(val));
+}
+
+Status SstBuilder::spill(Buffer* buffer) {
+    auto& kvs = buffer->data_;
+    if (kvs.empty()) {
+        return Status::OK();
+    }
+    // Stable, so the last one of the same key in the file is the newest. The keys of all parts
+    // go into the same run, each part is picked out by its prefixes when merging.
+    std::stable_sort(kvs.begin(), kvs.end(), [] (const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    auto path = runPath(runId_++);
+    rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), options_);
+    auto s = writer.Open(path);
+    for (size_t i = 0; s.ok() && i < kvs.size(); i++) {
+        if (i + 1 < kvs.size() && kvs[i + 1].first == kvs[i].first) {
+            continue;
+        }
+        s = writer.Put(kvs[i].first, kvs[i].second);
+    }
+    if (s.ok()) {
+        s = writer.Finish();
+    }
+    if (!s.ok()) {
+        return Status::Error("Write sorted run '%s' failed: %s",
+                             path.c_str(), s.ToString().c_str());
+    }
+    kvs.clear();
+    buffer->bytes_ = 0;
+    return Status::OK();
+}
+
+Status SstBuilder::compactRuns(std::vector<std::string>* runs) {
+    size_t fanIn = FLAGS_merge_fan_in;
+    while (runs->size() > fanIn) {
+        // Each group of adjacent runs is merged into a run, the merged runs keep the order of
+        // the groups, so the newer one of a key still wins in the next pass
+        size_t groups = (runs->size() + fanIn - 1) / fanIn;
+        uint64_t firstId = runId_.fetch_add(groups);
+        std::vector<std::string> merged(groups);
+        auto status = runInParallel(groups, [&] (size_t g) {
+            std::vector<std::string> group(
+                runs->begin() + g * fanIn,
+                runs->begin() + std::min(runs->size(), (g + 1) * fanIn));
+            if (group.size() == 1) {
+                merged[g] = group.front();
+                return Status::OK();
+            }
+            merged[g] = runPath(firstId + g);
+            std::vector<std::string> outputs;
+            auto ret = mergeRuns(group, {""}, [&] { return merged[g]; },
+                                 std::numeric_limits<uint64_t>::max(), &outputs);
+            if (!ret.ok()) {
+                return ret;
+            }
+            for (const auto& run : group) {
+                fs::FileUtils::remove(run.c_str());
+            }
+            return Status::OK();
+        });
+        if (!status.ok()) {
+            return status;
+        }
+        LOG(INFO) << "Merged " << runs->size() << " sorted runs into " << groups;
+        *runs = std::move(merged);
+    }
+    return Status::OK();
+}
+
+Status SstBuilder::mergePart(PartitionID partId, const std::vector<std::string>& runs) {
+    // The ranges of the prefixes are merged one by one, so the keys are written in order
+    auto prefixes = NebulaKeyUtils::snapshotPrefix(partId);
+    std::sort(prefixes.begin(), prefixes.end());
+    std::vector<std::string> outputs;
+    auto status = mergeRuns(runs, prefixes, [&] {
+        return folly::stringPrintf("%s/%d/data_%06lu.sst", FLAGS_output_path.c_str(),
+                                   partId, outputs.size());
+    }, static_cast<uint64_t>(FLAGS_sst_file_size_mb) << 20, &outputs);
+    if (!status.ok()) {
+        return status;
+    }
+    LOG(INFO) << "Part " << partId << " merged " << runs.size() << " sorted runs into "
+              << outputs.size() << " sst files";
+    return Status::OK();
+}
+
+Status SstBuilder::mergeRuns(const std::vector<std::string>& runs,
+                             const std::vector<std::string>& prefixes,
+                             std::function<std::string()> nextPath,
+                             uint64_t fileSizeLimit,
+                             std::vector<std::string>* outputs) {
+    std::vector<std::unique_ptr<rocksdb::SstFileReader>> readers;
+    std::vector<std::unique_ptr<rocksdb::Iterator>> iters;
+    for (const auto& run : runs) {
+        auto reader = std::make_unique<rocksdb::SstFileReader>(options_);
+        auto s = reader->Open(run);
+        if (!s.ok()) {
+            return Status::Error("Open sorted run '%s' failed: %s",
+                                 run.c_str(), s.ToString().c_str());
+        }
+        iters.emplace_back(reader->NewIterator(rocksdb::ReadOptions()));
+        readers.emplace_back(std::move(reader));
+    }
+
+    // The smallest key on top, and the newest run among those of the same key
+    auto cmp = [&iters] (size_t a, size_t b) {
+        int c = iters[a]->key().compare(iters[b]->key());
+        return c > 0 || (c == 0 && a < b);
+    };
+
+    std::unique_ptr<rocksdb::SstFileWriter> writer;
+    auto finish = [&] () -> Status {
+        if (writer == nullptr) {
+            return Status::OK();
+        }
+        auto s = writer->Finish();
+        writer.reset();
+        if (!s.ok()) {
+            return Status::Error("Write '%s' failed: %s",
+                                 outputs->back().c_str(), s.ToString().c_str());
+        }
+        return Status::OK();
+    };
+
+    std::string key;
+    for (const auto& prefix : prefixes) {
+        auto valid = [&iters, &prefix] (size_t i) {
+            return iters[i]->Valid() && iters[i]->key().starts_with(prefix);
+        };
+        std::priority_queue<size_t, std::vector<size_t>, decltype(cmp)> heap(cmp);
+        for (size_t i = 0; i < iters.size(); i++) {
+            iters[i]->Seek(prefix);
+            if (valid(i)) {
+                heap.push(i);
+            }
+        }
+
+        while (!heap.empty()) {
+            auto top = heap.top();
+            heap.pop();
+            if (writer == nullptr) {
+                auto path = nextPath();
+                writer = std::make_unique<rocksdb::SstFileWriter>(rocksdb::EnvOptions(),
+                                                                  options_);
+                auto s = writer->Open(path);
+                if (!s.ok()) {
+                    return Status::Error("Open '%s' failed: %s",
+                                         path.c_str(), s.ToString().c_str());
+                }
+                outputs->emplace_back(std::move(path));
+            }
+            key = iters[top]->key().ToString();
+            auto s = writer->Put(key, iters[top]->value());
+            if (!s.ok()) {
+                return Status::Error("Write '%s' failed: %s",
+                                     outputs->back().c_str(), s.ToString().c_str());
+            }
+
+            // Skip the older versions of the key
+            iters[top]->Next();
+            if (valid(top)) {
+                heap.push(top);
+            }
+            while (!heap.empty() && iters[heap.top()]->key() == key) {
+                auto older = heap.top();
+                heap.pop();
+                iters[older]->Next();
+                if (valid(older)) {
+                    heap.push(older);
+                }
+            }
+
+            if (writer->FileSize() >= fileSizeLimit) {
+                auto status = finish();
+                if (!status.ok()) {
+                    return status;
+                }
+            }
+        }
+    }
+    for (const auto& iter : iters) {
+        if (!iter->status().ok()) {
+            return Status::Error("Read sorted runs failed: %s",
+                                 iter->status().ToString().c_str());
+        }
+    }
+    return finish();
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,187 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef TOOLS_SSTBUILDER_SSTBUILDER_H_
+#define TOOLS_SSTBUILDER_SSTBUILDER_H_
+
+#include "common/base/Base.h"
+#include "common/base/Status.h"
+#include "common/clients/meta/MetaClient.h"
+#include "common/meta/ServerBasedSchemaManager.h"
+#include "common/meta/ServerBasedIndexManager.h"
+#include <gtest/gtest_prod.h>
+#include <rocksdb/options.h>
+#include "kvstore/Common.h"
+
+DECLARE_string(space_name);
+DECLARE_string(meta_server);
+DECLARE_string(tag_files);
+DECLARE_string(edge_files);
+DECLARE_string(output_path);
+DECLARE_string(tmp_path);
+DECLARE_string(delimiter);
+DECLARE_uint32(thread_num);
+DECLARE_uint32(memory_limit_mb);
+DECLARE_uint32(sst_file_size_mb);
+DECLARE_uint32(merge_fan_in);
+
+namespace nebula {
+namespace storage {
+
+/**
+ * Builds ingest-ready sst files of a space from csv files, without going through storaged.
+ *
+ * Each input file holds the vertices of one tag or the edges of one edge type, and its first
+ * line names the columns: ":vid" for a vertex, ":src", ":dst" and the optional ":rank" for an
+ * edge, the others are property names. The keys and rows are encoded the same way as
+ * AddVertices and AddEdges do, including the reverse edges and the index entries, and each
+ * key goes to the part which the meta service assigns to its vertex.
+ *
+ * The files are encoded in parallel, one file in each thread. Whenever the buffered keys of a
+ * file exceed the thread's share of the memory limit, and at the end of the file, they are
+ * sorted and spilled into one sorted run, in which the keys of a part lie in the ranges of its
+ * prefixes. At last the runs are merged, at most FLAGS_merge_fan_in of them at once: the runs are
+ * merged in passes till few enough are left, then the keys of each part are merged from them into
+ * sst files under <output_path>/<partId>/, which is the layout the download and ingest handlers
+ * of storaged expect.
+ *
+ * When a key shows up more than once, the last one of the same file is kept. Since no old row
+ * is read, a vertex or edge must not appear twice with different indexed values.
+ * */
+class SstBuilder {
+    FRIEND_TEST(SstBuilderTest, EncodeTest);
+    FRIEND_TEST(SstBuilderTest, MergeTest);
+
+public:
+    SstBuilder() = default;
+
+    ~SstBuilder() = default;
+
+    Status init();
+
+    Status run();
+
+private:
+    struct InputFile {
+        std::string   path_;
+        std::string   name_;
+        bool          isEdge_;
+        // TagID or EdgeType
+        int32_t       schemaId_;
+    };
+
+    // The keys buffered while encoding a file
+    struct Buffer {
+        std::vector<kvstore::KV>    data_;
+        size_t                      bytes_{0};
+    };
+
+    // The columns named by the first line of a file
+    struct Columns {
+        size_t                                      count_{0};
+        int32_t                                     vid_{-1};
+        int32_t                                     src_{-1};
+        int32_t                                     dst_{-1};
+        int32_t                                     rank_{-1};
+        // column index and property name
+        std::vector<std::pair<int32_t, std::string>> props_;
+    };
+
+    Status initMeta();
+
+    Status initSpace();
+
+    Status initInputs();
+
+    Status parseInputs(const std::string& flag, bool isEdge);
+
+    Status initDirs();
+
+    // Run task(0) ... task(total - 1) in FLAGS_thread_num threads, stop at the first failure
+    Status runInParallel(size_t total, std::function<Status(size_t)> task);
+
+    // Encode a file, the keys are spilled once a buffer is full and at the end of the file
+    Status loadFile(const InputFile& file);
+
+    StatusOr<Columns> parseHeader(const InputFile& file,
+                                  const meta::NebulaSchemaProvider* schema,
+                                  const std::vector<std::string>& fields);
+
+    std::vector<std::string> splitLine(const std::string& line);
+
+    StatusOr<VertexID> toVid(const std::string& field);
+
+    StatusOr<Value> toValue(const std::string& field, meta::cpp2::PropertyType type);
+
+    StatusOr<std::string> encodeRow(const meta::NebulaSchemaProvider* schema,
+                                    const Columns& columns,
+                                    const std::vector<std::string>& fields);
+
+    Status addVertex(const InputFile& file,
+                     const meta::NebulaSchemaProvider* schema,
+                     const Columns& columns,
+                     const std::vector<std::string>& fields,
+                     Buffer* buffer);
+
+    Status addEdge(const InputFile& file,
+                   const meta::NebulaSchemaProvider* schema,
+                   const Columns& columns,
+                   const std::vector<std::string>& fields,
+                   Buffer* buffer);
+
+    void append(Buffer* buffer, std::string key, std::string val);
+
+    // Sort the buffered keys and write them as a sorted run
+    Status spill(Buffer* buffer);
+
+    // Merge the runs, from the oldest to the newest, in passes till no more than
+    // FLAGS_merge_fan_in are left
+    Status compactRuns(std::vector<std::string>* runs);
+
+    // Merge the keys of a part in the runs into the sst files in the output path
+    Status mergePart(PartitionID partId, const std::vector<std::string>& runs);
+
+    // Merge the keys with the prefixes, which are in order, into the files named by nextPath,
+    // a file is rolled once it reaches fileSizeLimit. Of the same key, the one in the newest run
+    // is kept. The paths of the files written are appended to outputs.
+    Status mergeRuns(const std::vector<std::string>& runs,
+                     const std::vector<std::string>& prefixes,
+                     std::function<std::string()> nextPath,
+                     uint64_t fileSizeLimit,
+                     std::vector<std::string>* outputs);
+
+    std::string runPath(uint64_t runId) const;
+
+private:
+    std::shared_ptr<folly::IOThreadPoolExecutor>                    ioExecutor_;
+    std::unique_ptr<meta::MetaClient>                               metaClient_;
+    std::unique_ptr<meta::ServerBasedSchemaManager>                 schemaMan_;
+    std::unique_ptr<meta::ServerBasedIndexManager>                  indexMan_;
+    GraphSpaceID                                                    spaceId_;
+    int32_t                                                         spaceVidLen_;
+    bool                                                            isIntId_{false};
+    int32_t                                                         partNum_;
+    rocksdb::Options                                                options_;
+
+    std::vector<InputFile>                                          inputs_;
+    std::unordered_map<TagID,
+        std::vector<std::shared_ptr<meta::cpp2::IndexItem>>>        tagIndexes_;
+    std::unordered_map<EdgeType,
+        std::vector<std::shared_ptr<meta::cpp2::IndexItem>>>        edgeIndexes_;
+    char                                                            delimiter_;
+    // Bytes a thread buffers before spilling
+    size_t                                                          bufferLimit_;
+
+    // A run with a larger id is newer
+    std::atomic<uint64_t>                                           runId_{0};
+    std::atomic<int64_t>                                            vertexCount_{0};
+    std::atomic<int64_t>                                            edgeCount_{0};
+    std::atomic<int64_t>                                            errorCount_{0};
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // TOOLS_SSTBUILDER_SSTBUILDER_H_
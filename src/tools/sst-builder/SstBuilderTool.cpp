@@ -0,0 +1,96 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "common/base/Base.h"
+#include "tools/sst-builder/SstBuilder.h"
+
+void printHelp() {
+    fprintf(stderr,
+           R"(  ./sst_builder --space_name=<space name> --output_path=<path> --tag_files=<...>
+
+required:
+       --space_name=<space name>
+         The space must have been created, with the tags, edges and indexes.
+
+       --output_path=<path>
+         The sst files of part N are written into <output_path>/N/. Upload the directory
+         to hdfs and download it by storaged, or copy <output_path>/N/ into
+         <data_path>/nebula/<space id>/download/N/ of the leader, and then ingest.
+
+       --tag_files=<tag:path,...> and/or --edge_files=<edge:path,...>
+         The first line of a file names its columns. A vertex file must have a :vid
+         column, an edge file must have a :src and a :dst column and could have a :rank
+         column, the other columns are properties. An empty field leaves the property
+         to its default value or null.
+
+optional:
+       --meta_server=<ip:port,...>
+         A list of meta severs' ip:port seperated by comma.
+         Default: 127.0.0.1:45500
+
+       --delimiter=<char>
+         The field delimiter, \t for tsv. A field could be quoted by ".
+         Default: ,
+
+       --tmp_path=<path>
+         Where the sorted runs are spilled, it must not exist yet.
+         Default: <output_path>/tmp
+
+       --thread_num=<N>
+         The files are encoded in N threads, one file in each thread, and then the
+         parts are merged in N threads.
+         Default: 8
+
+       --memory_limit_mb=<N>
+         Memory of the keys buffered by all threads before they are spilled.
+         Default: 4096
+
+       --sst_file_size_mb=<N>
+         The size of each output sst file.
+         Default: 256
+
+       The rocksdb flags of storaged, e.g. --rocksdb_block_based_table_options, should be
+       the same as storaged, so are the table options of the sst files.
+)");
+}
+
+void printParams() {
+    std::cout << "===========================PARAMS============================\n";
+    std::cout << "meta server: " << FLAGS_meta_server << "\n";
+    std::cout << "space name: " << FLAGS_space_name << "\n";
+    std::cout << "tag files: " << FLAGS_tag_files << "\n";
+    std::cout << "edge files: " << FLAGS_edge_files << "\n";
+    std::cout << "output path: " << FLAGS_output_path << "\n";
+    std::cout << "thread num: " << FLAGS_thread_num << "\n";
+    std::cout << "memory limit: " << FLAGS_memory_limit_mb << "MB\n";
+    std::cout << "===========================PARAMS============================\n\n";
+}
+
+int main(int argc, char *argv[]) {
+    if (argc == 1) {
+        printHelp();
+        return EXIT_FAILURE;
+    } else {
+        folly::init(&argc, &argv, true);
+    }
+
+    google::SetStderrLogging(google::INFO);
+
+    printParams();
+
+    nebula::storage::SstBuilder builder;
+    auto status = builder.init();
+    if (!status.ok()) {
+        std::cerr << "Error: " << status << "\n\n";
+        return EXIT_FAILURE;
+    }
+    status = builder.run();
+    if (!status.ok()) {
+        std::cerr << "Error: " << status << "\n\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,273 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "common/base/Base.h"
+#include "common/fs/TempDir.h"
+#include "common/fs/FileUtils.h"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <rocksdb/sst_file_reader.h>
+#include "codec/RowReaderWrapper.h"
+#include "meta/test/TestUtils.h"
+#include "mock/MockCluster.h"
+#include "tools/sst-builder/SstBuilder.h"
+#include "utils/IndexKeyUtils.h"
+#include "utils/NebulaKeyUtils.h"
+
+DECLARE_int32(heartbeat_interval_secs);
+
+namespace nebula {
+namespace storage {
+
+// Read the sst files of a part in the order of their names, the keys must be in order across them
+static std::vector<kvstore::KV> readPart(PartitionID partId) {
+    auto path = fs::FileUtils::joinPath(FLAGS_output_path, folly::to<std::string>(partId));
+    auto files = fs::FileUtils::listAllFilesInDir(path.c_str(), true, "*.sst");
+    std::sort(files.begin(), files.end());
+    std::vector<kvstore::KV> kvs;
+    for (const auto& file : files) {
+        rocksdb::SstFileReader reader(rocksdb::Options{});
+        auto s = reader.Open(file);
+        CHECK(s.ok()) << s.ToString();
+        std::unique_ptr<rocksdb::Iterator> iter(reader.NewIterator(rocksdb::ReadOptions()));
+        for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+            auto key = iter->key().ToString();
+            EXPECT_EQ(partId, NebulaKeyUtils::getPart(key));
+            if (!kvs.empty()) {
+                EXPECT_LT(kvs.back().first, key);
+            }
+            kvs.emplace_back(std::move(key), iter->value().ToString());
+        }
+    }
+    return kvs;
+}
+
+static void writeFile(const std::string& path, const std::vector<std::string>& lines) {
+    std::ofstream out(path);
+    for (const auto& line : lines) {
+        out << line << "\n";
+    }
+}
+
+static meta::cpp2::ColumnDef column(const std::string& name, meta::cpp2::PropertyType type) {
+    meta::cpp2::ColumnDef col;
+    col.set_name(name);
+    col.type.set_type(type);
+    col.set_nullable(true);
+    return col;
+}
+
+TEST(SstBuilderTest, EncodeTest) {
+    FLAGS_heartbeat_interval_secs = 1;
+    fs::TempDir rootPath("/tmp/SstBuilderEncodeTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.startMeta(fs::FileUtils::joinPath(rootPath.path(), "meta"));
+    cluster.initMetaClient();
+    auto* client = cluster.metaClient_.get();
+    meta::TestUtils::createSomeHosts(cluster.metaKV_.get());
+
+    GraphSpaceID spaceId;
+    {
+        meta::cpp2::SpaceDesc spaceDesc;
+        spaceDesc.set_space_name("sst_space");
+        spaceDesc.set_partition_num(3);
+        spaceDesc.set_replica_factor(1);
+        auto ret = client->createSpace(spaceDesc).get();
+        ASSERT_TRUE(ret.ok()) << ret.status();
+        spaceId = ret.value();
+    }
+    {
+        meta::cpp2::Schema schema;
+        schema.columns.emplace_back(column("name", meta::cpp2::PropertyType::STRING));
+        schema.columns.emplace_back(column("age", meta::cpp2::PropertyType::INT64));
+        ASSERT_TRUE(client->createTagSchema(spaceId, "person", schema).get().ok());
+        meta::cpp2::IndexFieldDef field;
+        field.set_name("age");
+        ASSERT_TRUE(client->createTagIndex(spaceId, "person_age", "person", {field}).get().ok());
+    }
+    {
+        meta::cpp2::Schema schema;
+        schema.columns.emplace_back(column("likeness", meta::cpp2::PropertyType::INT64));
+        ASSERT_TRUE(client->createEdgeSchema(spaceId, "like", schema).get().ok());
+        meta::cpp2::IndexFieldDef field;
+        field.set_name("likeness");
+        ASSERT_TRUE(client->createEdgeIndex(spaceId, "like_likeness", "like", {field}).get().ok());
+    }
+
+    auto personFile = fs::FileUtils::joinPath(rootPath.path(), "person.csv");
+    auto likeFile = fs::FileUtils::joinPath(rootPath.path(), "like.csv");
+    // The last one of a vertex in the file is kept
+    writeFile(personFile, {":vid,name,age",
+                           "Tim,Tim,42",
+                           "Tony,\"Parker, Tony\",36",
+                           "bad,Bad,not_an_int",
+                           "Tim,Tim Duncan,42"});
+    writeFile(likeFile, {":src,:dst,:rank,likeness",
+                         "Tim,Tony,0,90",
+                         "Tony,Tim,1,80"});
+
+    FLAGS_meta_server = folly::stringPrintf("%s:%d", mock::MockCluster::localIP().c_str(),
+                                            cluster.metaServer_->port_);
+    FLAGS_space_name = "sst_space";
+    FLAGS_tag_files = "person:" + personFile;
+    FLAGS_edge_files = "like:" + likeFile;
+    FLAGS_output_path = fs::FileUtils::joinPath(rootPath.path(), "output");
+    FLAGS_tmp_path = "";
+    FLAGS_thread_num = 2;
+
+    SstBuilder builder;
+    auto status = builder.init();
+    ASSERT_TRUE(status.ok()) << status;
+    status = builder.run();
+    ASSERT_TRUE(status.ok()) << status;
+    EXPECT_EQ(3, builder.vertexCount_);
+    EXPECT_EQ(2, builder.edgeCount_);
+    EXPECT_EQ(1, builder.errorCount_);
+    EXPECT_FALSE(fs::FileUtils::exist(FLAGS_tmp_path));
+
+    std::map<std::string, std::string> kvs;
+    for (PartitionID partId = 1; partId <= 3; partId++) {
+        for (auto& kv : readPart(partId)) {
+            kvs.emplace(std::move(kv));
+        }
+    }
+    // Two vertices, two out edges and two in edges, and an index entry of each vertex and out edge
+    ASSERT_EQ(10, kvs.size());
+
+    auto* schemaMan = builder.schemaMan_.get();
+    auto tagId = schemaMan->toTagID(spaceId, "person").value();
+    auto edgeType = schemaMan->toEdgeType(spaceId, "like").value();
+    auto tagIndex = builder.tagIndexes_[tagId].front();
+    auto edgeIndex = builder.edgeIndexes_[edgeType].front();
+    auto partOf = [&] (const std::string& vid) {
+        return builder.metaClient_->partId(spaceId, vid).value();
+    };
+    auto vidLen = builder.spaceVidLen_;
+    ASSERT_EQ(8, vidLen);
+
+    {
+        auto tagSchema = schemaMan->getTagSchema(spaceId, tagId);
+        auto check = [&] (const std::string& vid, const std::string& name, int64_t age) {
+            auto part = partOf(vid);
+            auto it = kvs.find(NebulaKeyUtils::vertexKey(vidLen, part, vid, tagId));
+            ASSERT_NE(kvs.end(), it);
+            auto reader = RowReaderWrapper::getRowReader(tagSchema.get(), it->second);
+            ASSERT_NE(nullptr, reader);
+            EXPECT_EQ(name, reader->getValueByName("name").getStr());
+            EXPECT_EQ(age, reader->getValueByName("age").getInt());
+
+            auto values = IndexKeyUtils::encodeValues({Value(age)}, tagIndex->get_fields());
+            auto indexKey = IndexKeyUtils::vertexIndexKey(vidLen, part, tagIndex->get_index_id(),
+                                                          vid, std::move(values));
+            it = kvs.find(indexKey);
+            ASSERT_NE(kvs.end(), it);
+            EXPECT_EQ("", it->second);
+        };
+        check("Tim", "Tim Duncan", 42);
+        check("Tony", "Parker, Tony", 36);
+    }
+    {
+        auto edgeSchema = schemaMan->getEdgeSchema(spaceId, edgeType);
+        auto check = [&] (const std::string& src, const std::string& dst,
+                          EdgeRanking rank, int64_t likeness) {
+            auto srcPart = partOf(src);
+            auto dstPart = partOf(dst);
+            auto out = kvs.find(NebulaKeyUtils::edgeKey(vidLen, srcPart, src, edgeType, rank,
+                                                        dst));
+            ASSERT_NE(kvs.end(), out);
+            auto in = kvs.find(NebulaKeyUtils::edgeKey(vidLen, dstPart, dst, -edgeType, rank,
+                                                       src));
+            ASSERT_NE(kvs.end(), in);
+            EXPECT_EQ(out->second, in->second);
+            auto reader = RowReaderWrapper::getRowReader(edgeSchema.get(), out->second);
+            ASSERT_NE(nullptr, reader);
+            EXPECT_EQ(likeness, reader->getValueByName("likeness").getInt());
+
+            auto values = IndexKeyUtils::encodeValues({Value(likeness)},
+                                                      edgeIndex->get_fields());
+            auto indexKey = IndexKeyUtils::edgeIndexKey(vidLen, srcPart,
+                                                        edgeIndex->get_index_id(), src, rank,
+                                                        dst, std::move(values));
+            EXPECT_NE(kvs.end(), kvs.find(indexKey));
+        };
+        check("Tim", "Tony", 0, 90);
+        check("Tony", "Tim", 1, 80);
+    }
+}
+
+TEST(SstBuilderTest, MergeTest) {
+    fs::TempDir rootPath("/tmp/SstBuilderMergeTest.XXXXXX");
+    FLAGS_tmp_path = fs::FileUtils::joinPath(rootPath.path(), "tmp");
+    FLAGS_output_path = fs::FileUtils::joinPath(rootPath.path(), "output");
+    FLAGS_merge_fan_in = 3;
+    FLAGS_thread_num = 2;
+    const PartitionID partNum = 2;
+    ASSERT_TRUE(fs::FileUtils::makeDir(FLAGS_tmp_path));
+    for (PartitionID partId = 1; partId <= partNum; partId++) {
+        auto path = fs::FileUtils::joinPath(FLAGS_output_path, folly::to<std::string>(partId));
+        ASSERT_TRUE(fs::FileUtils::makeDir(path));
+    }
+
+    SstBuilder builder;
+    // Run r holds the vertices [10 * r, 10 * r + 30) and their index entries, so a key is in up
+    // to three runs, and the one in the newest run should be kept
+    const int32_t numRuns = 10;
+    std::map<std::string, std::string> expected[partNum + 1];
+    for (int32_t r = 0; r < numRuns; r++) {
+        SstBuilder::Buffer buffer;
+        for (int32_t i = 10 * r + 29; i >= 10 * r; i--) {
+            auto vid = folly::stringPrintf("v%03d", i);
+            PartitionID partId = i % partNum + 1;
+            auto val = folly::to<std::string>(r);
+            auto vertexKey = NebulaKeyUtils::vertexKey(8, partId, vid, 1);
+            auto indexKey = IndexKeyUtils::vertexIndexKey(8, partId, 1, vid,
+                                                          IndexKeyUtils::encodeValue(Value(i)));
+            // The former one of the same key in a run is stale
+            builder.append(&buffer, vertexKey, "stale");
+            builder.append(&buffer, vertexKey, val);
+            builder.append(&buffer, indexKey, val);
+            expected[partId][vertexKey] = val;
+            expected[partId][indexKey] = val;
+        }
+        auto status = builder.spill(&buffer);
+        ASSERT_TRUE(status.ok()) << status;
+        ASSERT_TRUE(buffer.data_.empty());
+    }
+
+    auto runs = fs::FileUtils::listAllFilesInDir(FLAGS_tmp_path.c_str(), true, "*.sst");
+    ASSERT_EQ(numRuns, runs.size());
+    std::sort(runs.begin(), runs.end());
+    auto status = builder.compactRuns(&runs);
+    ASSERT_TRUE(status.ok()) << status;
+    // 10 runs into 4 and then into 2
+    ASSERT_EQ(2, runs.size());
+    EXPECT_EQ(runs.size(),
+              fs::FileUtils::listAllFilesInDir(FLAGS_tmp_path.c_str(), true, "*.sst").size());
+
+    for (PartitionID partId = 1; partId <= partNum; partId++) {
+        status = builder.mergePart(partId, runs);
+        ASSERT_TRUE(status.ok()) << status;
+        auto kvs = readPart(partId);
+        ASSERT_EQ(expected[partId].size(), kvs.size());
+        auto it = expected[partId].begin();
+        for (const auto& kv : kvs) {
+            EXPECT_EQ(it->first, kv.first);
+            EXPECT_EQ(it->second, kv.second);
+            ++it;
+        }
+    }
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+    return RUN_ALL_TESTS();
+}